@@ -0,0 +1,175 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+void BenchmarkRunner::Add(const std::string& name, std::function<void(uint64_t)> body,
+                          std::function<void()> setup, std::function<void()> teardown)
+{
+    Benchmark benchmark;
+    benchmark.name = name;
+    benchmark.body = body;
+    benchmark.setup = setup;
+    benchmark.teardown = teardown;
+    m_benchmarks.push_back(benchmark);
+}
+
+std::vector<BenchmarkResult> BenchmarkRunner::Run(const std::string& filter, uint32_t minTimeMs)
+{
+    std::vector<BenchmarkResult> results;
+
+    for (const Benchmark& benchmark : m_benchmarks)
+    {
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos)
+            continue;
+
+        if (benchmark.setup)
+            benchmark.setup();
+
+        BenchmarkResult result = Measure(benchmark, minTimeMs);
+
+        if (benchmark.teardown)
+            benchmark.teardown();
+
+        printf("%-40s %14llu iterations %12.2f ns/op\n", result.name.c_str(),
+               static_cast<unsigned long long>(result.iterations), result.nsPerOp);
+        fflush(stdout);
+        results.push_back(result);
+    }
+
+    return results;
+}
+
+double BenchmarkRunner::TimeRun(const Benchmark& benchmark, uint64_t iterations)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    benchmark.body(iterations);
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+BenchmarkResult BenchmarkRunner::Measure(const Benchmark& benchmark, uint32_t minTimeMs)
+{
+    const double minTimeNs = static_cast<double>(minTimeMs) * 1e6;
+
+    // Grow the iteration count until one run is long enough to time reliably
+    uint64_t iterations = 1;
+    double elapsed = TimeRun(benchmark, iterations);
+    while (elapsed < minTimeNs && iterations < (UINT64_C(1) << 40))
+    {
+        double scale = elapsed > 0 ? minTimeNs * 1.2 / elapsed : 10.0;
+        scale = std::min(std::max(scale, 2.0), 10.0);
+        iterations = static_cast<uint64_t>(static_cast<double>(iterations) * scale);
+        elapsed = TimeRun(benchmark, iterations);
+    }
+
+    double best = elapsed;
+    for (int i = 1; i < REPETITIONS; ++i)
+    {
+        best = std::min(best, TimeRun(benchmark, iterations));
+    }
+
+    BenchmarkResult result;
+    result.name = benchmark.name;
+    result.iterations = iterations;
+    result.nsPerOp = best / static_cast<double>(iterations);
+    return result;
+}
+
+bool BenchmarkRunner::WriteJson(const std::vector<BenchmarkResult>& results, const char* path)
+{
+    FILE* file = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (!file)
+        return false;
+
+    fprintf(file, "{\n  \"suite\": \"mma_bench\",\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        fprintf(file, "    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.4f}%s\n",
+                results[i].name.c_str(), static_cast<unsigned long long>(results[i].iterations),
+                results[i].nsPerOp, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+
+    if (file != stdout)
+        fclose(file);
+    return true;
+}
+
+bool BenchmarkRunner::ReadJson(const char* path, std::vector<BenchmarkResult>& results)
+{
+    FILE* file = fopen(path, "r");
+    if (!file)
+        return false;
+
+    std::string text;
+    char chunk[4096];
+    size_t bytes;
+    while ((bytes = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        text.append(chunk, bytes);
+    }
+    fclose(file);
+
+    // Only reads the layout WriteJson produces: one object per benchmark
+    size_t pos = 0;
+    while ((pos = text.find("\"name\"", pos)) != std::string::npos)
+    {
+        size_t open = text.find('"', text.find(':', pos) + 1);
+        size_t close = text.find('"', open + 1);
+        size_t iterations = text.find("\"iterations\"", close);
+        size_t nsPerOp = text.find("\"ns_per_op\"", close);
+        if (open == std::string::npos || close == std::string::npos ||
+            iterations == std::string::npos || nsPerOp == std::string::npos)
+            return false;
+
+        BenchmarkResult result;
+        result.name = text.substr(open + 1, close - open - 1);
+        result.iterations = strtoull(text.c_str() + text.find(':', iterations) + 1, nullptr, 10);
+        result.nsPerOp = strtod(text.c_str() + text.find(':', nsPerOp) + 1, nullptr);
+        results.push_back(result);
+
+        pos = close;
+    }
+
+    return true;
+}
+
+int BenchmarkRunner::Compare(const std::vector<BenchmarkResult>& baseline,
+                             const std::vector<BenchmarkResult>& current, double thresholdPercent)
+{
+    int regressions = 0;
+
+    printf("%-40s %12s %12s %9s\n", "benchmark", "baseline", "current", "change");
+    for (const BenchmarkResult& result : current)
+    {
+        const BenchmarkResult* base = nullptr;
+        for (const BenchmarkResult& candidate : baseline)
+        {
+            if (candidate.name == result.name)
+            {
+                base = &candidate;
+                break;
+            }
+        }
+
+        if (!base || base->nsPerOp <= 0.0)
+        {
+            printf("%-40s %12s %12.2f %9s\n", result.name.c_str(), "-", result.nsPerOp, "new");
+            continue;
+        }
+
+        double change = (result.nsPerOp - base->nsPerOp) * 100.0 / base->nsPerOp;
+        bool regressed = change > thresholdPercent;
+        if (regressed)
+            ++regressions;
+
+        printf("%-40s %12.2f %12.2f %+8.1f%%%s\n", result.name.c_str(), base->nsPerOp,
+               result.nsPerOp, change, regressed ? "  REGRESSION" : "");
+    }
+
+    return regressions;
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * Keeps a computed value alive so the optimizer cannot drop the work
+ */
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+    _ReadWriteBarrier();
+#endif
+}
+
+/**
+ * One measured hot path
+ * body runs the operation the given number of times; setup and teardown
+ * run outside the timed region
+ */
+struct Benchmark
+{
+    std::string name;
+    std::function<void(uint64_t iterations)> body;
+    std::function<void()> setup;
+    std::function<void()> teardown;
+};
+
+struct BenchmarkResult
+{
+    std::string name;
+    uint64_t iterations = 0;
+    double nsPerOp = 0.0;
+};
+
+/**
+ * Calibrates, runs and reports registered benchmarks
+ * Iteration counts grow until one run lasts at least the minimum time;
+ * the best of several runs is reported to filter out scheduler noise
+ */
+class BenchmarkRunner
+{
+public:
+    static const int REPETITIONS = 3;
+
+    // Registration
+    void Add(const std::string& name, std::function<void(uint64_t)> body,
+             std::function<void()> setup = nullptr, std::function<void()> teardown = nullptr);
+
+    // Execution; filter selects benchmarks whose name contains it
+    std::vector<BenchmarkResult> Run(const std::string& filter, uint32_t minTimeMs);
+
+    // Reporting
+    static bool WriteJson(const std::vector<BenchmarkResult>& results, const char* path);
+    static bool ReadJson(const char* path, std::vector<BenchmarkResult>& results);
+
+    // Prints a comparison table; returns the number of regressions over thresholdPercent
+    static int Compare(const std::vector<BenchmarkResult>& baseline,
+                       const std::vector<BenchmarkResult>& current, double thresholdPercent);
+
+private:
+    // Private helpers
+    static double TimeRun(const Benchmark& benchmark, uint64_t iterations);
+    static BenchmarkResult Measure(const Benchmark& benchmark, uint32_t minTimeMs);
+
+    // Member variables
+    std::vector<Benchmark> m_benchmarks;
+};
+
+// Benchmark groups
+void RegisterCoreBenchmarks(BenchmarkRunner& runner);
+void RegisterSettingsBenchmarks(BenchmarkRunner& runner);
+void RegisterConcurrencyBenchmarks(BenchmarkRunner& runner);
+void RegisterControlBenchmarks(BenchmarkRunner& runner);
+void RegisterLinuxBenchmarks(BenchmarkRunner& runner);
+
+// Private bytes per instance of the portable core (and per seat on Linux)
+int RunFootprintReport(uint32_t instances);
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "Benchmark.h"
+#include "InputEventRing.h"
+#include "StatusPage.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+
+void RegisterConcurrencyBenchmarks(BenchmarkRunner& runner)
+{
+    // Producer/consumer throughput across two threads; time per event moved
+    runner.Add("ring.spsc_throughput", [](uint64_t iterations)
+    {
+        std::unique_ptr<InputEventRing> ring(new InputEventRing());
+        std::atomic<bool> done{ false };
+
+        std::thread consumer([&ring, &done, iterations]()
+        {
+            InputEvent batch[256];
+            uint64_t received = 0;
+            while (received < iterations)
+            {
+                size_t count = ring->PopBatch(batch, 256);
+                if (count == 0)
+                    std::this_thread::yield();
+                received += count;
+            }
+            done.store(true, std::memory_order_release);
+        });
+
+        InputEvent event;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            event.timestampMs = i;
+            // Stalls yield so the benchmark also works on a single core
+            while (!ring->TryPush(event))
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        consumer.join();
+        DoNotOptimize(done.load(std::memory_order_acquire));
+    });
+
+    // Producer cost when the ring is full and every push is dropped
+    runner.Add("ring.push_dropped", [](uint64_t iterations)
+    {
+        std::unique_ptr<InputEventRing> ring(new InputEventRing());
+        InputEvent event;
+        for (size_t i = 0; i < InputEventRing::CAPACITY; ++i)
+        {
+            ring->TryPush(event);
+        }
+
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            DoNotOptimize(ring->TryPush(event));
+        }
+    });
+
+    // Seqlock publish and snapshot of the status page (in process memory, same code path)
+    runner.Add("status.publish", [](uint64_t iterations)
+    {
+        std::unique_ptr<StatusPage> page(new StatusPage());
+        StatusPage::Initialize(*page);
+        StatusSnapshot snapshot = {};
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            snapshot.publishCount = i;
+            StatusPage::Write(*page, snapshot);
+        }
+        DoNotOptimize(page->sequence.load(std::memory_order_relaxed));
+    });
+
+    runner.Add("status.read", [](uint64_t iterations)
+    {
+        std::unique_ptr<StatusPage> page(new StatusPage());
+        StatusPage::Initialize(*page);
+        StatusSnapshot snapshot = {};
+        StatusPage::Write(*page, snapshot);
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            DoNotOptimize(StatusPage::Read(*page, snapshot));
+        }
+        DoNotOptimize(snapshot);
+    });
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "Benchmark.h"
+#include "ControlClient.h"
+#include "ControlServer.h"
+#include <cstdio>
+#include <memory>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+// Private endpoint, so a running instance is neither reached nor in the way
+static char s_endpoint[ControlProtocol::MAX_ENDPOINT_LENGTH];
+static std::unique_ptr<ControlServer> s_server;
+
+static void StartBenchServer()
+{
+    snprintf(s_endpoint, sizeof(s_endpoint), "mma-bench-control-%d", static_cast<int>(getpid()));
+    s_server.reset(new ControlServer());
+    s_server->Start([](const ControlRequest& request, ControlResponse& response)
+    {
+        response.timeoutSeconds = request.argument;
+    }, s_endpoint);
+}
+
+static void StopBenchServer()
+{
+    s_server.reset();
+}
+
+void RegisterControlBenchmarks(BenchmarkRunner& runner)
+{
+    // One command on an open connection: the channel's own cost, handler excluded
+    runner.Add("control.round_trip", [](uint64_t iterations)
+    {
+        ControlClient client;
+        if (!client.Connect(s_endpoint))
+            return;
+
+        ControlRequest request = ControlProtocol::MakeRequest(ControlCommand::Status);
+        ControlResponse response;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            request.sequence = static_cast<uint32_t>(i);
+            DoNotOptimize(client.Transact(request, response));
+        }
+    }, StartBenchServer, StopBenchServer);
+
+    // What one mma_ctl invocation or second launch pays, process start excluded
+    runner.Add("control.connect_round_trip", [](uint64_t iterations)
+    {
+        ControlRequest request = ControlProtocol::MakeRequest(ControlCommand::Status);
+        ControlResponse response;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            ControlClient client;
+            if (!client.Connect(s_endpoint))
+                return;
+            DoNotOptimize(client.Transact(request, response));
+        }
+    }, StartBenchServer, StopBenchServer);
+}
\ No newline at end of file
@@ -0,0 +1,422 @@
+#include "Benchmark.h"
+#include "ActivityChannel.h"
+#include "Clock.h"
+#include "DeadlineTimer.h"
+#include "HeadlessCursorDriver.h"
+#include "HookEventDecoder.h"
+#include "HotkeyModel.h"
+#include "IdleEngine.h"
+#include "InputDispatch.h"
+#include "LatencyHistogram.h"
+#include "Logger.h"
+#include "OpenMetricsWriter.h"
+#include "RawInputDecoder.h"
+#include "TimerHeap.h"
+#include "TraceRecorder.h"
+#include <cstring>
+#include <memory>
+
+namespace
+{
+    // Deadline timer that only remembers the last deadline
+    class NullDeadlineTimer : public IDeadlineTimer
+    {
+    public:
+        bool Arm(uint64_t deadlineMs) override { m_deadlineMs = deadlineMs; return true; }
+        void Disarm() override { m_deadlineMs = 0; }
+
+    private:
+        uint64_t m_deadlineMs = 0;
+    };
+
+    // Everything an IdleEngine needs, driven by a manual clock
+    struct EngineFixture
+    {
+        ManualClock clock{ 1000000 };
+        NullDeadlineTimer timer;
+        HeadlessCursorDriver cursor;
+        ActivityChannel channel;
+        IdleEngine engine{ clock, timer, cursor, channel };
+
+        EngineFixture()
+        {
+            channel.Reset(clock.NowMs());
+            engine.SetTimeout(60);
+            engine.Start();
+        }
+    };
+}
+
+static void RegisterActivityBenchmarks(BenchmarkRunner& runner)
+{
+    // UpdateActivityTime: application-side timestamp update
+    runner.Add("activity.update", [](uint64_t iterations)
+    {
+        SystemClock clock;
+        NullDeadlineTimer timer;
+        HeadlessCursorDriver cursor;
+        ActivityChannel channel;
+        IdleEngine engine(clock, timer, cursor, channel);
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            engine.NoteActivity();
+        }
+        DoNotOptimize(channel.GetLastActivity());
+    });
+
+    // Hook fast path: every event lands inside the current quantum
+    runner.Add("activity.publish_coalesced", [](uint64_t iterations)
+    {
+        ActivityChannel channel;
+        channel.Reset(1000);
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            DoNotOptimize(channel.Publish(1000));
+        }
+    });
+
+    // Slow path: every event opens a new quantum
+    runner.Add("activity.publish_processed", [](uint64_t iterations)
+    {
+        ActivityChannel channel;
+        uint64_t timestamp = 1000;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            timestamp += ActivityChannel::QUANTUM_MS;
+            DoNotOptimize(channel.Publish(timestamp));
+        }
+    });
+
+    // Full per-event path of an input source without the analytics ring
+    runner.Add("input.dispatch", [](uint64_t iterations)
+    {
+        ActivityChannel channel;
+        InputDispatch dispatch(channel);
+        InputEvent event;
+        event.timestampMs = 1000;
+        event.device = 7;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            event.timestampMs += (i & 7) == 0 ? 1 : 0;
+            dispatch.Dispatch(event);
+        }
+        DoNotOptimize(channel.GetEventCount());
+    });
+
+    // Per-event cost the hook procedures add for their latency histograms
+    runner.Add("hook.latency_record", [](uint64_t iterations)
+    {
+        std::unique_ptr<LatencyHistogram> histogram(new LatencyHistogram());
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            histogram->Record(200 + (i & 1023) * 37);
+        }
+        DoNotOptimize(histogram->GetCount());
+    });
+
+    // One metrics export into the reused buffer: counters plus a latency histogram
+    runner.Add("metrics.format", [](uint64_t iterations)
+    {
+        static const uint64_t BOUNDS_NS[] = { 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 1000000 };
+        std::unique_ptr<LatencyHistogram> histogram(new LatencyHistogram());
+        for (uint64_t i = 0; i < 10000; ++i)
+        {
+            histogram->Record(200 + (i & 1023) * 37);
+        }
+
+        OpenMetricsWriter writer;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            writer.Begin();
+            writer.WriteCounter("mma_idle_actions", "Cursor moves injected after an idle timeout", i);
+            writer.WriteCounter("mma_scheduler_wakeups", "Idle deadline expiries", i);
+            writer.WriteHistogram("mma_mouse_hook_latency_seconds", "Time spent in the mouse hook procedure",
+                                  "seconds", *histogram, BOUNDS_NS, sizeof(BOUNDS_NS) / sizeof(BOUNDS_NS[0]), 1e-9);
+            writer.End();
+        }
+        DoNotOptimize(writer.GetText().size());
+    });
+
+    // Log call site cost: enqueue into the ring, formatting happens on the logger thread
+    runner.Add("log.write", [](uint64_t iterations)
+    {
+        class NullSink : public ILogSink
+        {
+        public:
+            bool Write(const char*, size_t length) override { DoNotOptimize(length); return true; }
+        };
+
+        NullSink sink;
+        Logger::Start(&sink);
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            MMA_LOG_INFO("Bench record %llu of %s", static_cast<unsigned long long>(i), "log.write");
+        }
+        Logger::Flush();
+        Logger::Stop();
+    });
+
+    // A call site below the runtime level: one relaxed load and a branch
+    runner.Add("log.filtered", [](uint64_t iterations)
+    {
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            MMA_LOG_DEBUG("Bench record %llu", static_cast<unsigned long long>(i));
+        }
+    });
+
+    // Trace recorder cost per event when compiled in (instant and scoped)
+    runner.Add("trace.instant", [](uint64_t iterations)
+    {
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            TraceRecorder::Instant("bench.instant", i);
+        }
+    });
+
+    runner.Add("trace.scope", [](uint64_t iterations)
+    {
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            TraceScope scope("bench.scope", i);
+        }
+    });
+}
+
+static void RegisterEngineBenchmarks(BenchmarkRunner& runner)
+{
+    // CheckActivity when input arrived since arming: re-arm only
+    runner.Add("engine.check_activity_rearm", [](uint64_t iterations)
+    {
+        EngineFixture fixture;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            fixture.clock.Advance(60000);
+            fixture.channel.Publish(fixture.clock.NowMs() - 1);
+            DoNotOptimize(fixture.engine.OnDeadline());
+        }
+    });
+
+    // CheckActivity at a real idle deadline: pick a target and move the cursor
+    runner.Add("engine.check_activity_idle", [](uint64_t iterations)
+    {
+        EngineFixture fixture;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            fixture.clock.Advance(60000);
+            DoNotOptimize(fixture.engine.OnDeadline());
+        }
+        DoNotOptimize(fixture.cursor.GetMoveCount());
+    });
+
+    // MoveMouse target generation alone
+    runner.Add("cursor.pick_target", [](uint64_t iterations)
+    {
+        EngineFixture fixture;
+        int x = 0, y = 0;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            fixture.engine.PickCursorTarget(x, y);
+            DoNotOptimize(x);
+            DoNotOptimize(y);
+        }
+    });
+}
+
+static void RegisterHotkeyBenchmarks(BenchmarkRunner& runner)
+{
+    runner.Add("hotkey.display_string", [](uint64_t iterations)
+    {
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            DoNotOptimize(HotkeyModel::GetHotkeyDisplayString(HOTKEY_MOD_CONTROL | HOTKEY_MOD_SHIFT, 'M'));
+        }
+    });
+
+    // Worst case: the last entry of the key table
+    runner.Add("hotkey.key_name_last", [](uint64_t iterations)
+    {
+        uint32_t vk = g_keyMappings[g_keyMappingsCount - 1].vk;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            DoNotOptimize(HotkeyModel::GetKeyName(vk));
+        }
+    });
+
+    runner.Add("hotkey.key_name_unknown", [](uint64_t iterations)
+    {
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            DoNotOptimize(HotkeyModel::GetKeyName(0xFF));
+        }
+    });
+}
+
+// Mouse move packet as RawInputSource receives it
+static void MakeRawMousePacket(unsigned char (&packet)[sizeof(RawInputDecoder::Header) + sizeof(RawInputDecoder::Mouse)])
+{
+    RawInputDecoder::Header header = {};
+    header.type = RawInputDecoder::TYPE_MOUSE;
+    header.size = sizeof(packet);
+    header.device = 0x1234;
+    RawInputDecoder::Mouse mouse = {};
+    mouse.lastX = 3;
+    mouse.lastY = -2;
+    memcpy(packet, &header, sizeof(header));
+    memcpy(packet + sizeof(header), &mouse, sizeof(mouse));
+}
+
+static void MakeRawKeyboardPacket(unsigned char (&packet)[sizeof(RawInputDecoder::Header) + sizeof(RawInputDecoder::Keyboard)])
+{
+    RawInputDecoder::Header header = {};
+    header.type = RawInputDecoder::TYPE_KEYBOARD;
+    header.size = sizeof(packet);
+    header.device = 0x5678;
+    RawInputDecoder::Keyboard keyboard = {};
+    keyboard.makeCode = 0x1E;
+    keyboard.vkey = 'A';
+    memcpy(packet, &header, sizeof(header));
+    memcpy(packet + sizeof(header), &keyboard, sizeof(keyboard));
+}
+
+static void RegisterDecoderBenchmarks(BenchmarkRunner& runner)
+{
+    // Recorded-style RAWINPUT mouse move packet
+    runner.Add("rawinput.decode_mouse", [](uint64_t iterations)
+    {
+        unsigned char packet[sizeof(RawInputDecoder::Header) + sizeof(RawInputDecoder::Mouse)];
+        MakeRawMousePacket(packet);
+
+        InputEvent event;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            DoNotOptimize(RawInputDecoder::Decode(packet, sizeof(packet), i, event));
+        }
+    });
+
+    runner.Add("rawinput.decode_keyboard", [](uint64_t iterations)
+    {
+        unsigned char packet[sizeof(RawInputDecoder::Header) + sizeof(RawInputDecoder::Keyboard)];
+        MakeRawKeyboardPacket(packet);
+
+        InputEvent event;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            DoNotOptimize(RawInputDecoder::Decode(packet, sizeof(packet), i, event));
+        }
+    });
+
+    // Per-event work inside our process for each backend: what MouseHookProc and
+    // KeyboardHookProc run (record copy, decode, dispatch, latency histogram) against
+    // what RawInputSource runs per WM_INPUT (decode, dispatch). The system-wide cost
+    // of the synchronous hook round trip comes on top for hooks and is not measured here
+    runner.Add("input.hook_mouse", [](uint64_t iterations)
+    {
+        ActivityChannel channel;
+        InputDispatch dispatch(channel);
+        std::unique_ptr<LatencyHistogram> latency(new LatencyHistogram());
+
+        HookEventDecoder::MouseInfo record = {};
+        record.x = 640;
+        record.y = 480;
+        InputEvent event;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            HookEventDecoder::MouseInfo info;
+            memcpy(&info, &record, sizeof(info));
+            HookEventDecoder::DecodeMouse(HookEventDecoder::MESSAGE_MOUSEMOVE, info, 1000 + i / 8, event);
+            dispatch.Dispatch(event);
+            latency->Record(200 + (i & 1023));
+        }
+        DoNotOptimize(channel.GetEventCount());
+    });
+
+    runner.Add("input.raw_mouse", [](uint64_t iterations)
+    {
+        ActivityChannel channel;
+        InputDispatch dispatch(channel);
+
+        unsigned char packet[sizeof(RawInputDecoder::Header) + sizeof(RawInputDecoder::Mouse)];
+        MakeRawMousePacket(packet);
+        InputEvent event;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            if (RawInputDecoder::Decode(packet, sizeof(packet), 1000 + i / 8, event))
+                dispatch.Dispatch(event);
+        }
+        DoNotOptimize(channel.GetEventCount());
+    });
+
+    runner.Add("input.hook_keyboard", [](uint64_t iterations)
+    {
+        ActivityChannel channel;
+        InputDispatch dispatch(channel);
+        std::unique_ptr<LatencyHistogram> latency(new LatencyHistogram());
+
+        HookEventDecoder::KeyboardInfo record = {};
+        record.vkCode = 'A';
+        record.scanCode = 0x1E;
+        InputEvent event;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            HookEventDecoder::KeyboardInfo info;
+            memcpy(&info, &record, sizeof(info));
+            HookEventDecoder::DecodeKeyboard((i & 1) ? HookEventDecoder::MESSAGE_KEYUP : 0x0100, info, 1000 + i / 8, event);
+            dispatch.Dispatch(event);
+            latency->Record(200 + (i & 1023));
+        }
+        DoNotOptimize(channel.GetEventCount());
+    });
+
+    runner.Add("input.raw_keyboard", [](uint64_t iterations)
+    {
+        ActivityChannel channel;
+        InputDispatch dispatch(channel);
+
+        unsigned char packet[sizeof(RawInputDecoder::Header) + sizeof(RawInputDecoder::Keyboard)];
+        MakeRawKeyboardPacket(packet);
+        InputEvent event;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            if (RawInputDecoder::Decode(packet, sizeof(packet), 1000 + i / 8, event))
+                dispatch.Dispatch(event);
+        }
+        DoNotOptimize(channel.GetEventCount());
+    });
+}
+
+static void RegisterTimerHeapBenchmarks(BenchmarkRunner& runner)
+{
+    // Re-arming one seat's deadline with N seats scheduled
+    const uint32_t sizes[] = { 1, 100, 10000 };
+    for (uint32_t size : sizes)
+    {
+        std::shared_ptr<TimerHeap> heap = std::make_shared<TimerHeap>();
+        runner.Add("timer_heap.reschedule/" + std::to_string(size), [heap, size](uint64_t iterations)
+        {
+            uint64_t deadline = size;
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                heap->Schedule(static_cast<uint32_t>(i % size), ++deadline);
+            }
+            DoNotOptimize(heap->GetEarliest());
+        },
+        [heap, size]()
+        {
+            heap->Reserve(size);
+            for (uint32_t id = 0; id < size; ++id)
+            {
+                heap->Schedule(id, id);
+            }
+        });
+    }
+}
+
+void RegisterCoreBenchmarks(BenchmarkRunner& runner)
+{
+    RegisterActivityBenchmarks(runner);
+    RegisterEngineBenchmarks(runner);
+    RegisterHotkeyBenchmarks(runner);
+    RegisterDecoderBenchmarks(runner);
+    RegisterTimerHeapBenchmarks(runner);
+}
\ No newline at end of file
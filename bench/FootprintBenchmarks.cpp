@@ -0,0 +1,129 @@
+#include "Benchmark.h"
+#include "ActivityChannel.h"
+#include "Clock.h"
+#include "DeadlineTimer.h"
+#include "HeadlessCursorDriver.h"
+#include "HookWatchdog.h"
+#include "IdleEngine.h"
+#include "IdlePeriodStatistics.h"
+#include "InputDispatch.h"
+#include "InputEventRing.h"
+#include "InputStatistics.h"
+#include "LatencyHistogram.h"
+#include "ManualIdleSource.h"
+#include "ProcessMemory.h"
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#ifdef __linux__
+#include "SeatDaemon.h"
+#endif
+
+namespace
+{
+    class NullDeadlineTimer : public IDeadlineTimer
+    {
+    public:
+        bool Arm(uint64_t deadlineMs) override { m_deadlineMs = deadlineMs; return true; }
+        void Disarm() override { m_deadlineMs = 0; }
+
+    private:
+        uint64_t m_deadlineMs = 0;
+    };
+
+    // The portable members of one ActivityMonitor in low-footprint mode
+    struct CoreInstance
+    {
+        ManualClock clock{ 1000000 };
+        NullDeadlineTimer timer;
+        HeadlessCursorDriver cursor;
+        ActivityChannel channel;
+        InputDispatch dispatch{ channel };
+        ManualIdleSource idleSource;
+        HookWatchdog watchdog{ idleSource, channel };
+        LatencyHistogram mouseHookLatency;
+        LatencyHistogram keyboardHookLatency;
+        InputStatistics inputStatistics;
+        IdlePeriodStatistics idlePeriodStatistics;
+        IdleEngine engine{ clock, timer, cursor, channel };
+
+        CoreInstance()
+        {
+            channel.Reset(clock.NowMs());
+            engine.Start();
+        }
+    };
+
+    // The same with per-event analytics on, as in the default mode
+    struct AnalyticsInstance : CoreInstance
+    {
+        InputEventRing ring;
+
+        AnalyticsInstance() { dispatch.SetEventRing(&ring); }
+    };
+
+    uint64_t PrivateBytes()
+    {
+        ProcessMemoryUsage usage = {};
+        return ProcessMemory::Query(usage) ? usage.privateBytes : 0;
+    }
+
+    void PrintRow(const char* name, uint32_t instances, uint64_t before, uint64_t after, size_t size)
+    {
+        uint64_t perInstance = after > before ? (after - before) / instances : 0;
+        if (size)
+            printf("%-28s %10u %16llu %12zu\n", name, instances, static_cast<unsigned long long>(perInstance), size);
+        else
+            printf("%-28s %10u %16llu %12s\n", name, instances, static_cast<unsigned long long>(perInstance), "-");
+    }
+
+    template <typename T>
+    void MeasureObjects(const char* name, uint32_t instances)
+    {
+        ProcessMemory::TrimWorkingSet();
+        uint64_t before = PrivateBytes();
+        std::vector<std::unique_ptr<T>> objects;
+        objects.reserve(instances);
+        for (uint32_t i = 0; i < instances; ++i)
+        {
+            objects.push_back(std::make_unique<T>());
+        }
+        PrintRow(name, instances, before, PrivateBytes(), sizeof(T));
+    }
+}
+
+int RunFootprintReport(uint32_t instances)
+{
+    ProcessMemoryUsage usage;
+    if (!ProcessMemory::Query(usage))
+    {
+        fprintf(stderr, "mma_bench: process memory is not available on this system\n");
+        return 2;
+    }
+
+    // Private bytes are what a terminal server pays per session; pages a constructor
+    // never touches count on Windows (commit charge) but not on Linux (resident pages),
+    // so sizeof is printed beside the measured delta
+    printf("%-28s %10s %16s %12s\n", "footprint", "instances", "private B/inst", "sizeof B");
+    printf("%-28s %10u %16llu %12s\n", "process", 1u, static_cast<unsigned long long>(usage.privateBytes), "-");
+    MeasureObjects<CoreInstance>("core.instance_low_footprint", instances);
+    MeasureObjects<AnalyticsInstance>("core.instance", instances);
+
+#ifdef __linux__
+    {
+        ProcessMemory::TrimWorkingSet();
+        uint64_t before = PrivateBytes();
+        SeatDaemon daemon;
+        daemon.Open();
+        daemon.Reserve(instances);
+        for (uint32_t seat = 0; seat < instances; ++seat)
+        {
+            daemon.AddSeat(3600);
+        }
+        PrintRow("seat", instances, before, PrivateBytes(), 0);
+    }
+#endif
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "Benchmark.h"
+
+#ifdef __linux__
+
+#include "SeatDaemon.h"
+#include <algorithm>
+#include <linux/input.h>
+#include <memory>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    // A daemon with N seats; the first seats get a pipe standing in for an evdev node
+    struct SeatFixture
+    {
+        SeatDaemon daemon;
+        std::vector<int> writers;
+
+        explicit SeatFixture(uint32_t seats)
+        {
+            daemon.Open();
+            daemon.Reserve(seats);
+
+            // Keep well inside the descriptor limit; seats without a pipe still
+            // cost their heap entry and scheduler state
+            rlimit limit;
+            getrlimit(RLIMIT_NOFILE, &limit);
+            uint32_t piped = std::min<uint32_t>(seats, static_cast<uint32_t>(std::min<rlim_t>(limit.rlim_cur / 4, 1024)));
+
+            for (uint32_t seat = 0; seat < seats; ++seat)
+            {
+                daemon.AddSeat(3600);
+                int fds[2];
+                if (seat < piped && pipe(fds) == 0)
+                {
+                    daemon.AddDevice(seat, fds[0]);
+                    writers.push_back(fds[1]);
+                }
+            }
+        }
+
+        ~SeatFixture()
+        {
+            for (int fd : writers)
+            {
+                close(fd);
+            }
+        }
+    };
+}
+
+void RegisterLinuxBenchmarks(BenchmarkRunner& runner)
+{
+    // Deliver one key event to a seat and run one loop pass, with N seats registered
+    const uint32_t sizes[] = { 1, 100, 10000 };
+    for (uint32_t size : sizes)
+    {
+        std::shared_ptr<std::unique_ptr<SeatFixture>> fixture = std::make_shared<std::unique_ptr<SeatFixture>>();
+        runner.Add("seat.event/" + std::to_string(size), [fixture](uint64_t iterations)
+        {
+            SeatFixture& seats = **fixture;
+            input_event record = {};
+            record.type = EV_KEY;
+            record.code = KEY_A;
+            record.value = 1;
+
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                int fd = seats.writers[i % seats.writers.size()];
+                ssize_t written = write(fd, &record, sizeof(record));
+                (void)written;
+                seats.daemon.RunOnce(0);
+            }
+        },
+        [fixture, size]()
+        {
+            fixture->reset(new SeatFixture(size));
+        },
+        [fixture]()
+        {
+            fixture->reset();
+        });
+    }
+}
+
+#else
+
+void RegisterLinuxBenchmarks(BenchmarkRunner&)
+{
+}
+
+#endif
\ No newline at end of file
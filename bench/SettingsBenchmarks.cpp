@@ -0,0 +1,172 @@
+#include "Benchmark.h"
+#include "Clock.h"
+#include "FileSettingsStore.h"
+#include "MappedSettingsStore.h"
+#include "MemorySettingsStore.h"
+#include "SettingsModel.h"
+#include "SettingsReloader.h"
+#include "SettingsWriter.h"
+#include <cstdio>
+
+#ifdef _WIN32
+#include "RegistrySettingsStore.h"
+
+// Scratch key next to the real one, removed after each run
+static const WCHAR BENCH_REG_KEY[] = L"SOFTWARE\\MMA\\Benchmark";
+#endif
+
+// Scratch files in the working directory, removed after each run
+static const char BENCH_INI_PATH[] = "mma_bench_settings.ini";
+static const char BENCH_SNAPSHOT_PATH[] = "mma_bench_settings.snapshot";
+
+void RegisterSettingsBenchmarks(BenchmarkRunner& runner)
+{
+    // SettingsManager::LoadSettings against a fake store
+    runner.Add("settings.load", [](uint64_t iterations)
+    {
+        MemorySettingsStore store;
+        AppSettings settings;
+        SettingsModel::Save(store, settings);
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            DoNotOptimize(SettingsModel::Load(store, settings));
+        }
+    });
+
+    // SettingsManager::SaveSettings against a fake store
+    runner.Add("settings.save", [](uint64_t iterations)
+    {
+        MemorySettingsStore store;
+        AppSettings settings;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            settings.timeoutSeconds = 1 + static_cast<uint32_t>(i % MAX_TIMEOUT_SECONDS);
+            DoNotOptimize(SettingsModel::Save(store, settings));
+        }
+    });
+
+    // One changed field through the dirty mask instead of all values
+    runner.Add("settings.save_dirty", [](uint64_t iterations)
+    {
+        MemorySettingsStore store;
+        AppSettings settings;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            settings.timeoutSeconds = 1 + static_cast<uint32_t>(i % MAX_TIMEOUT_SECONDS);
+            DoNotOptimize(SettingsModel::SaveFields(store, settings, SettingsModel::FIELD_TIMEOUT));
+        }
+    });
+
+    // What a checkbox click costs the UI thread now: diff and queue, no store access
+    runner.Add("settings.submit", [](uint64_t iterations)
+    {
+        MemorySettingsStore store;
+        ManualClock clock(1000);
+        SettingsWriter writer(store, clock);
+        AppSettings settings;
+        writer.SetPersisted(settings);
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            settings.minimizeToTray = (i & 1) != 0;
+            writer.Submit(settings);
+        }
+        DoNotOptimize(writer.GetDirtyFields());
+    });
+
+    // Backends: one full load (cold start) and one single-field save (a settings change) each
+    runner.Add("settings.load_file", [](uint64_t iterations)
+    {
+        FileSettingsStore store(BENCH_INI_PATH);
+        AppSettings settings;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            DoNotOptimize(SettingsModel::Load(store, settings));
+        }
+    },
+    []() { FileSettingsStore store(BENCH_INI_PATH); SettingsModel::Save(store, AppSettings()); },
+    []() { remove(BENCH_INI_PATH); });
+
+    // A change notification's work: re-read the file and merge, re-applying nothing
+    runner.Add("settings.reload_file", [](uint64_t iterations)
+    {
+        FileSettingsStore store(BENCH_INI_PATH);
+        ManualClock clock(1000);
+        SettingsWriter writer(store, clock);
+        AppSettings settings;
+        writer.SetPersisted(settings);
+        SettingsReloader reloader(store, &writer);
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            DoNotOptimize(reloader.Reload(settings));
+        }
+    },
+    []() { FileSettingsStore store(BENCH_INI_PATH); SettingsModel::Save(store, AppSettings()); },
+    []() { remove(BENCH_INI_PATH); });
+
+    // Includes the flush to disk before the rename, which dominates
+    runner.Add("settings.save_file", [](uint64_t iterations)
+    {
+        FileSettingsStore store(BENCH_INI_PATH);
+        AppSettings settings;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            settings.timeoutSeconds = 1 + static_cast<uint32_t>(i % MAX_TIMEOUT_SECONDS);
+            DoNotOptimize(SettingsModel::SaveFields(store, settings, SettingsModel::FIELD_TIMEOUT));
+        }
+    },
+    []() { FileSettingsStore store(BENCH_INI_PATH); SettingsModel::Save(store, AppSettings()); },
+    []() { remove(BENCH_INI_PATH); });
+
+    // Cold: map, validate, read, unmap; what a process start pays
+    runner.Add("settings.load_snapshot", [](uint64_t iterations)
+    {
+        AppSettings settings;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            MappedSettingsStore store(BENCH_SNAPSHOT_PATH);
+            DoNotOptimize(SettingsModel::Load(store, settings));
+        }
+    },
+    []() { MappedSettingsStore::WriteSnapshot(BENCH_SNAPSHOT_PATH, AppSettings()); },
+    []() { remove(BENCH_SNAPSHOT_PATH); });
+
+    // Warm: later loads read the existing mapping
+    runner.Add("settings.reload_snapshot", [](uint64_t iterations)
+    {
+        MappedSettingsStore store(BENCH_SNAPSHOT_PATH);
+        AppSettings settings;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            DoNotOptimize(SettingsModel::Load(store, settings));
+        }
+    },
+    []() { MappedSettingsStore::WriteSnapshot(BENCH_SNAPSHOT_PATH, AppSettings()); },
+    []() { remove(BENCH_SNAPSHOT_PATH); });
+
+#ifdef _WIN32
+    runner.Add("settings.load_registry", [](uint64_t iterations)
+    {
+        RegistrySettingsStore store(BENCH_REG_KEY);
+        AppSettings settings;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            DoNotOptimize(SettingsModel::Load(store, settings));
+        }
+    },
+    []() { RegistrySettingsStore store(BENCH_REG_KEY); SettingsModel::Save(store, AppSettings()); },
+    []() { RegDeleteKeyW(HKEY_CURRENT_USER, BENCH_REG_KEY); });
+
+    runner.Add("settings.save_registry", [](uint64_t iterations)
+    {
+        RegistrySettingsStore store(BENCH_REG_KEY);
+        AppSettings settings;
+        for (uint64_t i = 0; i < iterations; ++i)
+        {
+            settings.timeoutSeconds = 1 + static_cast<uint32_t>(i % MAX_TIMEOUT_SECONDS);
+            DoNotOptimize(SettingsModel::SaveFields(store, settings, SettingsModel::FIELD_TIMEOUT));
+        }
+    },
+    []() { RegistrySettingsStore store(BENCH_REG_KEY); SettingsModel::Save(store, AppSettings()); },
+    []() { RegDeleteKeyW(HKEY_CURRENT_USER, BENCH_REG_KEY); });
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+// main.cpp : Micro-benchmark entry point
+//
+// Usage:
+//   mma_bench [--filter TEXT] [--json FILE] [--min-time-ms N]
+//   mma_bench --compare BASELINE.json CURRENT.json [--threshold PERCENT]
+//   mma_bench --footprint [--instances N]
+
+#include "Benchmark.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static void PrintUsage()
+{
+    fprintf(stderr,
+            "usage: mma_bench [--filter TEXT] [--json FILE] [--min-time-ms N]\n"
+            "       mma_bench --compare BASELINE.json CURRENT.json [--threshold PERCENT]\n"
+            "       mma_bench --footprint [--instances N]\n");
+}
+
+/**
+ * Compare two JSON result files; exit status 1 when anything regressed
+ */
+static int RunCompare(const char* baselinePath, const char* currentPath, double threshold)
+{
+    std::vector<BenchmarkResult> baseline, current;
+    if (!BenchmarkRunner::ReadJson(baselinePath, baseline))
+    {
+        fprintf(stderr, "mma_bench: cannot read %s\n", baselinePath);
+        return 2;
+    }
+    if (!BenchmarkRunner::ReadJson(currentPath, current))
+    {
+        fprintf(stderr, "mma_bench: cannot read %s\n", currentPath);
+        return 2;
+    }
+
+    int regressions = BenchmarkRunner::Compare(baseline, current, threshold);
+    printf("%d regression(s) over %.1f%%\n", regressions, threshold);
+    return regressions > 0 ? 1 : 0;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* filter = "";
+    const char* jsonPath = nullptr;
+    const char* compareBaseline = nullptr;
+    const char* compareCurrent = nullptr;
+    uint32_t minTimeMs = 100;
+    double threshold = 10.0;
+    bool footprint = false;
+    uint32_t instances = 1000;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonPath = argv[++i];
+        else if (strcmp(argv[i], "--min-time-ms") == 0 && i + 1 < argc)
+            minTimeMs = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc)
+            threshold = strtod(argv[++i], nullptr);
+        else if (strcmp(argv[i], "--footprint") == 0)
+            footprint = true;
+        else if (strcmp(argv[i], "--instances") == 0 && i + 1 < argc)
+            instances = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (strcmp(argv[i], "--compare") == 0 && i + 2 < argc)
+        {
+            compareBaseline = argv[++i];
+            compareCurrent = argv[++i];
+        }
+        else
+        {
+            PrintUsage();
+            return 2;
+        }
+    }
+
+    if (compareBaseline)
+        return RunCompare(compareBaseline, compareCurrent, threshold);
+
+    if (footprint)
+        return RunFootprintReport(instances > 0 ? instances : 1);
+
+    BenchmarkRunner runner;
+    RegisterCoreBenchmarks(runner);
+    RegisterSettingsBenchmarks(runner);
+    RegisterConcurrencyBenchmarks(runner);
+    RegisterControlBenchmarks(runner);
+    RegisterLinuxBenchmarks(runner);
+
+    std::vector<BenchmarkResult> results = runner.Run(filter, minTimeMs > 0 ? minTimeMs : 1);
+
+    if (jsonPath && !BenchmarkRunner::WriteJson(results, jsonPath))
+    {
+        fprintf(stderr, "mma_bench: cannot write %s\n", jsonPath);
+        return 2;
+    }
+
+    return 0;
+}
\ No newline at end of file
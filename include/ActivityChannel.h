@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Lock-free channel carrying the most recent activity timestamp from the
+ * input thread to the rest of the application.
+ * Timestamps are monotonic milliseconds; publishers and readers never block.
+ * Events inside the current time quantum are coalesced: they cost one
+ * relaxed load and a counter bump, so 8 kHz mice never contend on the line
+ */
+class ActivityChannel
+{
+public:
+    // Idle timeouts are whole seconds, so a few ms of timestamp lag is invisible
+    static const uint64_t QUANTUM_MS = 16;
+
+    ActivityChannel() = default;
+    ActivityChannel(const ActivityChannel&) = delete;
+    ActivityChannel& operator=(const ActivityChannel&) = delete;
+
+    // Publishing (safe from any thread, timestamps only move forward;
+    // counters assume one publishing thread at a time, as every backend does)
+    // Returns false when the event was coalesced into the current quantum
+    bool Publish(uint64_t timestampMs)
+    {
+        uint64_t current = m_lastActivityMs.load(std::memory_order_relaxed);
+        if (timestampMs < current + QUANTUM_MS)
+        {
+            Bump(m_stats.coalesced);
+            return false;
+        }
+
+        StoreMax(current, timestampMs);
+        Bump(m_stats.processed);
+        RollSecond(timestampMs);
+        return true;
+    }
+
+    // Move the timestamp forward without counting an input event
+    // (activity the application generates itself, such as the idle action)
+    void Advance(uint64_t timestampMs)
+    {
+        StoreMax(m_lastActivityMs.load(std::memory_order_relaxed), timestampMs);
+    }
+
+    // Overwrite the timestamp unconditionally (monitoring start)
+    void Reset(uint64_t timestampMs)
+    {
+        m_lastActivityMs.store(timestampMs, std::memory_order_release);
+    }
+
+    // Reading (safe from any thread)
+    uint64_t GetLastActivity() const { return m_lastActivityMs.load(std::memory_order_acquire); }
+    uint64_t GetEventCount() const { return GetProcessedCount() + GetCoalescedCount(); }
+    uint64_t GetProcessedCount() const { return m_stats.processed.load(std::memory_order_relaxed); }
+    uint64_t GetCoalescedCount() const { return m_stats.coalesced.load(std::memory_order_relaxed); }
+
+    // Rates over the last full second that saw input
+    uint64_t GetProcessedPerSecond() const { return m_stats.processedPerSecond.load(std::memory_order_relaxed); }
+    uint64_t GetCoalescedPerSecond() const { return m_stats.coalescedPerSecond.load(std::memory_order_relaxed); }
+
+private:
+    void StoreMax(uint64_t current, uint64_t timestampMs)
+    {
+        while (timestampMs > current &&
+               !m_lastActivityMs.compare_exchange_weak(current, timestampMs,
+                   std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    // Written by the publishing thread only; load+store avoids a locked
+    // read-modify-write on the per-event path
+    static void Bump(std::atomic<uint64_t>& counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // Runs on the slow path only, at most once per quantum
+    void RollSecond(uint64_t timestampMs)
+    {
+        uint64_t start = m_stats.secondStartMs.load(std::memory_order_relaxed);
+        if (timestampMs - start < 1000)
+            return;
+
+        uint64_t processed = GetProcessedCount();
+        uint64_t coalesced = GetCoalescedCount();
+
+        // A gap longer than a second leaves nothing meaningful to report
+        bool contiguous = timestampMs - start < 2000;
+        m_stats.processedPerSecond.store(contiguous ? processed - m_stats.processedMark.load(std::memory_order_relaxed) : 0,
+                                         std::memory_order_relaxed);
+        m_stats.coalescedPerSecond.store(contiguous ? coalesced - m_stats.coalescedMark.load(std::memory_order_relaxed) : 0,
+                                         std::memory_order_relaxed);
+
+        m_stats.processedMark.store(processed, std::memory_order_relaxed);
+        m_stats.coalescedMark.store(coalesced, std::memory_order_relaxed);
+        m_stats.secondStartMs.store(timestampMs, std::memory_order_relaxed);
+    }
+
+    struct Statistics
+    {
+        std::atomic<uint64_t> processed{ 0 };
+        std::atomic<uint64_t> coalesced{ 0 };
+        std::atomic<uint64_t> processedPerSecond{ 0 };
+        std::atomic<uint64_t> coalescedPerSecond{ 0 };
+        std::atomic<uint64_t> processedMark{ 0 };
+        std::atomic<uint64_t> coalescedMark{ 0 };
+        std::atomic<uint64_t> secondStartMs{ 0 };
+    };
+
+    // Kept on its own cache line so readers do not share it with unrelated state
+    alignas(64) std::atomic<uint64_t> m_lastActivityMs{ 0 };
+
+    // Counters live on the next line so statistics readers never invalidate the timestamp
+    alignas(64) Statistics m_stats;
+};
\ No newline at end of file
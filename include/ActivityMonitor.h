@@ -1,7 +1,26 @@
 #pragma once
 
 #include "common.h"
+#include "ActivityChannel.h"
+#include "Clock.h"
+#include "EventDrainThread.h"
+#include "HookWatchdog.h"
+#include "IdleEngine.h"
+#include "IdlePeriodStatistics.h"
+#include "InputDispatch.h"
+#include "InputEventRing.h"
+#include "InputStatistics.h"
+#include "InputThread.h"
+#include "LatencyHistogram.h"
+#include "OpenMetricsWriter.h"
+#include "StatusPublisher.h"
 #include <functional>
+#include <memory>
+
+class ICursorDriver;
+class IDeadlineTimer;
+class IIdleSource;
+class IInputSource;
 
 /**
  * Manages mouse and keyboard activity monitoring
@@ -10,6 +29,8 @@
 class ActivityMonitor
 {
 public:
+    static const uint64_t METRICS_INTERVAL_MS = 15000;
+
     ActivityMonitor();
     ~ActivityMonitor();
 
@@ -24,37 +45,88 @@ public:
 
     // Configuration
     void SetTimeout(DWORD timeoutSeconds);
-    DWORD GetTimeout() const { return m_timeoutSeconds; }
+    DWORD GetTimeout() const { return m_engine.GetTimeout(); }
     bool ApplyTimeoutSetting();
+    void SetActivityBackend(DWORD backend);
+    DWORD GetActivityBackend() const { return m_activityBackend; }
+
+    // Low-footprint instances skip per-event analytics: no event ring, no drain thread,
+    // so no input figures on the status page and no metrics export
+    void SetLowFootprint(bool lowFootprint) { m_lowFootprint = lowFootprint; }
+
+    // Scheduler statistics
+    ULONGLONG GetWakeupsPerHour() const;
+
+    // Input statistics (events that moved the timestamp vs. coalesced ones)
+    ULONGLONG GetProcessedEventsPerSecond() const;
+    ULONGLONG GetCoalescedEventsPerSecond() const;
+    const InputStatistics& GetInputStatistics() const { return m_inputStatistics; }
+    ULONGLONG GetDroppedEvents() const { return m_eventRing ? m_eventRing->GetDropped() : 0; }
+
+    // Hook health: time spent in each hook procedure (ns) and silently dropped hooks
+    const LatencyHistogram& GetMouseHookLatency() const { return m_mouseHookLatency; }
+    const LatencyHistogram& GetKeyboardHookLatency() const { return m_keyboardHookLatency; }
+    ULONGLONG GetHookIncidents() const { return m_hookWatchdog.GetIncidents(); }
+
+    // Shared-memory status page read by external monitoring agents
+    const StatusPublisher& GetStatusPublisher() const { return m_statusPublisher; }
+
+    // Idle periods between inputs (ms), also exported as a metrics histogram
+    const LatencyHistogram& GetIdlePeriods() const { return m_idlePeriodStatistics.GetPeriods(); }
 
     // Mouse movement
     void MoveMouse();
 
 private:
-    // Hook procedures (static members for Windows API compatibility)
-    static LRESULT CALLBACK MouseHookProc(int nCode, WPARAM wParam, LPARAM lParam);
-    static LRESULT CALLBACK KeyboardHookProc(int nCode, WPARAM wParam, LPARAM lParam);
-
     // Private helpers
-    bool InstallHooks();
-    void UninstallHooks();
+    bool StartActivitySource();
+    void StopActivitySource();
+    bool ReinstallHooks();
     void StartTimer();
     void StopTimer();
+    void PublishState();
+    void PublishInput();
+    void ExportMetrics();
     
     // Member variables
     bool m_isMonitoring = false;
-    DWORD m_timeoutSeconds = DEFAULT_TIMEOUT_SECONDS;
-    DWORD m_lastActivityTime = 0;
-    
-    // Windows hooks
-    HHOOK m_mouseHook = nullptr;
-    HHOOK m_keyboardHook = nullptr;
-    UINT_PTR m_timerId = 0;
-    
-    // Random number generation for mouse movement
-    std::random_device m_randomDevice;
-    std::mt19937 m_randomGenerator;
-    
-    // Static instance pointer for hook procedures
-    static ActivityMonitor* s_instance;
+
+    // Platform services behind the portable idle engine
+    SystemClock m_clock;
+    std::unique_ptr<IDeadlineTimer> m_deadlineTimer;
+    std::unique_ptr<ICursorDriver> m_cursorDriver;
+
+    // Input delivery (sources run on their own thread and publish here)
+    ActivityChannel m_activityChannel;
+    InputDispatch m_inputDispatch;
+    DWORD m_activityBackend = ACTIVITY_BACKEND_HOOKS;
+    std::unique_ptr<IInputSource> m_inputSource;
+    InputThread m_inputThread;
+
+    // Per-event analytics: the input thread fills the ring, the drain thread feeds consumers;
+    // the ring (about 100 KB) is allocated on the first start outside low-footprint mode
+    bool m_lowFootprint = false;
+    std::unique_ptr<InputEventRing> m_eventRing;
+    InputStatistics m_inputStatistics;
+    IdlePeriodStatistics m_idlePeriodStatistics;
+    EventDrainThread m_drainThread;
+
+    // Hookless backend: OS idle clock sampled when the deadline expires
+    std::unique_ptr<IIdleSource> m_idleSource;
+
+    // Hook backend: per-hook latency and a watchdog that cross-checks the idle clock
+    LatencyHistogram m_mouseHookLatency;
+    LatencyHistogram m_keyboardHookLatency;
+    HookWatchdog m_hookWatchdog;
+
+    // Idle state machine: one-shot deadline, re-armed only when it expires
+    IdleEngine m_engine;
+
+    // Status page: state from the UI thread, input rates from the drain thread
+    StatusPublisher m_statusPublisher;
+
+    // OpenMetrics textfile export, written by the drain thread when MMA_METRICS_FILE is set
+    OpenMetricsWriter m_metricsWriter;
+    uint64_t m_nextMetricsExportMs = 0;
+    bool m_metricsWritten = true;
 };
\ No newline at end of file
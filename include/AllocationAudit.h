@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Heap allocation audit for steady-state paths
+ * Builds with MMA_ALLOC_AUDIT replace the global operator new: every
+ * allocation is counted, and while the audit is armed an allocation inside
+ * an MMA_NO_ALLOC_SCOPE is a violation. Violations are counted per call
+ * site, logged, and assert in debug builds, so a hook callback, timer tick
+ * or CheckActivity that starts allocating stops at the offending frame.
+ * Recording itself never allocates: call sites live in a fixed table
+ * Without MMA_ALLOC_AUDIT the macros compile to nothing and operator new is
+ * the standard one; only C++ allocations are seen, not malloc or HeapAlloc
+ */
+class AllocationAudit
+{
+public:
+    static const size_t MAX_SITES = 64;
+
+    struct Site
+    {
+        const void* caller; // return address inside the allocating function
+        const char* scope;  // innermost no-alloc scope at the first violation
+        uint64_t count;
+    };
+
+    // Violations are only reported between Arm and Disarm (any thread)
+    static void Arm() { s_armed.store(true, std::memory_order_release); }
+    static void Disarm() { s_armed.store(false, std::memory_order_release); }
+    static bool IsArmed() { return s_armed.load(std::memory_order_acquire); }
+
+    // Debug builds assert on a violation unless this is turned off (self-tests)
+    static void SetAssertOnViolation(bool enabled) { s_assertOnViolation.store(enabled, std::memory_order_relaxed); }
+
+    // Statistics
+    static uint64_t GetAllocations() { return s_allocations.load(std::memory_order_relaxed); }
+    static uint64_t GetViolations() { return s_violations.load(std::memory_order_relaxed); }
+    static size_t GetSites(Site* sites, size_t maxSites);
+    static void Reset();
+
+    // Called by the replaced operator new
+    static void RecordAllocation(const void* caller)
+    {
+        s_allocations.fetch_add(1, std::memory_order_relaxed);
+        if (t_scope && IsArmed())
+            RecordViolation(caller);
+    }
+
+    // Scope tracking (current thread); returns the scope being replaced
+    static const char* EnterScope(const char* name)
+    {
+        const char* previous = t_scope;
+        t_scope = name;
+        return previous;
+    }
+
+    static void LeaveScope(const char* previous) { t_scope = previous; }
+
+private:
+    struct SiteSlot
+    {
+        std::atomic<const void*> caller{ nullptr };
+        std::atomic<const char*> scope{ nullptr };
+        std::atomic<uint64_t> count{ 0 };
+    };
+
+    // Private helpers
+    static void RecordViolation(const void* caller);
+
+    // Name of the innermost no-alloc scope, nullptr outside or in an allowed scope
+    static thread_local const char* t_scope;
+
+    static std::atomic<bool> s_armed;
+    static std::atomic<bool> s_assertOnViolation;
+    static std::atomic<uint64_t> s_allocations;
+    static std::atomic<uint64_t> s_violations;
+    static SiteSlot s_sites[MAX_SITES];
+};
+
+/**
+ * Marks the current thread's code as steady state for its lifetime;
+ * a null name re-allows allocation for a nested cold path
+ */
+class NoAllocScope
+{
+public:
+    explicit NoAllocScope(const char* name) : m_previous(AllocationAudit::EnterScope(name)) {}
+    ~NoAllocScope() { AllocationAudit::LeaveScope(m_previous); }
+
+    NoAllocScope(const NoAllocScope&) = delete;
+    NoAllocScope& operator=(const NoAllocScope&) = delete;
+
+private:
+    const char* m_previous;
+};
+
+#ifdef MMA_ALLOC_AUDIT
+#define MMA_ALLOC_AUDIT_CONCAT_INNER(a, b) a##b
+#define MMA_ALLOC_AUDIT_CONCAT(a, b) MMA_ALLOC_AUDIT_CONCAT_INNER(a, b)
+#define MMA_NO_ALLOC_SCOPE(name) NoAllocScope MMA_ALLOC_AUDIT_CONCAT(mmaNoAllocScope, __LINE__)(name)
+#define MMA_ALLOC_ALLOWED_SCOPE() NoAllocScope MMA_ALLOC_AUDIT_CONCAT(mmaNoAllocScope, __LINE__)(nullptr)
+#define MMA_ALLOC_AUDIT_ARM() AllocationAudit::Arm()
+#define MMA_ALLOC_AUDIT_DISARM() AllocationAudit::Disarm()
+#else
+#define MMA_NO_ALLOC_SCOPE(name) ((void)0)
+#define MMA_ALLOC_ALLOWED_SCOPE() ((void)0)
+#define MMA_ALLOC_AUDIT_ARM() ((void)0)
+#define MMA_ALLOC_AUDIT_DISARM() ((void)0)
+#endif
\ No newline at end of file
@@ -10,6 +10,10 @@ class SystemTray;
 class SettingsManager;
 class HotkeyManager;
 class DialogManager;
+class RotatingFileSink;
+class ControlServer;
+struct ControlRequest;
+struct ControlResponse;
 
 /**
  * Main application manager class that coordinates all subsystems
@@ -39,12 +43,27 @@ public:
     HWND GetMainDialog() const { return m_hMainDlg; }
     void SetMainDialog(HWND hDlg) { m_hMainDlg = hDlg; }
 
+    // Owner of the tray icon, hotkey and timers: the hidden window when started hidden, else the dialog
+    HWND GetMessageWindow() const;
+
+    // Builds the main dialog on first show when started hidden
+    HWND EnsureMainDialog();
+
+    // Low-footprint mode: drops the dialog and tray menu after hiding and trims the working set
+    void ReleaseHiddenResources();
+
     // Message handling
     bool HandleMessage(MSG& msg);
     
     // Hotkey handling
     void HandleHotkeyToggle();
 
+    // Hot reload (WM_SETTINGS_CHANGED): re-applies only the settings changed outside the process
+    void ApplyExternalSettings();
+
+    // Control channel (WM_CONTROL_REQUEST): runs a command from mma_ctl or a second launch on the UI thread
+    void HandleControlRequest(LPARAM lParam);
+
     ~ApplicationManager() = default;
 private:
     ApplicationManager() = default;
@@ -55,6 +74,11 @@ private:
     bool InitializeSubsystems();
     void LoadGlobalStrings();
     bool CreateMainDialog();
+    void StartLogging();
+    void LogStartupSummary();
+    void StartControlServer();
+    void StopControlServer();
+    void ExecuteControlCommand(const ControlRequest& request, ControlResponse& response);
 
     static std::unique_ptr<ApplicationManager> s_instance;
 
@@ -70,4 +94,7 @@ private:
     std::unique_ptr<SystemTray> m_systemTray;
     std::unique_ptr<HotkeyManager> m_hotkeyManager;
     std::unique_ptr<DialogManager> m_dialogManager;
+    std::unique_ptr<RotatingFileSink> m_logSink;
+    std::unique_ptr<ControlServer> m_controlServer;
+    HANDLE m_controlAbandon = nullptr;  // set on shutdown so a waiting control thread gives up at once
 };
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "MonotonicClock.h"
+#include <cstdint>
+
+/**
+ * Source of monotonic milliseconds for the idle engine
+ * Lets the core run against the real clock or a manually driven one
+ */
+class IClock
+{
+public:
+    virtual ~IClock() = default;
+
+    virtual uint64_t NowMs() const = 0;
+};
+
+/**
+ * Real clock: MonotonicNowMs()
+ */
+class SystemClock : public IClock
+{
+public:
+    uint64_t NowMs() const override { return MonotonicNowMs(); }
+};
+
+/**
+ * Headless clock that only moves when told to (benchmarks, replay)
+ */
+class ManualClock : public IClock
+{
+public:
+    explicit ManualClock(uint64_t startMs = 0) : m_nowMs(startMs) {}
+
+    uint64_t NowMs() const override { return m_nowMs; }
+    void Set(uint64_t nowMs) { m_nowMs = nowMs; }
+    void Advance(uint64_t deltaMs) { m_nowMs += deltaMs; }
+
+private:
+    uint64_t m_nowMs;
+};
\ No newline at end of file
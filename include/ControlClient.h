@@ -0,0 +1,46 @@
+#pragma once
+
+#include "ControlProtocol.h"
+#include <cstdint>
+
+/**
+ * Client side of the control channel (mma_ctl, a second MMA launch)
+ * Connect waits for the endpoint to appear, so a command sent while the
+ * instance is still starting is delivered once it listens, and on Linux
+ * refuses a server running as another user. One connection carries any
+ * number of Transact calls
+ */
+class ControlClient
+{
+public:
+    static const uint32_t DEFAULT_TIMEOUT_MS = 2000;
+
+    ControlClient() = default;
+    ~ControlClient();
+
+    ControlClient(const ControlClient&) = delete;
+    ControlClient& operator=(const ControlClient&) = delete;
+
+    // False when nothing serves the endpoint within timeoutMs or its server is another user's;
+    // nullptr is the user's default
+    bool Connect(const char* endpoint = nullptr, uint32_t timeoutMs = DEFAULT_TIMEOUT_MS);
+    void Close();
+    bool IsConnected() const;
+
+    // One request, one response; false on a broken connection or a reply to another request
+    bool Transact(const ControlRequest& request, ControlResponse& response);
+
+    // Sends a raw frame of any size (protocol checks); returns the reply length, -1 on failure
+    int TransactRaw(const void* request, size_t size, ControlResponse& response);
+
+    // Process serving the endpoint, 0 when unknown
+    uint32_t GetServerProcessId() const;
+
+private:
+    // Member variables
+#ifdef _WIN32
+    void* m_pipe = nullptr;
+#else
+    int m_fd = -1;
+#endif
+};
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+// Commands a running instance accepts on its control channel
+enum class ControlCommand : uint8_t
+{
+    Status,
+    Start,
+    Stop,
+    SetTimeout, // argument: seconds
+    Show        // bring up the main dialog (Windows app only)
+};
+
+const uint32_t CONTROL_COMMAND_COUNT = 5;
+
+enum class ControlResult : uint8_t
+{
+    Ok,
+    BadRequest,      // wrong magic, version or command
+    InvalidArgument,
+    Unsupported,     // the serving process has no such thing (mmad has no dialog)
+    Failed           // the server could not get the command executed in time
+};
+
+/**
+ * One request frame; the channel preserves message boundaries, so a frame
+ * of any other size is rejected
+ */
+struct ControlRequest
+{
+    uint32_t magic;
+    uint16_t version;
+    uint8_t command;     // ControlCommand
+    uint8_t reserved;
+    uint32_t argument;
+    uint32_t sequence;   // echoed in the response
+};
+
+/**
+ * Reply to every well-formed request: the result and the state after it
+ */
+struct ControlResponse
+{
+    uint32_t magic;
+    uint16_t version;
+    uint8_t result;      // ControlResult
+    uint8_t monitoring;
+    uint32_t sequence;
+    uint32_t timeoutSeconds;
+    uint32_t backend;    // ACTIVITY_BACKEND_*
+    uint32_t processId;
+};
+
+static_assert(sizeof(ControlRequest) == 16, "ControlRequest is a wire format");
+static_assert(sizeof(ControlResponse) == 24, "ControlResponse is a wire format");
+
+/**
+ * Framing helpers and endpoint naming for the control channel
+ * The endpoint is per user: a named pipe in the session on Windows, an
+ * abstract Unix socket carrying the uid on Linux
+ */
+class ControlProtocol
+{
+public:
+    static const uint32_t MAGIC = 0x43414D4D; // "MMAC" in memory order
+    static const uint16_t VERSION = 1;
+    static const size_t MAX_ENDPOINT_LENGTH = 64;
+
+    static ControlRequest MakeRequest(ControlCommand command, uint32_t argument = 0, uint32_t sequence = 0);
+    static ControlResponse MakeResponse(const ControlRequest& request, ControlResult result);
+    static bool IsValid(const ControlRequest& request);
+    static bool Matches(const ControlRequest& request, const ControlResponse& response);
+
+    // Command line names: "status", "start", "stop", "set-timeout", "show"
+    static bool ParseCommand(const char* name, ControlCommand& command);
+    static const char* GetCommandName(ControlCommand command);
+    static const char* GetResultName(ControlResult result);
+
+    // Default endpoint of the current user; buffer holds MAX_ENDPOINT_LENGTH characters
+    static void GetDefaultEndpoint(char* buffer, size_t size);
+
+    // OS address of an endpoint, nullptr meaning the default one
+#ifdef _WIN32
+    static void GetPipePath(const char* endpoint, wchar_t* path, size_t size);
+#else
+    static socklen_t GetSocketAddress(const char* endpoint, sockaddr_un& address);
+#endif
+};
\ No newline at end of file
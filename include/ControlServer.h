@@ -0,0 +1,64 @@
+#pragma once
+
+#include "ControlProtocol.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+/**
+ * Serves the local control channel on its own thread
+ * Windows listens on a message-mode named pipe (local clients in the same
+ * session only), Linux on an abstract SOCK_SEQPACKET socket (peers with the
+ * same uid only). Clients are served one at a time: each may send any
+ * number of requests and is dropped after IDLE_TIMEOUT_MS of silence, so a
+ * stuck client cannot hold the channel. The handler runs on the server
+ * thread with a response already carrying Ok, the sequence and the process
+ * id; it fills in the state and changes the result on failure
+ */
+class ControlServer
+{
+public:
+    typedef std::function<void(const ControlRequest& request, ControlResponse& response)> RequestHandler;
+
+    static const uint32_t IDLE_TIMEOUT_MS = 1000;
+
+    ControlServer() = default;
+    ~ControlServer();
+
+    ControlServer(const ControlServer&) = delete;
+    ControlServer& operator=(const ControlServer&) = delete;
+
+    // False when the endpoint is already served (another instance) or cannot be created
+    bool Start(const RequestHandler& handler, const char* endpoint = nullptr);
+    void Stop();
+    bool IsRunning() const { return m_thread.joinable(); }
+
+    // Statistics
+    uint64_t GetConnections() const { return m_connections.load(std::memory_order_relaxed); }
+    uint64_t GetRequests() const { return m_requests.load(std::memory_order_relaxed); }
+    uint64_t GetRejected() const { return m_rejected.load(std::memory_order_relaxed); }
+
+private:
+    // Private helpers
+    void Run();
+    bool ServeConnection();
+    void Answer(const ControlRequest& request, ControlResponse& response);
+
+    // Member variables
+    RequestHandler m_handler;
+    std::thread m_thread;
+    uint32_t m_processId = 0;
+    std::atomic<uint64_t> m_connections{ 0 };
+    std::atomic<uint64_t> m_requests{ 0 };
+    std::atomic<uint64_t> m_rejected{ 0 };
+#ifdef _WIN32
+    void* m_pipe = nullptr;
+    void* m_stopEvent = nullptr;
+    void* m_ioEvent = nullptr;
+#else
+    int m_listenFd = -1;
+    int m_connectionFd = -1;
+    int m_stopFd = -1;
+#endif
+};
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+// Platform-neutral constants shared by the Windows app and the portable core
+
+// Inactivity timeout limits
+const uint32_t DEFAULT_TIMEOUT_SECONDS = 5;
+const uint32_t MAX_TIMEOUT_SECONDS = 3600;
+
+// Activity detection backends
+const uint32_t ACTIVITY_BACKEND_HOOKS = 0;       // WH_MOUSE_LL / WH_KEYBOARD_LL on the input thread
+const uint32_t ACTIVITY_BACKEND_IDLE_CLOCK = 1;  // GetLastInputInfo sampled at the deadline, no hooks
+const uint32_t ACTIVITY_BACKEND_RAW_INPUT = 2;   // WM_INPUT with RIDEV_INPUTSINK on the input thread
+const uint32_t ACTIVITY_BACKEND_COUNT = 3;
+
+// Reported by mmad, which reads evdev devices itself; not a setting value
+const uint32_t ACTIVITY_BACKEND_EVDEV = 16;
+
+// Runtime log level (LogLevel values: 0 debug, 1 info, 2 warning, 3 error, 4 off)
+const uint32_t DEFAULT_LOG_LEVEL = 1;
+const uint32_t LOG_LEVEL_OFF = 4;
+
+// Private bytes one instance may use before the memory self-check warns
+const uint32_t MEMORY_BUDGET_KB = 4096;
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+
+/**
+ * Moves the pointer on behalf of the idle action
+ * Implementations may be called from any thread
+ */
+class ICursorDriver
+{
+public:
+    virtual ~ICursorDriver() = default;
+
+    // Area the cursor may be moved across, in desktop coordinates
+    virtual bool GetBounds(int& left, int& top, int& width, int& height) = 0;
+
+    virtual bool MoveTo(int x, int y) = 0;
+};
\ No newline at end of file
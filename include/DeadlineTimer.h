@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * One-shot timer armed at an absolute MonotonicNowMs() deadline
+ * Arming again replaces the pending deadline; expiry is reported by the
+ * backend's owner calling IdleScheduler::OnTimer
+ */
+class IDeadlineTimer
+{
+public:
+    virtual ~IDeadlineTimer() = default;
+
+    virtual bool Arm(uint64_t deadlineMs) = 0;
+    virtual void Disarm() = 0;
+};
\ No newline at end of file
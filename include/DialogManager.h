@@ -15,8 +15,13 @@ public:
     HWND CreateMainDialog(HINSTANCE hInstance);
     void DestroyMainDialog();
 
+    // Hidden tool window for tray-only startup; handles the main dialog's tray, hotkey and timer messages
+    HWND CreateMessageWindow(HINSTANCE hInstance);
+    void DestroyMessageWindow();
+
     // Dialog procedures (static for Windows API compatibility)
     static INT_PTR CALLBACK MainDlgProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lParam);
+    static LRESULT CALLBACK MessageWndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
     static INT_PTR CALLBACK AboutDlgProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lParam);
     static INT_PTR CALLBACK HotkeyDlgProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lParam);
 
@@ -26,6 +31,7 @@ public:
 
     // Dialog state
     HWND GetMainDialog() const { return m_mainDialog; }
+    HWND GetMessageWindow() const { return m_messageWindow; }
 
 private:
     // Message handlers for main dialog
@@ -45,9 +51,13 @@ private:
     void LoadSettingsToUI(HWND hDlg);
     void SaveUIToSettings(HWND hDlg);
     void CenterDialogOnScreen(HWND hDlg);
+#ifdef MMA_ENABLE_TRACE
+    void SaveTrace(HWND hDlg);
+#endif
 
     // Member variables
     HWND m_mainDialog = nullptr;
+    HWND m_messageWindow = nullptr;
     
     // Static instance pointer for dialog procedures
     static DialogManager* s_instance;
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "InputSource.h"
+#include <cstddef>
+#include <cstdint>
+
+struct input_event;
+struct InputEvent;
+
+/**
+ * Linux input source reading evdev nodes (/dev/input/event*)
+ * One epoll loop serves every device, inotify on the directory picks up
+ * hotplugged nodes, and input_event records are read in batches so the
+ * syscall count stays far below the event count
+ */
+class EvdevInputSource : public IInputSource
+{
+public:
+    // directory is scanned for event* nodes; tests may point it at a folder of FIFOs
+    explicit EvdevInputSource(const char* directory = "/dev/input");
+    ~EvdevInputSource() override;
+
+    EvdevInputSource(const EvdevInputSource&) = delete;
+    EvdevInputSource& operator=(const EvdevInputSource&) = delete;
+
+    // IInputSource
+    bool Open() override;
+    void Pump(InputDispatch& dispatch) override;
+    void Wake() override;
+    void Close() override;
+
+    // Statistics
+    size_t GetDeviceCount() const { return m_deviceCount; }
+    uint64_t GetReadCalls() const { return m_readCalls; }
+    uint64_t GetEventsRead() const { return m_eventsRead; }
+
+    // Translate one kernel record; false for records that are not user activity
+    static bool Decode(const input_event& record, uint64_t device, uint64_t timestampMs, InputEvent& event);
+
+    static const size_t MAX_DEVICES = 32;
+    static const size_t READ_BATCH = 64;
+
+private:
+    struct Device
+    {
+        int fd;
+        uint64_t id;
+    };
+
+    // Private helpers
+    void ScanDirectory();
+    void OpenDevice(const char* name);
+    void CloseDevice(size_t index);
+    void ReadDevice(InputDispatch& dispatch, size_t index);
+    void ReadHotplug();
+
+    // Member variables
+    char m_directory[256];
+    int m_epollFd = -1;
+    int m_wakeFd = -1;
+    int m_inotifyFd = -1;
+    Device m_devices[MAX_DEVICES];
+    size_t m_deviceCount = 0;
+    uint64_t m_readCalls = 0;
+    uint64_t m_eventsRead = 0;
+};
\ No newline at end of file
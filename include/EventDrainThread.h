@@ -0,0 +1,82 @@
+#pragma once
+
+#include "InputEventRing.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class IInputConsumer;
+
+/**
+ * Background thread that drains the input event ring in batches
+ * While events flow it drains every interval; once a pass finds the ring
+ * empty it sleeps until the input thread pushes again, so an idle session
+ * costs no wakeups beyond the idle timeout. The input thread never waits:
+ * NotifyPush only signals when the drain thread sleeps or a burst passes
+ * WAKE_THRESHOLD, the way Logger::Enqueue wakes the logger thread
+ */
+class EventDrainThread
+{
+public:
+    static const size_t BATCH_SIZE = 256;
+    static const size_t WAKE_THRESHOLD = InputEventRing::CAPACITY / 2;
+    static const uint32_t DEFAULT_INTERVAL_MS = 250;
+    static const uint32_t DEFAULT_IDLE_TIMEOUT_MS = 60000;
+
+    EventDrainThread() = default;
+    ~EventDrainThread();
+
+    EventDrainThread(const EventDrainThread&) = delete;
+    EventDrainThread& operator=(const EventDrainThread&) = delete;
+
+    // Consumers must be added before Start
+    void AddConsumer(IInputConsumer* consumer) { m_consumers.push_back(consumer); }
+
+    // Runs on the drain thread after every pass, with or without events; set before Start
+    void SetPassCallback(const std::function<void()>& callback) { m_passCallback = callback; }
+
+    // Thread control; the idle timeout bounds a sleep on an empty ring (a
+    // signal that raced the drain thread falling asleep is picked up then)
+    bool Start(InputEventRing* ring, uint32_t intervalMs = DEFAULT_INTERVAL_MS,
+               uint32_t idleTimeoutMs = DEFAULT_IDLE_TIMEOUT_MS);
+    void Stop();
+    bool IsRunning() const { return m_thread.joinable(); }
+
+    // Input thread, after every push into ring (also before Start)
+    void NotifyPush(const InputEventRing& ring)
+    {
+        if (m_wakePending.load(std::memory_order_relaxed))
+            return;
+        if (!m_sleeping.load(std::memory_order_relaxed) && ring.GetSize() < WAKE_THRESHOLD)
+            return;
+        if (!m_wakePending.exchange(true, std::memory_order_relaxed))
+            m_wake.notify_one();
+    }
+
+    // Statistics (any thread)
+    uint64_t GetPasses() const { return m_passes.load(std::memory_order_relaxed); }
+
+private:
+    // Private helpers
+    void Run();
+    size_t Drain();
+
+    // Member variables
+    InputEventRing* m_ring = nullptr;
+    uint32_t m_intervalMs = DEFAULT_INTERVAL_MS;
+    uint32_t m_idleTimeoutMs = DEFAULT_IDLE_TIMEOUT_MS;
+    std::vector<IInputConsumer*> m_consumers;
+    std::function<void()> m_passCallback;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stopRequested = false;
+    std::atomic<bool> m_sleeping{ false };
+    std::atomic<bool> m_wakePending{ false };
+    std::atomic<uint64_t> m_passes{ 0 };
+};
\ No newline at end of file
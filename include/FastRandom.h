@@ -0,0 +1,62 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * Small non-cryptographic random generator (PCG32, 16 bytes of state)
+ * Enough for picking a cursor target; replaces std::mt19937 and
+ * std::random_device, which together cost about 10 KB per instance.
+ * The seed mixes a time stamp and the object address through SplitMix64
+ */
+class FastRandom
+{
+public:
+    FastRandom() { Seed(DefaultSeed()); }
+    explicit FastRandom(uint64_t seed) { Seed(seed); }
+
+    void Seed(uint64_t seed)
+    {
+        m_state = 0;
+        m_increment = (SplitMix64(seed) << 1) | 1;
+        Next();
+        m_state += SplitMix64(seed + 1);
+        Next();
+    }
+
+    uint32_t Next()
+    {
+        uint64_t old = m_state;
+        m_state = old * 6364136223846793005ULL + m_increment;
+        uint32_t shifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        uint32_t rotation = static_cast<uint32_t>(old >> 59);
+        return (shifted >> rotation) | (shifted << ((0u - rotation) & 31));
+    }
+
+    // Uniform in [low, high] by multiply-shift; the bias is below 2^-32 * range
+    int NextInRange(int low, int high)
+    {
+        uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(high) - low) + 1;
+        return static_cast<int>(low + static_cast<int64_t>((static_cast<uint64_t>(Next()) * range) >> 32));
+    }
+
+private:
+    // Private helpers
+    static uint64_t SplitMix64(uint64_t value)
+    {
+        value += 0x9E3779B97F4A7C15ULL;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+
+    uint64_t DefaultSeed() const
+    {
+        uint64_t now = static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        return now ^ (static_cast<uint64_t>(reinterpret_cast<uintptr_t>(this)) << 16);
+    }
+
+    // Member variables
+    uint64_t m_state = 0;
+    uint64_t m_increment = 0;
+};
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "SettingsStore.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Settings store in a small INI file for portable and Linux deployments
+ * One "Name=value" line per setting under an [MMA] section. Open reads the
+ * whole file with one read; Close writes it back only when a value changed,
+ * through a temporary file that is flushed to disk and renamed over the
+ * original, so a crash leaves the old or the new file and never a torn one.
+ * Values a partial save does not touch are kept; comments are not. Paths
+ * are UTF-8
+ */
+class FileSettingsStore : public ISettingsStore
+{
+public:
+    static const char* const FILE_NAME;
+
+    explicit FileSettingsStore(const std::string& path);
+
+    // ISettingsStore
+    bool Open(bool forWrite) override;
+    bool Close() override;
+    bool ReadUInt32(const char* name, uint32_t& value) override;
+    bool WriteUInt32(const char* name, uint32_t value) override;
+
+    const std::string& GetPath() const { return m_path; }
+
+    // $XDG_CONFIG_HOME/mma/mma.ini (default ~/.config) on Linux, %APPDATA%\MMA\mma.ini on Windows;
+    // empty when neither variable is set
+    static std::string GetDefaultPath();
+
+    // File helpers shared with the snapshot store
+    static bool FileExists(const std::string& path);
+    static bool ReadFile(const std::string& path, std::string& contents);
+    static bool WriteFileAtomic(const std::string& path, const void* data, size_t size);
+
+private:
+    // Private helpers
+    void Parse(const std::string& text);
+    std::string Serialize() const;
+
+    // Member variables
+    std::string m_path;
+    std::vector<std::pair<std::string, uint32_t>> m_values; // file order, a dozen entries at most
+    bool m_open = false;
+    bool m_modified = false;
+};
\ No newline at end of file
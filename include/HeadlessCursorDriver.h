@@ -0,0 +1,45 @@
+#pragma once
+
+#include "CursorDriver.h"
+#include <cstdint>
+
+/**
+ * Cursor driver with a virtual screen and no display
+ * Records the requested positions so headless runs can observe the idle action
+ */
+class HeadlessCursorDriver : public ICursorDriver
+{
+public:
+    HeadlessCursorDriver(int width = 1920, int height = 1080) : m_width(width), m_height(height) {}
+
+    // ICursorDriver
+    bool GetBounds(int& left, int& top, int& width, int& height) override
+    {
+        left = 0;
+        top = 0;
+        width = m_width;
+        height = m_height;
+        return true;
+    }
+
+    bool MoveTo(int x, int y) override
+    {
+        m_x = x;
+        m_y = y;
+        ++m_moves;
+        return true;
+    }
+
+    // Observation
+    int GetX() const { return m_x; }
+    int GetY() const { return m_y; }
+    uint64_t GetMoveCount() const { return m_moves; }
+
+private:
+    // Member variables
+    int m_width;
+    int m_height;
+    int m_x = 0;
+    int m_y = 0;
+    uint64_t m_moves = 0;
+};
\ No newline at end of file
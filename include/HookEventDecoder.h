@@ -0,0 +1,47 @@
+#pragma once
+
+#include "InputEvent.h"
+#include <cstdint>
+
+/**
+ * Translates low-level hook records into InputEvents
+ * The layouts mirror MSLLHOOKSTRUCT and KBDLLHOOKSTRUCT so the per-event
+ * work of the hook procedures can be measured against RawInputDecoder on
+ * any platform; HookInputSource checks at compile time that they match
+ */
+class HookEventDecoder
+{
+public:
+    // MSLLHOOKSTRUCT
+    struct MouseInfo
+    {
+        int32_t x;
+        int32_t y;
+        uint32_t mouseData;
+        uint32_t flags;
+        uint32_t time;
+        uintptr_t extraInfo;
+    };
+
+    // KBDLLHOOKSTRUCT
+    struct KeyboardInfo
+    {
+        uint32_t vkCode;
+        uint32_t scanCode;
+        uint32_t flags;
+        uint32_t time;
+        uintptr_t extraInfo;
+    };
+
+    // WM_* hook messages and LLKHF_* values
+    static const uint32_t MESSAGE_MOUSEMOVE = 0x0200;
+    static const uint32_t MESSAGE_MOUSEWHEEL = 0x020A;
+    static const uint32_t MESSAGE_MOUSEHWHEEL = 0x020E;
+    static const uint32_t MESSAGE_KEYUP = 0x0101;
+    static const uint32_t MESSAGE_SYSKEYUP = 0x0105;
+    static const uint32_t KEY_EXTENDED = 0x0001;
+
+    // Low-level hooks cannot tell devices apart, so device stays 0
+    static void DecodeMouse(uintptr_t message, const MouseInfo& info, uint64_t timestampMs, InputEvent& event);
+    static void DecodeKeyboard(uintptr_t message, const KeyboardInfo& info, uint64_t timestampMs, InputEvent& event);
+};
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "common.h"
+#include "InputSource.h"
+
+class LatencyHistogram;
+
+/**
+ * Input source backed by WH_MOUSE_LL / WH_KEYBOARD_LL hooks
+ * Hooks are installed on the input thread, which runs its own minimal
+ * message pump at high priority so UI stalls never delay system input.
+ * The time spent inside each hook procedure is recorded in the optional
+ * histograms, which outlive the source across hook reinstalls
+ */
+class HookInputSource : public IInputSource
+{
+public:
+    HookInputSource(LatencyHistogram* mouseLatency = nullptr, LatencyHistogram* keyboardLatency = nullptr);
+    ~HookInputSource() override;
+
+    // IInputSource
+    bool Open() override;
+    void Pump(InputDispatch& dispatch) override;
+    void Wake() override;
+    void Close() override;
+
+private:
+    // Hook procedures (static members for Windows API compatibility)
+    static LRESULT CALLBACK MouseHookProc(int nCode, WPARAM wParam, LPARAM lParam);
+    static LRESULT CALLBACK KeyboardHookProc(int nCode, WPARAM wParam, LPARAM lParam);
+
+    // Private helpers
+    void RecordLatency(LatencyHistogram* histogram, const LARGE_INTEGER& start) const;
+
+    // Member variables
+    HHOOK m_mouseHook = nullptr;
+    HHOOK m_keyboardHook = nullptr;
+    DWORD m_threadId = 0;
+    InputDispatch* m_dispatch = nullptr;
+    LatencyHistogram* m_mouseLatency;
+    LatencyHistogram* m_keyboardLatency;
+    LONGLONG m_counterFrequency = 0;
+
+    // Static instance pointer for hook procedures
+    static HookInputSource* s_instance;
+};
\ No newline at end of file
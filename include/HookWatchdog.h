@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+class ActivityChannel;
+class IIdleSource;
+
+/**
+ * Detects input hooks the system removed without notice
+ * Windows silently unhooks WH_*_LL hooks that exceed LowLevelHooksTimeout;
+ * input then stops reaching the activity channel while the OS idle clock
+ * keeps moving. Check runs when the idle deadline expires and compares the
+ * two: input the hooks missed is adopted as activity, the reinstall action
+ * runs and the incident is counted. UI thread only
+ */
+class HookWatchdog
+{
+public:
+    // Returns false when the hooks could not be reinstalled
+    typedef std::function<bool()> ReinstallAction;
+
+    enum class Verdict
+    {
+        Healthy,
+        Unavailable, // the idle clock could not be read
+        HookLost
+    };
+
+    // Covers hook dispatch lag and the idle clock's tick granularity
+    static const uint64_t DEFAULT_TOLERANCE_MS = 1000;
+
+    HookWatchdog(IIdleSource& idleSource, ActivityChannel& channel, uint64_t toleranceMs = DEFAULT_TOLERANCE_MS);
+
+    HookWatchdog(const HookWatchdog&) = delete;
+    HookWatchdog& operator=(const HookWatchdog&) = delete;
+
+    void SetReinstallAction(ReinstallAction action) { m_reinstall = std::move(action); }
+
+    // Call before the idle engine evaluates the deadline
+    Verdict Check();
+
+    // Statistics
+    uint64_t GetChecks() const { return m_checks; }
+    uint64_t GetIncidents() const { return m_incidents; }
+    uint64_t GetReinstallFailures() const { return m_reinstallFailures; }
+    uint64_t GetLastIncidentMs() const { return m_lastIncidentMs; }
+
+private:
+    // Member variables
+    IIdleSource& m_idleSource;
+    ActivityChannel& m_channel;
+    uint64_t m_toleranceMs;
+    ReinstallAction m_reinstall;
+    uint64_t m_checks = 0;
+    uint64_t m_incidents = 0;
+    uint64_t m_reinstallFailures = 0;
+    uint64_t m_lastIncidentMs = 0;
+};
\ No newline at end of file
@@ -35,7 +35,7 @@ private:
 
     // Member variables
     bool m_hotkeyRegistered = false;
-    UINT m_modifiers = MOD_CONTROL | MOD_SHIFT;
+    UINT m_modifiers = HOTKEY_MOD_CONTROL | HOTKEY_MOD_SHIFT;
     UINT m_virtualKey = 'M';
     HWND m_targetWindow = nullptr;
     
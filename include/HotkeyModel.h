@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+// Hotkey modifier flags; identical to the Win32 MOD_* values so they can be
+// passed straight to RegisterHotKey
+const uint32_t HOTKEY_MOD_ALT = 0x0001;
+const uint32_t HOTKEY_MOD_CONTROL = 0x0002;
+const uint32_t HOTKEY_MOD_SHIFT = 0x0004;
+const uint32_t HOTKEY_MOD_WIN = 0x0008;
+
+// Key mapping structure for hotkey selection (virtual-key codes)
+struct KeyMapping
+{
+    uint32_t vk;
+    const wchar_t* name;
+};
+
+// Keys offered for the hotkey, in display order
+extern const KeyMapping g_keyMappings[];
+extern const int g_keyMappingsCount;
+
+/**
+ * Display names for hotkey combinations
+ * Results point into static buffers that the next call overwrites
+ */
+class HotkeyModel
+{
+public:
+    static const wchar_t* GetKeyName(uint32_t vk);
+    static const wchar_t* GetModifierString(uint32_t modifiers);
+    static wchar_t* GetHotkeyDisplayString(uint32_t modifiers, uint32_t vk);
+};
\ No newline at end of file
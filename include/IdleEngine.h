@@ -0,0 +1,56 @@
+#pragma once
+
+#include "FastRandom.h"
+#include "IdleScheduler.h"
+#include <cstdint>
+
+class ActivityChannel;
+class ICursorDriver;
+class IClock;
+class IDeadlineTimer;
+
+/**
+ * Platform-neutral idle state machine
+ * Combines the activity channel, the tickless scheduler and the cursor
+ * driver: when the armed deadline expires, OnDeadline either re-arms for
+ * newer activity or moves the cursor to a random point and restarts the
+ * countdown. Everything platform specific sits behind the interfaces
+ */
+class IdleEngine
+{
+public:
+    IdleEngine(IClock& clock, IDeadlineTimer& timer, ICursorDriver& cursor, ActivityChannel& channel);
+
+    // Scheduling control
+    void Start();
+    void Stop();
+    bool IsRunning() const { return m_scheduler.IsRunning(); }
+
+    // Configuration; restarts the countdown from now when running
+    void SetTimeout(uint32_t timeoutSeconds);
+    uint32_t GetTimeout() const { return m_scheduler.GetTimeout(); }
+
+    // Activity the application generates itself (idle action, settings change)
+    void NoteActivity();
+
+    // Called when the armed deadline expires; returns true when the idle action ran
+    bool OnDeadline();
+
+    // Idle action: move the cursor to a random point inside the driver bounds
+    void MoveCursor();
+    bool PickCursorTarget(int& x, int& y);
+
+    // Statistics
+    const IdleScheduler& GetScheduler() const { return m_scheduler; }
+    uint64_t GetWakeupsPerHour() const;
+
+private:
+    // Member variables
+    IClock& m_clock;
+    ICursorDriver& m_cursor;
+    ActivityChannel& m_channel;
+    IdleScheduler m_scheduler;
+
+    // Random number generation for mouse movement
+    FastRandom m_random;
+};
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "InputConsumer.h"
+#include "InputEvent.h"
+#include "LatencyHistogram.h"
+#include <cstdint>
+
+/**
+ * Consumer that records how long the user stayed idle between inputs
+ * A gap of at least MIN_IDLE_MS between two consecutive events counts as
+ * one idle period, recorded in milliseconds. Written by the drain thread
+ * only; the histogram may be read from any thread
+ */
+class IdlePeriodStatistics : public IInputConsumer
+{
+public:
+    // Shorter gaps are typing and pointing pauses, not idleness
+    static const uint64_t MIN_IDLE_MS = 1000;
+
+    IdlePeriodStatistics() = default;
+    IdlePeriodStatistics(const IdlePeriodStatistics&) = delete;
+    IdlePeriodStatistics& operator=(const IdlePeriodStatistics&) = delete;
+
+    // IInputConsumer
+    void OnEvents(const InputEvent* events, size_t count) override
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint64_t timestamp = events[i].timestampMs;
+            if (m_lastEventMs && timestamp >= m_lastEventMs + MIN_IDLE_MS)
+                m_periods.Record(timestamp - m_lastEventMs);
+
+            if (timestamp > m_lastEventMs)
+                m_lastEventMs = timestamp;
+        }
+    }
+
+    const LatencyHistogram& GetPeriods() const { return m_periods; }
+
+private:
+    // Member variables
+    LatencyHistogram m_periods;
+    uint64_t m_lastEventMs = 0; // drain thread only
+};
\ No newline at end of file
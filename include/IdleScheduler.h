@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+class IDeadlineTimer;
+
+/**
+ * Tickless idle deadline logic shared by every timer backend
+ * Arms a single deadline at lastActivity + timeout; activity never touches
+ * the timer, the deadline is re-armed lazily only when it expires
+ */
+class IdleScheduler
+{
+public:
+    explicit IdleScheduler(IDeadlineTimer* timer);
+
+    // Scheduling control
+    void Start(uint64_t nowMs, uint64_t lastActivityMs);
+    void Stop();
+    void Rearm(uint64_t lastActivityMs);
+    bool IsRunning() const { return m_running; }
+
+    // Configuration (takes effect on the next Rearm)
+    void SetTimeout(uint32_t timeoutSeconds) { m_timeoutSeconds = timeoutSeconds; }
+    uint32_t GetTimeout() const { return m_timeoutSeconds; }
+
+    // Called when the armed deadline expires
+    // Returns true when the idle action must run now
+    bool OnTimer(uint64_t nowMs, uint64_t lastActivityMs);
+
+    // Statistics
+    uint64_t GetDeadline() const { return m_deadlineMs; }
+    uint64_t GetWakeups() const { return m_wakeups; }
+    uint64_t GetActions() const { return m_actions; }
+    uint64_t GetWakeupsPerHour(uint64_t nowMs) const;
+
+    // Timers may fire up to one scheduler tick early; treat that as expired
+    static const uint64_t TIMER_SLACK_MS = 16;
+
+private:
+    // Member variables
+    IDeadlineTimer* m_timer;
+    bool m_running = false;
+    uint32_t m_timeoutSeconds = 0;
+    uint64_t m_deadlineMs = 0;
+    uint64_t m_startMs = 0;
+    uint64_t m_wakeups = 0;
+    uint64_t m_actions = 0;
+};
\ No newline at end of file
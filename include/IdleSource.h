@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Reads the operating system's own idle clock instead of observing input
+ * Nothing runs on the input path; the clock is sampled only when the
+ * idle deadline expires
+ */
+class IIdleSource
+{
+public:
+    virtual ~IIdleSource() = default;
+
+    virtual bool Open() = 0;
+    virtual void Close() = 0;
+
+    // Time of the last user input on the MonotonicNowMs() base
+    virtual bool QueryLastInputTime(uint64_t& lastInputMs) = 0;
+};
\ No newline at end of file
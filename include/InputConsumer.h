@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+
+struct InputEvent;
+
+/**
+ * Analytics consumer fed with batches of input events
+ * Called on the drain thread, never on the input thread, so consumers may
+ * take their time without delaying system input
+ */
+class IInputConsumer
+{
+public:
+    virtual ~IInputConsumer() = default;
+
+    virtual void OnEvents(const InputEvent* events, size_t count) = 0;
+};
\ No newline at end of file
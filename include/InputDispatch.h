@@ -0,0 +1,107 @@
+#pragma once
+
+#include "ActivityChannel.h"
+#include "EventDrainThread.h"
+#include "InputEvent.h"
+#include "InputEventRing.h"
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Entry point for decoded input events on the input thread
+ * Publishes activity to the channel, attributes events to devices and
+ * copies each event into the analytics ring when one is attached
+ * Only the input thread dispatches; statistics may be read from any thread
+ */
+class InputDispatch
+{
+public:
+    static const size_t MAX_DEVICES = 16;
+
+    explicit InputDispatch(ActivityChannel& channel)
+        : m_channel(channel)
+    {
+    }
+
+    InputDispatch(const InputDispatch&) = delete;
+    InputDispatch& operator=(const InputDispatch&) = delete;
+
+    // Event delivery (input thread only)
+    void Dispatch(const InputEvent& event)
+    {
+        m_channel.Publish(event.timestampMs);
+        RecordDevice(event.device);
+
+        // Full ring drops and counts; the input thread never waits on analytics
+        if (m_ring)
+        {
+            m_ring->TryPush(event);
+            if (m_drain)
+                m_drain->NotifyPush(*m_ring);
+        }
+    }
+
+    // Attach before the input thread starts; drain, when given, is woken as events arrive
+    void SetEventRing(InputEventRing* ring, EventDrainThread* drain = nullptr)
+    {
+        m_ring = ring;
+        m_drain = drain;
+    }
+
+    // Device attribution (any thread)
+    size_t GetDeviceCount() const { return m_deviceCount.load(std::memory_order_acquire); }
+    uint64_t GetDeviceHandle(size_t index) const { return m_devices[index].handle.load(std::memory_order_relaxed); }
+    uint64_t GetDeviceEvents(size_t index) const { return m_devices[index].events.load(std::memory_order_relaxed); }
+
+    ActivityChannel& GetChannel() { return m_channel; }
+
+private:
+    struct DeviceSlot
+    {
+        std::atomic<uint64_t> handle{ 0 };
+        std::atomic<uint64_t> events{ 0 };
+    };
+
+    void RecordDevice(uint64_t device)
+    {
+        // Bursts come from one device; check the slot that matched last time first
+        size_t count = m_deviceCount.load(std::memory_order_relaxed);
+        if (m_lastSlot < count && m_devices[m_lastSlot].handle.load(std::memory_order_relaxed) == device)
+        {
+            Bump(m_devices[m_lastSlot].events);
+            return;
+        }
+
+        // Few devices exist per machine, a linear scan beats any map here
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (m_devices[i].handle.load(std::memory_order_relaxed) == device)
+            {
+                Bump(m_devices[i].events);
+                m_lastSlot = i;
+                return;
+            }
+        }
+
+        if (count < MAX_DEVICES)
+        {
+            m_devices[count].handle.store(device, std::memory_order_relaxed);
+            m_devices[count].events.store(1, std::memory_order_relaxed);
+            m_deviceCount.store(count + 1, std::memory_order_release);
+            m_lastSlot = count;
+        }
+    }
+
+    static void Bump(std::atomic<uint64_t>& counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // Member variables
+    ActivityChannel& m_channel;
+    DeviceSlot m_devices[MAX_DEVICES];
+    std::atomic<size_t> m_deviceCount{ 0 };
+    size_t m_lastSlot = 0; // input thread only
+    InputEventRing* m_ring = nullptr;
+    EventDrainThread* m_drain = nullptr;
+};
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Kinds of user input an input source can report
+ */
+enum class InputEventType : uint8_t
+{
+    MouseMove,
+    MouseButton,
+    MouseWheel,
+    KeyDown,
+    KeyUp
+};
+
+/**
+ * One decoded input event, independent of the platform that produced it
+ * Kept small and trivially copyable so sources can pass it by value
+ */
+struct InputEvent
+{
+    uint64_t timestampMs = 0;  // MonotonicNowMs() base
+    uint64_t device = 0;       // Platform device handle, 0 when the source cannot attribute
+    int16_t x = 0;             // Coarse position or relative motion; key code for keyboard events
+    int16_t y = 0;             // Coarse position or relative motion; wheel delta for wheel events;
+                               // scan code (0xE0xx / 0xE1xx when prefixed) for Windows key events
+    InputEventType type = InputEventType::MouseMove;
+};
\ No newline at end of file
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "InputEvent.h"
+#include "SpscRing.h"
+
+// Ring between the input thread (producer) and the drain thread (consumer);
+// sized for several seconds of 1 kHz input between drain passes
+typedef SpscRing<InputEvent, 4096> InputEventRing;
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+class InputDispatch;
+
+/**
+ * Platform source of user input events, driven by a dedicated input thread
+ * Open, Pump and Close run on that thread; Wake may be called from any thread
+ */
+class IInputSource
+{
+public:
+    virtual ~IInputSource() = default;
+
+    // Acquire platform resources; returning false aborts the input thread
+    virtual bool Open() = 0;
+
+    // Deliver decoded events to the dispatcher until Wake is called
+    virtual void Pump(InputDispatch& dispatch) = 0;
+
+    // Ask a running Pump to return as soon as possible
+    virtual void Wake() = 0;
+
+    // Release everything acquired by Open
+    virtual void Close() = 0;
+};
\ No newline at end of file
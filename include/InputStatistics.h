@@ -0,0 +1,48 @@
+#pragma once
+
+#include "InputConsumer.h"
+#include "InputEvent.h"
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Consumer that counts drained input events by type
+ * Written by the drain thread only; counts may be read from any thread
+ */
+class InputStatistics : public IInputConsumer
+{
+public:
+    static const size_t TYPE_COUNT = static_cast<size_t>(InputEventType::KeyUp) + 1;
+
+    InputStatistics() = default;
+    InputStatistics(const InputStatistics&) = delete;
+    InputStatistics& operator=(const InputStatistics&) = delete;
+
+    // IInputConsumer
+    void OnEvents(const InputEvent* events, size_t count) override
+    {
+        // Tally locally, publish once per batch
+        uint64_t tally[TYPE_COUNT] = { 0 };
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t type = static_cast<size_t>(events[i].type);
+            if (type < TYPE_COUNT)
+                ++tally[type];
+        }
+
+        for (size_t type = 0; type < TYPE_COUNT; ++type)
+        {
+            if (tally[type])
+                m_counts[type].store(m_counts[type].load(std::memory_order_relaxed) + tally[type], std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t GetCount(InputEventType type) const
+    {
+        return m_counts[static_cast<size_t>(type)].load(std::memory_order_relaxed);
+    }
+
+private:
+    // Member variables
+    std::atomic<uint64_t> m_counts[TYPE_COUNT] = {};
+};
\ No newline at end of file
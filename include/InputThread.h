@@ -0,0 +1,30 @@
+#pragma once
+
+#include <thread>
+
+class IInputSource;
+class InputDispatch;
+
+/**
+ * Owns the thread that runs an input source and its event pump
+ * Keeps input delivery independent from the UI thread and its modal loops
+ */
+class InputThread
+{
+public:
+    InputThread() = default;
+    ~InputThread();
+
+    InputThread(const InputThread&) = delete;
+    InputThread& operator=(const InputThread&) = delete;
+
+    // Thread control
+    bool Start(IInputSource* source, InputDispatch* dispatch);
+    void Stop();
+    bool IsRunning() const { return m_thread.joinable(); }
+
+private:
+    // Member variables
+    IInputSource* m_source = nullptr;
+    std::thread m_thread;
+};
\ No newline at end of file
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+// Levels below this are compiled out of MMA_LOG_* call sites (0 = debug ... 3 = error, 4 = none)
+#ifndef MMA_LOG_MIN_LEVEL
+#define MMA_LOG_MIN_LEVEL 0
+#endif
+
+enum class LogLevel : uint8_t
+{
+    Debug,
+    Info,
+    Warning,
+    Error,
+    Off
+};
+
+/**
+ * Static description of one log call site; its address is the format id
+ */
+struct LogSite
+{
+    LogLevel level;
+    const char* file;
+    int line;
+    const char* format;
+};
+
+enum class LogArgType : uint8_t
+{
+    Signed,
+    Unsigned,
+    Double,
+    String,  // pointer only: pass string literals or other strings that outlive the process
+    Pointer
+};
+
+struct LogArg
+{
+    uint64_t bits;
+    LogArgType type;
+};
+
+/**
+ * One enqueued log call: the call site plus its raw arguments
+ */
+struct LogRecord
+{
+    static const size_t MAX_ARGS = 6;
+
+    const LogSite* site;
+    int64_t timeUs;      // wall clock, microseconds since the Unix epoch
+    uint32_t threadId;   // small per-process number, in order of first log call
+    uint8_t argCount;
+    LogArgType types[MAX_ARGS];
+    uint64_t args[MAX_ARGS];
+};
+
+/**
+ * Destination for formatted log text, called on the logger thread only
+ */
+class ILogSink
+{
+public:
+    virtual ~ILogSink() = default;
+
+    virtual bool Write(const char* text, size_t length) = 0;
+    virtual void Flush() {}
+};
+
+// Argument packing; anything else fails to compile at the call site
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, LogArg>::type MakeLogArg(T value)
+{
+    return LogArg{ static_cast<uint64_t>(static_cast<int64_t>(value)), LogArgType::Signed };
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value, LogArg>::type MakeLogArg(T value)
+{
+    return LogArg{ static_cast<uint64_t>(value), LogArgType::Unsigned };
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, LogArg>::type MakeLogArg(T value)
+{
+    double converted = static_cast<double>(value);
+    uint64_t bits;
+    static_assert(sizeof(bits) == sizeof(converted), "double must be 64 bits");
+    memcpy(&bits, &converted, sizeof(bits));
+    return LogArg{ bits, LogArgType::Double };
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_enum<T>::value, LogArg>::type MakeLogArg(T value)
+{
+    return MakeLogArg(static_cast<typename std::underlying_type<T>::type>(value));
+}
+
+inline LogArg MakeLogArg(const char* value)
+{
+    return LogArg{ static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value)), LogArgType::String };
+}
+
+inline LogArg MakeLogArg(const void* value)
+{
+    return LogArg{ static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value)), LogArgType::Pointer };
+}
+
+/**
+ * Asynchronous logger with deferred formatting
+ * A call site copies its site pointer and raw arguments into a lock-free
+ * ring (tens of nanoseconds, no formatting, no I/O, no allocation); the
+ * logger thread formats records as logfmt lines and hands them to the sink
+ * in batches. A full ring drops the record and counts it. Records enqueued
+ * while the logger is stopped wait in the ring for the next Start
+ * Log through the MMA_LOG_* macros: levels below MMA_LOG_MIN_LEVEL compile
+ * to nothing, the rest are filtered at runtime by SetLevel
+ */
+class Logger
+{
+public:
+    static const size_t RING_CAPACITY = 1024;
+    static const uint32_t IDLE_INTERVAL_MS = 1000;
+
+    // Lifecycle; the sink must outlive Stop
+    static bool Start(ILogSink* sink);
+    static void Stop();
+
+    // Runtime filter (any thread)
+    static void SetLevel(LogLevel level) { s_level.store(static_cast<uint8_t>(level), std::memory_order_relaxed); }
+    static LogLevel GetLevel() { return static_cast<LogLevel>(s_level.load(std::memory_order_relaxed)); }
+    static bool IsEnabled(LogLevel level)
+    {
+        return static_cast<uint8_t>(level) >= s_level.load(std::memory_order_relaxed);
+    }
+
+    // Recording (any thread)
+    template <typename... Args>
+    static void Write(const LogSite* site, Args... args)
+    {
+        static_assert(sizeof...(Args) <= LogRecord::MAX_ARGS, "Too many log arguments");
+
+        const LogArg packed[sizeof...(Args) + 1] = { MakeLogArg(args)..., LogArg{ 0, LogArgType::Unsigned } };
+
+        LogRecord record;
+        record.site = site;
+        record.argCount = static_cast<uint8_t>(sizeof...(Args));
+        for (size_t i = 0; i < sizeof...(Args); ++i)
+        {
+            record.types[i] = packed[i].type;
+            record.args[i] = packed[i].bits;
+        }
+        Enqueue(record);
+    }
+
+    // Blocks until everything enqueued so far reached the sink
+    static void Flush();
+
+    // Formats one record as a logfmt line ending in '\n'; returns its length
+    static size_t Format(const LogRecord& record, char* buffer, size_t size);
+
+    // Statistics
+    static uint64_t GetDropped();
+    static uint64_t GetWritten() { return s_written.load(std::memory_order_relaxed); }
+
+private:
+    // Private helpers
+    static void Enqueue(LogRecord& record);
+    static void Run();
+    static void Drain();
+
+    // Member variables
+    static std::atomic<uint8_t> s_level;
+    static std::atomic<uint64_t> s_written;
+    static std::atomic<bool> s_wakePending;
+    static ILogSink* s_sink;
+    static std::thread s_thread;
+    static std::mutex s_mutex;
+    static std::condition_variable s_wake;
+    static std::condition_variable s_flushed;
+    static bool s_stopRequested;
+    static uint64_t s_flushRequested;
+    static uint64_t s_flushCompleted;
+};
+
+// Compile-time filter; with nothing filtered there is no comparison to warn about
+#if MMA_LOG_MIN_LEVEL > 0
+#define MMA_LOG_COMPILED_IN(level) (static_cast<int>(level) >= MMA_LOG_MIN_LEVEL)
+#else
+#define MMA_LOG_COMPILED_IN(level) true
+#endif
+
+#define MMA_LOG(level, format, ...)                                                         \
+    do                                                                                      \
+    {                                                                                       \
+        if (MMA_LOG_COMPILED_IN(level) && Logger::IsEnabled(level))                         \
+        {                                                                                   \
+            static const LogSite mmaLogSite = { level, __FILE__, __LINE__, format };        \
+            Logger::Write(&mmaLogSite, ##__VA_ARGS__);                                      \
+        }                                                                                   \
+    } while (0)
+
+#define MMA_LOG_DEBUG(format, ...) MMA_LOG(LogLevel::Debug, format, ##__VA_ARGS__)
+#define MMA_LOG_INFO(format, ...) MMA_LOG(LogLevel::Info, format, ##__VA_ARGS__)
+#define MMA_LOG_WARNING(format, ...) MMA_LOG(LogLevel::Warning, format, ##__VA_ARGS__)
+#define MMA_LOG_ERROR(format, ...) MMA_LOG(LogLevel::Error, format, ##__VA_ARGS__)
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "IdleSource.h"
+
+/**
+ * Headless idle source reporting whatever input time it was told
+ * (watchdog and idle-clock replay without an operating system clock)
+ */
+class ManualIdleSource : public IIdleSource
+{
+public:
+    bool Open() override { return true; }
+    void Close() override {}
+
+    bool QueryLastInputTime(uint64_t& lastInputMs) override
+    {
+        lastInputMs = m_lastInputMs;
+        return m_available;
+    }
+
+    void SetLastInputTime(uint64_t lastInputMs) { m_lastInputMs = lastInputMs; }
+    void SetAvailable(bool available) { m_available = available; }
+
+private:
+    uint64_t m_lastInputMs = 0;
+    bool m_available = true;
+};
\ No newline at end of file
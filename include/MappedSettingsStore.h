@@ -0,0 +1,70 @@
+#pragma once
+
+#include "SettingsModel.h"
+#include "SettingsStore.h"
+#include <string>
+
+/**
+ * Read-only settings snapshot for provisioned deployments
+ * The snapshot is a fixed header followed by fixed-size name/value entries,
+ * compiled ahead of time by WriteSnapshot (or mma_settings --compile). The
+ * first Open maps the whole file with one mapping call and validates the
+ * header; reads scan the mapped entries in place, with no parsing or
+ * copying. The mapping lives until Invalidate, so a replaced snapshot is
+ * seen after a reload. Saving is refused: Open(true) fails and IsReadOnly
+ * is true
+ */
+class MappedSettingsStore : public ISettingsStore
+{
+public:
+    static const char* const FILE_NAME;
+    static const uint32_t MAGIC = 0x53414D4D; // "MMAS" in little-endian byte order
+    static const uint16_t VERSION = 1;
+    static const size_t MAX_NAME_LENGTH = 27;
+
+    explicit MappedSettingsStore(const std::string& path);
+    ~MappedSettingsStore() override;
+
+    MappedSettingsStore(const MappedSettingsStore&) = delete;
+    MappedSettingsStore& operator=(const MappedSettingsStore&) = delete;
+
+    // ISettingsStore
+    bool Open(bool forWrite) override;
+    bool Close() override;
+    bool ReadUInt32(const char* name, uint32_t& value) override;
+    bool WriteUInt32(const char*, uint32_t) override { return false; }
+    bool IsReadOnly() const override { return true; }
+    void Invalidate() override { Unmap(); }
+
+    const std::string& GetPath() const { return m_path; }
+
+    // Compiles every persisted value of settings into a snapshot, atomically
+    static bool WriteSnapshot(const std::string& path, const AppSettings& settings);
+
+private:
+    struct Header
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t entrySize;
+        uint32_t count;
+        uint32_t reserved;
+    };
+
+    struct Entry
+    {
+        char name[MAX_NAME_LENGTH + 1]; // NUL-padded
+        uint32_t value;
+    };
+
+    // Private helpers
+    bool Map();
+    void Unmap();
+
+    // Member variables
+    std::string m_path;
+    const void* m_view = nullptr;
+    size_t m_size = 0;
+    const Entry* m_entries = nullptr;
+    uint32_t m_count = 0;
+};
\ No newline at end of file
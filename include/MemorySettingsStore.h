@@ -0,0 +1,43 @@
+#pragma once
+
+#include "SettingsStore.h"
+#include <map>
+#include <string>
+
+/**
+ * In-memory settings store for headless runs and benchmarks
+ */
+class MemorySettingsStore : public ISettingsStore
+{
+public:
+    MemorySettingsStore() = default;
+
+    // ISettingsStore
+    bool Open(bool) override { return true; }
+    bool Close() override { return true; }
+
+    bool ReadUInt32(const char* name, uint32_t& value) override
+    {
+        std::map<std::string, uint32_t>::const_iterator it = m_values.find(name);
+        if (it == m_values.end())
+            return false;
+
+        value = it->second;
+        return true;
+    }
+
+    bool WriteUInt32(const char* name, uint32_t value) override
+    {
+        m_values[name] = value;
+        return true;
+    }
+
+    // Inspection
+    size_t GetValueCount() const { return m_values.size(); }
+    const std::map<std::string, uint32_t>& GetValues() const { return m_values; }
+    void Clear() { m_values.clear(); }
+
+private:
+    // Member variables
+    std::map<std::string, uint32_t> m_values;
+};
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+#ifdef _WIN32
+#include "framework.h"
+#else
+#include <time.h>
+#endif
+
+/**
+ * Millisecond monotonic clock shared by activity sources and deadline timers
+ * Windows uses GetTickCount64 (the base hook timestamps are taken in),
+ * Linux uses CLOCK_MONOTONIC (the base timerfd deadlines are armed in)
+ */
+inline uint64_t MonotonicNowMs()
+{
+#ifdef _WIN32
+    return GetTickCount64();
+#else
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000 + static_cast<uint64_t>(ts.tv_nsec) / 1000000;
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * Fixed-size lock-free multi-producer/multi-consumer ring
+ * Every cell carries a sequence number that tells producers and consumers
+ * whose turn it is, so a push or pop is one compare-exchange on the shared
+ * index and never waits on a stalled peer's cell. A full ring drops the
+ * item and counts it, like SpscRing
+ */
+template <typename T, size_t N>
+class MpmcRing
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "MpmcRing capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "MpmcRing items are copied with plain stores");
+
+public:
+    static const size_t CAPACITY = N;
+
+    MpmcRing()
+    {
+        for (size_t i = 0; i < N; ++i)
+        {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing& operator=(const MpmcRing&) = delete;
+
+    // Producer side (any thread)
+    bool TryPush(const T& item)
+    {
+        size_t position = m_head.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;)
+        {
+            cell = &m_cells[position & (N - 1)];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+            if (difference == 0)
+            {
+                if (m_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+            {
+                // The cell still holds an item from one lap ago: full
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                position = m_head.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->item = item;
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side (any thread)
+    bool TryPop(T& item)
+    {
+        size_t position = m_tail.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;)
+        {
+            cell = &m_cells[position & (N - 1)];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+            if (difference == 0)
+            {
+                if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+
+        item = cell->item;
+        cell->sequence.store(position + N, std::memory_order_release);
+        return true;
+    }
+
+    // Statistics (any thread, approximate while producers run)
+    size_t GetSize() const
+    {
+        size_t head = m_head.load(std::memory_order_acquire);
+        size_t tail = m_tail.load(std::memory_order_acquire);
+        return head > tail ? head - tail : 0;
+    }
+    uint64_t GetDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T item;
+    };
+
+    // Producer line
+    alignas(64) std::atomic<size_t> m_head{ 0 };
+    std::atomic<uint64_t> m_dropped{ 0 };
+
+    // Consumer line
+    alignas(64) std::atomic<size_t> m_tail{ 0 };
+
+    alignas(64) Cell m_cells[N];
+};
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class LatencyHistogram;
+
+/**
+ * OpenMetrics text exposition for node_exporter / windows_exporter
+ * textfile collectors
+ * The text is built in one buffer that keeps its capacity between exports,
+ * and written to a temporary file that is renamed over the target, so the
+ * collector never reads a half-written file and a steady-state export
+ * allocates nothing
+ */
+class OpenMetricsWriter
+{
+public:
+    static const size_t INITIAL_CAPACITY = 16 * 1024;
+
+    OpenMetricsWriter();
+
+    OpenMetricsWriter(const OpenMetricsWriter&) = delete;
+    OpenMetricsWriter& operator=(const OpenMetricsWriter&) = delete;
+
+    // Text building: Begin, any number of families, End
+    void Begin();
+    void WriteCounter(const char* name, const char* help, uint64_t value);
+    void WriteGauge(const char* name, const char* help, uint64_t value);
+
+    // Counter family with one label; add samples with WriteLabeledSample
+    void BeginFamily(const char* name, const char* type, const char* help, const char* unit = nullptr);
+    void WriteLabeledSample(const char* name, const char* suffix, const char* label, const char* labelValue, uint64_t value);
+
+    // bounds are ascending, in the histogram's own unit; scale converts them
+    // (and the sum) to the exported unit, e.g. 1e-9 for nanoseconds to seconds
+    void WriteHistogram(const char* name, const char* help, const char* unit, const LatencyHistogram& histogram,
+                        const uint64_t* bounds, size_t boundCount, double scale);
+
+    void End();
+    const std::string& GetText() const { return m_buffer; }
+
+    // Output; the temporary file is the target path plus ".tmp", which
+    // textfile collectors ignore
+    bool SetPath(const char* path);
+    bool HasPath() const { return !m_path.empty(); }
+    bool WriteFile();
+
+private:
+    // Private helpers
+    void Append(const char* format, ...);
+
+    // Member variables
+    std::string m_buffer;
+#ifdef _WIN32
+    std::wstring m_path;
+    std::wstring m_tempPath;
+#else
+    std::string m_path;
+    std::string m_tempPath;
+#endif
+};
\ No newline at end of file
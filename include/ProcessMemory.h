@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Memory figures of the current process
+ * privateBytes is what a terminal server pays per session: the commit
+ * charge on Windows, private resident pages on Linux. workingSetBytes
+ * includes shared pages (DLLs, the executable image)
+ */
+struct ProcessMemoryUsage
+{
+    uint64_t privateBytes;
+    uint64_t workingSetBytes;
+};
+
+/**
+ * Footprint self-check for low-footprint deployments
+ */
+class ProcessMemory
+{
+public:
+    // False when the platform cannot report (missing /proc, API failure)
+    static bool Query(ProcessMemoryUsage& usage);
+
+    // Returns unused pages to the system: empties the working set on Windows,
+    // releases free heap pages on Linux. Pages fault back in on next use
+    static void TrimWorkingSet();
+
+    // Logs usage at a named point against the budget; false when over it or unknown
+    static bool CheckBudget(uint64_t budgetBytes, const char* when);
+};
\ No newline at end of file
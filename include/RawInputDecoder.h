@@ -0,0 +1,62 @@
+#pragma once
+
+#include "InputEvent.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Decodes RAWINPUT packets into InputEvents
+ * The layouts mirror the Windows structures field for field so recorded
+ * packets can be decoded on any platform; RawInputSource checks at compile
+ * time that they match the SDK definitions
+ */
+class RawInputDecoder
+{
+public:
+    // RAWINPUTHEADER
+    struct Header
+    {
+        uint32_t type;
+        uint32_t size;
+        uintptr_t device;
+        uintptr_t wParam;
+    };
+
+    // RAWMOUSE
+    struct Mouse
+    {
+        uint16_t flags;
+        uint16_t reserved;
+        uint16_t buttonFlags;
+        uint16_t buttonData;
+        uint32_t rawButtons;
+        int32_t lastX;
+        int32_t lastY;
+        uint32_t extraInformation;
+    };
+
+    // RAWKEYBOARD
+    struct Keyboard
+    {
+        uint16_t makeCode;
+        uint16_t flags;
+        uint16_t reserved;
+        uint16_t vkey;
+        uint32_t message;
+        uint32_t extraInformation;
+    };
+
+    // RIM_TYPE*, MOUSE_MOVE_*, RI_MOUSE_* and RI_KEY_* values
+    static const uint32_t TYPE_MOUSE = 0;
+    static const uint32_t TYPE_KEYBOARD = 1;
+    static const uint32_t TYPE_HID = 2;
+    static const uint16_t MOUSE_ABSOLUTE = 0x0001;
+    static const uint16_t MOUSE_BUTTON_MASK = 0x03FF;
+    static const uint16_t MOUSE_WHEEL_MASK = 0x0C00;
+    static const uint16_t KEY_BREAK = 0x0001;
+    static const uint16_t KEY_E0 = 0x0002;
+    static const uint16_t KEY_E1 = 0x0004;
+
+    // Returns false for truncated packets (buffer or dwSize) and device types we do not track
+    static bool Decode(const void* data, size_t size, uint64_t timestampMs, InputEvent& event);
+};
\ No newline at end of file
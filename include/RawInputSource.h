@@ -0,0 +1,37 @@
+#pragma once
+
+#include "common.h"
+#include "InputSource.h"
+
+/**
+ * Input source backed by Raw Input (WM_INPUT) with RIDEV_INPUTSINK
+ * Events are delivered asynchronously to a message-only window on the
+ * input thread, so other applications' input is never serialized through
+ * this process; every event carries the originating device handle
+ */
+class RawInputSource : public IInputSource
+{
+public:
+    RawInputSource();
+    ~RawInputSource() override;
+
+    // IInputSource
+    bool Open() override;
+    void Pump(InputDispatch& dispatch) override;
+    void Wake() override;
+    void Close() override;
+
+private:
+    // Private helpers
+    void HandleRawInput(InputDispatch& dispatch, HRAWINPUT hRawInput);
+
+    // Member variables
+    HWND m_window = nullptr;
+    DWORD m_threadId = 0;
+    bool m_devicesRegistered = false;
+
+    // Large enough for mouse and keyboard packets; HID packets are skipped
+    alignas(8) BYTE m_packet[64];
+
+    static const WCHAR* WINDOW_CLASS;
+};
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "common.h"
+#include "SettingsStore.h"
+
+/**
+ * Settings store backed by a key under HKEY_CURRENT_USER
+ * Value names are ASCII and stored as REG_DWORD. ReadValues fetches a whole
+ * batch with one RegQueryMultipleValues call; the registry has no batched
+ * write, so WriteValues stays one RegSetValueEx per value
+ */
+class RegistrySettingsStore : public ISettingsStore
+{
+public:
+    explicit RegistrySettingsStore(const WCHAR* keyPath);
+    ~RegistrySettingsStore() override;
+
+    RegistrySettingsStore(const RegistrySettingsStore&) = delete;
+    RegistrySettingsStore& operator=(const RegistrySettingsStore&) = delete;
+
+    // ISettingsStore
+    bool Open(bool forWrite) override;
+    bool Close() override;
+    bool ReadUInt32(const char* name, uint32_t& value) override;
+    bool WriteUInt32(const char* name, uint32_t value) override;
+    uint32_t ReadValues(const char* const* names, uint32_t* values, uint32_t count) override;
+
+private:
+    // Member variables
+    const WCHAR* m_keyPath;
+    HKEY m_key = nullptr;
+};
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Logger.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Log sink appending to a file that rotates by size
+ * When the next write would grow the file past maxBytes, mma.log becomes
+ * mma.log.1, mma.log.1 becomes mma.log.2 and so on; the oldest of
+ * maxFiles rotated files is discarded. Paths are UTF-8
+ */
+class RotatingFileSink : public ILogSink
+{
+public:
+    static const uint64_t DEFAULT_MAX_BYTES = 1024 * 1024;
+    static const uint32_t DEFAULT_MAX_FILES = 3;
+
+    RotatingFileSink(const char* path, uint64_t maxBytes = DEFAULT_MAX_BYTES, uint32_t maxFiles = DEFAULT_MAX_FILES);
+    ~RotatingFileSink();
+
+    RotatingFileSink(const RotatingFileSink&) = delete;
+    RotatingFileSink& operator=(const RotatingFileSink&) = delete;
+
+    // ILogSink
+    bool Write(const char* text, size_t length) override;
+
+    uint64_t GetRotations() const { return m_rotations; }
+
+private:
+    // Private helpers
+    bool OpenFile();
+    void CloseFile();
+    void Rotate();
+    std::string RotatedPath(uint32_t index) const;
+
+    // Member variables
+    std::string m_path;
+    uint64_t m_maxBytes;
+    uint32_t m_maxFiles;
+    uint64_t m_size = 0;
+    uint64_t m_rotations = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+#else
+    int m_fd = -1;
+#endif
+};
\ No newline at end of file
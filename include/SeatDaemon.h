@@ -0,0 +1,124 @@
+#pragma once
+
+#include "DeadlineTimer.h"
+#include "IdleScheduler.h"
+#include "TimerFdDeadlineTimer.h"
+#include "TimerHeap.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+class IIdleSource;
+
+/**
+ * Linux daemon serving many seats from one thread
+ * Each seat runs its own IdleScheduler, the same state machine
+ * ActivityMonitor uses, but all seats share one epoll set for their evdev
+ * devices and one timerfd armed at the earliest deadline of a TimerHeap.
+ * Input only stores a timestamp on the seat; the heap is touched when a
+ * deadline expires, so the per-seat cost stays at a few hundred bytes.
+ * A seat may also follow an IIdleSource (the X server's idle clock for a
+ * desktop session); it is read only when the seat's deadline expires
+ */
+class SeatDaemon
+{
+public:
+    typedef std::function<void(uint32_t seat)> IdleAction;
+    typedef std::function<void()> Task;
+
+    SeatDaemon();
+    ~SeatDaemon();
+
+    SeatDaemon(const SeatDaemon&) = delete;
+    SeatDaemon& operator=(const SeatDaemon&) = delete;
+
+    // Lifecycle
+    bool Open();
+    void Close();
+
+    // Seat configuration; a seat starts its idle countdown when added, its
+    // timeout clamped to 1..MAX_TIMEOUT_SECONDS
+    uint32_t AddSeat(uint32_t timeoutSeconds);
+    bool AddDevice(uint32_t seat, int fd); // takes ownership of fd
+    bool AddDevicePath(uint32_t seat, const char* path);
+    bool SetIdleSource(uint32_t seat, IIdleSource* source); // not owned, must outlive the loop
+    void SetIdleAction(const IdleAction& action) { m_idleAction = action; }
+    void Reserve(size_t seats);
+
+    // Loop thread only; the seat's countdown restarts from its last activity.
+    // A timeout of 0 or above MAX_TIMEOUT_SECONDS is refused: 0 would re-arm at now forever
+    bool SetTimeout(uint32_t seat, uint32_t timeoutSeconds);
+    uint32_t GetTimeout(uint32_t seat) const { return m_seats[seat].scheduler.GetTimeout(); }
+
+    // Any thread: runs task on the loop thread at its next wakeup; tasks still queued at Close are dropped
+    void Post(const Task& task);
+
+    // Event loop; Stop may be called from any thread or a signal handler
+    int Run();
+    bool RunOnce(int timeoutMs);
+    void Stop();
+
+    // Statistics
+    size_t GetSeatCount() const { return m_seats.size(); }
+    size_t GetDeviceCount() const { return m_deviceFds.size(); }
+    uint64_t GetLastActivity(uint32_t seat) const { return m_seats[seat].lastActivityMs; }
+    uint64_t GetSeatEvents(uint32_t seat) const { return m_seats[seat].events; }
+    uint64_t GetSeatActions(uint32_t seat) const { return m_seats[seat].scheduler.GetActions(); }
+    uint64_t GetTimerArms() const { return m_timer.GetArmCount(); }
+    uint64_t GetWakeups() const { return m_wakeups; }
+    static size_t GetSeatFootprint();
+
+    static const size_t READ_BATCH = 64;
+
+private:
+    // Forwards a seat's IdleScheduler deadline into the shared heap
+    class SeatTimer : public IDeadlineTimer
+    {
+    public:
+        SeatTimer(TimerHeap& heap, uint32_t id) : m_heap(heap), m_id(id) {}
+
+        bool Arm(uint64_t deadlineMs) override { m_heap.Schedule(m_id, deadlineMs); return true; }
+        void Disarm() override { m_heap.Cancel(m_id); }
+
+    private:
+        TimerHeap& m_heap;
+        uint32_t m_id;
+    };
+
+    struct Seat
+    {
+        Seat(TimerHeap& heap, uint32_t id) : timer(heap, id), scheduler(&timer) {}
+
+        SeatTimer timer;
+        IdleScheduler scheduler;
+        IIdleSource* idleSource = nullptr;
+        uint64_t lastActivityMs = 0;
+        uint64_t events = 0;
+    };
+
+    // Private helpers
+    void ReadDevice(uint32_t seat, int fd);
+    void RemoveDevice(int fd);
+    void ExpireDeadlines();
+    void RunTasks();
+    void ArmEarliest();
+
+    // Member variables
+    int m_epollFd = -1;
+    int m_wakeFd = -1;
+    int m_taskFd = -1;
+    TimerFdDeadlineTimer m_timer;
+    TimerHeap m_heap;
+    uint64_t m_armedDeadlineMs = 0;
+    std::deque<Seat> m_seats; // deque keeps seats in place for their timers
+    std::vector<int> m_deviceFds;
+    IdleAction m_idleAction;
+    uint64_t m_wakeups = 0;
+
+    // Guarded by m_taskMutex
+    std::mutex m_taskMutex;
+    std::vector<Task> m_tasks;
+};
\ No newline at end of file
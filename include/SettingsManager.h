@@ -1,6 +1,14 @@
 #pragma once
 
 #include "common.h"
+#include "Clock.h"
+#include "SettingsModel.h"
+#include "SettingsReloader.h"
+#include "SettingsStore.h"
+#include "SettingsWatcher.h"
+#include "SettingsWriter.h"
+#include <memory>
+#include <string>
 
 /**
  * Manages application settings and registry operations
@@ -8,24 +16,34 @@
 class SettingsManager
 {
 public:
-    struct Settings
-    {
-        DWORD timeoutSeconds = DEFAULT_TIMEOUT_SECONDS;
-        bool minimizeToTray = true;
-        bool startHidden = false;
-        bool startMonitoring = false;
-        bool startWithWindows = false;
-        UINT hotkeyModifiers = MOD_CONTROL | MOD_SHIFT;
-        UINT hotkeyVK = 'M';
-    };
+    typedef AppSettings Settings;
 
     SettingsManager();
     ~SettingsManager() = default;
 
-    // Settings operations
+    // Backend in use: "snapshot", "file" or "registry"
+    const char* GetStoreName() const { return m_storeName; }
+
+    // Settings operations; SaveSettings queues changed values for the background writer
     void LoadSettings();
     void SaveSettings();
 
+    // Shutdown: stops the writer and saves synchronously, only when something is unsaved
+    void FlushSettings();
+
+    // Hot reload: a change to the store posts WM_SETTINGS_CHANGED to hwnd, whose handler
+    // calls ReloadSettings and re-applies the FIELD_* bits it returns
+    bool StartWatching(HWND hwnd);
+    void StopWatching();
+    uint32_t ReloadSettings();
+
+    // Save statistics (read from the drain thread by the metrics export)
+    ULONGLONG GetSaveCount() const { return m_writer.GetWrites(); }
+    ULONGLONG GetSaveFailures() const { return m_writer.GetFailures(); }
+    ULONGLONG GetSaveRequests() const { return m_writer.GetSubmits(); }
+    ULONGLONG GetValuesWritten() const { return m_writer.GetValuesWritten(); }
+    ULONGLONG GetReloadCount() const { return m_reloader.GetReloads(); }
+
     // Settings access
     const Settings& GetSettings() const { return m_settings; }
     void SetSettings(const Settings& settings) { m_settings = settings; }
@@ -52,33 +70,35 @@ public:
     UINT GetHotkeyVK() const { return m_settings.hotkeyVK; }
     void SetHotkeyVK(UINT vk) { m_settings.hotkeyVK = vk; }
 
+    DWORD GetActivityBackend() const { return m_settings.activityBackend; }
+    void SetActivityBackend(DWORD backend);
+
+    DWORD GetLogLevel() const { return m_settings.logLevel; }
+
+    bool GetLowFootprint() const { return m_settings.lowFootprint; }
+
     // Windows startup management
     bool SetStartWithWindowsRegistry(bool enable);
     bool IsStartWithWindowsEnabled();
 
-    // Utility
-    WCHAR* GetApplicationPath();
+    // Utility; false when the path does not fit in size characters
+    static bool GetApplicationPath(WCHAR* path, DWORD size);
 
 private:
-    // Registry operations
-    bool LoadFromRegistry();
-    bool SaveToRegistry();
-    
-    // Helper methods
-    DWORD ReadRegistryDWORD(HKEY hKey, const WCHAR* valueName, DWORD defaultValue);
-    bool WriteRegistryDWORD(HKEY hKey, const WCHAR* valueName, DWORD value);
+    // Private helpers
+    std::unique_ptr<ISettingsStore> CreateStore();
 
     Settings m_settings;
+    const char* m_storeName = nullptr;
+    std::string m_storePath; // empty for the registry
+    std::unique_ptr<ISettingsStore> m_store; // before m_writer, which keeps a reference
+    SystemClock m_clock;
+    SettingsWriter m_writer;
+    SettingsReloader m_reloader;
+    SettingsWatcher m_watcher; // last: stopped before the members its handler uses
 
     // Registry constants
     static const WCHAR* REG_KEY;
-    static const WCHAR* REG_TIMEOUT;
-    static const WCHAR* REG_MINIMIZE_TO_TRAY;
-    static const WCHAR* REG_START_HIDDEN;
-    static const WCHAR* REG_START_MONITORING;
-    static const WCHAR* REG_START_WITH_WINDOWS;
-    static const WCHAR* REG_HOTKEY_MODIFIERS;
-    static const WCHAR* REG_HOTKEY_VK;
     static const WCHAR* STARTUP_REG_KEY;
     static const WCHAR* STARTUP_REG_VALUE;
 };
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "SettingsSchema.h"
+#include <cstdint>
+
+class ISettingsStore;
+
+/**
+ * What a load found besides the values: the store's schema version and the
+ * fields a migration save should write (missing, or older than their row)
+ */
+struct SettingsLoadInfo
+{
+    uint32_t version = 0;
+    uint32_t upgradeFields = 0;
+
+    bool NeedsMigration() const { return version < SETTINGS_VERSION || upgradeFields != 0; }
+};
+
+/**
+ * Validation and persistence of AppSettings through an ISettingsStore
+ * Everything here walks SETTINGS_FIELDS; a load or save is one batched
+ * ReadValues or WriteValues call per pass
+ */
+class SettingsModel
+{
+public:
+    // Missing values fall back to defaults; returns false when the store cannot be opened
+    static bool Load(ISettingsStore& store, AppSettings& settings, SettingsLoadInfo* info = nullptr);
+    static bool Save(ISettingsStore& store, const AppSettings& settings);
+
+    // Brings a store written by an older version up to SETTINGS_VERSION: writes the
+    // info.upgradeFields values and the version; stores from newer versions are left alone
+    static bool Migrate(ISettingsStore& store, const AppSettings& settings, const SettingsLoadInfo& info);
+
+    // Dirty tracking: Diff returns the FIELD_* bits that differ, SaveFields writes only those
+    static uint32_t Diff(const AppSettings& a, const AppSettings& b);
+    static bool SaveFields(ISettingsStore& store, const AppSettings& settings, uint32_t fields);
+    static uint32_t CountFields(uint32_t fields);
+    static void CopyFields(AppSettings& target, const AppSettings& source, uint32_t fields);
+
+    // Replace out-of-range values with defaults
+    static void Validate(AppSettings& settings);
+    static bool IsValidTimeout(uint32_t timeoutSeconds) { return timeoutSeconds >= 1 && timeoutSeconds <= MAX_TIMEOUT_SECONDS; }
+    static bool IsValidBackend(uint32_t backend) { return backend < ACTIVITY_BACKEND_COUNT; }
+    static bool IsValidLogLevel(uint32_t level) { return level <= LOG_LEVEL_OFF; }
+
+    // Field bits, one per persisted value (row order of SETTINGS_FIELDS)
+    static const uint32_t FIELD_TIMEOUT = SettingFieldBit("Timeout");
+    static const uint32_t FIELD_MINIMIZE_TO_TRAY = SettingFieldBit("MinimizeToTray");
+    static const uint32_t FIELD_START_HIDDEN = SettingFieldBit("StartHidden");
+    static const uint32_t FIELD_START_MONITORING = SettingFieldBit("StartMonitoring");
+    static const uint32_t FIELD_START_WITH_WINDOWS = SettingFieldBit("StartWithWindows");
+    static const uint32_t FIELD_HOTKEY_MODIFIERS = SettingFieldBit("HotkeyModifiers");
+    static const uint32_t FIELD_HOTKEY_VK = SettingFieldBit("HotkeyVK");
+    static const uint32_t FIELD_ACTIVITY_BACKEND = SettingFieldBit("ActivityBackend");
+    static const uint32_t FIELD_LOG_LEVEL = SettingFieldBit("LogLevel");
+    static const uint32_t FIELD_LOW_FOOTPRINT = SettingFieldBit("LowFootprint");
+    static const uint32_t FIELD_ALL = (1u << SETTINGS_FIELD_COUNT) - 1;
+
+    // Value name of the schema version, stored next to the settings
+    static const char* const VALUE_VERSION;
+
+private:
+    // Private helpers
+    static bool WriteFields(ISettingsStore& store, const AppSettings& settings, uint32_t fields, bool stampVersion);
+};
\ No newline at end of file
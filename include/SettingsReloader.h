@@ -0,0 +1,40 @@
+#pragma once
+
+#include "SettingsModel.h"
+#include <cstdint>
+
+class ISettingsStore;
+class SettingsWriter;
+
+/**
+ * Incremental reload of settings changed outside the process
+ * Reload re-reads the store and merges it into the live settings; the
+ * returned FIELD_* bits are the only values whose owners need to re-apply
+ * them, so a reload that changed the timeout re-registers nothing else.
+ * With a writer, unsaved local edits win over the store (see
+ * SettingsWriter::Rebase) and the reload waits for a save in progress,
+ * since both use the same store. Runs on the thread that owns the settings
+ */
+class SettingsReloader
+{
+public:
+    SettingsReloader(ISettingsStore& store, SettingsWriter* writer = nullptr);
+
+    // ignoredFields keep their live value (state with another source of truth)
+    uint32_t Reload(AppSettings& settings, uint32_t ignoredFields = 0);
+
+    // Statistics
+    uint64_t GetReloads() const { return m_reloads; }
+    uint64_t GetUnchangedReloads() const { return m_unchangedReloads; }
+    uint64_t GetFieldsApplied() const { return m_fieldsApplied; }
+    uint64_t GetLastReloadUs() const { return m_lastReloadUs; }
+
+private:
+    // Member variables
+    ISettingsStore& m_store;
+    SettingsWriter* m_writer;
+    uint64_t m_reloads = 0;
+    uint64_t m_unchangedReloads = 0;
+    uint64_t m_fieldsApplied = 0;
+    uint64_t m_lastReloadUs = 0;
+};
\ No newline at end of file
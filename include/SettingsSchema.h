@@ -0,0 +1,167 @@
+#pragma once
+
+#include "CoreConfig.h"
+#include "HotkeyModel.h"
+#include <cstdint>
+
+/**
+ * Application settings, independent of where they are persisted
+ * Every member has a row in SETTINGS_FIELDS below; the defaults here must
+ * match the table, which is checked at compile time
+ */
+struct AppSettings
+{
+    uint32_t timeoutSeconds = DEFAULT_TIMEOUT_SECONDS;
+    bool minimizeToTray = true;
+    bool startHidden = false;
+    bool startMonitoring = false;
+    bool startWithWindows = false;
+    uint32_t hotkeyModifiers = HOTKEY_MOD_CONTROL | HOTKEY_MOD_SHIFT;
+    uint32_t hotkeyVK = 'M';
+    uint32_t activityBackend = ACTIVITY_BACKEND_HOOKS;
+    uint32_t logLevel = DEFAULT_LOG_LEVEL;
+    bool lowFootprint = false;
+};
+
+// Schema version stamped into stores on a full save; 0 means a store written before versioning
+const uint32_t SETTINGS_VERSION = 1;
+
+enum class SettingType : uint8_t
+{
+    UInt32,
+    Flag    // stored as 0 or 1, any non-zero value reads as true
+};
+
+/**
+ * One persisted setting: store value name, member, default, valid range and
+ * the schema version that introduced it
+ */
+struct SettingField
+{
+    const char* name;
+    SettingType type;
+    uint32_t AppSettings::*number;  // UInt32 fields
+    bool AppSettings::*flag;        // Flag fields
+    uint32_t defaultValue;
+    uint32_t minValue;
+    uint32_t maxValue;
+    uint32_t sinceVersion;
+
+    static constexpr SettingField UInt32(const char* name, uint32_t AppSettings::*member, uint32_t defaultValue,
+                                         uint32_t minValue, uint32_t maxValue, uint32_t sinceVersion)
+    {
+        return SettingField{ name, SettingType::UInt32, member, nullptr, defaultValue, minValue, maxValue, sinceVersion };
+    }
+
+    static constexpr SettingField Flag(const char* name, bool AppSettings::*member, bool defaultValue,
+                                       uint32_t sinceVersion)
+    {
+        return SettingField{ name, SettingType::Flag, nullptr, member, defaultValue ? 1u : 0u, 0, 1, sinceVersion };
+    }
+
+    constexpr uint32_t Get(const AppSettings& settings) const
+    {
+        return type == SettingType::Flag ? (settings.*flag ? 1u : 0u) : settings.*number;
+    }
+
+    void Set(AppSettings& settings, uint32_t value) const
+    {
+        if (type == SettingType::Flag)
+            settings.*flag = value != 0;
+        else
+            settings.*number = value;
+    }
+
+    constexpr bool IsValid(uint32_t value) const
+    {
+        return type == SettingType::Flag || (value >= minValue && value <= maxValue);
+    }
+};
+
+// One row per persisted value, in FIELD_* bit order (row i is bit 1 << i).
+// Adding a setting is a member in AppSettings and a row here; load, save,
+// validation, dirty tracking and migration all walk this table
+constexpr SettingField SETTINGS_FIELDS[] =
+{
+    SettingField::UInt32("Timeout", &AppSettings::timeoutSeconds, DEFAULT_TIMEOUT_SECONDS, 1, MAX_TIMEOUT_SECONDS, 1),
+    SettingField::Flag("MinimizeToTray", &AppSettings::minimizeToTray, true, 1),
+    SettingField::Flag("StartHidden", &AppSettings::startHidden, false, 1),
+    SettingField::Flag("StartMonitoring", &AppSettings::startMonitoring, false, 1),
+    SettingField::Flag("StartWithWindows", &AppSettings::startWithWindows, false, 1),
+    SettingField::UInt32("HotkeyModifiers", &AppSettings::hotkeyModifiers, HOTKEY_MOD_CONTROL | HOTKEY_MOD_SHIFT, 0,
+                         HOTKEY_MOD_ALT | HOTKEY_MOD_CONTROL | HOTKEY_MOD_SHIFT | HOTKEY_MOD_WIN, 1),
+    SettingField::UInt32("HotkeyVK", &AppSettings::hotkeyVK, 'M', 0x01, 0xFE, 1),
+    SettingField::UInt32("ActivityBackend", &AppSettings::activityBackend, ACTIVITY_BACKEND_HOOKS, 0,
+                         ACTIVITY_BACKEND_COUNT - 1, 1),
+    SettingField::UInt32("LogLevel", &AppSettings::logLevel, DEFAULT_LOG_LEVEL, 0, LOG_LEVEL_OFF, 1),
+    SettingField::Flag("LowFootprint", &AppSettings::lowFootprint, false, 1),
+};
+
+const uint32_t SETTINGS_FIELD_COUNT = sizeof(SETTINGS_FIELDS) / sizeof(SETTINGS_FIELDS[0]);
+
+// Compile-time lookups; an unknown name is a compile error where a constant is required
+constexpr bool SettingNameEquals(const char* a, const char* b)
+{
+    while (*a && *a == *b)
+    {
+        ++a;
+        ++b;
+    }
+    return *a == *b;
+}
+
+constexpr uint32_t SettingFieldIndex(const char* name)
+{
+    for (uint32_t i = 0; i < SETTINGS_FIELD_COUNT; ++i)
+    {
+        if (SettingNameEquals(SETTINGS_FIELDS[i].name, name))
+            return i;
+    }
+    throw "unknown setting name";
+}
+
+constexpr uint32_t SettingFieldBit(const char* name)
+{
+    return 1u << SettingFieldIndex(name);
+}
+
+// Table checks, evaluated by the static_asserts in SettingsModel.cpp
+constexpr bool SettingDefaultsMatch()
+{
+    constexpr AppSettings defaults{};
+    for (uint32_t i = 0; i < SETTINGS_FIELD_COUNT; ++i)
+    {
+        if (SETTINGS_FIELDS[i].Get(defaults) != SETTINGS_FIELDS[i].defaultValue ||
+            !SETTINGS_FIELDS[i].IsValid(SETTINGS_FIELDS[i].defaultValue))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr bool SettingNamesUnique()
+{
+    for (uint32_t i = 0; i < SETTINGS_FIELD_COUNT; ++i)
+    {
+        for (uint32_t j = i + 1; j < SETTINGS_FIELD_COUNT; ++j)
+        {
+            if (SettingNameEquals(SETTINGS_FIELDS[i].name, SETTINGS_FIELDS[j].name))
+                return false;
+        }
+    }
+    return true;
+}
+
+constexpr uint32_t SettingNameMaxLength()
+{
+    uint32_t longest = 0;
+    for (uint32_t i = 0; i < SETTINGS_FIELD_COUNT; ++i)
+    {
+        uint32_t length = 0;
+        while (SETTINGS_FIELDS[i].name[length])
+            ++length;
+        longest = length > longest ? length : longest;
+    }
+    return longest;
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Persistent key/value storage behind the settings model
+ * A load or save is bracketed by Open and Close so backends can hold one
+ * handle (registry key, file) for the whole pass
+ */
+class ISettingsStore
+{
+public:
+    virtual ~ISettingsStore() = default;
+
+    // forWrite creates the storage when it does not exist yet
+    virtual bool Open(bool forWrite) = 0;
+    virtual bool Close() = 0;
+
+    // Values are 32-bit unsigned; a missing or mistyped value reads as false
+    virtual bool ReadUInt32(const char* name, uint32_t& value) = 0;
+    virtual bool WriteUInt32(const char* name, uint32_t value) = 0;
+
+    // Batched access inside one Open/Close pass, for backends where each value is a round trip.
+    // ReadValues returns a mask with bit i set when names[i] was read (count <= 32)
+    virtual uint32_t ReadValues(const char* const* names, uint32_t* values, uint32_t count)
+    {
+        uint32_t found = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (ReadUInt32(names[i], values[i]))
+                found |= 1u << i;
+        }
+        return found;
+    }
+
+    virtual bool WriteValues(const char* const* names, const uint32_t* values, uint32_t count)
+    {
+        bool success = true;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            success &= WriteUInt32(names[i], values[i]);
+        }
+        return success;
+    }
+
+    // Provisioned stores (snapshots) reject Open(true); callers skip saving instead of retrying
+    virtual bool IsReadOnly() const { return false; }
+
+    // Stores that keep content between passes drop it, so the next Open sees an external change
+    virtual void Invalidate() {}
+};
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+/**
+ * Change notifications for the settings store, without polling
+ * A watcher thread blocks on inotify (Linux), a directory change
+ * notification or RegNotifyChangeKeyValue (Windows). Notifications are
+ * coalesced until SETTLE_MS pass without another one, so a management
+ * push writing several values causes one reload; the handler then runs on
+ * the watcher thread. Files are saved by rename, so their directory is
+ * watched; on Linux events are filtered by file name
+ */
+class SettingsWatcher
+{
+public:
+    typedef std::function<void()> ChangeHandler;
+
+    static const uint32_t SETTLE_MS = 20;
+
+    SettingsWatcher() = default;
+    ~SettingsWatcher();
+
+    SettingsWatcher(const SettingsWatcher&) = delete;
+    SettingsWatcher& operator=(const SettingsWatcher&) = delete;
+
+    // One source per watcher; a second Watch* call replaces the first
+    bool WatchFile(const std::string& path, ChangeHandler handler);
+#ifdef _WIN32
+    // A key under HKEY_CURRENT_USER, created when missing so it can be watched
+    bool WatchRegistryKey(const wchar_t* keyPath, ChangeHandler handler);
+#endif
+    void Stop();
+    bool IsWatching() const { return m_thread.joinable(); }
+
+    // Raw notifications, and handler calls after coalescing
+    uint64_t GetNotifications() const { return m_notifications.load(std::memory_order_relaxed); }
+    uint64_t GetChanges() const { return m_changes.load(std::memory_order_relaxed); }
+
+private:
+    // Private helpers
+    void Run();
+    bool Rearm();
+
+    // Member variables
+    ChangeHandler m_handler;
+    std::thread m_thread;
+    std::atomic<uint64_t> m_notifications{ 0 };
+    std::atomic<uint64_t> m_changes{ 0 };
+#ifdef _WIN32
+    void* m_stopEvent = nullptr;
+    void* m_changeHandle = nullptr; // directory notification, or the event the key signals
+    void* m_key = nullptr;          // HKEY when watching the registry
+#else
+    int m_inotifyFd = -1;
+    int m_stopFd = -1;
+    std::string m_fileName;
+#endif
+};
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "SettingsModel.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+class IClock;
+class ISettingsStore;
+
+/**
+ * Debounced, dirty-tracked settings persistence
+ * Submit records a settings snapshot and returns without touching the
+ * store; fields that differ from what the store last acknowledged are
+ * dirty. Once no change arrived for the debounce interval (at most
+ * MAX_DELAY_MS after the first unsaved change) the writer thread saves
+ * only the dirty fields in one store pass, so a burst of checkbox clicks
+ * becomes a single write of the values that actually changed. A failed
+ * write keeps its fields dirty and is retried after MAX_DELAY_MS
+ * Poll drives the same logic without the thread for headless runs
+ */
+class SettingsWriter
+{
+public:
+    static const uint32_t DEFAULT_DEBOUNCE_MS = 500;
+    static const uint32_t MAX_DELAY_MS = 5000;
+
+    SettingsWriter(ISettingsStore& store, IClock& clock, uint32_t debounceMs = DEFAULT_DEBOUNCE_MS);
+    ~SettingsWriter();
+
+    SettingsWriter(const SettingsWriter&) = delete;
+    SettingsWriter& operator=(const SettingsWriter&) = delete;
+
+    // What the store holds (after a load); drops anything dirty
+    void SetPersisted(const AppSettings& settings);
+
+    // The store changed underneath (hot reload): stored becomes the persisted state and its
+    // changes are merged into settings, except fields still dirty here, whose local value
+    // wins and is written over it. Returns the fields whose value in settings changed
+    uint32_t Rebase(const AppSettings& stored, AppSettings& settings);
+
+    // Any thread; never waits for the store
+    void Submit(const AppSettings& settings);
+
+    // Writer thread; Stop does not flush
+    bool Start();
+    void Stop();
+    bool IsRunning() const { return m_thread.joinable(); }
+
+    // Writes the dirty fields now, if any; false when the store rejected them
+    bool Flush();
+
+    // Keeps the writer out of the store while held; other users of the same store (a reload) take it
+    std::unique_lock<std::mutex> LockStore() { return std::unique_lock<std::mutex>(m_writeMutex); }
+
+    // Writes if the debounce deadline passed at nowMs; returns true when it wrote
+    bool Poll(uint64_t nowMs);
+
+    // State and statistics (any thread)
+    uint32_t GetDirtyFields() const;
+    uint64_t GetSubmits() const { return m_submits.load(std::memory_order_relaxed); }
+    uint64_t GetWrites() const { return m_writes.load(std::memory_order_relaxed); }
+    uint64_t GetValuesWritten() const { return m_valuesWritten.load(std::memory_order_relaxed); }
+    uint64_t GetFailures() const { return m_failures.load(std::memory_order_relaxed); }
+
+private:
+    // Private helpers
+    bool WriteDirty();
+    void Run();
+
+    // Member variables
+    ISettingsStore& m_store;
+    IClock& m_clock;
+    uint32_t m_debounceMs;
+
+    // Guarded by m_mutex
+    mutable std::mutex m_mutex;
+    AppSettings m_persisted;
+    AppSettings m_pending;
+    uint32_t m_dirty = 0;
+    uint64_t m_firstDirtyMs = 0;
+    uint64_t m_deadlineMs = 0;
+    bool m_stopRequested = false;
+
+    // One store pass at a time (writer thread, Flush and LockStore)
+    std::mutex m_writeMutex;
+    std::condition_variable m_wake;
+    std::thread m_thread;
+
+    std::atomic<uint64_t> m_submits{ 0 };
+    std::atomic<uint64_t> m_writes{ 0 };
+    std::atomic<uint64_t> m_valuesWritten{ 0 };
+    std::atomic<uint64_t> m_failures{ 0 };
+};
\ No newline at end of file
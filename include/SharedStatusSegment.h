@@ -0,0 +1,50 @@
+#pragma once
+
+#include "StatusPage.h"
+
+/**
+ * Named shared-memory mapping holding one StatusPage
+ * Windows uses a session-local file mapping (Local\<name>), Linux a POSIX
+ * shared-memory object (/dev/shm/<name>) whose default name carries the uid.
+ * The writer creates the segment and owns its lifetime; readers map it
+ * read-only. A writer never takes over a page whose writer is still running
+ */
+class SharedStatusSegment
+{
+public:
+    static const size_t MAX_NAME_LENGTH = 64;
+
+    // Default name of the current user; buffer holds MAX_NAME_LENGTH characters
+    static void GetDefaultName(char* buffer, size_t size);
+
+    SharedStatusSegment() = default;
+    ~SharedStatusSegment();
+
+    SharedStatusSegment(const SharedStatusSegment&) = delete;
+    SharedStatusSegment& operator=(const SharedStatusSegment&) = delete;
+
+    // Writer: create the segment, or take over one whose writer has exited, and
+    // initialize the page; false while another live writer owns the name.
+    // nullptr means the default name
+    bool Create(const char* name = nullptr);
+
+    // Reader: map an existing segment read-only
+    bool Open(const char* name = nullptr);
+
+    // Unmaps; the writer also removes the name so readers stop seeing stale data
+    void Close();
+
+    bool IsOpen() const { return m_page != nullptr; }
+    StatusPage* GetPage() { return m_page; }
+    const StatusPage* GetPage() const { return m_page; }
+
+private:
+    // Member variables
+    StatusPage* m_page = nullptr;
+    bool m_owner = false;
+#ifdef _WIN32
+    void* m_mapping = nullptr;
+#else
+    char m_name[MAX_NAME_LENGTH + 1] = {};
+#endif
+};
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * Fixed-size wait-free single-producer/single-consumer ring
+ * The producer never allocates, locks or waits: when the ring is full the
+ * item is dropped and counted. Each side caches the other side's index so
+ * the shared cache lines are only read when the cached view runs out
+ */
+template <typename T, size_t N>
+class SpscRing
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing items are copied with plain stores");
+
+public:
+    static const size_t CAPACITY = N;
+
+    SpscRing() = default;
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer side
+    bool TryPush(const T& item)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cachedTail == N)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cachedTail == N)
+            {
+                m_dropped.store(m_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        m_items[head & (N - 1)] = item;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; copies up to maxCount items and returns how many
+    size_t PopBatch(T* out, size_t maxCount)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (m_cachedHead == tail)
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (m_cachedHead == tail)
+                return 0;
+        }
+
+        size_t count = m_cachedHead - tail;
+        if (count > maxCount)
+            count = maxCount;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            out[i] = m_items[(tail + i) & (N - 1)];
+        }
+
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Statistics (any thread, approximate while both sides run)
+    size_t GetSize() const
+    {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+    uint64_t GetDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    // Producer line
+    alignas(64) std::atomic<size_t> m_head{ 0 };
+    size_t m_cachedTail = 0;
+    std::atomic<uint64_t> m_dropped{ 0 };
+
+    // Consumer line
+    alignas(64) std::atomic<size_t> m_tail{ 0 };
+    size_t m_cachedHead = 0;
+
+    alignas(64) T m_items[N];
+};
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Phase timestamps from process start to ready
+ * Begin anchors the clock at process creation; every Mark records the time
+ * since then under a phase name and logs it, so a slow logon start shows
+ * which phase waited. Phases live in a fixed table and are published with
+ * release stores, so other threads may read them while startup goes on.
+ * Phase names must be string literals; only the pointer is stored
+ */
+class StartupProfiler
+{
+public:
+    static const size_t MAX_PHASES = 16;
+
+    // Microsecond time source; steady_clock unless a test installs its own
+    typedef uint64_t (*NowUsFunction)();
+    static void SetClock(NowUsFunction nowUs);
+
+    // processAgeUs: how long the process existed before this call (loader, static init)
+    static void Begin(uint64_t processAgeUs);
+
+    // Startup thread only; phases past MAX_PHASES are dropped
+    static void Mark(const char* phase);
+
+    // Reading (any thread)
+    static size_t GetPhaseCount() { return s_count.load(std::memory_order_acquire); }
+    static const char* GetPhaseName(size_t index) { return s_names[index]; }
+    static uint64_t GetPhaseUs(size_t index) { return s_times[index]; }
+
+    // Time since process start of a phase, 0 when it was not marked
+    static uint64_t FindPhaseUs(const char* phase);
+
+    // Time between a phase and the one before it (or process start)
+    static uint64_t GetPhaseDurationUs(size_t index) { return s_times[index] - (index > 0 ? s_times[index - 1] : 0); }
+
+private:
+    // Private helpers
+    static uint64_t NowUs();
+
+    // Member variables
+    static NowUsFunction s_nowUs;
+    static uint64_t s_originUs;
+    static bool s_begun;
+    static const char* s_names[MAX_PHASES];
+    static uint64_t s_times[MAX_PHASES];
+    static std::atomic<size_t> s_count;
+};
\ No newline at end of file
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Application state as seen by monitoring agents
+ * Every field is 64 bits wide so the page layout is identical for 32- and
+ * 64-bit processes; times are on the MonotonicNowMs() base
+ */
+struct StatusSnapshot
+{
+    // Published by the UI thread when monitoring state changes or a deadline expires
+    struct State
+    {
+        uint64_t monitoring;
+        uint64_t backend;
+        uint64_t timeoutSeconds;
+        uint64_t nextDeadlineMs;
+        uint64_t idleActions;
+        uint64_t hookIncidents;
+        uint64_t wakeupsPerHour;
+        uint64_t wakeups;
+    } state;
+
+    // Published by the drain thread after every pass
+    struct Input
+    {
+        uint64_t lastActivityMs;
+        uint64_t eventsPerSecond;
+        uint64_t processedPerSecond;
+        uint64_t coalescedPerSecond;
+        uint64_t droppedEvents;
+        uint64_t mouseHookP99Ns;
+        uint64_t keyboardHookP99Ns;
+    } input;
+
+    // Filled in by the publisher
+    uint64_t publishedMs;
+    uint64_t publishCount;
+    uint64_t writerPid;
+
+    // Version 2, published by the UI thread: 1 while input analytics are off
+    // (low-footprint mode), so the input fields stay 0 and no metrics are exported
+    uint64_t inputAnalyticsOff;
+};
+
+/**
+ * Fixed-layout, versioned status page living in shared memory
+ * One writer at a time publishes through a seqlock: the sequence is odd
+ * while fields change, and readers retry when it was odd or moved during
+ * their copy. Reading costs a few loads: no syscall, no lock, no IPC.
+ * New fields are appended inside the reserved slots and bump VERSION;
+ * readers use fieldCount to ignore slots they do not know
+ */
+struct StatusPage
+{
+    static const uint32_t MAGIC = 0x53414D4D; // "MMAS" in memory order
+    static const uint32_t VERSION = 2;
+    static const size_t FIELD_SLOTS = 56;
+    static const size_t FIELD_COUNT = sizeof(StatusSnapshot) / sizeof(uint64_t);
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;
+    uint32_t fieldCount;
+    std::atomic<uint64_t> sequence;
+    uint64_t reserved[5];
+    std::atomic<uint64_t> fields[FIELD_SLOTS];
+
+    // Writer side: stamp the header of a freshly mapped page
+    static void Initialize(StatusPage& page)
+    {
+        page.sequence.store(0, std::memory_order_relaxed);
+        for (size_t i = 0; i < FIELD_SLOTS; ++i)
+        {
+            page.fields[i].store(0, std::memory_order_relaxed);
+        }
+        page.version = VERSION;
+        page.size = sizeof(StatusPage);
+        page.fieldCount = static_cast<uint32_t>(FIELD_COUNT);
+
+        // Magic last, so a reader never accepts a half-initialized page
+        std::atomic_thread_fence(std::memory_order_release);
+        page.magic = MAGIC;
+    }
+
+    // Writer side (callers serialize writers)
+    static void Write(StatusPage& page, const StatusSnapshot& snapshot)
+    {
+        uint64_t values[FIELD_COUNT];
+        memcpy(values, &snapshot, sizeof(values));
+
+        uint64_t sequence = page.sequence.load(std::memory_order_relaxed);
+        page.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < FIELD_COUNT; ++i)
+        {
+            page.fields[i].store(values[i], std::memory_order_relaxed);
+        }
+
+        page.sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Reader side; false when the page is foreign or no stable copy was seen
+    static bool Read(const StatusPage& page, StatusSnapshot& snapshot, uint32_t maxAttempts = 1000)
+    {
+        if (page.magic != MAGIC || page.version < 1)
+            return false;
+
+        // Newer writers may publish more fields than this reader knows
+        size_t count = page.fieldCount < FIELD_COUNT ? page.fieldCount : FIELD_COUNT;
+        uint64_t values[FIELD_COUNT] = { 0 };
+
+        for (uint32_t attempt = 0; attempt < maxAttempts; ++attempt)
+        {
+            uint64_t before = page.sequence.load(std::memory_order_acquire);
+            if (before & 1)
+                continue;
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                values[i] = page.fields[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (page.sequence.load(std::memory_order_relaxed) == before)
+            {
+                memcpy(&snapshot, values, sizeof(values));
+                return true;
+            }
+        }
+
+        return false;
+    }
+};
+
+static_assert(sizeof(StatusSnapshot) % sizeof(uint64_t) == 0, "StatusSnapshot must be made of 64-bit fields");
+static_assert(StatusPage::FIELD_COUNT <= StatusPage::FIELD_SLOTS, "StatusPage is out of reserved slots");
+static_assert(sizeof(StatusPage) == 512, "StatusPage layout is part of the reader contract");
+static_assert(offsetof(StatusPage, fields) == 64, "StatusPage layout is part of the reader contract");
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "Shared atomics must be plain 64-bit words");
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "SharedStatusSegment.h"
+#include "StatusPage.h"
+#include <mutex>
+
+/**
+ * Keeps the shared status page current for external monitoring agents
+ * The UI thread publishes state changes and the drain thread publishes
+ * input rates; each call rewrites the whole page under one seqlock write,
+ * so a reader never sees state from one publish and rates from another.
+ * Without a segment (Open failed or never called) publishing is a no-op
+ */
+class StatusPublisher
+{
+public:
+    StatusPublisher() = default;
+
+    StatusPublisher(const StatusPublisher&) = delete;
+    StatusPublisher& operator=(const StatusPublisher&) = delete;
+
+    // Segment lifetime
+    bool Open(const char* name = nullptr);
+    void Close();
+    bool IsOpen() const { return m_segment.IsOpen(); }
+
+    // Publishing (any thread)
+    void PublishState(const StatusSnapshot::State& state);
+    void PublishInput(const StatusSnapshot::Input& input);
+    void PublishInputAnalytics(bool enabled);
+
+    // Last published values
+    StatusSnapshot GetSnapshot() const;
+
+private:
+    // Private helpers
+    void WriteLocked();
+
+    // Member variables
+    SharedStatusSegment m_segment;
+    mutable std::mutex m_mutex;
+    StatusSnapshot m_snapshot = {};
+};
\ No newline at end of file
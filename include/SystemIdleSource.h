@@ -0,0 +1,20 @@
+#pragma once
+
+#include "common.h"
+#include "IdleSource.h"
+
+/**
+ * Idle source backed by GetLastInputInfo
+ * Needs no hooks and no thread; the session's input clock is read on demand
+ */
+class SystemIdleSource : public IIdleSource
+{
+public:
+    SystemIdleSource() = default;
+    ~SystemIdleSource() override = default;
+
+    // IIdleSource
+    bool Open() override;
+    void Close() override;
+    bool QueryLastInputTime(uint64_t& lastInputMs) override;
+};
\ No newline at end of file
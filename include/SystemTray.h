@@ -39,4 +39,5 @@ private:
     NOTIFYICONDATAW m_notifyIconData;
     bool m_iconAdded = false;
     HWND m_mainDialog = nullptr;
+    HMENU m_menu = nullptr; // loaded on the first right-click, kept until exit unless low-footprint
 };
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "DeadlineTimer.h"
+
+/**
+ * Linux deadline timer backed by a CLOCK_MONOTONIC timerfd
+ * The descriptor is pollable; expiry is consumed with ConsumeExpiration
+ */
+class TimerFdDeadlineTimer : public IDeadlineTimer
+{
+public:
+    TimerFdDeadlineTimer();
+    ~TimerFdDeadlineTimer() override;
+
+    TimerFdDeadlineTimer(const TimerFdDeadlineTimer&) = delete;
+    TimerFdDeadlineTimer& operator=(const TimerFdDeadlineTimer&) = delete;
+
+    // IDeadlineTimer
+    bool Arm(uint64_t deadlineMs) override;
+    void Disarm() override;
+
+    // Poll integration
+    int GetFd() const { return m_fd; }
+    bool ConsumeExpiration();
+
+    // Number of times the kernel timer was programmed
+    uint64_t GetArmCount() const { return m_armCount; }
+
+private:
+    // Member variables
+    int m_fd = -1;
+    uint64_t m_armCount = 0;
+};
\ No newline at end of file
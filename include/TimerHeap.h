@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Indexed binary min-heap of deadlines keyed by dense ids
+ * Lets one kernel timer serve any number of idle schedulers: only the
+ * earliest deadline is ever armed, and rescheduling an id is O(log n)
+ */
+class TimerHeap
+{
+public:
+    static const uint32_t NOT_SCHEDULED = UINT32_MAX;
+
+    TimerHeap() = default;
+
+    // Capacity
+    void Reserve(size_t ids);
+    size_t GetSize() const { return m_entries.size(); }
+    bool IsEmpty() const { return m_entries.empty(); }
+    static size_t GetBytesPerId();
+
+    // Scheduling (replaces any pending deadline for the id)
+    void Schedule(uint32_t id, uint64_t deadlineMs);
+    void Cancel(uint32_t id);
+    bool IsScheduled(uint32_t id) const;
+
+    // Expiry
+    uint64_t GetEarliest() const { return m_entries.front().deadlineMs; }
+    bool PopExpired(uint64_t nowMs, uint32_t& id);
+
+private:
+    struct Entry
+    {
+        uint64_t deadlineMs;
+        uint32_t id;
+    };
+
+    // Private helpers
+    void SiftUp(size_t pos);
+    void SiftDown(size_t pos);
+    void Place(size_t pos, const Entry& entry);
+    void RemoveAt(size_t pos);
+
+    // Member variables
+    std::vector<Entry> m_entries;
+    std::vector<uint32_t> m_positions; // id -> index in m_entries
+};
\ No newline at end of file
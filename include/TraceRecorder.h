@@ -0,0 +1,165 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define MMA_TRACE_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define MMA_TRACE_TSC 1
+#endif
+
+/**
+ * Flight recorder for explaining idle decisions after the fact
+ * Every thread records into its own fixed-size ring, so an event costs a
+ * timestamp read and a few relaxed stores with no locks and no shared
+ * cache lines. Names must be string literals; only the pointer is stored.
+ * The rings export as Chrome trace-event JSON, which Perfetto and
+ * chrome://tracing open directly
+ * Record through the MMA_TRACE_* macros: they compile to nothing unless
+ * MMA_ENABLE_TRACE is defined
+ */
+class TraceRecorder
+{
+public:
+    static const size_t EVENTS_PER_THREAD = 4096;
+    static const size_t MAX_THREADS = 16;
+
+    // Recording (any thread; a thread past MAX_THREADS records nothing)
+    static void Instant(const char* name, uint64_t arg = 0)
+    {
+        Record(name, NowTicks(), INSTANT, arg);
+    }
+
+    static void Complete(const char* name, uint64_t startTicks, uint64_t arg = 0)
+    {
+        uint64_t now = NowTicks();
+        Record(name, startTicks, now - startTicks, arg);
+    }
+
+    // Shown as the thread's track name in the viewer
+    static void SetThreadName(const char* name);
+
+    // Raw timestamp: the TSC on x86, steady_clock nanoseconds elsewhere
+    static uint64_t NowTicks()
+    {
+#ifdef MMA_TRACE_TSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // Export (any thread); events overwritten while copying are skipped
+    static bool WriteChromeJson(FILE* file);
+
+    // Events currently held across all rings
+    static size_t GetEventCount();
+
+private:
+    // Duration value marking an instant event
+    static const uint64_t INSTANT = UINT64_MAX;
+
+    // Fields are relaxed atomics so the exporter may read a ring while its owner writes
+    struct Slot
+    {
+        std::atomic<uint64_t> ticks{ 0 };
+        std::atomic<uint64_t> duration{ 0 };
+        std::atomic<uint64_t> arg{ 0 };
+        std::atomic<const char*> name{ nullptr };
+    };
+
+    struct ThreadRing
+    {
+        std::atomic<uint64_t> head{ 0 };
+        std::atomic<const char*> threadName{ nullptr };
+        bool inUse = false;
+        Slot slots[EVENTS_PER_THREAD];
+    };
+
+    static_assert((EVENTS_PER_THREAD & (EVENTS_PER_THREAD - 1)) == 0, "EVENTS_PER_THREAD must be a power of two");
+
+    static void Record(const char* name, uint64_t ticks, uint64_t duration, uint64_t arg)
+    {
+        ThreadRing* ring = t_ring;
+        if (!ring && !(ring = AttachThread()))
+            return;
+
+        // Single writer: plain load+store of head, release publishes the slot;
+        // the fence orders the slot stores after the previous head store, so an
+        // exporter that copied any of them also sees head at this index and
+        // drops the event being overwritten (the order StatusPage::Write uses)
+        uint64_t head = ring->head.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        Slot& slot = ring->slots[head & (EVENTS_PER_THREAD - 1)];
+        slot.ticks.store(ticks, std::memory_order_relaxed);
+        slot.duration.store(duration, std::memory_order_relaxed);
+        slot.arg.store(arg, std::memory_order_relaxed);
+        slot.name.store(name, std::memory_order_relaxed);
+        ring->head.store(head + 1, std::memory_order_release);
+    }
+
+    // Private helpers
+    static ThreadRing* AttachThread();
+    static void DetachThread(ThreadRing* ring);
+
+    friend class TraceThreadHandle;
+
+    // Trivially initialized so the hot path needs no TLS guard
+    static thread_local ThreadRing* t_ring;
+
+    // Rings are never freed: a ring released by an exiting thread keeps its
+    // events until a new thread takes it over
+    static std::mutex s_ringMutex;
+    static ThreadRing* s_rings[MAX_THREADS];
+    static size_t s_ringCount;
+
+    // Tick-to-time calibration point, taken when the first thread attaches
+    static uint64_t s_originTicks;
+    static std::chrono::steady_clock::time_point s_originTime;
+};
+
+/**
+ * Records one complete event covering its own lifetime
+ */
+class TraceScope
+{
+public:
+    explicit TraceScope(const char* name, uint64_t arg = 0)
+        : m_name(name)
+        , m_arg(arg)
+        , m_start(TraceRecorder::NowTicks())
+    {
+    }
+
+    ~TraceScope() { TraceRecorder::Complete(m_name, m_start, m_arg); }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* m_name;
+    uint64_t m_arg;
+    uint64_t m_start;
+};
+
+#ifdef MMA_ENABLE_TRACE
+#define MMA_TRACE_CONCAT_INNER(a, b) a##b
+#define MMA_TRACE_CONCAT(a, b) MMA_TRACE_CONCAT_INNER(a, b)
+#define MMA_TRACE_SCOPE(name) TraceScope MMA_TRACE_CONCAT(mmaTraceScope, __LINE__)(name)
+#define MMA_TRACE_SCOPE_ARG(name, arg) TraceScope MMA_TRACE_CONCAT(mmaTraceScope, __LINE__)(name, arg)
+#define MMA_TRACE_INSTANT(name, arg) TraceRecorder::Instant(name, arg)
+#define MMA_TRACE_THREAD(name) TraceRecorder::SetThreadName(name)
+#else
+#define MMA_TRACE_SCOPE(name) ((void)0)
+#define MMA_TRACE_SCOPE_ARG(name, arg) ((void)0)
+#define MMA_TRACE_INSTANT(name, arg) ((void)0)
+#define MMA_TRACE_THREAD(name) ((void)0)
+#endif
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "common.h"
+#include "CursorDriver.h"
+
+/**
+ * Cursor driver for the primary monitor using SetCursorPos
+ */
+class Win32CursorDriver : public ICursorDriver
+{
+public:
+    Win32CursorDriver() = default;
+    ~Win32CursorDriver() override = default;
+
+    // ICursorDriver
+    bool GetBounds(int& left, int& top, int& width, int& height) override;
+    bool MoveTo(int x, int y) override;
+};
\ No newline at end of file
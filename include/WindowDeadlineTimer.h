@@ -0,0 +1,24 @@
+#pragma once
+
+#include "common.h"
+#include "DeadlineTimer.h"
+
+/**
+ * Deadline timer backed by SetTimer on the main dialog
+ * Expiry arrives as WM_TIMER with ACTIVITY_TIMER_ID
+ */
+class WindowDeadlineTimer : public IDeadlineTimer
+{
+public:
+    WindowDeadlineTimer() = default;
+    ~WindowDeadlineTimer() override;
+
+    // IDeadlineTimer
+    bool Arm(uint64_t deadlineMs) override;
+    void Disarm() override;
+
+private:
+    // Member variables
+    HWND m_targetWindow = nullptr;
+    UINT_PTR m_timerId = 0;
+};
\ No newline at end of file
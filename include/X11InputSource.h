@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CursorDriver.h"
+#include "InputSource.h"
+#include <atomic>
+#include <cstdint>
+
+struct _XDisplay;
+struct InputEvent;
+
+/**
+ * X11 backend covering both halves of activity monitoring
+ * Activity: XInput2 2.2 raw events (XI_RawMotion, XI_RawKeyPress, raw touch,
+ * ...) selected on the root window. Cursor: XTestFakeMotionEvent across the root geometry.
+ * One Display connection is served by a single poll loop on the input
+ * thread; cursor moves requested from other threads are handed over through
+ * an eventfd so Xlib is never used concurrently and no request waits for a reply
+ */
+class X11InputSource : public IInputSource, public ICursorDriver
+{
+public:
+    // displayName of nullptr uses $DISPLAY
+    explicit X11InputSource(const char* displayName = nullptr);
+    ~X11InputSource() override;
+
+    X11InputSource(const X11InputSource&) = delete;
+    X11InputSource& operator=(const X11InputSource&) = delete;
+
+    // IInputSource
+    bool Open() override;
+    void Pump(InputDispatch& dispatch) override;
+    void Wake() override;
+    void Close() override;
+
+    // ICursorDriver (any thread, applied by the input thread)
+    bool GetBounds(int& left, int& top, int& width, int& height) override;
+    bool MoveTo(int x, int y) override;
+
+    // Translate one XI2 raw event; false for event types we do not track
+    static bool Decode(int evtype, int sourceId, int detail, uint64_t timestampMs, InputEvent& event);
+
+private:
+    // Private helpers
+    void DrainEvents(InputDispatch& dispatch);
+    void HandleRequests();
+
+    // Member variables
+    const char* m_displayName;
+    _XDisplay* m_display = nullptr;
+    int m_xiOpcode = 0;
+    bool m_hasXTest = false;
+    int m_wakeFd = -1;
+    int m_rootWidth = 0;
+    int m_rootHeight = 0;
+
+    // Cross-thread requests, signalled through m_wakeFd
+    std::atomic<bool> m_stopRequested{ false };
+    std::atomic<bool> m_movePending{ false };
+    std::atomic<int> m_moveX{ 0 };
+    std::atomic<int> m_moveY{ 0 };
+};
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "IdleSource.h"
+
+struct _XDisplay;
+
+/**
+ * X11 idle source backed by the MIT-SCREEN-SAVER extension
+ * One XScreenSaverQueryInfo round-trip per deadline, nothing per input event
+ */
+class XScreenSaverIdleSource : public IIdleSource
+{
+public:
+    // displayName of nullptr uses $DISPLAY
+    explicit XScreenSaverIdleSource(const char* displayName = nullptr);
+    ~XScreenSaverIdleSource() override;
+
+    XScreenSaverIdleSource(const XScreenSaverIdleSource&) = delete;
+    XScreenSaverIdleSource& operator=(const XScreenSaverIdleSource&) = delete;
+
+    // IIdleSource
+    bool Open() override;
+    void Close() override;
+    bool QueryLastInputTime(uint64_t& lastInputMs) override;
+
+private:
+    // Member variables
+    const char* m_displayName;
+    _XDisplay* m_display = nullptr;
+    void* m_info = nullptr; // XScreenSaverInfo (anonymous typedef, cannot be forward declared)
+};
\ No newline at end of file
@@ -1,8 +1,9 @@
 #pragma once
 
 #include "framework.h"
+#include "CoreConfig.h"
+#include "HotkeyModel.h"
 #include <time.h>
-#include <random>
 #include <shellapi.h>
 #include <windows.h>
 
@@ -21,21 +22,14 @@ extern ApplicationManager* g_pApp;
 
 // Constants
 const UINT WM_TRAYICON = WM_USER + 1;
-const DWORD DEFAULT_TIMEOUT_SECONDS = 5;
-const DWORD MAX_TIMEOUT_SECONDS = 3600;
+const UINT WM_SETTINGS_CHANGED = WM_USER + 2;
+const UINT WM_CONTROL_REQUEST = WM_USER + 3;
+const UINT_PTR ACTIVITY_TIMER_ID = 1;
 
 // Single instance constants
 const LPCWSTR APP_MUTEX_NAME = L"Global\\MMAApplication_SingleInstance_Mutex";
 const LPCWSTR APP_NAME = L"Mouse & Keyboard Activity Monitor";
 const LPCWSTR APP_SHORT_NAME = L"MMA";
 
-// Key mapping structure for hotkey selection
-struct KeyMapping 
-{
-    UINT vk;
-    const WCHAR* name;
-};
-
-// Declare the key mappings array as extern
-extern const KeyMapping g_keyMappings[];
-extern const int g_keyMappingsCount;
\ No newline at end of file
+// Hidden window carrying tray, hotkey and timer messages when starting hidden
+const LPCWSTR APP_WINDOW_CLASS = L"MMAMessageWindow";
\ No newline at end of file
@@ -40,6 +40,7 @@
 #define IDM_TRAY_SHOW                   32772
 #define IDM_TRAY_EXIT                   32773
 #define IDM_TRAY_ABOUT					32774
+#define IDM_TRAY_SAVE_TRACE             32775
 #define IDC_STATIC                      -1
 
 // Next default values for new objects
@@ -48,7 +49,7 @@
 #ifndef APSTUDIO_READONLY_SYMBOLS
 #define _APS_NO_MFC                     1
 #define _APS_NEXT_RESOURCE_VALUE        131
-#define _APS_NEXT_COMMAND_VALUE         32775
+#define _APS_NEXT_COMMAND_VALUE         32776
 #define _APS_NEXT_CONTROL_VALUE         1012
 #define _APS_NEXT_SYMED_VALUE           110
 #endif
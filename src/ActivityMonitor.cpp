@@ -1,23 +1,57 @@
 #include "ActivityMonitor.h"
+#include "AllocationAudit.h"
 #include "ApplicationManager.h"
 #include "SystemTray.h"
 #include "SettingsManager.h"
+#include "HookInputSource.h"
+#include "Logger.h"
+#include "MonotonicClock.h"
+#include "RawInputSource.h"
+#include "SystemIdleSource.h"
+#include "Win32CursorDriver.h"
+#include "WindowDeadlineTimer.h"
 #include "resource.h"
 
-// Static member definition
-ActivityMonitor* ActivityMonitor::s_instance = nullptr;
-
 ActivityMonitor::ActivityMonitor() 
-    : m_randomGenerator(m_randomDevice())
+    : m_deadlineTimer(std::make_unique<WindowDeadlineTimer>())
+    , m_cursorDriver(std::make_unique<Win32CursorDriver>())
+    , m_inputDispatch(m_activityChannel)
+    , m_idleSource(std::make_unique<SystemIdleSource>())
+    , m_hookWatchdog(*m_idleSource, m_activityChannel)
+    , m_engine(m_clock, *m_deadlineTimer, *m_cursorDriver, m_activityChannel)
 {
-    s_instance = this;
+    m_drainThread.AddConsumer(&m_inputStatistics);
+    m_drainThread.AddConsumer(&m_idlePeriodStatistics);
+    m_hookWatchdog.SetReinstallAction([this] { return ReinstallHooks(); });
+    m_drainThread.SetPassCallback([this]
+    {
+        PublishInput();
+        ExportMetrics();
+    });
     UpdateActivityTime();
+
+    // Monitoring agents are optional; the app runs the same without the page
+    if (!m_statusPublisher.Open())
+        MMA_LOG_WARNING("Status page unavailable; monitoring agents cannot read MMA state");
+    PublishState();
+
+    // Fleet deployments point this at the node/windows_exporter textfile directory
+    WCHAR metricsPath[MAX_PATH];
+    DWORD length = GetEnvironmentVariableW(L"MMA_METRICS_FILE", metricsPath, MAX_PATH);
+    if (length > 0 && length < MAX_PATH)
+    {
+        char utf8Path[MAX_PATH * 3];
+        if (WideCharToMultiByte(CP_UTF8, 0, metricsPath, -1, utf8Path, sizeof(utf8Path), nullptr, nullptr) > 0)
+        {
+            m_metricsWriter.SetPath(utf8Path);
+        }
+    }
 }
 
 ActivityMonitor::~ActivityMonitor()
 {
     StopMonitoring();
-    s_instance = nullptr;
+    m_statusPublisher.Close();
 }
 
 bool ActivityMonitor::StartMonitoring()
@@ -35,28 +69,58 @@ bool ActivityMonitor::StartMonitoring()
         UINT timeout = GetDlgItemInt(hDlg, IDC_TIMEOUT_EDIT, &translated, FALSE);
         if (translated && timeout > 0 && timeout <= MAX_TIMEOUT_SECONDS)
         {
-            m_timeoutSeconds = timeout;
+            m_engine.SetTimeout(timeout);
         }
     }
 
-    // Install hooks
-    if (!InstallHooks())
+    // The input thread starts below, so the ring must be in place first
+    if (!m_lowFootprint && !m_eventRing)
+    {
+        m_eventRing = std::make_unique<InputEventRing>();
+        m_inputDispatch.SetEventRing(m_eventRing.get(), &m_drainThread);
+    }
+
+    // Without the ring nothing publishes input rates or writes metrics; tell readers
+    m_statusPublisher.PublishInputAnalytics(m_eventRing != nullptr);
+    if (!m_eventRing && m_metricsWriter.HasPath())
+        MMA_LOG_WARNING("Low-footprint mode: input analytics and the MMA_METRICS_FILE export are off");
+
+    // Install hooks or open the idle clock
+    if (!StartActivitySource())
     {
+        MMA_LOG_ERROR("Activity backend %u failed to start", m_activityBackend);
         MessageBoxW(app.GetMainDialog(), 
-            L"Failed to install system hooks. Try running as administrator.", 
+            m_activityBackend == ACTIVITY_BACKEND_IDLE_CLOCK
+                ? L"Failed to read the system idle time."
+                : L"Failed to install system hooks. Try running as administrator.", 
             L"Error", MB_OK | MB_ICONERROR);
         return false;
     }
 
     m_isMonitoring = true;
     UpdateActivityTime();
+    MMA_LOG_INFO("Monitoring started (backend %u, timeout %u s)", m_activityBackend, m_engine.GetTimeout());
+
+    // Analytics run beside monitoring and never hold up the input thread. An idle
+    // session only wakes the drain thread when metrics are exported, once per export
+    if (m_eventRing)
+    {
+        uint32_t idleTimeoutMs = EventDrainThread::DEFAULT_IDLE_TIMEOUT_MS;
+        if (m_metricsWriter.HasPath())
+            idleTimeoutMs = static_cast<uint32_t>(METRICS_INTERVAL_MS);
+        m_drainThread.Start(m_eventRing.get(), EventDrainThread::DEFAULT_INTERVAL_MS, idleTimeoutMs);
+    }
     
     // Start timer
     StartTimer();
     
     // Update tray icon
     app.GetSystemTray()->SetMonitoringState(true);
-    
+
+    PublishState();
+
+    // Everything monitoring needs exists now; from here on hooks and ticks must not allocate
+    MMA_ALLOC_AUDIT_ARM();
     return true;
 }
 
@@ -66,9 +130,16 @@ void ActivityMonitor::StopMonitoring()
         return;
 
     m_isMonitoring = false;
+    MMA_ALLOC_AUDIT_DISARM();
+    MMA_LOG_INFO("Monitoring stopped after %llu idle actions", m_engine.GetScheduler().GetActions());
+#ifdef MMA_ALLOC_AUDIT
+    MMA_LOG_INFO("Allocation audit: %llu allocations, %llu in no-alloc scopes",
+        AllocationAudit::GetAllocations(), AllocationAudit::GetViolations());
+#endif
 
-    // Remove hooks
-    UninstallHooks();
+    // Remove hooks or close the idle clock
+    StopActivitySource();
+    m_drainThread.Stop();
     
     // Stop timer
     StopTimer();
@@ -76,11 +147,13 @@ void ActivityMonitor::StopMonitoring()
     // Update tray icon
     auto& app = ApplicationManager::GetInstance();
     app.GetSystemTray()->SetMonitoringState(false);
+
+    PublishState();
 }
 
 void ActivityMonitor::UpdateActivityTime()
 {
-    m_lastActivityTime = GetTickCount();
+    m_engine.NoteActivity();
 }
 
 void ActivityMonitor::CheckActivity()
@@ -88,28 +161,75 @@ void ActivityMonitor::CheckActivity()
     if (!m_isMonitoring)
         return;
 
-    DWORD currentTime = GetTickCount();
-    DWORD elapsed = (currentTime - m_lastActivityTime) / 1000; // Convert to seconds
+    // The timer tick of the UI thread: steady state while monitoring
+    MMA_NO_ALLOC_SCOPE("check_activity");
 
-    if (elapsed >= m_timeoutSeconds)
+    // Hookless backend: the OS idle clock is only read at the deadline
+    if (m_activityBackend == ACTIVITY_BACKEND_IDLE_CLOCK)
+    {
+        uint64_t lastInputMs;
+        if (m_idleSource->QueryLastInputTime(lastInputMs))
+        {
+            m_activityChannel.Publish(lastInputMs);
+        }
+    }
+    else if (m_activityBackend == ACTIVITY_BACKEND_HOOKS)
     {
-        MoveMouse();
-        UpdateActivityTime(); // Reset timer after moving mouse
+        // Input the system saw but the hooks missed means they were dropped
+        m_hookWatchdog.Check();
     }
+
+    // Runs only when the armed deadline expires
+    m_engine.OnDeadline();
+    PublishState();
 }
 
 void ActivityMonitor::SetTimeout(DWORD timeoutSeconds)
 {
     if (timeoutSeconds > 0 && timeoutSeconds <= MAX_TIMEOUT_SECONDS)
     {
-        m_timeoutSeconds = timeoutSeconds;
-        
-        // Reset activity timer if monitoring is active
-        if (m_isMonitoring)
+        m_engine.SetTimeout(timeoutSeconds);
+        PublishState();
+    }
+}
+
+void ActivityMonitor::SetActivityBackend(DWORD backend)
+{
+    if (backend >= ACTIVITY_BACKEND_COUNT || backend == m_activityBackend)
+        return;
+
+    // Switch sources in place when monitoring is already running
+    if (m_isMonitoring)
+    {
+        StopActivitySource();
+        m_activityBackend = backend;
+        if (!StartActivitySource())
         {
-            UpdateActivityTime();
+            MMA_LOG_ERROR("Activity backend %u failed to start; monitoring stopped", backend);
+            StopMonitoring();
         }
     }
+    else
+    {
+        m_activityBackend = backend;
+    }
+
+    PublishState();
+}
+
+ULONGLONG ActivityMonitor::GetWakeupsPerHour() const
+{
+    return m_engine.GetWakeupsPerHour();
+}
+
+ULONGLONG ActivityMonitor::GetProcessedEventsPerSecond() const
+{
+    return m_activityChannel.GetProcessedPerSecond();
+}
+
+ULONGLONG ActivityMonitor::GetCoalescedEventsPerSecond() const
+{
+    return m_activityChannel.GetCoalescedPerSecond();
 }
 
 bool ActivityMonitor::ApplyTimeoutSetting()
@@ -128,7 +248,7 @@ bool ActivityMonitor::ApplyTimeoutSetting()
         MessageBoxW(hDlg, L"Please enter a valid number for the timeout value.", 
                    L"Invalid Input", MB_OK | MB_ICONWARNING);
         // Reset to current value
-        SetDlgItemInt(hDlg, IDC_TIMEOUT_EDIT, m_timeoutSeconds, FALSE);
+        SetDlgItemInt(hDlg, IDC_TIMEOUT_EDIT, GetTimeout(), FALSE);
         return false;
     }
     
@@ -137,7 +257,7 @@ bool ActivityMonitor::ApplyTimeoutSetting()
         MessageBoxW(hDlg, L"Timeout must be between 1 and 3600 seconds (1 hour).", 
                    L"Invalid Range", MB_OK | MB_ICONWARNING);
         // Reset to current value
-        SetDlgItemInt(hDlg, IDC_TIMEOUT_EDIT, m_timeoutSeconds, FALSE);
+        SetDlgItemInt(hDlg, IDC_TIMEOUT_EDIT, GetTimeout(), FALSE);
         return false;
     }
     
@@ -156,84 +276,154 @@ bool ActivityMonitor::ApplyTimeoutSetting()
 
 void ActivityMonitor::MoveMouse()
 {
-    // Get screen dimensions
-    int screenWidth = GetSystemMetrics(SM_CXSCREEN);
-    int screenHeight = GetSystemMetrics(SM_CYSCREEN);
-
-    // Generate random position
-    std::uniform_int_distribution<> xDist(0, screenWidth - 1);
-    std::uniform_int_distribution<> yDist(0, screenHeight - 1);
-    
-    int newX = xDist(m_randomGenerator);
-    int newY = yDist(m_randomGenerator);
-
-    // Move mouse cursor
-    SetCursorPos(newX, newY);
+    m_engine.MoveCursor();
 }
 
-LRESULT CALLBACK ActivityMonitor::MouseHookProc(int nCode, WPARAM wParam, LPARAM lParam)
+bool ActivityMonitor::StartActivitySource()
 {
-    if (nCode >= 0 && s_instance)
+    switch (m_activityBackend)
     {
-        s_instance->UpdateActivityTime();
+    case ACTIVITY_BACKEND_IDLE_CLOCK:
+        return m_idleSource->Open();
+
+    case ACTIVITY_BACKEND_RAW_INPUT:
+        m_inputSource = std::make_unique<RawInputSource>();
+        break;
+
+    default:
+        // The idle clock is only read by the watchdog; hooks work without it
+        m_idleSource->Open();
+        m_inputSource = std::make_unique<HookInputSource>(&m_mouseHookLatency, &m_keyboardHookLatency);
+        break;
     }
-    return CallNextHookEx(s_instance ? s_instance->m_mouseHook : nullptr, nCode, wParam, lParam);
+
+    // Input sources are owned by the input thread so UI stalls never delay system input
+    return m_inputThread.Start(m_inputSource.get(), &m_inputDispatch);
 }
 
-LRESULT CALLBACK ActivityMonitor::KeyboardHookProc(int nCode, WPARAM wParam, LPARAM lParam)
+void ActivityMonitor::StopActivitySource()
 {
-    if (nCode >= 0 && s_instance)
-    {
-        s_instance->UpdateActivityTime();
-    }
-    return CallNextHookEx(s_instance ? s_instance->m_keyboardHook : nullptr, nCode, wParam, lParam);
+    m_inputThread.Stop();
+    m_idleSource->Close();
 }
 
-bool ActivityMonitor::InstallHooks()
+bool ActivityMonitor::ReinstallHooks()
 {
-    auto& app = ApplicationManager::GetInstance();
-    HINSTANCE hInstance = app.GetAppInstance();
-    
-    m_mouseHook = SetWindowsHookEx(WH_MOUSE_LL, MouseHookProc, hInstance, 0);
-    m_keyboardHook = SetWindowsHookEx(WH_KEYBOARD_LL, KeyboardHookProc, hInstance, 0);
+    // Closing unhooks whatever the system left installed; Open hooks again on a fresh thread
+    m_inputThread.Stop();
+    m_inputSource = std::make_unique<HookInputSource>(&m_mouseHookLatency, &m_keyboardHookLatency);
+    return m_inputThread.Start(m_inputSource.get(), &m_inputDispatch);
+}
 
-    return (m_mouseHook != nullptr && m_keyboardHook != nullptr);
+void ActivityMonitor::StartTimer()
+{
+    m_engine.Start();
 }
 
-void ActivityMonitor::UninstallHooks()
+void ActivityMonitor::StopTimer()
 {
-    if (m_mouseHook)
-    {
-        UnhookWindowsHookEx(m_mouseHook);
-        m_mouseHook = nullptr;
-    }
-    
-    if (m_keyboardHook)
-    {
-        UnhookWindowsHookEx(m_keyboardHook);
-        m_keyboardHook = nullptr;
-    }
+    m_engine.Stop();
 }
 
-void ActivityMonitor::StartTimer()
+void ActivityMonitor::PublishState()
 {
-    auto& app = ApplicationManager::GetInstance();
-    HWND hDlg = app.GetMainDialog();
-    
-    if (hDlg)
-    {
-        m_timerId = SetTimer(hDlg, 1, 1000, nullptr); // Check every second
-    }
+    const IdleScheduler& scheduler = m_engine.GetScheduler();
+
+    StatusSnapshot::State state = {};
+    state.monitoring = m_isMonitoring ? 1 : 0;
+    state.backend = m_activityBackend;
+    state.timeoutSeconds = m_engine.GetTimeout();
+    state.nextDeadlineMs = m_isMonitoring ? scheduler.GetDeadline() : 0;
+    state.idleActions = scheduler.GetActions();
+    state.hookIncidents = m_hookWatchdog.GetIncidents();
+    state.wakeupsPerHour = m_engine.GetWakeupsPerHour();
+    state.wakeups = scheduler.GetWakeups();
+    m_statusPublisher.PublishState(state);
 }
 
-void ActivityMonitor::StopTimer()
+void ActivityMonitor::PublishInput()
 {
-    auto& app = ApplicationManager::GetInstance();
-    HWND hDlg = app.GetMainDialog();
-    
-    if (hDlg && m_timerId)
+    // Drain thread, every pass: everything read here is atomic
+    StatusSnapshot::Input input = {};
+    input.lastActivityMs = m_activityChannel.GetLastActivity();
+    input.processedPerSecond = m_activityChannel.GetProcessedPerSecond();
+    input.coalescedPerSecond = m_activityChannel.GetCoalescedPerSecond();
+    input.eventsPerSecond = input.processedPerSecond + input.coalescedPerSecond;
+    input.droppedEvents = GetDroppedEvents();
+    input.mouseHookP99Ns = m_mouseHookLatency.GetPercentile(99.0);
+    input.keyboardHookP99Ns = m_keyboardHookLatency.GetPercentile(99.0);
+    m_statusPublisher.PublishInput(input);
+}
+
+void ActivityMonitor::ExportMetrics()
+{
+    // Drain thread; UI-thread counters come from the last published status
+    if (!m_metricsWriter.HasPath())
+        return;
+
+    uint64_t now = MonotonicNowMs();
+    if (now < m_nextMetricsExportMs)
+        return;
+    m_nextMetricsExportMs = now + METRICS_INTERVAL_MS;
+
+    static const uint64_t HOOK_LATENCY_BOUNDS_NS[] = {
+        1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 1000000, 10000000, 100000000 };
+    static const uint64_t IDLE_PERIOD_BOUNDS_MS[] = {
+        5000, 10000, 30000, 60000, 300000, 900000, 1800000, 3600000, 14400000 };
+    static const char* const EVENT_TYPE_NAMES[InputStatistics::TYPE_COUNT] = {
+        "mouse_move", "mouse_button", "mouse_wheel", "key_down", "key_up" };
+
+    StatusSnapshot status = m_statusPublisher.GetSnapshot();
+    SettingsManager* settings = ApplicationManager::GetInstance().GetSettingsManager();
+
+    OpenMetricsWriter& writer = m_metricsWriter;
+    writer.Begin();
+
+    writer.BeginFamily("mma_input_events", "counter", "Input events drained from the event ring, by type");
+    for (size_t type = 0; type < InputStatistics::TYPE_COUNT; ++type)
+    {
+        writer.WriteLabeledSample("mma_input_events", "_total", "type", EVENT_TYPE_NAMES[type],
+            m_inputStatistics.GetCount(static_cast<InputEventType>(type)));
+    }
+    writer.WriteCounter("mma_input_processed", "Input events that moved the activity timestamp",
+        m_activityChannel.GetProcessedCount());
+    writer.WriteCounter("mma_input_coalesced", "Input events coalesced into the current quantum",
+        m_activityChannel.GetCoalescedCount());
+    writer.WriteCounter("mma_input_dropped", "Input events dropped by a full event ring", GetDroppedEvents());
+
+    writer.WriteGauge("mma_monitoring", "1 while monitoring is on", status.state.monitoring);
+    writer.WriteCounter("mma_idle_actions", "Cursor moves injected after an idle timeout", status.state.idleActions);
+    writer.WriteCounter("mma_scheduler_wakeups", "Idle deadline expiries", status.state.wakeups);
+    writer.WriteCounter("mma_hook_incidents", "Hooks found dropped by the system and reinstalled",
+        status.state.hookIncidents);
+    if (settings)
+    {
+        writer.WriteCounter("mma_settings_saves", "Settings saved to the store", settings->GetSaveCount());
+        writer.WriteCounter("mma_settings_save_failures", "Settings saves the store rejected",
+            settings->GetSaveFailures());
+        writer.WriteCounter("mma_settings_save_requests", "Settings changes submitted for saving",
+            settings->GetSaveRequests());
+        writer.WriteCounter("mma_settings_values_written", "Individual values written to the store",
+            settings->GetValuesWritten());
+    }
+
+    writer.WriteHistogram("mma_idle_period_seconds", "Idle periods of at least a second between inputs",
+        "seconds", m_idlePeriodStatistics.GetPeriods(), IDLE_PERIOD_BOUNDS_MS, ARRAYSIZE(IDLE_PERIOD_BOUNDS_MS), 1e-3);
+    writer.WriteHistogram("mma_mouse_hook_latency_seconds", "Time spent in the mouse hook procedure",
+        "seconds", m_mouseHookLatency, HOOK_LATENCY_BOUNDS_NS, ARRAYSIZE(HOOK_LATENCY_BOUNDS_NS), 1e-9);
+    writer.WriteHistogram("mma_keyboard_hook_latency_seconds", "Time spent in the keyboard hook procedure",
+        "seconds", m_keyboardHookLatency, HOOK_LATENCY_BOUNDS_NS, ARRAYSIZE(HOOK_LATENCY_BOUNDS_NS), 1e-9);
+
+    writer.End();
+
+    // Reported once per failure streak, not every interval
+    bool written = writer.WriteFile();
+    if (written != m_metricsWritten)
     {
-        KillTimer(hDlg, m_timerId);
-        m_timerId = 0;
+        if (written)
+            MMA_LOG_INFO("Metrics export written again");
+        else
+            MMA_LOG_WARNING("Metrics export cannot be written");
+        m_metricsWritten = written;
     }
 }
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include "AllocationAudit.h"
+#include "Logger.h"
+#include <cassert>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#pragma intrinsic(_ReturnAddress)
+#define MMA_RETURN_ADDRESS() _ReturnAddress()
+#else
+#define MMA_RETURN_ADDRESS() __builtin_return_address(0)
+#endif
+
+// Static member definitions; all constant-initialized, operator new may run before main
+thread_local const char* AllocationAudit::t_scope = nullptr;
+std::atomic<bool> AllocationAudit::s_armed{ false };
+std::atomic<bool> AllocationAudit::s_assertOnViolation{ true };
+std::atomic<uint64_t> AllocationAudit::s_allocations{ 0 };
+std::atomic<uint64_t> AllocationAudit::s_violations{ 0 };
+AllocationAudit::SiteSlot AllocationAudit::s_sites[AllocationAudit::MAX_SITES];
+
+size_t AllocationAudit::GetSites(Site* sites, size_t maxSites)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < MAX_SITES && count < maxSites; ++i)
+    {
+        const void* caller = s_sites[i].caller.load(std::memory_order_acquire);
+        if (!caller)
+            break;
+
+        sites[count].caller = caller;
+        sites[count].scope = s_sites[i].scope.load(std::memory_order_relaxed);
+        sites[count].count = s_sites[i].count.load(std::memory_order_relaxed);
+        ++count;
+    }
+    return count;
+}
+
+void AllocationAudit::Reset()
+{
+    // Only meaningful while no thread allocates inside a no-alloc scope
+    for (size_t i = 0; i < MAX_SITES; ++i)
+    {
+        s_sites[i].count.store(0, std::memory_order_relaxed);
+        s_sites[i].scope.store(nullptr, std::memory_order_relaxed);
+        s_sites[i].caller.store(nullptr, std::memory_order_release);
+    }
+    s_violations.store(0, std::memory_order_relaxed);
+    s_allocations.store(0, std::memory_order_relaxed);
+}
+
+void AllocationAudit::RecordViolation(const void* caller)
+{
+    // Anything below may allocate again; that must not count as a second violation
+    const char* scope = t_scope;
+    t_scope = nullptr;
+
+    s_violations.fetch_add(1, std::memory_order_relaxed);
+
+    // Claim the slot for this caller, or the first free one; sites past the table only count in total
+    bool firstAtSite = false;
+    for (size_t i = 0; i < MAX_SITES; ++i)
+    {
+        const void* expected = nullptr;
+        if (s_sites[i].caller.compare_exchange_strong(expected, caller, std::memory_order_acq_rel) ||
+            expected == caller)
+        {
+            firstAtSite = s_sites[i].count.fetch_add(1, std::memory_order_relaxed) == 0;
+            if (firstAtSite)
+                s_sites[i].scope.store(scope, std::memory_order_relaxed);
+            break;
+        }
+    }
+
+    if (firstAtSite)
+        MMA_LOG_ERROR("Heap allocation in no-alloc scope %s from %p", scope, caller);
+    assert(!s_assertOnViolation.load(std::memory_order_relaxed) && "heap allocation in a no-alloc scope");
+
+    t_scope = scope;
+}
+
+#ifdef MMA_ALLOC_AUDIT
+
+// Global allocator replacement: counts, then defers to the C runtime
+static void* AuditedAllocate(size_t size, const void* caller)
+{
+    AllocationAudit::RecordAllocation(caller);
+    return malloc(size ? size : 1);
+}
+
+static void* AuditedAllocateAligned(size_t size, std::align_val_t alignment, const void* caller)
+{
+    AllocationAudit::RecordAllocation(caller);
+    size_t bytes = size ? size : 1;
+#ifdef _WIN32
+    return _aligned_malloc(bytes, static_cast<size_t>(alignment));
+#else
+    void* memory = nullptr;
+    return posix_memalign(&memory, static_cast<size_t>(alignment), bytes) == 0 ? memory : nullptr;
+#endif
+}
+
+static void AuditedFreeAligned(void* memory)
+{
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    free(memory);
+#endif
+}
+
+void* operator new(size_t size)
+{
+    void* memory = AuditedAllocate(size, MMA_RETURN_ADDRESS());
+    if (!memory)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new[](size_t size)
+{
+    void* memory = AuditedAllocate(size, MMA_RETURN_ADDRESS());
+    if (!memory)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return AuditedAllocate(size, MMA_RETURN_ADDRESS());
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return AuditedAllocate(size, MMA_RETURN_ADDRESS());
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    void* memory = AuditedAllocateAligned(size, alignment, MMA_RETURN_ADDRESS());
+    if (!memory)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    void* memory = AuditedAllocateAligned(size, alignment, MMA_RETURN_ADDRESS());
+    if (!memory)
+        throw std::bad_alloc();
+    return memory;
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return AuditedAllocateAligned(size, alignment, MMA_RETURN_ADDRESS());
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return AuditedAllocateAligned(size, alignment, MMA_RETURN_ADDRESS());
+}
+
+void operator delete(void* memory) noexcept { free(memory); }
+void operator delete[](void* memory) noexcept { free(memory); }
+void operator delete(void* memory, size_t) noexcept { free(memory); }
+void operator delete[](void* memory, size_t) noexcept { free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { free(memory); }
+
+void operator delete(void* memory, std::align_val_t) noexcept { AuditedFreeAligned(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { AuditedFreeAligned(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { AuditedFreeAligned(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { AuditedFreeAligned(memory); }
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept { AuditedFreeAligned(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { AuditedFreeAligned(memory); }
+
+#endif
\ No newline at end of file
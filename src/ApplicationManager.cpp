@@ -1,15 +1,42 @@
 #include "ApplicationManager.h"
 #include "ActivityMonitor.h"
+#include "ControlServer.h"
 #include "SystemTray.h"
 #include "SettingsManager.h"
 #include "HotkeyManager.h"
 #include "DialogManager.h"
+#include "Logger.h"
+#include "ProcessMemory.h"
+#include "RotatingFileSink.h"
+#include "StartupProfiler.h"
+#include "TraceRecorder.h"
 #include "resource.h"
 #include <memory>
 
 // Static member definition
 std::unique_ptr<ApplicationManager> ApplicationManager::s_instance = nullptr;
 
+// How long the control thread waits for the UI thread; clients wait ControlClient::DEFAULT_TIMEOUT_MS
+static const DWORD CONTROL_DISPATCH_TIMEOUT_MS = 1500;
+
+/**
+ * One control request handed from the server thread to the UI thread
+ * Both sides hold a reference, so a UI thread that answers after the server
+ * gave up never writes to a released exchange
+ */
+struct ControlExchange
+{
+    ControlRequest request;
+    ControlResponse response;
+    HANDLE done = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+
+    ~ControlExchange()
+    {
+        if (done)
+            CloseHandle(done);
+    }
+};
+
 ApplicationManager& ApplicationManager::GetInstance()
 {
     if (!s_instance)
@@ -31,6 +58,9 @@ bool ApplicationManager::Initialize(HINSTANCE hInstance, int nCmdShow)
     // Load global strings
     LoadGlobalStrings();
     
+    // Start logging before anything that may report a failure
+    StartLogging();
+    
     // Initialize subsystems
     if (!InitializeSubsystems())
     {
@@ -39,6 +69,14 @@ bool ApplicationManager::Initialize(HINSTANCE hInstance, int nCmdShow)
     
     // Load settings
     m_settingsManager->LoadSettings();
+    Logger::SetLevel(static_cast<LogLevel>(m_settingsManager->GetLogLevel()));
+    MMA_LOG_INFO("MMA started, timeout %u s", m_settingsManager->GetTimeout());
+    m_activityMonitor->SetActivityBackend(m_settingsManager->GetActivityBackend());
+    m_activityMonitor->SetLowFootprint(m_settingsManager->GetLowFootprint());
+    
+    // Without a dialog at startup, StartMonitoring has no edit box to read the timeout from
+    m_activityMonitor->SetTimeout(m_settingsManager->GetTimeout());
+    StartupProfiler::Mark("settings");
     
     // Initialize hotkey manager with current settings
     m_hotkeyManager->SetHotkey(
@@ -46,28 +84,42 @@ bool ApplicationManager::Initialize(HINSTANCE hInstance, int nCmdShow)
         m_settingsManager->GetHotkeyVK());
     
     // Create main dialog based on settings
-    if (m_settingsManager->GetStartHidden())
+    bool startHidden = m_settingsManager->GetStartHidden();
+    if (startHidden || m_settingsManager->GetLowFootprint())
     {
-        // Create dialog but don't show it
-        m_hMainDlg = m_dialogManager->CreateMainDialog(hInstance);
-        if (!m_hMainDlg)
+        // Only a hidden window and the tray icon; the dialog is built on first show
+        // (and released again on hide in low-footprint mode)
+        HWND hWnd = m_dialogManager->CreateMessageWindow(hInstance);
+        if (!hWnd)
         {
             return false;
         }
         
         // Add tray icon
-        m_systemTray->AddTrayIcon(m_hMainDlg);
+        m_systemTray->AddTrayIcon(hWnd);
         
         // Register hotkey
-        m_hotkeyManager->RegisterGlobalHotkey(m_hMainDlg, 
+        m_hotkeyManager->RegisterGlobalHotkey(hWnd, 
             m_settingsManager->GetHotkeyModifiers(),
             m_settingsManager->GetHotkeyVK());
+        StartupProfiler::Mark("tray");
         
-        // Start monitoring if configured
-        if (m_settingsManager->GetStartMonitoring())
+        if (!startHidden)
+        {
+            HWND hDlg = EnsureMainDialog();
+            if (!hDlg)
+            {
+                return false;
+            }
+            
+            ShowWindow(hDlg, nCmdShow);
+            UpdateWindow(hDlg);
+        }
+        else if (m_settingsManager->GetStartMonitoring())
         {
+            // Start monitoring if configured
             m_activityMonitor->StartMonitoring();
-            m_dialogManager->UpdateUI();
+            StartupProfiler::Mark("hooks");
         }
     }
     else
@@ -79,15 +131,72 @@ bool ApplicationManager::Initialize(HINSTANCE hInstance, int nCmdShow)
             return false;
         }
         
+        StartupProfiler::Mark("tray");
+        
         ShowWindow(m_hMainDlg, nCmdShow);
         UpdateWindow(m_hMainDlg);
     }
     
+    StartupProfiler::Mark("ready");
+    LogStartupSummary();
+    
+    // Changes made by an administrator or another tool apply without a restart
+    m_settingsManager->StartWatching(GetMessageWindow());
+    
+    // mma_ctl and later launches reach this instance through the control channel
+    StartControlServer();
+    
+    if (startHidden && m_settingsManager->GetLowFootprint())
+    {
+        ProcessMemory::TrimWorkingSet();
+    }
+    ProcessMemory::CheckBudget(static_cast<uint64_t>(MEMORY_BUDGET_KB) * 1024, "at startup");
     return true;
 }
 
+HWND ApplicationManager::GetMessageWindow() const
+{
+    HWND hWnd = m_dialogManager ? m_dialogManager->GetMessageWindow() : nullptr;
+    return hWnd ? hWnd : m_hMainDlg;
+}
+
+void ApplicationManager::ReleaseHiddenResources()
+{
+    // Only low-footprint instances have the hidden window that makes the dialog disposable
+    if (!m_settingsManager->GetLowFootprint() || !m_dialogManager->GetMessageWindow())
+        return;
+
+    m_dialogManager->DestroyMainDialog();
+    m_hMainDlg = nullptr;
+    ProcessMemory::TrimWorkingSet();
+    ProcessMemory::CheckBudget(static_cast<uint64_t>(MEMORY_BUDGET_KB) * 1024, "when hidden");
+}
+
+HWND ApplicationManager::EnsureMainDialog()
+{
+    if (!m_hMainDlg && m_dialogManager)
+    {
+        ULONGLONG start = GetTickCount64();
+        m_hMainDlg = m_dialogManager->CreateMainDialog(m_hInstance);
+        if (m_hMainDlg)
+        {
+            m_dialogManager->UpdateUI();
+            MMA_LOG_INFO("Main dialog built on first show in %llu ms", GetTickCount64() - start);
+        }
+    }
+    return m_hMainDlg;
+}
+
 void ApplicationManager::Shutdown()
 {
+    // No control commands or reloads while tearing down
+    StopControlServer();
+    
+    if (m_settingsManager)
+    {
+        m_settingsManager->StopWatching();
+    }
+    
     // Stop monitoring
     if (m_activityMonitor)
     {
@@ -106,24 +215,30 @@ void ApplicationManager::Shutdown()
         m_systemTray->RemoveTrayIcon();
     }
     
-    // Save settings
+    // Save settings, if anything is still unsaved
     if (m_settingsManager)
     {
-        m_settingsManager->SaveSettings();
+        m_settingsManager->FlushSettings();
     }
     
     // Destroy dialog
     if (m_dialogManager)
     {
         m_dialogManager->DestroyMainDialog();
+        m_dialogManager->DestroyMessageWindow();
     }
     
     m_hMainDlg = nullptr;
+    
+    // Stop logging last so shutdown failures still reach the file
+    MMA_LOG_INFO("MMA stopped");
+    Logger::Stop();
 }
 
 int ApplicationManager::Run()
 {
     MSG msg;
+    MMA_TRACE_THREAD("ui");
     
     // Main message loop
     while (GetMessage(&msg, nullptr, 0, 0))
@@ -165,6 +280,172 @@ void ApplicationManager::HandleHotkeyToggle()
     m_dialogManager->UpdateUI();
 }
 
+void ApplicationManager::ApplyExternalSettings()
+{
+    uint32_t changed = m_settingsManager->ReloadSettings();
+    if (!changed)
+        return;
+
+    // Each subsystem only hears about its own values
+    if (changed & SettingsModel::FIELD_TIMEOUT)
+    {
+        m_activityMonitor->SetTimeout(m_settingsManager->GetTimeout());
+    }
+    
+    const uint32_t hotkeyFields = SettingsModel::FIELD_HOTKEY_MODIFIERS | SettingsModel::FIELD_HOTKEY_VK;
+    if (changed & hotkeyFields)
+    {
+        m_hotkeyManager->SetHotkey(m_settingsManager->GetHotkeyModifiers(), m_settingsManager->GetHotkeyVK());
+    }
+    
+    if (changed & SettingsModel::FIELD_ACTIVITY_BACKEND)
+    {
+        m_activityMonitor->SetActivityBackend(m_settingsManager->GetActivityBackend());
+    }
+    
+    if (changed & SettingsModel::FIELD_LOG_LEVEL)
+    {
+        Logger::SetLevel(static_cast<LogLevel>(m_settingsManager->GetLogLevel()));
+    }
+    
+    if (changed & SettingsModel::FIELD_LOW_FOOTPRINT)
+    {
+        m_activityMonitor->SetLowFootprint(m_settingsManager->GetLowFootprint());
+    }
+    
+    m_dialogManager->UpdateUI();
+    MMA_LOG_INFO("Settings changed externally: %u values applied, hotkey %s", SettingsModel::CountFields(changed),
+                 (changed & hotkeyFields) ? "re-registered" : "unchanged");
+}
+
+void ApplicationManager::StartControlServer()
+{
+    m_controlAbandon = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!m_controlAbandon)
+        return;
+
+    // Requests arrive on the server thread; the UI thread owns every subsystem, so each one is posted there
+    HWND hWnd = GetMessageWindow();
+    HANDLE abandon = m_controlAbandon;
+    ControlServer::RequestHandler handler = [hWnd, abandon](const ControlRequest& request, ControlResponse& response)
+    {
+        auto exchange = std::make_shared<ControlExchange>();
+        exchange->request = request;
+        exchange->response = response;
+        response.result = static_cast<uint8_t>(ControlResult::Failed);
+        if (!exchange->done)
+            return;
+
+        auto* holder = new std::shared_ptr<ControlExchange>(exchange);
+        if (!PostMessageW(hWnd, WM_CONTROL_REQUEST, 0, reinterpret_cast<LPARAM>(holder)))
+        {
+            delete holder;
+            return;
+        }
+
+        HANDLE waits[] = { exchange->done, abandon };
+        if (WaitForMultipleObjects(2, waits, FALSE, CONTROL_DISPATCH_TIMEOUT_MS) == WAIT_OBJECT_0)
+        {
+            response = exchange->response;
+        }
+    };
+
+    m_controlServer = std::make_unique<ControlServer>();
+    if (!m_controlServer->Start(handler))
+    {
+        MMA_LOG_WARNING("Control channel unavailable; mma_ctl and later launches cannot reach this instance");
+        m_controlServer.reset();
+    }
+}
+
+void ApplicationManager::StopControlServer()
+{
+    if (m_controlAbandon)
+    {
+        SetEvent(m_controlAbandon);
+    }
+    
+    if (m_controlServer)
+    {
+        m_controlServer->Stop();
+        MMA_LOG_INFO("Control channel: %llu connections, %llu requests, %llu rejected",
+                     m_controlServer->GetConnections(), m_controlServer->GetRequests(),
+                     m_controlServer->GetRejected());
+        m_controlServer.reset();
+    }
+    
+    if (m_controlAbandon)
+    {
+        CloseHandle(m_controlAbandon);
+        m_controlAbandon = nullptr;
+    }
+}
+
+void ApplicationManager::HandleControlRequest(LPARAM lParam)
+{
+    // Takes over the reference posted by the server thread
+    std::unique_ptr<std::shared_ptr<ControlExchange>> holder(
+        reinterpret_cast<std::shared_ptr<ControlExchange>*>(lParam));
+    ControlExchange& exchange = **holder;
+
+    ExecuteControlCommand(exchange.request, exchange.response);
+    SetEvent(exchange.done);
+}
+
+void ApplicationManager::ExecuteControlCommand(const ControlRequest& request, ControlResponse& response)
+{
+    ControlCommand command = static_cast<ControlCommand>(request.command);
+    switch (command)
+    {
+    case ControlCommand::Start:
+        if (!m_activityMonitor->IsMonitoring())
+        {
+            m_activityMonitor->StartMonitoring();
+            m_dialogManager->UpdateUI();
+        }
+        break;
+        
+    case ControlCommand::Stop:
+        if (m_activityMonitor->IsMonitoring())
+        {
+            m_activityMonitor->StopMonitoring();
+            m_dialogManager->UpdateUI();
+        }
+        break;
+        
+    case ControlCommand::SetTimeout:
+        if (!SettingsModel::IsValidTimeout(request.argument))
+        {
+            response.result = static_cast<uint8_t>(ControlResult::InvalidArgument);
+            break;
+        }
+        m_activityMonitor->SetTimeout(request.argument);
+        m_settingsManager->SetTimeout(request.argument);
+        m_settingsManager->SaveSettings();
+        m_dialogManager->UpdateUI();
+        break;
+        
+    case ControlCommand::Show:
+        {
+            m_systemTray->ShowMainDialog();
+            if (m_hMainDlg && IsIconic(m_hMainDlg))
+            {
+                ShowWindow(m_hMainDlg, SW_RESTORE);
+            }
+        }
+        break;
+        
+    default:
+        break;
+    }
+    
+    response.monitoring = m_activityMonitor->IsMonitoring() ? 1 : 0;
+    response.timeoutSeconds = m_activityMonitor->GetTimeout();
+    response.backend = m_activityMonitor->GetActivityBackend();
+    MMA_LOG_INFO("Control command %s: %s", ControlProtocol::GetCommandName(command),
+                 ControlProtocol::GetResultName(static_cast<ControlResult>(response.result)));
+}
+
 bool ApplicationManager::InitializeSubsystems()
 {
     try
@@ -184,6 +465,43 @@ bool ApplicationManager::InitializeSubsystems()
     }
 }
 
+void ApplicationManager::StartLogging()
+{
+    // %LOCALAPPDATA%\MMA\mma.log; logging stays off when the folder is unavailable
+    WCHAR path[MAX_PATH];
+    DWORD length = GetEnvironmentVariableW(L"LOCALAPPDATA", path, MAX_PATH);
+    if (length == 0 || length + 12 >= MAX_PATH)
+        return;
+
+    wcscat_s(path, L"\\MMA");
+    if (!CreateDirectoryW(path, nullptr) && GetLastError() != ERROR_ALREADY_EXISTS)
+        return;
+    wcscat_s(path, L"\\mma.log");
+
+    char utf8Path[MAX_PATH * 3];
+    if (WideCharToMultiByte(CP_UTF8, 0, path, -1, utf8Path, sizeof(utf8Path), nullptr, nullptr) <= 0)
+        return;
+
+    m_logSink = std::make_unique<RotatingFileSink>(utf8Path);
+    if (!Logger::Start(m_logSink.get()))
+    {
+        m_logSink.reset();
+    }
+}
+
+void ApplicationManager::LogStartupSummary()
+{
+    // Time to monitoring is the figure users notice after logon; 0 when monitoring starts later
+    uint64_t readyUs = StartupProfiler::FindPhaseUs("ready");
+    uint64_t hooksUs = StartupProfiler::FindPhaseUs("hooks");
+
+    ProcessMemoryUsage usage = {};
+    ProcessMemory::Query(usage);
+
+    MMA_LOG_INFO("Startup ready in %llu us, monitoring after %llu us, working set %llu KB",
+                 readyUs, hooksUs, usage.workingSetBytes / 1024);
+}
+
 void ApplicationManager::LoadGlobalStrings()
 {
     LoadStringW(m_hInstance, IDS_APP_TITLE, m_szTitle, MAX_LOADSTRING);
@@ -0,0 +1,178 @@
+#include "ControlClient.h"
+#include "MonotonicClock.h"
+#include <chrono>
+#include <thread>
+
+#ifdef _WIN32
+#include "framework.h"
+#else
+#include <cerrno>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+// Pause between attempts while the endpoint does not exist yet
+static const uint32_t CONNECT_RETRY_MS = 10;
+
+ControlClient::~ControlClient()
+{
+    Close();
+}
+
+bool ControlClient::Transact(const ControlRequest& request, ControlResponse& response)
+{
+    return TransactRaw(&request, sizeof(request), response) == static_cast<int>(sizeof(response)) &&
+           ControlProtocol::Matches(request, response);
+}
+
+#ifdef _WIN32
+
+bool ControlClient::Connect(const char* endpoint, uint32_t timeoutMs)
+{
+    Close();
+
+    wchar_t path[ControlProtocol::MAX_ENDPOINT_LENGTH + 16];
+    ControlProtocol::GetPipePath(endpoint, path, sizeof(path) / sizeof(path[0]));
+
+    uint64_t deadline = MonotonicNowMs() + timeoutMs;
+    for (;;)
+    {
+        // Identification only: whoever serves the pipe cannot act as this user
+        HANDLE pipe = CreateFileW(path, GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING,
+                                  SECURITY_SQOS_PRESENT | SECURITY_IDENTIFICATION, nullptr);
+        if (pipe != INVALID_HANDLE_VALUE)
+        {
+            DWORD mode = PIPE_READMODE_MESSAGE;
+            if (!SetNamedPipeHandleState(pipe, &mode, nullptr, nullptr))
+            {
+                CloseHandle(pipe);
+                return false;
+            }
+            m_pipe = pipe;
+            return true;
+        }
+
+        DWORD error = GetLastError();
+        uint64_t now = MonotonicNowMs();
+        if (now >= deadline || (error != ERROR_PIPE_BUSY && error != ERROR_FILE_NOT_FOUND))
+            return false;
+
+        // Busy: the server is talking to another client; missing: it is not listening yet
+        if (error == ERROR_PIPE_BUSY)
+            WaitNamedPipeW(path, static_cast<DWORD>(deadline - now));
+        else
+            std::this_thread::sleep_for(std::chrono::milliseconds(CONNECT_RETRY_MS));
+    }
+}
+
+void ControlClient::Close()
+{
+    if (m_pipe)
+    {
+        CloseHandle(m_pipe);
+        m_pipe = nullptr;
+    }
+}
+
+bool ControlClient::IsConnected() const
+{
+    return m_pipe != nullptr;
+}
+
+int ControlClient::TransactRaw(const void* request, size_t size, ControlResponse& response)
+{
+    // The server answers within its own timeouts, so a blocking round trip is bounded
+    DWORD read = 0;
+    if (!m_pipe || !TransactNamedPipe(m_pipe, const_cast<void*>(request), static_cast<DWORD>(size), &response,
+                                      sizeof(response), &read, nullptr))
+    {
+        return -1;
+    }
+    return static_cast<int>(read);
+}
+
+uint32_t ControlClient::GetServerProcessId() const
+{
+    ULONG processId = 0;
+    return m_pipe && GetNamedPipeServerProcessId(m_pipe, &processId) ? static_cast<uint32_t>(processId) : 0;
+}
+
+#else
+
+bool ControlClient::Connect(const char* endpoint, uint32_t timeoutMs)
+{
+    Close();
+
+    sockaddr_un address;
+    socklen_t length = ControlProtocol::GetSocketAddress(endpoint, address);
+
+    uint64_t deadline = MonotonicNowMs() + timeoutMs;
+    for (;;)
+    {
+        int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+            return false;
+
+        if (connect(fd, reinterpret_cast<sockaddr*>(&address), length) == 0)
+        {
+            // Anyone can bind an abstract name first; only an instance of our own user may get commands
+            ucred credentials;
+            socklen_t size = sizeof(credentials);
+            if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &size) != 0 || credentials.uid != geteuid())
+            {
+                close(fd);
+                return false;
+            }
+
+            // Bound every round trip by the same timeout
+            timeval timeout;
+            timeout.tv_sec = timeoutMs / 1000;
+            timeout.tv_usec = (timeoutMs % 1000) * 1000;
+            setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+            m_fd = fd;
+            return true;
+        }
+
+        // Refused: nothing bound to the name yet (abstract names have no file to wait for)
+        int error = errno;
+        close(fd);
+        if (MonotonicNowMs() >= deadline || (error != ECONNREFUSED && error != ENOENT && error != EAGAIN))
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(CONNECT_RETRY_MS));
+    }
+}
+
+void ControlClient::Close()
+{
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+        m_fd = -1;
+    }
+}
+
+bool ControlClient::IsConnected() const
+{
+    return m_fd >= 0;
+}
+
+int ControlClient::TransactRaw(const void* request, size_t size, ControlResponse& response)
+{
+    if (m_fd < 0 || send(m_fd, request, size, MSG_NOSIGNAL) != static_cast<ssize_t>(size))
+        return -1;
+
+    ssize_t length = recv(m_fd, &response, sizeof(response), 0);
+    return length < 0 ? -1 : static_cast<int>(length);
+}
+
+uint32_t ControlClient::GetServerProcessId() const
+{
+    ucred credentials;
+    socklen_t size = sizeof(credentials);
+    if (m_fd < 0 || getsockopt(m_fd, SOL_SOCKET, SO_PEERCRED, &credentials, &size) != 0)
+        return 0;
+    return static_cast<uint32_t>(credentials.pid);
+}
+
+#endif
\ No newline at end of file
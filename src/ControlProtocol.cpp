@@ -0,0 +1,122 @@
+#include "ControlProtocol.h"
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include "framework.h"
+#else
+#include <unistd.h>
+#endif
+
+// Indexed by ControlCommand
+static const char* const COMMAND_NAMES[CONTROL_COMMAND_COUNT] = { "status", "start", "stop", "set-timeout", "show" };
+
+ControlRequest ControlProtocol::MakeRequest(ControlCommand command, uint32_t argument, uint32_t sequence)
+{
+    ControlRequest request = {};
+    request.magic = MAGIC;
+    request.version = VERSION;
+    request.command = static_cast<uint8_t>(command);
+    request.argument = argument;
+    request.sequence = sequence;
+    return request;
+}
+
+ControlResponse ControlProtocol::MakeResponse(const ControlRequest& request, ControlResult result)
+{
+    ControlResponse response = {};
+    response.magic = MAGIC;
+    response.version = VERSION;
+    response.result = static_cast<uint8_t>(result);
+    response.sequence = request.sequence;
+    return response;
+}
+
+bool ControlProtocol::IsValid(const ControlRequest& request)
+{
+    return request.magic == MAGIC && request.version == VERSION && request.command < CONTROL_COMMAND_COUNT;
+}
+
+bool ControlProtocol::Matches(const ControlRequest& request, const ControlResponse& response)
+{
+    return response.magic == MAGIC && response.version == VERSION && response.sequence == request.sequence;
+}
+
+bool ControlProtocol::ParseCommand(const char* name, ControlCommand& command)
+{
+    for (uint32_t i = 0; i < CONTROL_COMMAND_COUNT; ++i)
+    {
+        if (strcmp(name, COMMAND_NAMES[i]) == 0)
+        {
+            command = static_cast<ControlCommand>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* ControlProtocol::GetCommandName(ControlCommand command)
+{
+    uint32_t index = static_cast<uint32_t>(command);
+    return index < CONTROL_COMMAND_COUNT ? COMMAND_NAMES[index] : "unknown";
+}
+
+const char* ControlProtocol::GetResultName(ControlResult result)
+{
+    switch (result)
+    {
+    case ControlResult::Ok:              return "ok";
+    case ControlResult::BadRequest:      return "bad request";
+    case ControlResult::InvalidArgument: return "invalid argument";
+    case ControlResult::Unsupported:     return "unsupported";
+    case ControlResult::Failed:          return "failed";
+    default:                             return "unknown";
+    }
+}
+
+void ControlProtocol::GetDefaultEndpoint(char* buffer, size_t size)
+{
+#ifdef _WIN32
+    // Sessions separate interactive users; the pipe's default DACL keeps other accounts out
+    DWORD session = 0;
+    ProcessIdToSessionId(GetCurrentProcessId(), &session);
+    snprintf(buffer, size, "mma-control-%lu", static_cast<unsigned long>(session));
+#else
+    // Abstract sockets have no permissions; the server checks the peer's uid instead
+    snprintf(buffer, size, "mma-control-%lu", static_cast<unsigned long>(geteuid()));
+#endif
+}
+
+#ifdef _WIN32
+
+void ControlProtocol::GetPipePath(const char* endpoint, wchar_t* path, size_t size)
+{
+    char name[MAX_ENDPOINT_LENGTH];
+    if (!endpoint)
+    {
+        GetDefaultEndpoint(name, sizeof(name));
+        endpoint = name;
+    }
+    _snwprintf_s(path, size, _TRUNCATE, L"\\\\.\\pipe\\%hs", endpoint);
+}
+
+#else
+
+socklen_t ControlProtocol::GetSocketAddress(const char* endpoint, sockaddr_un& address)
+{
+    char name[MAX_ENDPOINT_LENGTH];
+    if (!endpoint)
+    {
+        GetDefaultEndpoint(name, sizeof(name));
+        endpoint = name;
+    }
+
+    // Abstract namespace: a leading NUL, no file, gone when the last socket closes
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    size_t length = strnlen(endpoint, MAX_ENDPOINT_LENGTH - 1);
+    memcpy(address.sun_path + 1, endpoint, length);
+    return static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + length);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,318 @@
+#include "ControlServer.h"
+#include "TraceRecorder.h"
+
+#ifdef _WIN32
+#include "framework.h"
+#else
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+ControlServer::~ControlServer()
+{
+    Stop();
+}
+
+void ControlServer::Answer(const ControlRequest& request, ControlResponse& response)
+{
+    m_requests.fetch_add(1, std::memory_order_relaxed);
+    if (!ControlProtocol::IsValid(request))
+    {
+        m_rejected.fetch_add(1, std::memory_order_relaxed);
+        response = ControlProtocol::MakeResponse(request, ControlResult::BadRequest);
+        response.processId = m_processId;
+        return;
+    }
+
+    response = ControlProtocol::MakeResponse(request, ControlResult::Ok);
+    response.processId = m_processId;
+    m_handler(request, response);
+}
+
+#ifdef _WIN32
+
+// Outcome of one overlapped pipe operation
+enum class PipeWait
+{
+    Done,
+    Failed,
+    TimedOut,
+    Stopped
+};
+
+static PipeWait CompleteIo(HANDLE pipe, OVERLAPPED& overlapped, BOOL started, HANDLE stopEvent, DWORD timeoutMs,
+                           DWORD& bytes)
+{
+    if (!started && GetLastError() != ERROR_IO_PENDING)
+        return PipeWait::Failed;
+
+    HANDLE handles[2] = { stopEvent, overlapped.hEvent };
+    DWORD wait = WaitForMultipleObjects(2, handles, FALSE, timeoutMs);
+    if (wait != WAIT_OBJECT_0 + 1)
+    {
+        // The buffer belongs to the caller's frame; nothing may complete into it after we return
+        CancelIoEx(pipe, &overlapped);
+        GetOverlappedResult(pipe, &overlapped, &bytes, TRUE);
+        if (wait == WAIT_OBJECT_0)
+            return PipeWait::Stopped;
+        return wait == WAIT_TIMEOUT ? PipeWait::TimedOut : PipeWait::Failed;
+    }
+    return GetOverlappedResult(pipe, &overlapped, &bytes, FALSE) ? PipeWait::Done : PipeWait::Failed;
+}
+
+bool ControlServer::Start(const RequestHandler& handler, const char* endpoint)
+{
+    Stop();
+
+    wchar_t path[ControlProtocol::MAX_ENDPOINT_LENGTH + 16];
+    ControlProtocol::GetPipePath(endpoint, path, sizeof(path) / sizeof(path[0]));
+
+    // First instance only: a pipe squatted by another process fails here instead of serving it
+    HANDLE pipe = CreateNamedPipeW(path, PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+                                   PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+                                   1, sizeof(ControlResponse), sizeof(ControlRequest), 0, nullptr);
+    if (pipe == INVALID_HANDLE_VALUE)
+        return false;
+
+    m_pipe = pipe;
+    m_stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    m_ioEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!m_stopEvent || !m_ioEvent)
+    {
+        Stop();
+        return false;
+    }
+
+    m_handler = handler;
+    m_processId = GetCurrentProcessId();
+    m_thread = std::thread(&ControlServer::Run, this);
+    return true;
+}
+
+void ControlServer::Stop()
+{
+    if (m_thread.joinable())
+    {
+        SetEvent(m_stopEvent);
+        m_thread.join();
+    }
+
+    if (m_pipe)
+        CloseHandle(m_pipe);
+    if (m_stopEvent)
+        CloseHandle(m_stopEvent);
+    if (m_ioEvent)
+        CloseHandle(m_ioEvent);
+
+    m_pipe = nullptr;
+    m_stopEvent = nullptr;
+    m_ioEvent = nullptr;
+}
+
+void ControlServer::Run()
+{
+    MMA_TRACE_THREAD("control");
+
+    DWORD session = 0;
+    ProcessIdToSessionId(m_processId, &session);
+
+    for (;;)
+    {
+        OVERLAPPED overlapped = {};
+        overlapped.hEvent = m_ioEvent;
+        DWORD bytes = 0;
+
+        // A client that connected before this call is reported as ERROR_PIPE_CONNECTED
+        BOOL started = ConnectNamedPipe(m_pipe, &overlapped);
+        PipeWait wait = (!started && GetLastError() == ERROR_PIPE_CONNECTED)
+                            ? PipeWait::Done
+                            : CompleteIo(m_pipe, overlapped, started, m_stopEvent, INFINITE, bytes);
+        if (wait == PipeWait::Stopped)
+            break;
+
+        bool keepRunning = true;
+        if (wait == PipeWait::Done)
+        {
+            m_connections.fetch_add(1, std::memory_order_relaxed);
+            ULONG clientSession = 0;
+            if (GetNamedPipeClientSessionId(m_pipe, &clientSession) && clientSession == session)
+                keepRunning = ServeConnection();
+            else
+                m_rejected.fetch_add(1, std::memory_order_relaxed);
+        }
+        else if (WaitForSingleObject(m_stopEvent, 100) == WAIT_OBJECT_0)
+        {
+            // Do not spin on a pipe that keeps failing
+            break;
+        }
+
+        DisconnectNamedPipe(m_pipe);
+        if (!keepRunning)
+            break;
+    }
+}
+
+bool ControlServer::ServeConnection()
+{
+    for (;;)
+    {
+        ControlRequest request;
+        OVERLAPPED overlapped = {};
+        overlapped.hEvent = m_ioEvent;
+        DWORD bytes = 0;
+
+        BOOL started = ReadFile(m_pipe, &request, sizeof(request), nullptr, &overlapped);
+        PipeWait wait = CompleteIo(m_pipe, overlapped, started, m_stopEvent, IDLE_TIMEOUT_MS, bytes);
+        if (wait == PipeWait::Stopped)
+            return false;
+        if (wait != PipeWait::Done || bytes != sizeof(request))
+        {
+            // An oversized message fails with ERROR_MORE_DATA; a closed pipe is the normal end
+            if (wait == PipeWait::Done || GetLastError() == ERROR_MORE_DATA)
+                m_rejected.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        ControlResponse response;
+        Answer(request, response);
+
+        overlapped = {};
+        overlapped.hEvent = m_ioEvent;
+        started = WriteFile(m_pipe, &response, sizeof(response), nullptr, &overlapped);
+        wait = CompleteIo(m_pipe, overlapped, started, m_stopEvent, IDLE_TIMEOUT_MS, bytes);
+        if (wait == PipeWait::Stopped)
+            return false;
+        if (wait != PipeWait::Done)
+            return true;
+    }
+}
+
+#else
+
+bool ControlServer::Start(const RequestHandler& handler, const char* endpoint)
+{
+    Stop();
+
+    sockaddr_un address;
+    socklen_t length = ControlProtocol::GetSocketAddress(endpoint, address);
+
+    // Binding fails with EADDRINUSE while another instance serves the endpoint
+    m_listenFd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (m_listenFd < 0 || bind(m_listenFd, reinterpret_cast<sockaddr*>(&address), length) != 0 ||
+        listen(m_listenFd, 8) != 0)
+    {
+        Stop();
+        return false;
+    }
+
+    m_stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_stopFd < 0)
+    {
+        Stop();
+        return false;
+    }
+
+    m_handler = handler;
+    m_processId = static_cast<uint32_t>(getpid());
+    m_thread = std::thread(&ControlServer::Run, this);
+    return true;
+}
+
+void ControlServer::Stop()
+{
+    if (m_thread.joinable())
+    {
+        uint64_t one = 1;
+        ssize_t written = write(m_stopFd, &one, sizeof(one));
+        (void)written;
+        m_thread.join();
+    }
+
+    if (m_listenFd >= 0)
+        close(m_listenFd);
+    if (m_stopFd >= 0)
+        close(m_stopFd);
+
+    m_listenFd = -1;
+    m_stopFd = -1;
+}
+
+void ControlServer::Run()
+{
+    MMA_TRACE_THREAD("control");
+
+    pollfd fds[2] = { { m_stopFd, POLLIN, 0 }, { m_listenFd, POLLIN, 0 } };
+    for (;;)
+    {
+        if (poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        if (fds[0].revents)
+            break;
+
+        int connection = accept4(m_listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (connection < 0)
+            continue;
+
+        // Anyone on the machine can reach an abstract socket; only our own user may use it
+        m_connections.fetch_add(1, std::memory_order_relaxed);
+        ucred credentials;
+        socklen_t size = sizeof(credentials);
+        bool keepRunning = true;
+        if (getsockopt(connection, SOL_SOCKET, SO_PEERCRED, &credentials, &size) == 0 && credentials.uid == geteuid())
+        {
+            m_connectionFd = connection;
+            keepRunning = ServeConnection();
+            m_connectionFd = -1;
+        }
+        else
+        {
+            m_rejected.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        close(connection);
+        if (!keepRunning)
+            break;
+    }
+}
+
+bool ControlServer::ServeConnection()
+{
+    pollfd fds[2] = { { m_stopFd, POLLIN, 0 }, { m_connectionFd, POLLIN, 0 } };
+    for (;;)
+    {
+        int ready = poll(fds, 2, static_cast<int>(IDLE_TIMEOUT_MS));
+        if (ready < 0 && errno == EINTR)
+            continue;
+        if (ready <= 0)
+            return true;
+        if (fds[0].revents)
+            return false;
+
+        // MSG_TRUNC returns the real length of an oversized frame, which is rejected
+        ControlRequest request;
+        ssize_t length = recv(m_connectionFd, &request, sizeof(request), MSG_TRUNC | MSG_DONTWAIT);
+        if (length < 0 && (errno == EAGAIN || errno == EINTR))
+            continue;
+        if (length <= 0)
+            return true;
+        if (length != static_cast<ssize_t>(sizeof(request)))
+        {
+            m_rejected.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        ControlResponse response;
+        Answer(request, response);
+        if (send(m_connectionFd, &response, sizeof(response), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(response)))
+            return true;
+    }
+}
+
+#endif
\ No newline at end of file
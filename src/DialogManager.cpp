@@ -4,6 +4,7 @@
 #include "SettingsManager.h"
 #include "HotkeyManager.h"
 #include "SystemTray.h"
+#include "TraceRecorder.h"
 #include "resource.h"
 #include <commctrl.h>
 
@@ -30,6 +31,32 @@ void DialogManager::DestroyMainDialog()
     }
 }
 
+HWND DialogManager::CreateMessageWindow(HINSTANCE hInstance)
+{
+    WNDCLASSEXW windowClass = {};
+    windowClass.cbSize = sizeof(windowClass);
+    windowClass.lpfnWndProc = MessageWndProc;
+    windowClass.hInstance = hInstance;
+    windowClass.lpszClassName = APP_WINDOW_CLASS;
+    if (!RegisterClassExW(&windowClass) && GetLastError() != ERROR_CLASS_ALREADY_EXISTS)
+        return nullptr;
+
+    // A top-level tool window that is never shown, rather than a message-only window:
+    // those miss broadcasts and cannot take the foreground the tray menu needs
+    m_messageWindow = CreateWindowExW(WS_EX_TOOLWINDOW, APP_WINDOW_CLASS, APP_NAME, WS_POPUP,
+                                      0, 0, 0, 0, nullptr, nullptr, hInstance, nullptr);
+    return m_messageWindow;
+}
+
+void DialogManager::DestroyMessageWindow()
+{
+    if (m_messageWindow)
+    {
+        DestroyWindow(m_messageWindow);
+        m_messageWindow = nullptr;
+    }
+}
+
 INT_PTR CALLBACK DialogManager::MainDlgProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lParam)
 {
     if (!s_instance)
@@ -54,11 +81,60 @@ INT_PTR CALLBACK DialogManager::MainDlgProc(HWND hDlg, UINT message, WPARAM wPar
         
     case WM_HOTKEY:
         return s_instance->HandleMainDialogHotkey(hDlg, wParam);
+
+    case WM_SETTINGS_CHANGED:
+        ApplicationManager::GetInstance().ApplyExternalSettings();
+        return TRUE;
+
+    case WM_CONTROL_REQUEST:
+        ApplicationManager::GetInstance().HandleControlRequest(lParam);
+        return TRUE;
     }
     
     return FALSE;
 }
 
+LRESULT CALLBACK DialogManager::MessageWndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    if (s_instance)
+    {
+        bool handled = false;
+        switch (message)
+        {
+        case WM_COMMAND:
+            handled = s_instance->HandleMainDialogCommand(hWnd, wParam, lParam);
+            break;
+            
+        case WM_TIMER:
+            handled = s_instance->HandleMainDialogTimer(hWnd, wParam);
+            break;
+            
+        case WM_TRAYICON:
+            handled = s_instance->HandleMainDialogTrayIcon(hWnd, wParam, lParam);
+            break;
+            
+        case WM_HOTKEY:
+            handled = s_instance->HandleMainDialogHotkey(hWnd, wParam);
+            break;
+
+        case WM_SETTINGS_CHANGED:
+            ApplicationManager::GetInstance().ApplyExternalSettings();
+            handled = true;
+            break;
+
+        case WM_CONTROL_REQUEST:
+            ApplicationManager::GetInstance().HandleControlRequest(lParam);
+            handled = true;
+            break;
+        }
+        
+        if (handled)
+            return 0;
+    }
+    
+    return DefWindowProcW(hWnd, message, wParam, lParam);
+}
+
 INT_PTR CALLBACK DialogManager::AboutDlgProc(HWND hDlg, UINT message, WPARAM wParam, LPARAM lParam)
 {
     UNREFERENCED_PARAMETER(lParam);
@@ -99,6 +175,7 @@ INT_PTR CALLBACK DialogManager::HotkeyDlgProc(HWND hDlg, UINT message, WPARAM wP
 
 void DialogManager::UpdateUI()
 {
+    MMA_TRACE_SCOPE("ui.update");
     if (!m_mainDialog)
         return;
         
@@ -157,12 +234,12 @@ bool DialogManager::HandleMainDialogInit(HWND hDlg)
     // Load settings into UI
     LoadSettingsToUI(hDlg);
     
-    // Add tray icon
-    app.GetSystemTray()->AddTrayIcon(hDlg);
+    // Add tray icon (already there when the dialog is built on first show)
+    app.GetSystemTray()->AddTrayIcon(app.GetMessageWindow());
     
     // Register hotkey
     auto* settings = app.GetSettingsManager();
-    app.GetHotkeyManager()->RegisterGlobalHotkey(hDlg, 
+    app.GetHotkeyManager()->RegisterGlobalHotkey(app.GetMessageWindow(), 
         settings->GetHotkeyModifiers(), settings->GetHotkeyVK());
     
     return TRUE;
@@ -237,6 +314,12 @@ bool DialogManager::HandleMainDialogCommand(HWND hDlg, WPARAM wParam, LPARAM lPa
     case IDM_TRAY_EXIT:
         PostQuitMessage(0);
         return TRUE;
+
+#ifdef MMA_ENABLE_TRACE
+    case IDM_TRAY_SAVE_TRACE:
+        SaveTrace(hDlg);
+        return TRUE;
+#endif
         
     // Handle checkboxes
     case IDC_MINIMIZE_TO_TRAY:
@@ -252,8 +335,9 @@ bool DialogManager::HandleMainDialogCommand(HWND hDlg, WPARAM wParam, LPARAM lPa
 
 bool DialogManager::HandleMainDialogTimer(HWND hDlg, WPARAM wParam)
 {
-    if (wParam == 1) // Activity check timer
+    if (wParam == ACTIVITY_TIMER_ID) // Activity deadline timer
     {
+        MMA_TRACE_SCOPE("timer.fire");
         auto& app = ApplicationManager::GetInstance();
         app.GetActivityMonitor()->CheckActivity();
         return TRUE;
@@ -440,7 +524,7 @@ bool DialogManager::HandleHotkeyDialogCommand(HWND hDlg, WPARAM wParam, LPARAM l
             
             // Re-register with new hotkey
             app.GetHotkeyManager()->RegisterGlobalHotkey(
-                app.GetMainDialog(), modifiers, vk);
+                app.GetMessageWindow(), modifiers, vk);
         }
         EndDialog(hDlg, IDOK);
         return TRUE;
@@ -524,4 +608,31 @@ void DialogManager::CenterDialogOnScreen(HWND hDlg)
     
     // Move the dialog to the centered position
     SetWindowPos(hDlg, nullptr, x, y, 0, 0, SWP_NOZORDER | SWP_NOSIZE);
-}
\ No newline at end of file
+}
+
+#ifdef MMA_ENABLE_TRACE
+void DialogManager::SaveTrace(HWND hDlg)
+{
+    // %TEMP%\mma-trace-YYYYMMDD-HHMMSS.json, opens directly in Perfetto or chrome://tracing
+    WCHAR path[MAX_PATH];
+    DWORD length = GetTempPathW(MAX_PATH, path);
+    if (length == 0 || length > MAX_PATH - 32)
+        return;
+
+    SYSTEMTIME now;
+    GetLocalTime(&now);
+    swprintf_s(path + length, MAX_PATH - length, L"mma-trace-%04u%02u%02u-%02u%02u%02u.json",
+               now.wYear, now.wMonth, now.wDay, now.wHour, now.wMinute, now.wSecond);
+
+    FILE* file = nullptr;
+    bool saved = _wfopen_s(&file, path, L"w") == 0 && TraceRecorder::WriteChromeJson(file);
+    if (file)
+    {
+        saved = fclose(file) == 0 && saved;
+    }
+
+    WCHAR message[MAX_PATH + 64];
+    swprintf_s(message, saved ? L"Trace saved to %s" : L"Failed to write the trace to %s", path);
+    MessageBoxW(hDlg, message, L"Save Trace", MB_OK | (saved ? MB_ICONINFORMATION : MB_ICONERROR));
+}
+#endif
\ No newline at end of file
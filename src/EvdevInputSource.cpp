@@ -0,0 +1,325 @@
+#include "EvdevInputSource.h"
+#include "AllocationAudit.h"
+#include "InputDispatch.h"
+#include "MonotonicClock.h"
+#include "TraceRecorder.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// epoll tags of the wake and inotify descriptors; devices are tagged with their
+// st_rdev (st_ino for FIFOs), which never reach these values
+static const uint64_t WAKE_TAG = UINT64_MAX;
+static const uint64_t HOTPLUG_TAG = UINT64_MAX - 1;
+
+static bool IsEventNode(const char* name)
+{
+    return strncmp(name, "event", 5) == 0;
+}
+
+EvdevInputSource::EvdevInputSource(const char* directory)
+{
+    snprintf(m_directory, sizeof(m_directory), "%s", directory);
+}
+
+EvdevInputSource::~EvdevInputSource()
+{
+    Close();
+}
+
+bool EvdevInputSource::Open()
+{
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_epollFd < 0 || m_wakeFd < 0)
+    {
+        Close();
+        return false;
+    }
+
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.u64 = WAKE_TAG;
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &ev);
+
+    // udev creates the node first and fixes permissions after, so watch both
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd >= 0 && inotify_add_watch(m_inotifyFd, m_directory, IN_CREATE | IN_ATTRIB) >= 0)
+    {
+        ev.data.u64 = HOTPLUG_TAG;
+        epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_inotifyFd, &ev);
+    }
+
+    ScanDirectory();
+    return true;
+}
+
+void EvdevInputSource::Pump(InputDispatch& dispatch)
+{
+    epoll_event ready[16];
+
+    for (;;)
+    {
+        int count = epoll_wait(m_epollFd, ready, 16, -1);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            uint64_t tag = ready[i].data.u64;
+            if (tag == WAKE_TAG)
+                return;
+
+            if (tag == HOTPLUG_TAG)
+            {
+                ReadHotplug();
+                continue;
+            }
+
+            // Find the slot by its stable id; slots move when devices close
+            for (size_t d = 0; d < m_deviceCount; ++d)
+            {
+                if (m_devices[d].id == tag)
+                {
+                    ReadDevice(dispatch, d);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void EvdevInputSource::Wake()
+{
+    if (m_wakeFd >= 0)
+    {
+        uint64_t one = 1;
+        ssize_t written = write(m_wakeFd, &one, sizeof(one));
+        (void)written;
+    }
+}
+
+void EvdevInputSource::Close()
+{
+    while (m_deviceCount > 0)
+    {
+        CloseDevice(m_deviceCount - 1);
+    }
+
+    if (m_inotifyFd >= 0)
+    {
+        close(m_inotifyFd);
+        m_inotifyFd = -1;
+    }
+
+    if (m_wakeFd >= 0)
+    {
+        close(m_wakeFd);
+        m_wakeFd = -1;
+    }
+
+    if (m_epollFd >= 0)
+    {
+        close(m_epollFd);
+        m_epollFd = -1;
+    }
+}
+
+bool EvdevInputSource::Decode(const input_event& record, uint64_t device, uint64_t timestampMs, InputEvent& event)
+{
+    event.timestampMs = timestampMs;
+    event.device = device;
+    event.x = 0;
+    event.y = 0;
+
+    switch (record.type)
+    {
+    case EV_KEY:
+        if (record.code >= BTN_MISC && record.code < KEY_OK)
+        {
+            event.type = InputEventType::MouseButton;
+        }
+        else
+        {
+            event.type = record.value == 0 ? InputEventType::KeyUp : InputEventType::KeyDown;
+            event.x = static_cast<int16_t>(record.code);
+        }
+        return true;
+
+    case EV_REL:
+        if (record.code == REL_WHEEL || record.code == REL_HWHEEL)
+        {
+            event.type = InputEventType::MouseWheel;
+            event.y = static_cast<int16_t>(record.value);
+        }
+        else
+        {
+            event.type = InputEventType::MouseMove;
+            if (record.code == REL_X)
+                event.x = static_cast<int16_t>(record.value);
+            else if (record.code == REL_Y)
+                event.y = static_cast<int16_t>(record.value);
+        }
+        return true;
+
+    case EV_ABS:
+        // Touchpads and tablets; the axis value is only kept as a coarse hint
+        event.type = InputEventType::MouseMove;
+        if (record.code == ABS_X)
+            event.x = static_cast<int16_t>(record.value >> 1);
+        else if (record.code == ABS_Y)
+            event.y = static_cast<int16_t>(record.value >> 1);
+        return true;
+    }
+
+    // EV_SYN, EV_MSC, LEDs and the like are not user activity
+    return false;
+}
+
+void EvdevInputSource::ScanDirectory()
+{
+    DIR* dir = opendir(m_directory);
+    if (!dir)
+        return;
+
+    while (dirent* entry = readdir(dir))
+    {
+        if (IsEventNode(entry->d_name))
+        {
+            OpenDevice(entry->d_name);
+        }
+    }
+
+    closedir(dir);
+}
+
+void EvdevInputSource::OpenDevice(const char* name)
+{
+    if (m_deviceCount >= MAX_DEVICES)
+        return;
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s", m_directory, name);
+
+    int fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+        return;
+
+    // The device number identifies the node across hotplug notifications
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        return;
+    }
+
+    uint64_t id = static_cast<uint64_t>(info.st_rdev ? info.st_rdev : info.st_ino);
+    for (size_t i = 0; i < m_deviceCount; ++i)
+    {
+        if (m_devices[i].id == id)
+        {
+            // Already open (IN_ATTRIB after IN_CREATE)
+            close(fd);
+            return;
+        }
+    }
+
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.u64 = id;
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &ev) != 0)
+    {
+        close(fd);
+        return;
+    }
+
+    m_devices[m_deviceCount].fd = fd;
+    m_devices[m_deviceCount].id = id;
+    ++m_deviceCount;
+}
+
+void EvdevInputSource::CloseDevice(size_t index)
+{
+    epoll_ctl(m_epollFd, EPOLL_CTL_DEL, m_devices[index].fd, nullptr);
+    close(m_devices[index].fd);
+
+    // Keep the table dense
+    m_devices[index] = m_devices[m_deviceCount - 1];
+    --m_deviceCount;
+}
+
+void EvdevInputSource::ReadDevice(InputDispatch& dispatch, size_t index)
+{
+    MMA_TRACE_SCOPE("evdev.read");
+    MMA_NO_ALLOC_SCOPE("evdev.read");
+    input_event records[READ_BATCH];
+    Device& device = m_devices[index];
+
+    for (;;)
+    {
+        ssize_t bytes = read(device.fd, records, sizeof(records));
+        ++m_readCalls;
+
+        if (bytes <= 0)
+        {
+            // Unplugged (ENODEV) or writer gone (EOF on a FIFO)
+            if (bytes == 0 || (errno != EAGAIN && errno != EINTR))
+            {
+                CloseDevice(index);
+            }
+            return;
+        }
+
+        // One clock read per batch instead of per record
+        uint64_t now = MonotonicNowMs();
+        size_t count = static_cast<size_t>(bytes) / sizeof(input_event);
+        m_eventsRead += count;
+
+        InputEvent event;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (Decode(records[i], device.id, now, event))
+            {
+                dispatch.Dispatch(event);
+            }
+        }
+
+        // A short read means the kernel buffer is drained
+        if (count < READ_BATCH)
+            return;
+    }
+}
+
+void EvdevInputSource::ReadHotplug()
+{
+    alignas(inotify_event) char buffer[4096];
+
+    for (;;)
+    {
+        ssize_t bytes = read(m_inotifyFd, buffer, sizeof(buffer));
+        if (bytes <= 0)
+            return;
+
+        for (char* p = buffer; p < buffer + bytes; )
+        {
+            inotify_event* notification = reinterpret_cast<inotify_event*>(p);
+            if (notification->len > 0 && IsEventNode(notification->name))
+            {
+                OpenDevice(notification->name);
+            }
+            p += sizeof(inotify_event) + notification->len;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "EventDrainThread.h"
+#include "AllocationAudit.h"
+#include "InputConsumer.h"
+#include "TraceRecorder.h"
+#include <chrono>
+
+EventDrainThread::~EventDrainThread()
+{
+    Stop();
+}
+
+bool EventDrainThread::Start(InputEventRing* ring, uint32_t intervalMs, uint32_t idleTimeoutMs)
+{
+    if (IsRunning())
+        return true;
+
+    if (!ring)
+        return false;
+
+    m_ring = ring;
+    m_intervalMs = intervalMs;
+    m_idleTimeoutMs = idleTimeoutMs;
+    m_stopRequested = false;
+    m_thread = std::thread(&EventDrainThread::Run, this);
+    return true;
+}
+
+void EventDrainThread::Stop()
+{
+    if (!IsRunning())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopRequested = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void EventDrainThread::Run()
+{
+    MMA_TRACE_THREAD("drain");
+
+    auto woken = [this] { return m_stopRequested || m_wakePending.load(std::memory_order_relaxed); };
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    bool idle = true;
+    for (;;)
+    {
+        if (idle)
+        {
+            // Announce the sleep before the last look at the ring, so a push either
+            // lands in that look or sees the flag and signals
+            m_sleeping.store(true);
+            if (m_ring->GetSize() == 0)
+                m_wake.wait_for(lock, std::chrono::milliseconds(m_idleTimeoutMs), woken);
+            m_sleeping.store(false, std::memory_order_relaxed);
+        }
+        else
+        {
+            m_wake.wait_for(lock, std::chrono::milliseconds(m_intervalMs), woken);
+        }
+        m_wakePending.store(false, std::memory_order_relaxed);
+        if (m_stopRequested)
+            break;
+
+        lock.unlock();
+        idle = Drain() == 0;
+        lock.lock();
+    }
+
+    // Hand over whatever arrived before the stop
+    lock.unlock();
+    Drain();
+}
+
+size_t EventDrainThread::Drain()
+{
+    MMA_TRACE_SCOPE("ring.drain");
+    MMA_NO_ALLOC_SCOPE("ring.drain");
+    InputEvent batch[BATCH_SIZE];
+
+    size_t total = 0;
+    size_t count;
+    while ((count = m_ring->PopBatch(batch, BATCH_SIZE)) > 0)
+    {
+        for (IInputConsumer* consumer : m_consumers)
+        {
+            consumer->OnEvents(batch, count);
+        }
+        total += count;
+    }
+
+    m_passes.store(m_passes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (m_passCallback)
+        m_passCallback();
+    return total;
+}
\ No newline at end of file
@@ -0,0 +1,359 @@
+#include "FileSettingsStore.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#include "framework.h"
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Static member definitions
+const char* const FileSettingsStore::FILE_NAME = "mma.ini";
+
+static const char* const SECTION_NAME = "[MMA]";
+
+FileSettingsStore::FileSettingsStore(const std::string& path)
+    : m_path(path)
+{
+}
+
+bool FileSettingsStore::Open(bool forWrite)
+{
+    Close();
+
+    // A missing file reads like a missing registry key; a save creates it
+    std::string text;
+    if (!ReadFile(m_path, text) && (!forWrite || FileExists(m_path)))
+        return false;
+
+    Parse(text);
+    m_open = true;
+    m_modified = false;
+    return true;
+}
+
+bool FileSettingsStore::Close()
+{
+    if (!m_open)
+        return true;
+
+    m_open = false;
+    if (!m_modified)
+        return true;
+
+    m_modified = false;
+    std::string text = Serialize();
+    return WriteFileAtomic(m_path, text.data(), text.size());
+}
+
+bool FileSettingsStore::ReadUInt32(const char* name, uint32_t& value)
+{
+    if (!m_open)
+        return false;
+
+    for (const auto& entry : m_values)
+    {
+        if (entry.first == name)
+        {
+            value = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FileSettingsStore::WriteUInt32(const char* name, uint32_t value)
+{
+    if (!m_open)
+        return false;
+
+    for (auto& entry : m_values)
+    {
+        if (entry.first == name)
+        {
+            m_modified |= entry.second != value;
+            entry.second = value;
+            return true;
+        }
+    }
+
+    m_values.emplace_back(name, value);
+    m_modified = true;
+    return true;
+}
+
+// Decimal digits only, up to UINT32_MAX; "060" is 60, and signs, hex, units
+// and anything else after the digits make the value invalid
+static bool ParseValue(const char* text, uint32_t& value)
+{
+    text += strspn(text, " \t");
+    if (*text < '0' || *text > '9')
+        return false;
+
+    errno = 0;
+    char* end = nullptr;
+    unsigned long long parsed = strtoull(text, &end, 10);
+    if (errno == ERANGE || parsed > UINT32_MAX || *end != '\0')
+        return false;
+
+    value = static_cast<uint32_t>(parsed);
+    return true;
+}
+
+void FileSettingsStore::Parse(const std::string& text)
+{
+    m_values.clear();
+
+    size_t position = 0;
+    while (position < text.size())
+    {
+        size_t end = text.find('\n', position);
+        if (end == std::string::npos)
+            end = text.size();
+
+        std::string line = text.substr(position, end - position);
+        position = end + 1;
+
+        // Trim, then skip blanks, comments and section headers
+        size_t first = line.find_first_not_of(" \t\r");
+        size_t last = line.find_last_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == ';' || line[first] == '#' || line[first] == '[')
+            continue;
+        line = line.substr(first, last - first + 1);
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos || equals == 0)
+            continue;
+
+        // Lines with a malformed value are skipped, so the setting keeps its default
+        std::string name = line.substr(0, line.find_last_not_of(" \t", equals - 1) + 1);
+        uint32_t value = 0;
+        if (!ParseValue(line.c_str() + equals + 1, value))
+            continue;
+
+        // A repeated name keeps its last value, as in most INI readers
+        bool replaced = false;
+        for (auto& entry : m_values)
+        {
+            if (entry.first == name)
+            {
+                entry.second = value;
+                replaced = true;
+            }
+        }
+        if (!replaced)
+            m_values.emplace_back(name, value);
+    }
+}
+
+std::string FileSettingsStore::Serialize() const
+{
+    std::string text = SECTION_NAME;
+    text += '\n';
+    for (const auto& entry : m_values)
+    {
+        text += entry.first;
+        text += '=';
+        text += std::to_string(entry.second);
+        text += '\n';
+    }
+    return text;
+}
+
+#ifdef _WIN32
+
+static std::wstring ToWide(const std::string& path)
+{
+    int length = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    if (length <= 1)
+        return std::wstring();
+
+    std::wstring wide(static_cast<size_t>(length - 1), L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &wide[0], length);
+    return wide;
+}
+
+static void CreateParentDirectories(const std::wstring& path)
+{
+    for (size_t separator = path.find_first_of(L"\\/", 3); separator != std::wstring::npos;
+         separator = path.find_first_of(L"\\/", separator + 1))
+    {
+        CreateDirectoryW(path.substr(0, separator).c_str(), nullptr);
+    }
+}
+
+std::string FileSettingsStore::GetDefaultPath()
+{
+    WCHAR appData[MAX_PATH];
+    DWORD length = GetEnvironmentVariableW(L"APPDATA", appData, MAX_PATH);
+    if (length == 0 || length >= MAX_PATH)
+        return std::string();
+
+    char utf8Path[MAX_PATH * 3];
+    if (WideCharToMultiByte(CP_UTF8, 0, appData, -1, utf8Path, sizeof(utf8Path), nullptr, nullptr) <= 0)
+        return std::string();
+
+    return std::string(utf8Path) + "\\MMA\\" + FILE_NAME;
+}
+
+bool FileSettingsStore::FileExists(const std::string& path)
+{
+    return GetFileAttributesW(ToWide(path).c_str()) != INVALID_FILE_ATTRIBUTES;
+}
+
+bool FileSettingsStore::ReadFile(const std::string& path, std::string& contents)
+{
+    HANDLE file = CreateFileW(ToWide(path).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    bool success = GetFileSizeEx(file, &size) && size.QuadPart < (1 << 20);
+    DWORD read = 0;
+    if (success)
+    {
+        contents.resize(static_cast<size_t>(size.QuadPart));
+        success = contents.empty() ||
+                  (::ReadFile(file, &contents[0], static_cast<DWORD>(contents.size()), &read, nullptr) &&
+                   read == contents.size());
+    }
+
+    CloseHandle(file);
+    return success;
+}
+
+bool FileSettingsStore::WriteFileAtomic(const std::string& path, const void* data, size_t size)
+{
+    std::wstring widePath = ToWide(path);
+    std::wstring tempPath = widePath + L".tmp";
+    CreateParentDirectories(widePath);
+
+    HANDLE file = CreateFileW(tempPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    DWORD written = 0;
+    BOOL success = ::WriteFile(file, data, static_cast<DWORD>(size), &written, nullptr) && written == size &&
+                   FlushFileBuffers(file);
+    CloseHandle(file);
+
+    if (!success)
+    {
+        DeleteFileW(tempPath.c_str());
+        return false;
+    }
+
+    return MoveFileExW(tempPath.c_str(), widePath.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != FALSE;
+}
+
+#else
+
+static void CreateParentDirectories(const std::string& path)
+{
+    for (size_t separator = path.find('/', 1); separator != std::string::npos; separator = path.find('/', separator + 1))
+    {
+        mkdir(path.substr(0, separator).c_str(), 0700);
+    }
+}
+
+std::string FileSettingsStore::GetDefaultPath()
+{
+    // XDG base directories: a relative XDG_CONFIG_HOME is invalid and ignored
+    const char* configHome = getenv("XDG_CONFIG_HOME");
+    if (configHome && configHome[0] == '/')
+        return std::string(configHome) + "/mma/" + FILE_NAME;
+
+    const char* home = getenv("HOME");
+    if (home && home[0] == '/')
+        return std::string(home) + "/.config/mma/" + FILE_NAME;
+
+    return std::string();
+}
+
+bool FileSettingsStore::FileExists(const std::string& path)
+{
+    return access(path.c_str(), F_OK) == 0;
+}
+
+bool FileSettingsStore::ReadFile(const std::string& path, std::string& contents)
+{
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    // Settings files are tiny: one read normally returns all of it
+    contents.clear();
+    char buffer[4096];
+    ssize_t count;
+    while ((count = read(fd, buffer, sizeof(buffer))) != 0)
+    {
+        if (count < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            close(fd);
+            return false;
+        }
+        contents.append(buffer, static_cast<size_t>(count));
+    }
+
+    close(fd);
+    return true;
+}
+
+bool FileSettingsStore::WriteFileAtomic(const std::string& path, const void* data, size_t size)
+{
+    std::string tempPath = path + ".tmp";
+    CreateParentDirectories(path);
+
+    int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0)
+        return false;
+
+    const char* bytes = static_cast<const char*>(data);
+    size_t remaining = size;
+    while (remaining > 0)
+    {
+        ssize_t written = write(fd, bytes, remaining);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            break;
+
+        bytes += written;
+        remaining -= static_cast<size_t>(written);
+    }
+
+    // The data must be on disk before the rename makes it the settings file
+    bool success = remaining == 0 && fsync(fd) == 0;
+    if (close(fd) != 0 || !success)
+    {
+        unlink(tempPath.c_str());
+        return false;
+    }
+
+    if (rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        unlink(tempPath.c_str());
+        return false;
+    }
+
+    // Persist the rename itself
+    size_t slash = path.rfind('/');
+    int directory = open(slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash).c_str()),
+                         O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (directory >= 0)
+    {
+        fsync(directory);
+        close(directory);
+    }
+    return true;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,38 @@
+#include "HookEventDecoder.h"
+
+void HookEventDecoder::DecodeMouse(uintptr_t message, const MouseInfo& info, uint64_t timestampMs, InputEvent& event)
+{
+    event.timestampMs = timestampMs;
+    event.device = 0;
+    event.x = static_cast<int16_t>(info.x);
+    event.y = static_cast<int16_t>(info.y);
+
+    switch (message)
+    {
+    case MESSAGE_MOUSEMOVE:
+        event.type = InputEventType::MouseMove;
+        break;
+    case MESSAGE_MOUSEWHEEL:
+    case MESSAGE_MOUSEHWHEEL:
+        // Wheel delta travels in the high word of mouseData
+        event.type = InputEventType::MouseWheel;
+        event.y = static_cast<int16_t>(info.mouseData >> 16);
+        break;
+    default:
+        event.type = InputEventType::MouseButton;
+        break;
+    }
+}
+
+void HookEventDecoder::DecodeKeyboard(uintptr_t message, const KeyboardInfo& info, uint64_t timestampMs, InputEvent& event)
+{
+    event.timestampMs = timestampMs;
+    event.device = 0;
+    event.x = static_cast<int16_t>(info.vkCode);
+
+    // Same scan code notation as RawInputDecoder: extended keys carry 0xE0 in the high byte
+    uint32_t scanCode = info.scanCode & 0xFF;
+    event.y = static_cast<int16_t>((info.flags & KEY_EXTENDED) ? (0xE000 | scanCode) : scanCode);
+    event.type = (message == MESSAGE_KEYUP || message == MESSAGE_SYSKEYUP)
+        ? InputEventType::KeyUp : InputEventType::KeyDown;
+}
\ No newline at end of file
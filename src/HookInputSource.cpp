@@ -0,0 +1,168 @@
+#include "HookInputSource.h"
+#include "AllocationAudit.h"
+#include "HookEventDecoder.h"
+#include "InputDispatch.h"
+#include "LatencyHistogram.h"
+#include "Logger.h"
+#include "TraceRecorder.h"
+#include "ApplicationManager.h"
+#include <cstddef>
+#include <cstring>
+
+// The portable decoder must see exactly the SDK layouts
+static_assert(sizeof(HookEventDecoder::MouseInfo) == sizeof(MSLLHOOKSTRUCT), "MSLLHOOKSTRUCT layout mismatch");
+static_assert(offsetof(HookEventDecoder::MouseInfo, mouseData) == offsetof(MSLLHOOKSTRUCT, mouseData),
+              "MSLLHOOKSTRUCT layout mismatch");
+static_assert(sizeof(HookEventDecoder::KeyboardInfo) == sizeof(KBDLLHOOKSTRUCT), "KBDLLHOOKSTRUCT layout mismatch");
+static_assert(offsetof(HookEventDecoder::KeyboardInfo, flags) == offsetof(KBDLLHOOKSTRUCT, flags),
+              "KBDLLHOOKSTRUCT layout mismatch");
+static_assert(HookEventDecoder::MESSAGE_MOUSEMOVE == WM_MOUSEMOVE && HookEventDecoder::MESSAGE_MOUSEWHEEL == WM_MOUSEWHEEL &&
+              HookEventDecoder::MESSAGE_MOUSEHWHEEL == WM_MOUSEHWHEEL, "WM_MOUSE* values mismatch");
+static_assert(HookEventDecoder::MESSAGE_KEYUP == WM_KEYUP && HookEventDecoder::MESSAGE_SYSKEYUP == WM_SYSKEYUP &&
+              HookEventDecoder::KEY_EXTENDED == LLKHF_EXTENDED, "WM_KEYUP / LLKHF values mismatch");
+
+// Static member definition
+HookInputSource* HookInputSource::s_instance = nullptr;
+
+HookInputSource::HookInputSource(LatencyHistogram* mouseLatency, LatencyHistogram* keyboardLatency)
+    : m_mouseLatency(mouseLatency)
+    , m_keyboardLatency(keyboardLatency)
+{
+}
+
+HookInputSource::~HookInputSource()
+{
+    Close();
+}
+
+bool HookInputSource::Open()
+{
+    m_threadId = GetCurrentThreadId();
+
+    // Hook callbacks are dispatched through this thread's message queue,
+    // so it must never wait behind anything but input
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    m_counterFrequency = frequency.QuadPart;
+
+    // Force creation of the message queue before anyone posts to it
+    MSG msg;
+    PeekMessageW(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+
+    s_instance = this;
+
+    auto& app = ApplicationManager::GetInstance();
+    HINSTANCE hInstance = app.GetAppInstance();
+
+    m_mouseHook = SetWindowsHookEx(WH_MOUSE_LL, MouseHookProc, hInstance, 0);
+    m_keyboardHook = SetWindowsHookEx(WH_KEYBOARD_LL, KeyboardHookProc, hInstance, 0);
+
+    if (m_mouseHook == nullptr || m_keyboardHook == nullptr)
+    {
+        MMA_LOG_ERROR("SetWindowsHookEx failed (mouse %s, keyboard %s, error %lu)",
+            m_mouseHook ? "ok" : "failed", m_keyboardHook ? "ok" : "failed", GetLastError());
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void HookInputSource::Pump(InputDispatch& dispatch)
+{
+    m_dispatch = &dispatch;
+
+    // Minimal pump: no windows live on this thread, only hook dispatch
+    MSG msg;
+    while (GetMessageW(&msg, nullptr, 0, 0) > 0)
+    {
+    }
+
+    m_dispatch = nullptr;
+}
+
+void HookInputSource::Wake()
+{
+    if (m_threadId)
+    {
+        PostThreadMessageW(m_threadId, WM_QUIT, 0, 0);
+    }
+}
+
+void HookInputSource::Close()
+{
+    if (m_mouseHook)
+    {
+        UnhookWindowsHookEx(m_mouseHook);
+        m_mouseHook = nullptr;
+    }
+
+    if (m_keyboardHook)
+    {
+        UnhookWindowsHookEx(m_keyboardHook);
+        m_keyboardHook = nullptr;
+    }
+
+    if (s_instance == this)
+    {
+        s_instance = nullptr;
+    }
+
+    m_threadId = 0;
+}
+
+LRESULT CALLBACK HookInputSource::MouseHookProc(int nCode, WPARAM wParam, LPARAM lParam)
+{
+    if (nCode >= 0 && s_instance && s_instance->m_dispatch)
+    {
+        MMA_TRACE_SCOPE("hook.mouse");
+        MMA_NO_ALLOC_SCOPE("hook.mouse");
+        LARGE_INTEGER start;
+        QueryPerformanceCounter(&start);
+
+        HookEventDecoder::MouseInfo info;
+        memcpy(&info, reinterpret_cast<const void*>(lParam), sizeof(info));
+
+        InputEvent event;
+        HookEventDecoder::DecodeMouse(static_cast<uintptr_t>(wParam), info, GetTickCount64(), event);
+
+        s_instance->m_dispatch->Dispatch(event);
+        s_instance->RecordLatency(s_instance->m_mouseLatency, start);
+    }
+    return CallNextHookEx(nullptr, nCode, wParam, lParam);
+}
+
+LRESULT CALLBACK HookInputSource::KeyboardHookProc(int nCode, WPARAM wParam, LPARAM lParam)
+{
+    if (nCode >= 0 && s_instance && s_instance->m_dispatch)
+    {
+        MMA_TRACE_SCOPE("hook.keyboard");
+        MMA_NO_ALLOC_SCOPE("hook.keyboard");
+        LARGE_INTEGER start;
+        QueryPerformanceCounter(&start);
+
+        HookEventDecoder::KeyboardInfo info;
+        memcpy(&info, reinterpret_cast<const void*>(lParam), sizeof(info));
+
+        InputEvent event;
+        HookEventDecoder::DecodeKeyboard(static_cast<uintptr_t>(wParam), info, GetTickCount64(), event);
+
+        s_instance->m_dispatch->Dispatch(event);
+        s_instance->RecordLatency(s_instance->m_keyboardLatency, start);
+    }
+    return CallNextHookEx(nullptr, nCode, wParam, lParam);
+}
+
+void HookInputSource::RecordLatency(LatencyHistogram* histogram, const LARGE_INTEGER& start) const
+{
+    if (!histogram)
+        return;
+
+    // Our own share of the hook budget in nanoseconds; CallNextHookEx belongs to other hooks
+    LARGE_INTEGER end;
+    QueryPerformanceCounter(&end);
+    histogram->Record(static_cast<uint64_t>(end.QuadPart - start.QuadPart) * 1000000000ULL /
+                      static_cast<uint64_t>(m_counterFrequency));
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "HookWatchdog.h"
+#include "ActivityChannel.h"
+#include "AllocationAudit.h"
+#include "IdleSource.h"
+#include "Logger.h"
+#include "TraceRecorder.h"
+
+HookWatchdog::HookWatchdog(IIdleSource& idleSource, ActivityChannel& channel, uint64_t toleranceMs)
+    : m_idleSource(idleSource)
+    , m_channel(channel)
+    , m_toleranceMs(toleranceMs)
+{
+}
+
+HookWatchdog::Verdict HookWatchdog::Check()
+{
+    ++m_checks;
+
+    uint64_t lastInputMs;
+    if (!m_idleSource.QueryLastInputTime(lastInputMs))
+        return Verdict::Unavailable;
+
+    if (lastInputMs <= m_channel.GetLastActivity() + m_toleranceMs)
+        return Verdict::Healthy;
+
+    // The system saw input the hooks never delivered: the user is active,
+    // so adopt the input before the engine decides to move the cursor
+    MMA_TRACE_INSTANT("hook.lost", lastInputMs - m_channel.GetLastActivity());
+    MMA_LOG_WARNING("Hooks missed %llu ms of input; reinstalling",
+        lastInputMs - m_channel.GetLastActivity());
+    ++m_incidents;
+    m_lastIncidentMs = lastInputMs;
+    m_channel.Advance(lastInputMs);
+
+    // Reinstalling builds a new input source; incidents are not steady state
+    MMA_ALLOC_ALLOWED_SCOPE();
+    if (m_reinstall && !m_reinstall())
+    {
+        MMA_LOG_ERROR("Hook reinstall failed");
+        ++m_reinstallFailures;
+    }
+
+    return Verdict::HookLost;
+}
\ No newline at end of file
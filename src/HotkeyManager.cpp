@@ -2,6 +2,11 @@
 #include "ApplicationManager.h"
 #include "SystemTray.h"
 
+// The portable hotkey model stores modifiers in RegisterHotKey's encoding
+static_assert(HOTKEY_MOD_ALT == MOD_ALT && HOTKEY_MOD_CONTROL == MOD_CONTROL &&
+              HOTKEY_MOD_SHIFT == MOD_SHIFT && HOTKEY_MOD_WIN == MOD_WIN,
+              "HOTKEY_MOD_* must match the Win32 MOD_* flags");
+
 HotkeyManager::HotkeyManager()
 {
 }
@@ -68,63 +73,15 @@ bool HotkeyManager::HandleHotkeyMessage(WPARAM wParam)
 
 const WCHAR* HotkeyManager::GetKeyName(UINT vk)
 {
-    // Find the key name in the global mapping array
-    for (int i = 0; i < g_keyMappingsCount; ++i)
-    {
-        if (g_keyMappings[i].vk == vk)
-        {
-            return g_keyMappings[i].name;
-        }
-    }
-    
-    return L"Unknown";
+    return HotkeyModel::GetKeyName(vk);
 }
 
 const WCHAR* HotkeyManager::GetModifierString(UINT modifiers)
 {
-    static WCHAR buffer[256];
-    buffer[0] = L'\0';
-    
-    if (modifiers & MOD_CONTROL)
-    {
-        wcscat_s(buffer, L"Ctrl");
-    }
-    
-    if (modifiers & MOD_SHIFT)
-    {
-        if (wcslen(buffer) > 0) wcscat_s(buffer, L"+");
-        wcscat_s(buffer, L"Shift");
-    }
-    
-    if (modifiers & MOD_ALT)
-    {
-        if (wcslen(buffer) > 0) wcscat_s(buffer, L"+");
-        wcscat_s(buffer, L"Alt");
-    }
-    
-    if (modifiers & MOD_WIN)
-    {
-        if (wcslen(buffer) > 0) wcscat_s(buffer, L"+");
-        wcscat_s(buffer, L"Win");
-    }
-    
-    return buffer;
+    return HotkeyModel::GetModifierString(modifiers);
 }
 
 WCHAR* HotkeyManager::GetHotkeyDisplayString(UINT modifiers, UINT vk)
 {
-    static WCHAR buffer[512];
-    const WCHAR* modifierStr = GetModifierString(modifiers);
-    const WCHAR* keyName = GetKeyName(vk);
-    
-    if (wcslen(modifierStr) > 0)
-    {
-        swprintf_s(buffer, L"%s+%s", modifierStr, keyName);
-    }
-    else
-    {
-        wcscpy_s(buffer, keyName);
-    }
-    
-    return buffer;
+    return HotkeyModel::GetHotkeyDisplayString(modifiers, vk);
 }
\ No newline at end of file
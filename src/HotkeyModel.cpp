@@ -0,0 +1,118 @@
+#include "HotkeyModel.h"
+#include <cwchar>
+
+// Virtual-key codes used by the table, mirrored from WinUser.h
+static const uint32_t KEY_BACK = 0x08;
+static const uint32_t KEY_TAB = 0x09;
+static const uint32_t KEY_RETURN = 0x0D;
+static const uint32_t KEY_ESCAPE = 0x1B;
+static const uint32_t KEY_SPACE = 0x20;
+static const uint32_t KEY_PRIOR = 0x21;
+static const uint32_t KEY_NEXT = 0x22;
+static const uint32_t KEY_END = 0x23;
+static const uint32_t KEY_HOME = 0x24;
+static const uint32_t KEY_LEFT = 0x25;
+static const uint32_t KEY_UP = 0x26;
+static const uint32_t KEY_RIGHT = 0x27;
+static const uint32_t KEY_DOWN = 0x28;
+static const uint32_t KEY_INSERT = 0x2D;
+static const uint32_t KEY_DELETE = 0x2E;
+static const uint32_t KEY_F1 = 0x70;
+
+// Key mapping data
+const KeyMapping g_keyMappings[] = {
+    {KEY_F1, L"F1"}, {KEY_F1 + 1, L"F2"}, {KEY_F1 + 2, L"F3"}, {KEY_F1 + 3, L"F4"},
+    {KEY_F1 + 4, L"F5"}, {KEY_F1 + 5, L"F6"}, {KEY_F1 + 6, L"F7"}, {KEY_F1 + 7, L"F8"},
+    {KEY_F1 + 8, L"F9"}, {KEY_F1 + 9, L"F10"}, {KEY_F1 + 10, L"F11"}, {KEY_F1 + 11, L"F12"},
+    {'A', L"A"}, {'B', L"B"}, {'C', L"C"}, {'D', L"D"}, {'E', L"E"},
+    {'F', L"F"}, {'G', L"G"}, {'H', L"H"}, {'I', L"I"}, {'J', L"J"},
+    {'K', L"K"}, {'L', L"L"}, {'M', L"M"}, {'N', L"N"}, {'O', L"O"},
+    {'P', L"P"}, {'Q', L"Q"}, {'R', L"R"}, {'S', L"S"}, {'T', L"T"},
+    {'U', L"U"}, {'V', L"V"}, {'W', L"W"}, {'X', L"X"}, {'Y', L"Y"}, {'Z', L"Z"},
+    {'0', L"0"}, {'1', L"1"}, {'2', L"2"}, {'3', L"3"}, {'4', L"4"},
+    {'5', L"5"}, {'6', L"6"}, {'7', L"7"}, {'8', L"8"}, {'9', L"9"},
+    {KEY_SPACE, L"Space"}, {KEY_ESCAPE, L"Esc"}, {KEY_TAB, L"Tab"},
+    {KEY_RETURN, L"Enter"}, {KEY_BACK, L"Backspace"}, {KEY_DELETE, L"Delete"},
+    {KEY_INSERT, L"Insert"}, {KEY_HOME, L"Home"}, {KEY_END, L"End"},
+    {KEY_PRIOR, L"Page Up"}, {KEY_NEXT, L"Page Down"},
+    {KEY_UP, L"Up Arrow"}, {KEY_DOWN, L"Down Arrow"},
+    {KEY_LEFT, L"Left Arrow"}, {KEY_RIGHT, L"Right Arrow"}
+};
+
+const int g_keyMappingsCount = sizeof(g_keyMappings) / sizeof(g_keyMappings[0]);
+
+// Append text at the end of a bounded buffer; plain copy so the same code
+// builds under MSVC SDL checks and on Linux
+static void AppendText(wchar_t* buffer, size_t capacity, const wchar_t* text)
+{
+    size_t length = wcslen(buffer);
+    while (*text && length + 1 < capacity)
+    {
+        buffer[length++] = *text++;
+    }
+    buffer[length] = L'\0';
+}
+
+const wchar_t* HotkeyModel::GetKeyName(uint32_t vk)
+{
+    // Find the key name in the global mapping array
+    for (int i = 0; i < g_keyMappingsCount; ++i)
+    {
+        if (g_keyMappings[i].vk == vk)
+        {
+            return g_keyMappings[i].name;
+        }
+    }
+
+    return L"Unknown";
+}
+
+const wchar_t* HotkeyModel::GetModifierString(uint32_t modifiers)
+{
+    static wchar_t buffer[256];
+    const size_t capacity = sizeof(buffer) / sizeof(buffer[0]);
+    buffer[0] = L'\0';
+
+    if (modifiers & HOTKEY_MOD_CONTROL)
+    {
+        AppendText(buffer, capacity, L"Ctrl");
+    }
+
+    if (modifiers & HOTKEY_MOD_SHIFT)
+    {
+        if (buffer[0]) AppendText(buffer, capacity, L"+");
+        AppendText(buffer, capacity, L"Shift");
+    }
+
+    if (modifiers & HOTKEY_MOD_ALT)
+    {
+        if (buffer[0]) AppendText(buffer, capacity, L"+");
+        AppendText(buffer, capacity, L"Alt");
+    }
+
+    if (modifiers & HOTKEY_MOD_WIN)
+    {
+        if (buffer[0]) AppendText(buffer, capacity, L"+");
+        AppendText(buffer, capacity, L"Win");
+    }
+
+    return buffer;
+}
+
+wchar_t* HotkeyModel::GetHotkeyDisplayString(uint32_t modifiers, uint32_t vk)
+{
+    static wchar_t buffer[512];
+    const size_t capacity = sizeof(buffer) / sizeof(buffer[0]);
+    const wchar_t* modifierStr = GetModifierString(modifiers);
+    const wchar_t* keyName = GetKeyName(vk);
+
+    buffer[0] = L'\0';
+    if (modifierStr[0])
+    {
+        AppendText(buffer, capacity, modifierStr);
+        AppendText(buffer, capacity, L"+");
+    }
+    AppendText(buffer, capacity, keyName);
+
+    return buffer;
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "IdleEngine.h"
+#include "ActivityChannel.h"
+#include "Clock.h"
+#include "CoreConfig.h"
+#include "CursorDriver.h"
+#include "TraceRecorder.h"
+
+IdleEngine::IdleEngine(IClock& clock, IDeadlineTimer& timer, ICursorDriver& cursor, ActivityChannel& channel)
+    : m_clock(clock)
+    , m_cursor(cursor)
+    , m_channel(channel)
+    , m_scheduler(&timer)
+{
+    m_scheduler.SetTimeout(DEFAULT_TIMEOUT_SECONDS);
+}
+
+void IdleEngine::Start()
+{
+    m_scheduler.Start(m_clock.NowMs(), m_channel.GetLastActivity());
+}
+
+void IdleEngine::Stop()
+{
+    m_scheduler.Stop();
+}
+
+void IdleEngine::SetTimeout(uint32_t timeoutSeconds)
+{
+    m_scheduler.SetTimeout(timeoutSeconds);
+
+    // Reset activity timer if monitoring is active
+    if (m_scheduler.IsRunning())
+    {
+        NoteActivity();
+        m_scheduler.Rearm(m_channel.GetLastActivity());
+    }
+}
+
+void IdleEngine::NoteActivity()
+{
+    m_channel.Advance(m_clock.NowMs());
+}
+
+bool IdleEngine::OnDeadline()
+{
+    uint64_t now = m_clock.NowMs();
+    uint64_t lastActivity = m_channel.GetLastActivity();
+
+    // The scheduler either re-arms for the newer deadline or asks for the idle action;
+    // both decisions are traced with the idle time they were based on
+    if (!m_scheduler.OnTimer(now, lastActivity))
+    {
+        MMA_TRACE_INSTANT("engine.rearm", now - lastActivity);
+        return false;
+    }
+
+    MMA_TRACE_INSTANT("engine.idle", now - lastActivity);
+    MoveCursor();
+    NoteActivity(); // Reset timer after moving mouse
+    return true;
+}
+
+void IdleEngine::MoveCursor()
+{
+    MMA_TRACE_SCOPE("cursor.move");
+    int x, y;
+    if (PickCursorTarget(x, y))
+    {
+        m_cursor.MoveTo(x, y);
+    }
+}
+
+bool IdleEngine::PickCursorTarget(int& x, int& y)
+{
+    // Get screen dimensions
+    int left, top, width, height;
+    if (!m_cursor.GetBounds(left, top, width, height))
+        return false;
+
+    // Generate random position
+    x = m_random.NextInRange(left, left + width - 1);
+    y = m_random.NextInRange(top, top + height - 1);
+    return true;
+}
+
+uint64_t IdleEngine::GetWakeupsPerHour() const
+{
+    return m_scheduler.GetWakeupsPerHour(m_clock.NowMs());
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "IdleScheduler.h"
+#include "DeadlineTimer.h"
+
+IdleScheduler::IdleScheduler(IDeadlineTimer* timer)
+    : m_timer(timer)
+{
+}
+
+void IdleScheduler::Start(uint64_t nowMs, uint64_t lastActivityMs)
+{
+    m_running = true;
+    m_startMs = nowMs;
+    m_wakeups = 0;
+    m_actions = 0;
+    Rearm(lastActivityMs);
+}
+
+void IdleScheduler::Stop()
+{
+    if (!m_running)
+        return;
+
+    m_running = false;
+    m_timer->Disarm();
+}
+
+void IdleScheduler::Rearm(uint64_t lastActivityMs)
+{
+    if (!m_running)
+        return;
+
+    m_deadlineMs = lastActivityMs + static_cast<uint64_t>(m_timeoutSeconds) * 1000;
+    m_timer->Arm(m_deadlineMs);
+}
+
+bool IdleScheduler::OnTimer(uint64_t nowMs, uint64_t lastActivityMs)
+{
+    if (!m_running)
+        return false;
+
+    ++m_wakeups;
+
+    uint64_t deadline = lastActivityMs + static_cast<uint64_t>(m_timeoutSeconds) * 1000;
+    if (nowMs + TIMER_SLACK_MS < deadline)
+    {
+        // Activity happened since arming: sleep until the new deadline
+        m_deadlineMs = deadline;
+        m_timer->Arm(m_deadlineMs);
+        return false;
+    }
+
+    // Idle for the full timeout; the caller acts and activity restarts now
+    ++m_actions;
+    Rearm(nowMs);
+    return true;
+}
+
+uint64_t IdleScheduler::GetWakeupsPerHour(uint64_t nowMs) const
+{
+    uint64_t elapsedMs = nowMs > m_startMs ? nowMs - m_startMs : 0;
+    if (elapsedMs == 0)
+        return m_wakeups;
+
+    return m_wakeups * 3600000 / elapsedMs;
+}
\ No newline at end of file
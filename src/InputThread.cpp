@@ -0,0 +1,57 @@
+#include "InputThread.h"
+#include "InputDispatch.h"
+#include "InputSource.h"
+#include "TraceRecorder.h"
+#include <future>
+
+InputThread::~InputThread()
+{
+    Stop();
+}
+
+bool InputThread::Start(IInputSource* source, InputDispatch* dispatch)
+{
+    if (IsRunning())
+        return true;
+
+    if (!source || !dispatch)
+        return false;
+
+    std::promise<bool> opened;
+    std::future<bool> openResult = opened.get_future();
+
+    m_source = source;
+    m_thread = std::thread([source, dispatch](std::promise<bool> opened)
+    {
+        MMA_TRACE_THREAD("input");
+
+        // Resources must be acquired on the thread that pumps them
+        bool ok = source->Open();
+        opened.set_value(ok);
+        if (!ok)
+            return;
+
+        source->Pump(*dispatch);
+        source->Close();
+    }, std::move(opened));
+
+    // Wait until the source is ready so callers can report failures
+    if (!openResult.get())
+    {
+        m_thread.join();
+        m_source = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+void InputThread::Stop()
+{
+    if (!IsRunning())
+        return;
+
+    m_source->Wake();
+    m_thread.join();
+    m_source = nullptr;
+}
\ No newline at end of file
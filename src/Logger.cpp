@@ -0,0 +1,320 @@
+#include "Logger.h"
+#include "MpmcRing.h"
+#include "TraceRecorder.h"
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+
+// Static member definitions
+const size_t Logger::RING_CAPACITY;
+const uint32_t Logger::IDLE_INTERVAL_MS;
+std::atomic<uint8_t> Logger::s_level{ static_cast<uint8_t>(LogLevel::Info) };
+std::atomic<uint64_t> Logger::s_written{ 0 };
+std::atomic<bool> Logger::s_wakePending{ false };
+ILogSink* Logger::s_sink = nullptr;
+std::thread Logger::s_thread;
+std::mutex Logger::s_mutex;
+std::condition_variable Logger::s_wake;
+std::condition_variable Logger::s_flushed;
+bool Logger::s_stopRequested = false;
+uint64_t Logger::s_flushRequested = 0;
+uint64_t Logger::s_flushCompleted = 0;
+
+// Shared by every producer thread and the logger thread
+static MpmcRing<LogRecord, Logger::RING_CAPACITY> s_ring;
+
+static const char* const LEVEL_NAMES[] = { "debug", "info", "warning", "error", "off" };
+
+static uint32_t CurrentThreadId()
+{
+    static std::atomic<uint32_t> s_nextId{ 1 };
+    static thread_local uint32_t t_id = 0;
+    if (!t_id)
+        t_id = s_nextId.fetch_add(1, std::memory_order_relaxed);
+    return t_id;
+}
+
+bool Logger::Start(ILogSink* sink)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (s_thread.joinable() || !sink)
+        return s_thread.joinable();
+
+    s_sink = sink;
+    s_stopRequested = false;
+    s_thread = std::thread(&Logger::Run);
+    return true;
+}
+
+void Logger::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        if (!s_thread.joinable())
+            return;
+        s_stopRequested = true;
+    }
+    s_wake.notify_one();
+    s_thread.join();
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_sink = nullptr;
+}
+
+void Logger::Flush()
+{
+    std::unique_lock<std::mutex> lock(s_mutex);
+    if (!s_thread.joinable() || s_stopRequested)
+        return;
+
+    // Every pass completes the tickets issued before it started
+    uint64_t ticket = ++s_flushRequested;
+    s_wake.notify_one();
+    s_flushed.wait(lock, [ticket] { return s_flushCompleted >= ticket; });
+}
+
+uint64_t Logger::GetDropped()
+{
+    return s_ring.GetDropped();
+}
+
+void Logger::Enqueue(LogRecord& record)
+{
+    record.threadId = CurrentThreadId();
+    record.timeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    if (!s_ring.TryPush(record))
+        return;
+
+    // Producers never wait; the logger thread is only woken early when a burst
+    // threatens to fill the ring before its next idle pass
+    if (s_ring.GetSize() >= RING_CAPACITY / 2 && !s_wakePending.exchange(true, std::memory_order_relaxed))
+        s_wake.notify_one();
+}
+
+void Logger::Run()
+{
+    MMA_TRACE_THREAD("log");
+
+    std::unique_lock<std::mutex> lock(s_mutex);
+    for (;;)
+    {
+        uint64_t flushTicket = s_flushRequested;
+        bool stopping = s_stopRequested;
+
+        lock.unlock();
+        Drain();
+        lock.lock();
+
+        s_flushCompleted = flushTicket;
+        s_flushed.notify_all();
+
+        if (stopping)
+            break;
+
+        s_wake.wait_for(lock, std::chrono::milliseconds(IDLE_INTERVAL_MS), [flushTicket]
+        {
+            return s_stopRequested || s_flushRequested != flushTicket || s_wakePending.load(std::memory_order_relaxed);
+        });
+        s_wakePending.store(false, std::memory_order_relaxed);
+    }
+}
+
+void Logger::Drain()
+{
+    // Lines are batched so a burst costs one sink write per buffer
+    char buffer[16 * 1024];
+    size_t used = 0;
+    uint64_t written = 0;
+
+    LogRecord record;
+    while (s_ring.TryPop(record))
+    {
+        if (sizeof(buffer) - used < 1024)
+        {
+            s_sink->Write(buffer, used);
+            used = 0;
+        }
+
+        used += Format(record, buffer + used, sizeof(buffer) - used);
+        ++written;
+    }
+
+    if (used)
+        s_sink->Write(buffer, used);
+    if (written)
+    {
+        s_sink->Flush();
+        s_written.store(s_written.load(std::memory_order_relaxed) + written, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * Expand one printf conversion with a captured argument
+ * Length modifiers in the format are replaced by the captured width, so
+ * "%u" or "%lu" both print a 64-bit unsigned value
+ */
+static int FormatArg(char* out, size_t size, const char* spec, size_t specLength, char conversion,
+                     LogArgType type, uint64_t bits)
+{
+    char format[32];
+    if (specLength > sizeof(format) - 4)
+        specLength = sizeof(format) - 4;
+    memcpy(format, spec, specLength);
+
+    switch (conversion)
+    {
+    case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+    {
+        if (type == LogArgType::Double)
+        {
+            double value;
+            memcpy(&value, &bits, sizeof(value));
+            bits = static_cast<uint64_t>(static_cast<int64_t>(value));
+        }
+
+        if (conversion == 'c')
+        {
+            format[specLength] = 'c';
+            format[specLength + 1] = '\0';
+            return snprintf(out, size, format, static_cast<int>(bits));
+        }
+
+        format[specLength] = 'l';
+        format[specLength + 1] = 'l';
+        format[specLength + 2] = conversion;
+        format[specLength + 3] = '\0';
+        if (conversion == 'd' || conversion == 'i')
+            return snprintf(out, size, format, static_cast<long long>(bits));
+        return snprintf(out, size, format, static_cast<unsigned long long>(bits));
+    }
+
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+    {
+        double value;
+        if (type == LogArgType::Double)
+            memcpy(&value, &bits, sizeof(value));
+        else if (type == LogArgType::Signed)
+            value = static_cast<double>(static_cast<int64_t>(bits));
+        else
+            value = static_cast<double>(bits);
+
+        format[specLength] = conversion;
+        format[specLength + 1] = '\0';
+        return snprintf(out, size, format, value);
+    }
+
+    case 's':
+        format[specLength] = 's';
+        format[specLength + 1] = '\0';
+        if (type != LogArgType::String)
+            return snprintf(out, size, "%s", "(not a string)");
+        return snprintf(out, size, format, bits ? reinterpret_cast<const char*>(static_cast<uintptr_t>(bits)) : "(null)");
+
+    case 'p':
+        return snprintf(out, size, "%p", reinterpret_cast<const void*>(static_cast<uintptr_t>(bits)));
+
+    default:
+        return snprintf(out, size, "%%%c", conversion);
+    }
+}
+
+size_t Logger::Format(const LogRecord& record, char* buffer, size_t size)
+{
+    if (size < 2)
+        return 0;
+
+    // ts=... level=... thread=... site=File.cpp:123 msg="..."
+    time_t seconds = static_cast<time_t>(record.timeUs / 1000000);
+    tm utc;
+#ifdef _WIN32
+    gmtime_s(&utc, &seconds);
+#else
+    gmtime_r(&seconds, &utc);
+#endif
+
+    const LogSite* site = record.site;
+    const char* file = site->file;
+    for (const char* c = site->file; *c; ++c)
+    {
+        if (*c == '/' || *c == '\\')
+            file = c + 1;
+    }
+
+    size_t level = static_cast<size_t>(site->level);
+    int length = snprintf(buffer, size, "ts=%04d-%02d-%02dT%02d:%02d:%02d.%03dZ level=%s thread=%u site=%s:%d msg=\"",
+                          utc.tm_year + 1900, utc.tm_mon + 1, utc.tm_mday, utc.tm_hour, utc.tm_min, utc.tm_sec,
+                          static_cast<int>(record.timeUs / 1000 % 1000),
+                          LEVEL_NAMES[level < 5 ? level : 4], record.threadId, file, site->line);
+    if (length < 0)
+        return 0;
+
+    // Keep room for the closing quote and newline
+    size_t used = static_cast<size_t>(length) < size - 2 ? static_cast<size_t>(length) : size - 2;
+    size_t limit = size - 2;
+    size_t arg = 0;
+
+    char expanded[256];
+    for (const char* c = site->format; *c && used < limit; ++c)
+    {
+        const char* text = c;
+        size_t textLength = 1;
+
+        if (*c == '%' && c[1] == '%')
+        {
+            ++c;
+        }
+        else if (*c == '%' && c[1])
+        {
+            // %[flags][width][.precision][length]conversion
+            const char* spec = c++;
+            while (*c && strchr("-+ #0", *c))
+                ++c;
+            while (*c >= '0' && *c <= '9')
+                ++c;
+            if (*c == '.')
+            {
+                ++c;
+                while (*c >= '0' && *c <= '9')
+                    ++c;
+            }
+            size_t specLength = static_cast<size_t>(c - spec);
+            while (*c && strchr("hlLqjzt", *c))
+                ++c;
+            if (!*c)
+                break;
+
+            int expandedLength = arg < record.argCount
+                ? FormatArg(expanded, sizeof(expanded), spec, specLength, *c, record.types[arg], record.args[arg])
+                : snprintf(expanded, sizeof(expanded), "(missing)");
+            ++arg;
+
+            text = expanded;
+            textLength = expandedLength < 0 ? 0 : static_cast<size_t>(expandedLength);
+            if (textLength >= sizeof(expanded))
+                textLength = sizeof(expanded) - 1;
+        }
+
+        // The message is quoted, so quotes, backslashes and line breaks are escaped
+        for (size_t i = 0; i < textLength && used < limit; ++i)
+        {
+            char ch = text[i];
+            if (ch == '"' || ch == '\\' || ch == '\n')
+            {
+                if (used + 2 > limit)
+                {
+                    used = limit;
+                    break;
+                }
+                buffer[used++] = '\\';
+                ch = ch == '\n' ? 'n' : ch;
+            }
+            buffer[used++] = ch;
+        }
+    }
+
+    buffer[used++] = '"';
+    buffer[used++] = '\n';
+    return used;
+}
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "MappedSettingsStore.h"
+#include "FileSettingsStore.h"
+#include "MemorySettingsStore.h"
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include "framework.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static_assert(SettingNameMaxLength() <= MappedSettingsStore::MAX_NAME_LENGTH, "setting names must fit a snapshot entry");
+
+// Static member definitions
+const char* const MappedSettingsStore::FILE_NAME = "mma.snapshot";
+
+MappedSettingsStore::MappedSettingsStore(const std::string& path)
+    : m_path(path)
+{
+}
+
+MappedSettingsStore::~MappedSettingsStore()
+{
+    Unmap();
+}
+
+bool MappedSettingsStore::Open(bool forWrite)
+{
+    if (forWrite)
+        return false;
+
+    // Later passes read the mapping made by the first one
+    if (m_entries)
+        return true;
+
+    if (!Map())
+        return false;
+
+    // Reject anything that was not written by this version of WriteSnapshot
+    const Header* header = static_cast<const Header*>(m_view);
+    if (m_size < sizeof(Header) || header->magic != MAGIC || header->version != VERSION ||
+        header->entrySize != sizeof(Entry) || header->count > (m_size - sizeof(Header)) / sizeof(Entry))
+    {
+        Unmap();
+        return false;
+    }
+
+    m_entries = reinterpret_cast<const Entry*>(header + 1);
+    m_count = header->count;
+    return true;
+}
+
+bool MappedSettingsStore::Close()
+{
+    return true;
+}
+
+bool MappedSettingsStore::ReadUInt32(const char* name, uint32_t& value)
+{
+    for (uint32_t i = 0; i < m_count; ++i)
+    {
+        if (strncmp(m_entries[i].name, name, sizeof(m_entries[i].name)) == 0)
+        {
+            value = m_entries[i].value;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MappedSettingsStore::WriteSnapshot(const std::string& path, const AppSettings& settings)
+{
+    MemorySettingsStore values;
+    SettingsModel::Save(values, settings);
+
+    std::vector<char> data(sizeof(Header) + values.GetValues().size() * sizeof(Entry), 0);
+    Header header = { MAGIC, VERSION, static_cast<uint16_t>(sizeof(Entry)),
+                      static_cast<uint32_t>(values.GetValues().size()), 0 };
+    memcpy(data.data(), &header, sizeof(header));
+
+    Entry* entries = reinterpret_cast<Entry*>(data.data() + sizeof(Header));
+    for (const auto& value : values.GetValues())
+    {
+        if (value.first.size() > MAX_NAME_LENGTH)
+            return false;
+
+        memcpy(entries->name, value.first.c_str(), value.first.size());
+        entries->value = value.second;
+        ++entries;
+    }
+
+    return FileSettingsStore::WriteFileAtomic(path, data.data(), data.size());
+}
+
+#ifdef _WIN32
+
+bool MappedSettingsStore::Map()
+{
+    int length = MultiByteToWideChar(CP_UTF8, 0, m_path.c_str(), -1, nullptr, 0);
+    if (length <= 1)
+        return false;
+
+    std::wstring widePath(static_cast<size_t>(length - 1), L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, m_path.c_str(), -1, &widePath[0], length);
+
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart >= static_cast<LONGLONG>(sizeof(Header)) &&
+        size.QuadPart < (1 << 20))
+    {
+        mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    }
+    CloseHandle(file);
+
+    if (!mapping)
+        return false;
+
+    // The view keeps the mapping alive on its own
+    m_view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    m_size = m_view ? static_cast<size_t>(size.QuadPart) : 0;
+    return m_view != nullptr;
+}
+
+void MappedSettingsStore::Unmap()
+{
+    if (m_view)
+        UnmapViewOfFile(m_view);
+
+    m_view = nullptr;
+    m_size = 0;
+    m_entries = nullptr;
+    m_count = 0;
+}
+
+#else
+
+bool MappedSettingsStore::Map()
+{
+    int fd = open(m_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    struct stat status;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &status) == 0 && status.st_size >= static_cast<off_t>(sizeof(Header)) &&
+        status.st_size < (1 << 20))
+    {
+        view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+
+    if (view == MAP_FAILED)
+        return false;
+
+    m_view = view;
+    m_size = static_cast<size_t>(status.st_size);
+    return true;
+}
+
+void MappedSettingsStore::Unmap()
+{
+    if (m_view)
+        munmap(const_cast<void*>(m_view), m_size);
+
+    m_view = nullptr;
+    m_size = 0;
+    m_entries = nullptr;
+    m_count = 0;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "OpenMetricsWriter.h"
+#include "LatencyHistogram.h"
+#include <cstdarg>
+#include <cstdio>
+
+#ifdef _WIN32
+#include "framework.h"
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+OpenMetricsWriter::OpenMetricsWriter()
+{
+    m_buffer.reserve(INITIAL_CAPACITY);
+}
+
+void OpenMetricsWriter::Begin()
+{
+    // clear keeps the capacity, so only the first exports grow the buffer
+    m_buffer.clear();
+}
+
+void OpenMetricsWriter::WriteCounter(const char* name, const char* help, uint64_t value)
+{
+    BeginFamily(name, "counter", help);
+    Append("%s_total %llu\n", name, static_cast<unsigned long long>(value));
+}
+
+void OpenMetricsWriter::WriteGauge(const char* name, const char* help, uint64_t value)
+{
+    BeginFamily(name, "gauge", help);
+    Append("%s %llu\n", name, static_cast<unsigned long long>(value));
+}
+
+void OpenMetricsWriter::BeginFamily(const char* name, const char* type, const char* help, const char* unit)
+{
+    Append("# TYPE %s %s\n", name, type);
+    if (unit)
+        Append("# UNIT %s %s\n", name, unit);
+    Append("# HELP %s %s\n", name, help);
+}
+
+void OpenMetricsWriter::WriteLabeledSample(const char* name, const char* suffix, const char* label,
+                                           const char* labelValue, uint64_t value)
+{
+    Append("%s%s{%s=\"%s\"} %llu\n", name, suffix, label, labelValue, static_cast<unsigned long long>(value));
+}
+
+void OpenMetricsWriter::WriteHistogram(const char* name, const char* help, const char* unit,
+                                       const LatencyHistogram& histogram, const uint64_t* bounds,
+                                       size_t boundCount, double scale)
+{
+    BeginFamily(name, "histogram", help, unit);
+
+    // One pass over the buckets; the total comes from the same pass so the
+    // cumulative counts stay monotonic while the writer keeps recording
+    size_t index = 0;
+    uint64_t cumulative = 0;
+    for (size_t b = 0; b < boundCount; ++b)
+    {
+        while (index < LatencyHistogram::BUCKET_COUNT && LatencyHistogram::UpperBoundOf(index) <= bounds[b])
+        {
+            cumulative += histogram.GetBucketCount(index++);
+        }
+        Append("%s_bucket{le=\"%.9g\"} %llu\n", name, static_cast<double>(bounds[b]) * scale,
+               static_cast<unsigned long long>(cumulative));
+    }
+
+    while (index < LatencyHistogram::BUCKET_COUNT)
+    {
+        cumulative += histogram.GetBucketCount(index++);
+    }
+
+    Append("%s_bucket{le=\"+Inf\"} %llu\n", name, static_cast<unsigned long long>(cumulative));
+    Append("%s_count %llu\n", name, static_cast<unsigned long long>(cumulative));
+    Append("%s_sum %.9g\n", name, static_cast<double>(histogram.GetSum()) * scale);
+}
+
+void OpenMetricsWriter::End()
+{
+    Append("# EOF\n");
+}
+
+void OpenMetricsWriter::Append(const char* format, ...)
+{
+    char line[512];
+
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    if (length > 0)
+        m_buffer.append(line, static_cast<size_t>(length) < sizeof(line) ? static_cast<size_t>(length) : sizeof(line) - 1);
+}
+
+#ifdef _WIN32
+
+bool OpenMetricsWriter::SetPath(const char* path)
+{
+    // Paths are UTF-8 so the core stays free of TCHAR
+    int length = MultiByteToWideChar(CP_UTF8, 0, path, -1, nullptr, 0);
+    if (length <= 1)
+        return false;
+
+    m_path.assign(static_cast<size_t>(length - 1), L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path, -1, &m_path[0], length);
+    m_tempPath = m_path + L".tmp";
+    return true;
+}
+
+bool OpenMetricsWriter::WriteFile()
+{
+    if (m_path.empty())
+        return false;
+
+    HANDLE file = CreateFileW(m_tempPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    DWORD written = 0;
+    BOOL success = ::WriteFile(file, m_buffer.data(), static_cast<DWORD>(m_buffer.size()), &written, nullptr);
+    CloseHandle(file);
+
+    if (!success || written != m_buffer.size())
+    {
+        DeleteFileW(m_tempPath.c_str());
+        return false;
+    }
+
+    return MoveFileExW(m_tempPath.c_str(), m_path.c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE;
+}
+
+#else
+
+bool OpenMetricsWriter::SetPath(const char* path)
+{
+    if (!path || !*path)
+        return false;
+
+    m_path = path;
+    m_tempPath = m_path + ".tmp";
+    return true;
+}
+
+bool OpenMetricsWriter::WriteFile()
+{
+    if (m_path.empty())
+        return false;
+
+    int fd = open(m_tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+
+    const char* data = m_buffer.data();
+    size_t remaining = m_buffer.size();
+    while (remaining > 0)
+    {
+        ssize_t written = write(fd, data, remaining);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            break;
+
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+
+    if (close(fd) != 0 || remaining > 0)
+    {
+        unlink(m_tempPath.c_str());
+        return false;
+    }
+
+    // rename replaces the target atomically within one filesystem
+    return rename(m_tempPath.c_str(), m_path.c_str()) == 0;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "ProcessMemory.h"
+#include "Logger.h"
+
+#ifdef _WIN32
+#include "framework.h"
+#include <psapi.h>
+#else
+#include <cstdio>
+#include <cstring>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#endif
+
+#ifdef _WIN32
+
+bool ProcessMemory::Query(ProcessMemoryUsage& usage)
+{
+    PROCESS_MEMORY_COUNTERS_EX counters = {};
+    counters.cb = sizeof(counters);
+    if (!K32GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters),
+                                 sizeof(counters)))
+        return false;
+
+    usage.privateBytes = counters.PrivateUsage;
+    usage.workingSetBytes = counters.WorkingSetSize;
+    return true;
+}
+
+void ProcessMemory::TrimWorkingSet()
+{
+    SetProcessWorkingSetSize(GetCurrentProcess(), static_cast<SIZE_T>(-1), static_cast<SIZE_T>(-1));
+}
+
+#else
+
+// Sums the kB fields of /proc/self/smaps_rollup (or status) whose names are listed
+static bool ReadProcKilobytes(const char* path, const char* const* fields, size_t fieldCount, uint64_t& total)
+{
+    FILE* file = fopen(path, "r");
+    if (!file)
+        return false;
+
+    char line[128];
+    bool found = false;
+    total = 0;
+    while (fgets(line, sizeof(line), file))
+    {
+        for (size_t i = 0; i < fieldCount; ++i)
+        {
+            size_t length = strlen(fields[i]);
+            unsigned long long kilobytes;
+            if (strncmp(line, fields[i], length) == 0 && sscanf(line + length, " %llu kB", &kilobytes) == 1)
+            {
+                total += kilobytes * 1024;
+                found = true;
+            }
+        }
+    }
+
+    fclose(file);
+    return found;
+}
+
+bool ProcessMemory::Query(ProcessMemoryUsage& usage)
+{
+    static const char* const PRIVATE_FIELDS[] = { "Private_Clean:", "Private_Dirty:" };
+    static const char* const RSS_FIELDS[] = { "Rss:" };
+    static const char* const STATUS_PRIVATE_FIELDS[] = { "RssAnon:" };
+    static const char* const STATUS_RSS_FIELDS[] = { "VmRSS:" };
+
+    // smaps_rollup (Linux 4.14+) separates private from shared file pages; status is the fallback
+    if (ReadProcKilobytes("/proc/self/smaps_rollup", PRIVATE_FIELDS, 2, usage.privateBytes) &&
+        ReadProcKilobytes("/proc/self/smaps_rollup", RSS_FIELDS, 1, usage.workingSetBytes))
+        return true;
+
+    return ReadProcKilobytes("/proc/self/status", STATUS_PRIVATE_FIELDS, 1, usage.privateBytes) &&
+           ReadProcKilobytes("/proc/self/status", STATUS_RSS_FIELDS, 1, usage.workingSetBytes);
+}
+
+void ProcessMemory::TrimWorkingSet()
+{
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+}
+
+#endif
+
+bool ProcessMemory::CheckBudget(uint64_t budgetBytes, const char* when)
+{
+    ProcessMemoryUsage usage;
+    if (!Query(usage))
+    {
+        MMA_LOG_WARNING("Memory self-check %s: usage unavailable", when);
+        return false;
+    }
+
+    if (usage.privateBytes > budgetBytes)
+    {
+        MMA_LOG_WARNING("Memory self-check %s: %llu KB private over the %llu KB budget, working set %llu KB",
+                        when, usage.privateBytes / 1024, budgetBytes / 1024, usage.workingSetBytes / 1024);
+        return false;
+    }
+
+    MMA_LOG_INFO("Memory self-check %s: %llu KB private of %llu KB budget, working set %llu KB",
+                 when, usage.privateBytes / 1024, budgetBytes / 1024, usage.workingSetBytes / 1024);
+    return true;
+}
\ No newline at end of file
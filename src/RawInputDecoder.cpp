@@ -0,0 +1,88 @@
+#include "RawInputDecoder.h"
+#include <cstring>
+
+static int16_t ClampCoordinate(int32_t value)
+{
+    if (value > INT16_MAX)
+        return INT16_MAX;
+    if (value < INT16_MIN)
+        return INT16_MIN;
+    return static_cast<int16_t>(value);
+}
+
+bool RawInputDecoder::Decode(const void* data, size_t size, uint64_t timestampMs, InputEvent& event)
+{
+    if (!data || size < sizeof(Header))
+        return false;
+
+    // Packets may come from unaligned fixture buffers, copy instead of casting
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    Header header;
+    memcpy(&header, bytes, sizeof(header));
+
+    // dwSize covers the whole packet; a short one means the payload was cut off
+    if (header.size < sizeof(Header) || header.size > size)
+        return false;
+    size = header.size;
+
+    event.timestampMs = timestampMs;
+    event.device = static_cast<uint64_t>(header.device);
+    event.x = 0;
+    event.y = 0;
+
+    if (header.type == TYPE_MOUSE)
+    {
+        if (size < sizeof(Header) + sizeof(Mouse))
+            return false;
+
+        Mouse mouse;
+        memcpy(&mouse, bytes + sizeof(Header), sizeof(mouse));
+
+        if (mouse.buttonFlags & MOUSE_WHEEL_MASK)
+        {
+            // Wheel delta travels in buttonData
+            event.type = InputEventType::MouseWheel;
+            event.y = static_cast<int16_t>(mouse.buttonData);
+            return true;
+        }
+
+        event.type = (mouse.buttonFlags & MOUSE_BUTTON_MASK)
+            ? InputEventType::MouseButton : InputEventType::MouseMove;
+
+        if (mouse.flags & MOUSE_ABSOLUTE)
+        {
+            // Absolute devices report 0..65535; keep the top 15 bits as a coarse position
+            event.x = static_cast<int16_t>((mouse.lastX & 0xFFFF) >> 1);
+            event.y = static_cast<int16_t>((mouse.lastY & 0xFFFF) >> 1);
+        }
+        else
+        {
+            event.x = ClampCoordinate(mouse.lastX);
+            event.y = ClampCoordinate(mouse.lastY);
+        }
+        return true;
+    }
+
+    if (header.type == TYPE_KEYBOARD)
+    {
+        if (size < sizeof(Header) + sizeof(Keyboard))
+            return false;
+
+        Keyboard keyboard;
+        memcpy(&keyboard, bytes + sizeof(Header), sizeof(keyboard));
+
+        event.type = (keyboard.flags & KEY_BREAK) ? InputEventType::KeyUp : InputEventType::KeyDown;
+        event.x = static_cast<int16_t>(keyboard.vkey);
+
+        // Prefixed scan codes tell right Ctrl, Alt and the navigation block from their twins
+        uint16_t scanCode = keyboard.makeCode & 0xFF;
+        if (keyboard.flags & KEY_E0)
+            scanCode |= 0xE000;
+        else if (keyboard.flags & KEY_E1)
+            scanCode |= 0xE100;
+        event.y = static_cast<int16_t>(scanCode);
+        return true;
+    }
+
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "RawInputSource.h"
+#include "AllocationAudit.h"
+#include "InputDispatch.h"
+#include "RawInputDecoder.h"
+#include "ApplicationManager.h"
+#include "Logger.h"
+#include "TraceRecorder.h"
+#include <cstddef>
+
+// The portable decoder must see exactly the SDK layouts
+static_assert(sizeof(RawInputDecoder::Header) == sizeof(RAWINPUTHEADER), "RAWINPUTHEADER layout mismatch");
+static_assert(offsetof(RawInputDecoder::Header, device) == offsetof(RAWINPUTHEADER, hDevice), "RAWINPUTHEADER layout mismatch");
+static_assert(sizeof(RawInputDecoder::Mouse) == sizeof(RAWMOUSE), "RAWMOUSE layout mismatch");
+static_assert(offsetof(RawInputDecoder::Mouse, lastX) == offsetof(RAWMOUSE, lLastX), "RAWMOUSE layout mismatch");
+static_assert(sizeof(RawInputDecoder::Keyboard) == sizeof(RAWKEYBOARD), "RAWKEYBOARD layout mismatch");
+static_assert(offsetof(RawInputDecoder::Keyboard, vkey) == offsetof(RAWKEYBOARD, VKey), "RAWKEYBOARD layout mismatch");
+static_assert(RawInputDecoder::TYPE_MOUSE == RIM_TYPEMOUSE && RawInputDecoder::TYPE_KEYBOARD == RIM_TYPEKEYBOARD,
+              "RIM_TYPE values mismatch");
+
+// Static member definition
+const WCHAR* RawInputSource::WINDOW_CLASS = L"MMARawInputSink";
+
+RawInputSource::RawInputSource()
+{
+}
+
+RawInputSource::~RawInputSource()
+{
+    Close();
+}
+
+bool RawInputSource::Open()
+{
+    m_threadId = GetCurrentThreadId();
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL);
+
+    auto& app = ApplicationManager::GetInstance();
+    HINSTANCE hInstance = app.GetAppInstance();
+
+    WNDCLASSEXW wc = { 0 };
+    wc.cbSize = sizeof(wc);
+    wc.lpfnWndProc = DefWindowProcW;
+    wc.hInstance = hInstance;
+    wc.lpszClassName = WINDOW_CLASS;
+    RegisterClassExW(&wc);
+
+    // Message-only window: never visible, exists only to receive WM_INPUT
+    m_window = CreateWindowExW(0, WINDOW_CLASS, L"", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, hInstance, nullptr);
+    if (!m_window)
+    {
+        MMA_LOG_ERROR("Raw input window creation failed (error %lu)", GetLastError());
+        Close();
+        return false;
+    }
+
+    RAWINPUTDEVICE devices[2] = {};
+    devices[0].usUsagePage = 0x01; // Generic desktop
+    devices[0].usUsage = 0x02;     // Mouse
+    devices[0].dwFlags = RIDEV_INPUTSINK;
+    devices[0].hwndTarget = m_window;
+    devices[1].usUsagePage = 0x01;
+    devices[1].usUsage = 0x06;     // Keyboard
+    devices[1].dwFlags = RIDEV_INPUTSINK;
+    devices[1].hwndTarget = m_window;
+
+    if (!RegisterRawInputDevices(devices, 2, sizeof(RAWINPUTDEVICE)))
+    {
+        MMA_LOG_ERROR("RegisterRawInputDevices failed (error %lu)", GetLastError());
+        Close();
+        return false;
+    }
+
+    m_devicesRegistered = true;
+    return true;
+}
+
+void RawInputSource::Pump(InputDispatch& dispatch)
+{
+    MSG msg;
+    while (GetMessageW(&msg, nullptr, 0, 0) > 0)
+    {
+        if (msg.message == WM_INPUT)
+        {
+            HandleRawInput(dispatch, reinterpret_cast<HRAWINPUT>(msg.lParam));
+        }
+
+        // DefWindowProc releases the raw input buffer
+        DispatchMessageW(&msg);
+    }
+}
+
+void RawInputSource::Wake()
+{
+    if (m_threadId)
+    {
+        PostThreadMessageW(m_threadId, WM_QUIT, 0, 0);
+    }
+}
+
+void RawInputSource::Close()
+{
+    if (m_devicesRegistered)
+    {
+        RAWINPUTDEVICE devices[2] = {};
+        devices[0].usUsagePage = 0x01;
+        devices[0].usUsage = 0x02;
+        devices[0].dwFlags = RIDEV_REMOVE;
+        devices[1].usUsagePage = 0x01;
+        devices[1].usUsage = 0x06;
+        devices[1].dwFlags = RIDEV_REMOVE;
+        RegisterRawInputDevices(devices, 2, sizeof(RAWINPUTDEVICE));
+        m_devicesRegistered = false;
+    }
+
+    if (m_window)
+    {
+        DestroyWindow(m_window);
+        m_window = nullptr;
+    }
+
+    m_threadId = 0;
+}
+
+void RawInputSource::HandleRawInput(InputDispatch& dispatch, HRAWINPUT hRawInput)
+{
+    MMA_TRACE_SCOPE("rawinput.packet");
+    MMA_NO_ALLOC_SCOPE("rawinput.packet");
+    UINT size = sizeof(m_packet);
+    UINT copied = GetRawInputData(hRawInput, RID_INPUT, m_packet, &size, sizeof(RAWINPUTHEADER));
+    if (copied == static_cast<UINT>(-1))
+        return;
+
+    InputEvent event;
+    if (RawInputDecoder::Decode(m_packet, copied, GetTickCount64(), event))
+    {
+        dispatch.Dispatch(event);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "RegistrySettingsStore.h"
+#include <cstring>
+
+RegistrySettingsStore::RegistrySettingsStore(const WCHAR* keyPath)
+    : m_keyPath(keyPath)
+{
+}
+
+RegistrySettingsStore::~RegistrySettingsStore()
+{
+    Close();
+}
+
+bool RegistrySettingsStore::Open(bool forWrite)
+{
+    Close();
+
+    if (forWrite)
+    {
+        return RegCreateKeyExW(HKEY_CURRENT_USER, m_keyPath, 0, nullptr, REG_OPTION_NON_VOLATILE,
+                               KEY_WRITE, nullptr, &m_key, nullptr) == ERROR_SUCCESS;
+    }
+
+    return RegOpenKeyExW(HKEY_CURRENT_USER, m_keyPath, 0, KEY_READ, &m_key) == ERROR_SUCCESS;
+}
+
+bool RegistrySettingsStore::Close()
+{
+    if (!m_key)
+        return true;
+
+    LONG result = RegCloseKey(m_key);
+    m_key = nullptr;
+    return result == ERROR_SUCCESS;
+}
+
+bool RegistrySettingsStore::ReadUInt32(const char* name, uint32_t& value)
+{
+    if (!m_key)
+        return false;
+
+    DWORD dwValue;
+    DWORD dwSize = sizeof(DWORD);
+    DWORD dwType;
+
+    // Value names are ASCII, so the ANSI entry point avoids a conversion per value
+    if (RegQueryValueExA(m_key, name, nullptr, &dwType, (LPBYTE)&dwValue, &dwSize) != ERROR_SUCCESS ||
+        dwType != REG_DWORD)
+    {
+        return false;
+    }
+
+    value = dwValue;
+    return true;
+}
+
+uint32_t RegistrySettingsStore::ReadValues(const char* const* names, uint32_t* values, uint32_t count)
+{
+    static const uint32_t MAX_BATCH = 32;
+
+    if (!m_key)
+        return 0;
+
+    // Fails as a whole when any value is missing or larger than a DWORD: fresh installs and
+    // upgrades take the per-value path once, after which every value exists
+    VALENTA entries[MAX_BATCH];
+    DWORD buffer[MAX_BATCH];
+    DWORD bufferSize = sizeof(buffer);
+    if (count <= MAX_BATCH)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            entries[i].ve_valuename = const_cast<LPSTR>(names[i]);
+        }
+
+        if (RegQueryMultipleValuesA(m_key, entries, count, reinterpret_cast<LPSTR>(buffer), &bufferSize) == ERROR_SUCCESS)
+        {
+            uint32_t found = 0;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                if (entries[i].ve_type == REG_DWORD && entries[i].ve_valuelen == sizeof(DWORD))
+                {
+                    DWORD value;
+                    memcpy(&value, reinterpret_cast<const void*>(entries[i].ve_valueptr), sizeof(value));
+                    values[i] = value;
+                    found |= 1u << i;
+                }
+            }
+            return found;
+        }
+    }
+
+    return ISettingsStore::ReadValues(names, values, count);
+}
+
+bool RegistrySettingsStore::WriteUInt32(const char* name, uint32_t value)
+{
+    if (!m_key)
+        return false;
+
+    DWORD dwValue = value;
+    return RegSetValueExA(m_key, name, 0, REG_DWORD, (const BYTE*)&dwValue, sizeof(DWORD)) == ERROR_SUCCESS;
+}
\ No newline at end of file
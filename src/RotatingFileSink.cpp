@@ -0,0 +1,161 @@
+#include "RotatingFileSink.h"
+
+#ifdef _WIN32
+#include "framework.h"
+#else
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+static std::wstring ToWide(const std::string& path)
+{
+    int length = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    if (length <= 1)
+        return std::wstring();
+
+    std::wstring wide(static_cast<size_t>(length - 1), L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &wide[0], length);
+    return wide;
+}
+#endif
+
+RotatingFileSink::RotatingFileSink(const char* path, uint64_t maxBytes, uint32_t maxFiles)
+    : m_path(path ? path : "")
+    , m_maxBytes(maxBytes)
+    , m_maxFiles(maxFiles ? maxFiles : 1)
+{
+}
+
+RotatingFileSink::~RotatingFileSink()
+{
+    CloseFile();
+}
+
+bool RotatingFileSink::Write(const char* text, size_t length)
+{
+    // A file that cannot be opened is retried on the next batch
+    if (!OpenFile())
+        return false;
+
+    if (m_size > 0 && m_size + length > m_maxBytes)
+    {
+        Rotate();
+        if (!OpenFile())
+            return false;
+    }
+
+#ifdef _WIN32
+    DWORD written = 0;
+    if (!::WriteFile(static_cast<HANDLE>(m_file), text, static_cast<DWORD>(length), &written, nullptr))
+        return false;
+    m_size += written;
+    return written == length;
+#else
+    while (length > 0)
+    {
+        ssize_t written = write(m_fd, text, length);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            return false;
+
+        text += written;
+        length -= static_cast<size_t>(written);
+        m_size += static_cast<uint64_t>(written);
+    }
+    return true;
+#endif
+}
+
+std::string RotatingFileSink::RotatedPath(uint32_t index) const
+{
+    return index ? m_path + "." + std::to_string(index) : m_path;
+}
+
+#ifdef _WIN32
+
+bool RotatingFileSink::OpenFile()
+{
+    if (m_file)
+        return true;
+
+    HANDLE file = CreateFileW(ToWide(m_path).c_str(), FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                              nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    m_size = GetFileSizeEx(file, &size) ? static_cast<uint64_t>(size.QuadPart) : 0;
+    m_file = file;
+    return true;
+}
+
+void RotatingFileSink::CloseFile()
+{
+    if (m_file)
+    {
+        CloseHandle(static_cast<HANDLE>(m_file));
+        m_file = nullptr;
+    }
+}
+
+void RotatingFileSink::Rotate()
+{
+    CloseFile();
+
+    // Oldest first; replacing the target discards the oldest file
+    for (uint32_t index = m_maxFiles; index > 0; --index)
+    {
+        MoveFileExW(ToWide(RotatedPath(index - 1)).c_str(), ToWide(RotatedPath(index)).c_str(),
+                    MOVEFILE_REPLACE_EXISTING);
+    }
+
+    m_size = 0;
+    ++m_rotations;
+}
+
+#else
+
+bool RotatingFileSink::OpenFile()
+{
+    if (m_fd >= 0)
+        return true;
+
+    int fd = open(m_path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    m_size = fstat(fd, &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+    m_fd = fd;
+    return true;
+}
+
+void RotatingFileSink::CloseFile()
+{
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+        m_fd = -1;
+    }
+}
+
+void RotatingFileSink::Rotate()
+{
+    CloseFile();
+
+    // rename replaces the target, so the oldest file is discarded by the first step
+    for (uint32_t index = m_maxFiles; index > 0; --index)
+    {
+        rename(RotatedPath(index - 1).c_str(), RotatedPath(index).c_str());
+    }
+
+    m_size = 0;
+    ++m_rotations;
+}
+
+#endif
\ No newline at end of file
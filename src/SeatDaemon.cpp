@@ -0,0 +1,358 @@
+#include "SeatDaemon.h"
+#include "AllocationAudit.h"
+#include "CoreConfig.h"
+#include "EvdevInputSource.h"
+#include "IdleSource.h"
+#include "InputEvent.h"
+#include "MonotonicClock.h"
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+// Device registrations pack the seat into the high half and the fd into the low half
+static const uint64_t WAKE_TAG = UINT64_MAX;
+static const uint64_t TIMER_TAG = UINT64_MAX - 1;
+static const uint64_t TASK_TAG = UINT64_MAX - 2;
+
+static uint64_t MakeDeviceTag(uint32_t seat, int fd)
+{
+    return (static_cast<uint64_t>(seat) << 32) | static_cast<uint32_t>(fd);
+}
+
+SeatDaemon::SeatDaemon()
+{
+}
+
+SeatDaemon::~SeatDaemon()
+{
+    Close();
+}
+
+bool SeatDaemon::Open()
+{
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    m_taskFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_epollFd < 0 || m_wakeFd < 0 || m_taskFd < 0 || m_timer.GetFd() < 0)
+    {
+        Close();
+        return false;
+    }
+
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.u64 = WAKE_TAG;
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeFd, &ev);
+
+    ev.data.u64 = TIMER_TAG;
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_timer.GetFd(), &ev);
+
+    ev.data.u64 = TASK_TAG;
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_taskFd, &ev);
+
+    return true;
+}
+
+void SeatDaemon::Close()
+{
+    for (int fd : m_deviceFds)
+    {
+        close(fd);
+    }
+    m_deviceFds.clear();
+
+    if (m_wakeFd >= 0)
+    {
+        close(m_wakeFd);
+        m_wakeFd = -1;
+    }
+
+    if (m_taskFd >= 0)
+    {
+        close(m_taskFd);
+        m_taskFd = -1;
+    }
+
+    std::lock_guard<std::mutex> lock(m_taskMutex);
+    m_tasks.clear();
+
+    if (m_epollFd >= 0)
+    {
+        close(m_epollFd);
+        m_epollFd = -1;
+    }
+}
+
+void SeatDaemon::Reserve(size_t seats)
+{
+    m_heap.Reserve(seats);
+}
+
+uint32_t SeatDaemon::AddSeat(uint32_t timeoutSeconds)
+{
+    uint32_t id = static_cast<uint32_t>(m_seats.size());
+    m_seats.emplace_back(m_heap, id);
+
+    Seat& seat = m_seats.back();
+    uint64_t now = MonotonicNowMs();
+    seat.lastActivityMs = now;
+    seat.scheduler.SetTimeout(std::min(std::max(timeoutSeconds, 1u), MAX_TIMEOUT_SECONDS));
+    seat.scheduler.Start(now, now);
+
+    ArmEarliest();
+    return id;
+}
+
+bool SeatDaemon::SetIdleSource(uint32_t seat, IIdleSource* source)
+{
+    if (seat >= m_seats.size())
+        return false;
+
+    m_seats[seat].idleSource = source;
+    return true;
+}
+
+bool SeatDaemon::SetTimeout(uint32_t seat, uint32_t timeoutSeconds)
+{
+    if (seat >= m_seats.size() || timeoutSeconds == 0 || timeoutSeconds > MAX_TIMEOUT_SECONDS)
+        return false;
+
+    Seat& state = m_seats[seat];
+    state.scheduler.SetTimeout(timeoutSeconds);
+    state.scheduler.Rearm(state.lastActivityMs);
+    ArmEarliest();
+    return true;
+}
+
+void SeatDaemon::Post(const Task& task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_taskMutex);
+        m_tasks.push_back(task);
+    }
+
+    uint64_t one = 1;
+    ssize_t written = write(m_taskFd, &one, sizeof(one));
+    (void)written;
+}
+
+bool SeatDaemon::AddDevice(uint32_t seat, int fd)
+{
+    if (seat >= m_seats.size() || fd < 0)
+    {
+        if (fd >= 0)
+            close(fd);
+        return false;
+    }
+
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.u64 = MakeDeviceTag(seat, fd);
+    if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &ev) != 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    m_deviceFds.push_back(fd);
+    return true;
+}
+
+bool SeatDaemon::AddDevicePath(uint32_t seat, const char* path)
+{
+    int fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    return AddDevice(seat, fd);
+}
+
+int SeatDaemon::Run()
+{
+    while (RunOnce(-1))
+    {
+    }
+    return 0;
+}
+
+bool SeatDaemon::RunOnce(int timeoutMs)
+{
+    epoll_event ready[64];
+
+    int count = epoll_wait(m_epollFd, ready, 64, timeoutMs);
+    if (count < 0)
+        return errno == EINTR;
+
+    ++m_wakeups;
+
+    for (int i = 0; i < count; ++i)
+    {
+        uint64_t tag = ready[i].data.u64;
+        if (tag == WAKE_TAG)
+            return false;
+
+        if (tag == TIMER_TAG)
+        {
+            m_timer.ConsumeExpiration();
+            ExpireDeadlines();
+            continue;
+        }
+
+        if (tag == TASK_TAG)
+        {
+            RunTasks();
+            continue;
+        }
+
+        ReadDevice(static_cast<uint32_t>(tag >> 32), static_cast<int>(tag & 0xFFFFFFFF));
+    }
+
+    return true;
+}
+
+void SeatDaemon::Stop()
+{
+    // eventfd writes are async-signal-safe
+    if (m_wakeFd >= 0)
+    {
+        uint64_t one = 1;
+        ssize_t written = write(m_wakeFd, &one, sizeof(one));
+        (void)written;
+    }
+}
+
+size_t SeatDaemon::GetSeatFootprint()
+{
+    return sizeof(Seat) + TimerHeap::GetBytesPerId();
+}
+
+void SeatDaemon::ReadDevice(uint32_t seat, int fd)
+{
+    MMA_NO_ALLOC_SCOPE("seat.input");
+    input_event records[READ_BATCH];
+    Seat& state = m_seats[seat];
+
+    for (;;)
+    {
+        ssize_t bytes = read(fd, records, sizeof(records));
+        if (bytes <= 0)
+        {
+            // Unplugged (ENODEV) or writer gone (EOF on a FIFO)
+            if (bytes == 0 || (errno != EAGAIN && errno != EINTR))
+            {
+                RemoveDevice(fd);
+            }
+            return;
+        }
+
+        size_t count = static_cast<size_t>(bytes) / sizeof(input_event);
+        uint64_t now = MonotonicNowMs();
+
+        // Only the timestamp moves; the deadline is corrected when it expires
+        InputEvent event;
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (EvdevInputSource::Decode(records[i], static_cast<uint64_t>(fd), now, event))
+            {
+                state.lastActivityMs = now;
+                ++state.events;
+            }
+        }
+
+        if (count < READ_BATCH)
+            return;
+    }
+}
+
+void SeatDaemon::RemoveDevice(int fd)
+{
+    epoll_ctl(m_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+
+    std::vector<int>::iterator it = std::find(m_deviceFds.begin(), m_deviceFds.end(), fd);
+    if (it != m_deviceFds.end())
+    {
+        *it = m_deviceFds.back();
+        m_deviceFds.pop_back();
+    }
+}
+
+void SeatDaemon::ExpireDeadlines()
+{
+    MMA_TRACE_SCOPE("seat.expire");
+    MMA_NO_ALLOC_SCOPE("seat.expire");
+    // Allow the same early-fire slack the scheduler itself tolerates
+    uint64_t now = MonotonicNowMs();
+    uint32_t id;
+
+    while (m_heap.PopExpired(now + IdleScheduler::TIMER_SLACK_MS, id))
+    {
+        Seat& seat = m_seats[id];
+
+        // Input the idle clock saw counts like input read from the seat's devices
+        if (seat.idleSource)
+        {
+            // One query per deadline, not per event; Xlib may allocate its reply
+            MMA_ALLOC_ALLOWED_SCOPE();
+            uint64_t lastInputMs;
+            if (seat.idleSource->QueryLastInputTime(lastInputMs) && lastInputMs > seat.lastActivityMs)
+                seat.lastActivityMs = lastInputMs;
+        }
+
+        // OnTimer re-arms through SeatTimer, pushing the seat back into the heap
+        if (seat.scheduler.OnTimer(now, seat.lastActivityMs))
+        {
+            MMA_TRACE_INSTANT("seat.idle", id);
+            seat.lastActivityMs = now;
+            if (m_idleAction)
+                m_idleAction(id);
+        }
+    }
+
+    m_armedDeadlineMs = 0;
+    ArmEarliest();
+}
+
+void SeatDaemon::RunTasks()
+{
+    uint64_t count;
+    ssize_t bytes = read(m_taskFd, &count, sizeof(count));
+    (void)bytes;
+
+    // Run outside the lock so a task may post another
+    std::vector<Task> tasks;
+    {
+        std::lock_guard<std::mutex> lock(m_taskMutex);
+        tasks.swap(m_tasks);
+    }
+    for (const Task& task : tasks)
+    {
+        task();
+    }
+}
+
+void SeatDaemon::ArmEarliest()
+{
+    if (m_heap.IsEmpty())
+    {
+        if (m_armedDeadlineMs != 0)
+        {
+            m_timer.Disarm();
+            m_armedDeadlineMs = 0;
+        }
+        return;
+    }
+
+    // Reprogram the kernel timer only when the head of the heap changed
+    uint64_t earliest = m_heap.GetEarliest();
+    if (earliest != m_armedDeadlineMs)
+    {
+        m_timer.Arm(earliest);
+        m_armedDeadlineMs = earliest;
+    }
+}
\ No newline at end of file
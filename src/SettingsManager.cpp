@@ -1,26 +1,73 @@
 #include "SettingsManager.h"
 #include "ApplicationManager.h"
+#include "FileSettingsStore.h"
+#include "Logger.h"
+#include "MappedSettingsStore.h"
+#include "RegistrySettingsStore.h"
 
 // Static member definitions
 const WCHAR* SettingsManager::REG_KEY = L"SOFTWARE\\MMA";
-const WCHAR* SettingsManager::REG_TIMEOUT = L"Timeout";
-const WCHAR* SettingsManager::REG_MINIMIZE_TO_TRAY = L"MinimizeToTray";
-const WCHAR* SettingsManager::REG_START_HIDDEN = L"StartHidden";
-const WCHAR* SettingsManager::REG_START_MONITORING = L"StartMonitoring";
-const WCHAR* SettingsManager::REG_START_WITH_WINDOWS = L"StartWithWindows";
-const WCHAR* SettingsManager::REG_HOTKEY_MODIFIERS = L"HotkeyModifiers";
-const WCHAR* SettingsManager::REG_HOTKEY_VK = L"HotkeyVK";
 const WCHAR* SettingsManager::STARTUP_REG_KEY = L"SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Run";
 const WCHAR* SettingsManager::STARTUP_REG_VALUE = L"MMA";
 
 SettingsManager::SettingsManager()
+    : m_store(CreateStore())
+    , m_writer(*m_store, m_clock)
+    , m_reloader(*m_store, &m_writer)
 {
     // Initialize with default values
 }
 
+std::unique_ptr<ISettingsStore> SettingsManager::CreateStore()
+{
+    // A snapshot or INI file next to the executable makes the install portable
+    WCHAR appPath[MAX_PATH];
+    char directory[MAX_PATH * 3] = {};
+    if (GetApplicationPath(appPath, MAX_PATH))
+    {
+        WCHAR* separator = wcsrchr(appPath, L'\\');
+        if (separator)
+        {
+            separator[1] = L'\0';
+            WideCharToMultiByte(CP_UTF8, 0, appPath, -1, directory, sizeof(directory), nullptr, nullptr);
+        }
+    }
+
+    if (directory[0])
+    {
+        std::string snapshotPath = std::string(directory) + MappedSettingsStore::FILE_NAME;
+        if (FileSettingsStore::FileExists(snapshotPath))
+        {
+            m_storeName = "snapshot";
+            m_storePath = snapshotPath;
+            return std::unique_ptr<ISettingsStore>(new MappedSettingsStore(snapshotPath));
+        }
+
+        std::string filePath = std::string(directory) + FileSettingsStore::FILE_NAME;
+        if (FileSettingsStore::FileExists(filePath))
+        {
+            m_storeName = "file";
+            m_storePath = filePath;
+            return std::unique_ptr<ISettingsStore>(new FileSettingsStore(filePath));
+        }
+    }
+
+    m_storeName = "registry";
+    return std::unique_ptr<ISettingsStore>(new RegistrySettingsStore(REG_KEY));
+}
+
 void SettingsManager::LoadSettings()
 {
-    LoadFromRegistry();
+    MMA_LOG_INFO("Settings backend: %s", m_storeName);
+    SettingsLoadInfo info;
+    if (SettingsModel::Load(*m_store, m_settings, &info) && info.NeedsMigration() && !m_store->IsReadOnly())
+    {
+        // Once per upgrade: write the values the old version lacked and stamp the schema version
+        bool migrated = SettingsModel::Migrate(*m_store, m_settings, info);
+        MMA_LOG_INFO("Settings migrated from version %u to %u: %u values added, %s", info.version, SETTINGS_VERSION,
+                     SettingsModel::CountFields(info.upgradeFields), migrated ? "saved" : "save failed");
+    }
+    m_writer.SetPersisted(m_settings);
     
     // Verify that Windows startup setting matches registry
     m_settings.startWithWindows = IsStartWithWindowsEnabled();
@@ -28,19 +75,74 @@ void SettingsManager::LoadSettings()
 
 void SettingsManager::SaveSettings()
 {
-    SaveToRegistry();
+    // A provisioned snapshot is the administrator's to change
+    if (m_store->IsReadOnly())
+        return;
+
+    // The writer thread only exists once something was changed
+    m_writer.Start();
+    m_writer.Submit(m_settings);
+}
+
+void SettingsManager::FlushSettings()
+{
+    m_writer.Stop();
+    if (m_writer.GetDirtyFields())
+        m_writer.Flush();
+
+    MMA_LOG_INFO("Settings: %llu save requests, %llu writes, %llu values written",
+                 m_writer.GetSubmits(), m_writer.GetWrites(), m_writer.GetValuesWritten());
+}
+
+bool SettingsManager::StartWatching(HWND hwnd)
+{
+    // The watcher thread only wakes the UI thread, which owns m_settings
+    auto notify = [hwnd]() { PostMessageW(hwnd, WM_SETTINGS_CHANGED, 0, 0); };
+    bool watching = m_storePath.empty() ? m_watcher.WatchRegistryKey(REG_KEY, notify)
+                                        : m_watcher.WatchFile(m_storePath, notify);
+    if (!watching)
+        MMA_LOG_WARNING("Settings watcher could not start; external changes apply on restart");
+    return watching;
+}
+
+void SettingsManager::StopWatching()
+{
+    m_watcher.Stop();
+    MMA_LOG_INFO("Settings: %llu reloads, %llu unchanged, %llu values applied",
+                 m_reloader.GetReloads(), m_reloader.GetUnchangedReloads(), m_reloader.GetFieldsApplied());
+}
+
+uint32_t SettingsManager::ReloadSettings()
+{
+    // The Run key, not the store, says whether we start with Windows
+    uint32_t changed = m_reloader.Reload(m_settings, SettingsModel::FIELD_START_WITH_WINDOWS);
+    MMA_LOG_DEBUG("Settings reloaded in %llu us: %u values changed", m_reloader.GetLastReloadUs(),
+                  SettingsModel::CountFields(changed));
+    return changed;
 }
 
 void SettingsManager::SetTimeout(DWORD timeout)
 {
-    if (timeout > 0 && timeout <= MAX_TIMEOUT_SECONDS)
+    if (SettingsModel::IsValidTimeout(timeout))
     {
         m_settings.timeoutSeconds = timeout;
     }
 }
 
+void SettingsManager::SetActivityBackend(DWORD backend)
+{
+    if (SettingsModel::IsValidBackend(backend))
+    {
+        m_settings.activityBackend = backend;
+    }
+}
+
 void SettingsManager::SetStartWithWindows(bool startup)
 {
+    // Every checkbox click lands here; only a real change touches the Run key
+    if (m_settings.startWithWindows == startup)
+        return;
+
     m_settings.startWithWindows = startup;
     SetStartWithWindowsRegistry(startup);
 }
@@ -59,8 +161,8 @@ bool SettingsManager::SetStartWithWindowsRegistry(bool enable)
     if (enable)
     {
         // Add to startup
-        WCHAR* appPath = GetApplicationPath();
-        if (appPath)
+        WCHAR appPath[MAX_PATH];
+        if (GetApplicationPath(appPath, MAX_PATH))
         {
             // Add quotes around path to handle spaces
             WCHAR quotedPath[MAX_PATH + 4];
@@ -68,7 +170,6 @@ bool SettingsManager::SetStartWithWindowsRegistry(bool enable)
             
             result = RegSetValueExW(hKey, STARTUP_REG_VALUE, 0, REG_SZ, 
                                    (LPBYTE)quotedPath, (wcslen(quotedPath) + 1) * sizeof(WCHAR));
-            delete[] appPath;
         }
         else
         {
@@ -115,81 +216,9 @@ bool SettingsManager::IsStartWithWindowsEnabled()
     return isEnabled;
 }
 
-WCHAR* SettingsManager::GetApplicationPath()
-{
-    WCHAR* path = new WCHAR[MAX_PATH];
-    if (GetModuleFileNameW(nullptr, path, MAX_PATH) == 0)
-    {
-        delete[] path;
-        return nullptr;
-    }
-    return path;
-}
-
-bool SettingsManager::LoadFromRegistry()
-{
-    HKEY hKey;
-    if (RegOpenKeyExW(HKEY_CURRENT_USER, REG_KEY, 0, KEY_READ, &hKey) != ERROR_SUCCESS)
-    {
-        return false;
-    }
-
-    m_settings.timeoutSeconds = ReadRegistryDWORD(hKey, REG_TIMEOUT, DEFAULT_TIMEOUT_SECONDS);
-    m_settings.minimizeToTray = ReadRegistryDWORD(hKey, REG_MINIMIZE_TO_TRAY, 1) != 0;
-    m_settings.startHidden = ReadRegistryDWORD(hKey, REG_START_HIDDEN, 0) != 0;
-    m_settings.startMonitoring = ReadRegistryDWORD(hKey, REG_START_MONITORING, 0) != 0;
-    m_settings.startWithWindows = ReadRegistryDWORD(hKey, REG_START_WITH_WINDOWS, 0) != 0;
-    m_settings.hotkeyModifiers = ReadRegistryDWORD(hKey, REG_HOTKEY_MODIFIERS, MOD_CONTROL | MOD_SHIFT);
-    m_settings.hotkeyVK = ReadRegistryDWORD(hKey, REG_HOTKEY_VK, 'M');
-
-    // Validate timeout range
-    if (m_settings.timeoutSeconds < 1 || m_settings.timeoutSeconds > MAX_TIMEOUT_SECONDS)
-    {
-        m_settings.timeoutSeconds = DEFAULT_TIMEOUT_SECONDS;
-    }
-
-    RegCloseKey(hKey);
-    return true;
-}
-
-bool SettingsManager::SaveToRegistry()
-{
-    HKEY hKey;
-    if (RegCreateKeyExW(HKEY_CURRENT_USER, REG_KEY, 0, nullptr, REG_OPTION_NON_VOLATILE, 
-                       KEY_WRITE, nullptr, &hKey, nullptr) != ERROR_SUCCESS)
-    {
-        return false;
-    }
-
-    bool success = true;
-    success &= WriteRegistryDWORD(hKey, REG_TIMEOUT, m_settings.timeoutSeconds);
-    success &= WriteRegistryDWORD(hKey, REG_MINIMIZE_TO_TRAY, m_settings.minimizeToTray ? 1 : 0);
-    success &= WriteRegistryDWORD(hKey, REG_START_HIDDEN, m_settings.startHidden ? 1 : 0);
-    success &= WriteRegistryDWORD(hKey, REG_START_MONITORING, m_settings.startMonitoring ? 1 : 0);
-    success &= WriteRegistryDWORD(hKey, REG_START_WITH_WINDOWS, m_settings.startWithWindows ? 1 : 0);
-    success &= WriteRegistryDWORD(hKey, REG_HOTKEY_MODIFIERS, m_settings.hotkeyModifiers);
-    success &= WriteRegistryDWORD(hKey, REG_HOTKEY_VK, m_settings.hotkeyVK);
-
-    RegCloseKey(hKey);
-    return success;
-}
-
-DWORD SettingsManager::ReadRegistryDWORD(HKEY hKey, const WCHAR* valueName, DWORD defaultValue)
-{
-    DWORD dwValue = defaultValue;
-    DWORD dwSize = sizeof(DWORD);
-    DWORD dwType;
-    
-    if (RegQueryValueExW(hKey, valueName, nullptr, &dwType, (LPBYTE)&dwValue, &dwSize) != ERROR_SUCCESS ||
-        dwType != REG_DWORD)
-    {
-        dwValue = defaultValue;
-    }
-    
-    return dwValue;
-}
-
-bool SettingsManager::WriteRegistryDWORD(HKEY hKey, const WCHAR* valueName, DWORD value)
+bool SettingsManager::GetApplicationPath(WCHAR* path, DWORD size)
 {
-    return RegSetValueExW(hKey, valueName, 0, REG_DWORD, (LPBYTE)&value, sizeof(DWORD)) == ERROR_SUCCESS;
+    // A truncated path fills the buffer exactly and must not end up in the Run key
+    DWORD length = GetModuleFileNameW(nullptr, path, size);
+    return length > 0 && length < size;
 }
\ No newline at end of file
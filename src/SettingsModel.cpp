@@ -0,0 +1,140 @@
+#include "SettingsModel.h"
+#include "SettingsStore.h"
+
+static_assert(SETTINGS_FIELD_COUNT < 32, "field bits and the version must fit one ReadValues mask");
+static_assert(SettingDefaultsMatch(), "SETTINGS_FIELDS defaults must match AppSettings and lie in range");
+static_assert(SettingNamesUnique(), "SETTINGS_FIELDS names must be unique");
+
+// Static member definitions
+const char* const SettingsModel::VALUE_VERSION = "SettingsVersion";
+
+bool SettingsModel::Load(ISettingsStore& store, AppSettings& settings, SettingsLoadInfo* info)
+{
+    if (!store.Open(false))
+        return false;
+
+    // One batched read: every field, then the version
+    const char* names[SETTINGS_FIELD_COUNT + 1];
+    uint32_t values[SETTINGS_FIELD_COUNT + 1];
+    for (uint32_t i = 0; i < SETTINGS_FIELD_COUNT; ++i)
+    {
+        names[i] = SETTINGS_FIELDS[i].name;
+    }
+    names[SETTINGS_FIELD_COUNT] = VALUE_VERSION;
+
+    uint32_t found = store.ReadValues(names, values, SETTINGS_FIELD_COUNT + 1);
+    store.Close();
+
+    uint32_t version = (found & (1u << SETTINGS_FIELD_COUNT)) ? values[SETTINGS_FIELD_COUNT] : 0;
+    uint32_t upgradeFields = 0;
+    for (uint32_t i = 0; i < SETTINGS_FIELD_COUNT; ++i)
+    {
+        const SettingField& field = SETTINGS_FIELDS[i];
+
+        // A value from a versioned store older than its row was left over by a newer build
+        bool present = (found & (1u << i)) && (version == 0 || field.sinceVersion <= version);
+        uint32_t value = present ? values[i] : field.defaultValue;
+        field.Set(settings, field.IsValid(value) ? value : field.defaultValue);
+
+        if (!present)
+            upgradeFields |= 1u << i;
+    }
+
+    if (info)
+    {
+        info->version = version;
+        info->upgradeFields = version <= SETTINGS_VERSION ? upgradeFields : 0;
+    }
+    return true;
+}
+
+bool SettingsModel::Save(ISettingsStore& store, const AppSettings& settings)
+{
+    return WriteFields(store, settings, FIELD_ALL, true);
+}
+
+bool SettingsModel::Migrate(ISettingsStore& store, const AppSettings& settings, const SettingsLoadInfo& info)
+{
+    if (!info.NeedsMigration() || info.version > SETTINGS_VERSION)
+        return true;
+
+    return WriteFields(store, settings, info.upgradeFields, true);
+}
+
+uint32_t SettingsModel::Diff(const AppSettings& a, const AppSettings& b)
+{
+    uint32_t fields = 0;
+    for (uint32_t i = 0; i < SETTINGS_FIELD_COUNT; ++i)
+    {
+        if (SETTINGS_FIELDS[i].Get(a) != SETTINGS_FIELDS[i].Get(b))
+            fields |= 1u << i;
+    }
+    return fields;
+}
+
+bool SettingsModel::SaveFields(ISettingsStore& store, const AppSettings& settings, uint32_t fields)
+{
+    return WriteFields(store, settings, fields, false);
+}
+
+bool SettingsModel::WriteFields(ISettingsStore& store, const AppSettings& settings, uint32_t fields, bool stampVersion)
+{
+    if (!fields && !stampVersion)
+        return true;
+
+    const char* names[SETTINGS_FIELD_COUNT + 1];
+    uint32_t values[SETTINGS_FIELD_COUNT + 1];
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < SETTINGS_FIELD_COUNT; ++i)
+    {
+        if (fields & (1u << i))
+        {
+            names[count] = SETTINGS_FIELDS[i].name;
+            values[count] = SETTINGS_FIELDS[i].Get(settings);
+            ++count;
+        }
+    }
+    if (stampVersion)
+    {
+        names[count] = VALUE_VERSION;
+        values[count] = SETTINGS_VERSION;
+        ++count;
+    }
+
+    if (!store.Open(true))
+        return false;
+
+    bool success = store.WriteValues(names, values, count);
+    success &= store.Close();
+    return success;
+}
+
+uint32_t SettingsModel::CountFields(uint32_t fields)
+{
+    uint32_t count = 0;
+    for (; fields; fields &= fields - 1)
+    {
+        ++count;
+    }
+    return count;
+}
+
+void SettingsModel::CopyFields(AppSettings& target, const AppSettings& source, uint32_t fields)
+{
+    for (uint32_t i = 0; i < SETTINGS_FIELD_COUNT; ++i)
+    {
+        if (fields & (1u << i))
+            SETTINGS_FIELDS[i].Set(target, SETTINGS_FIELDS[i].Get(source));
+    }
+}
+
+void SettingsModel::Validate(AppSettings& settings)
+{
+    // Replace out-of-range values with the row's default
+    for (uint32_t i = 0; i < SETTINGS_FIELD_COUNT; ++i)
+    {
+        const SettingField& field = SETTINGS_FIELDS[i];
+        if (!field.IsValid(field.Get(settings)))
+            field.Set(settings, field.defaultValue);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "SettingsReloader.h"
+#include "SettingsStore.h"
+#include "SettingsWriter.h"
+#include <chrono>
+#include <mutex>
+
+SettingsReloader::SettingsReloader(ISettingsStore& store, SettingsWriter* writer)
+    : m_store(store)
+    , m_writer(writer)
+{
+}
+
+uint32_t SettingsReloader::Reload(AppSettings& settings, uint32_t ignoredFields)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    // The writer thread shares the store: a save in progress must not see it reopened, and
+    // one finishing between the load and the rebase would be taken for an external change
+    std::unique_lock<std::mutex> storeLock;
+    if (m_writer)
+        storeLock = m_writer->LockStore();
+
+    // Cached content (a snapshot mapping) predates the change that woke us
+    m_store.Invalidate();
+    AppSettings stored;
+    if (!SettingsModel::Load(m_store, stored))
+        return 0;
+
+    uint32_t changed;
+    if (m_writer)
+    {
+        // The writer learns what the store really holds; the live value of an ignored field is kept
+        AppSettings live = settings;
+        changed = m_writer->Rebase(stored, settings) & ~ignoredFields;
+        SettingsModel::CopyFields(settings, live, ignoredFields);
+    }
+    else
+    {
+        changed = SettingsModel::Diff(stored, settings) & ~ignoredFields;
+        SettingsModel::CopyFields(settings, stored, changed);
+    }
+
+    ++m_reloads;
+    if (!changed)
+        ++m_unchangedReloads;
+    m_fieldsApplied += SettingsModel::CountFields(changed);
+    m_lastReloadUs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    return changed;
+}
\ No newline at end of file
@@ -0,0 +1,247 @@
+#include "SettingsWatcher.h"
+#include "Logger.h"
+#include "TraceRecorder.h"
+
+#ifdef _WIN32
+#include "framework.h"
+#else
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+SettingsWatcher::~SettingsWatcher()
+{
+    Stop();
+}
+
+#ifdef _WIN32
+
+bool SettingsWatcher::WatchFile(const std::string& path, ChangeHandler handler)
+{
+    Stop();
+
+    size_t separator = path.find_last_of("\\/");
+    std::string directory = separator == std::string::npos ? "." : path.substr(0, separator);
+    int length = MultiByteToWideChar(CP_UTF8, 0, directory.c_str(), -1, nullptr, 0);
+    if (length <= 1)
+        return false;
+
+    std::wstring wideDirectory(static_cast<size_t>(length - 1), L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, directory.c_str(), -1, &wideDirectory[0], length);
+
+    // Not filtered by name: other files in the folder cause a reload that finds nothing changed
+    HANDLE change = FindFirstChangeNotificationW(wideDirectory.c_str(), FALSE,
+                                                 FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+    if (change == INVALID_HANDLE_VALUE)
+        return false;
+
+    m_changeHandle = change;
+    m_stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    m_handler = handler;
+    m_thread = std::thread(&SettingsWatcher::Run, this);
+    return true;
+}
+
+bool SettingsWatcher::WatchRegistryKey(const wchar_t* keyPath, ChangeHandler handler)
+{
+    Stop();
+
+    HKEY key;
+    if (RegCreateKeyExW(HKEY_CURRENT_USER, keyPath, 0, nullptr, REG_OPTION_NON_VOLATILE, KEY_NOTIFY, nullptr,
+                        &key, nullptr) != ERROR_SUCCESS)
+    {
+        return false;
+    }
+
+    m_key = key;
+    m_changeHandle = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    m_stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    m_handler = handler;
+    m_thread = std::thread(&SettingsWatcher::Run, this);
+    return true;
+}
+
+void SettingsWatcher::Stop()
+{
+    if (m_thread.joinable())
+    {
+        SetEvent(m_stopEvent);
+        m_thread.join();
+    }
+
+    // Closing the key also cancels a pending registry notification
+    if (m_key)
+    {
+        RegCloseKey(static_cast<HKEY>(m_key));
+        CloseHandle(m_changeHandle);
+    }
+    else if (m_changeHandle)
+    {
+        FindCloseChangeNotification(m_changeHandle);
+    }
+    if (m_stopEvent)
+        CloseHandle(m_stopEvent);
+
+    m_key = nullptr;
+    m_changeHandle = nullptr;
+    m_stopEvent = nullptr;
+}
+
+bool SettingsWatcher::Rearm()
+{
+    // Registry notifications are one-shot and tied to the thread that asked, which is this one
+    if (m_key)
+    {
+        return RegNotifyChangeKeyValue(static_cast<HKEY>(m_key), FALSE,
+                                       REG_NOTIFY_CHANGE_NAME | REG_NOTIFY_CHANGE_LAST_SET,
+                                       m_changeHandle, TRUE) == ERROR_SUCCESS;
+    }
+    return FindNextChangeNotification(m_changeHandle) != FALSE;
+}
+
+void SettingsWatcher::Run()
+{
+    MMA_TRACE_THREAD("settings-watch");
+
+    if (m_key && !Rearm())
+    {
+        MMA_LOG_WARNING("Settings watcher could not arm the registry notification");
+        return;
+    }
+
+    HANDLE handles[2] = { m_stopEvent, m_changeHandle };
+    bool pending = false;
+    for (;;)
+    {
+        DWORD result = WaitForMultipleObjects(2, handles, FALSE, pending ? SETTLE_MS : INFINITE);
+        if (result == WAIT_OBJECT_0 + 1)
+        {
+            m_notifications.fetch_add(1, std::memory_order_relaxed);
+            pending = true;
+            if (!Rearm())
+                break;
+        }
+        else if (result == WAIT_TIMEOUT)
+        {
+            pending = false;
+            m_changes.fetch_add(1, std::memory_order_relaxed);
+            m_handler();
+        }
+        else
+        {
+            break;
+        }
+    }
+}
+
+#else
+
+bool SettingsWatcher::WatchFile(const std::string& path, ChangeHandler handler)
+{
+    Stop();
+
+    size_t slash = path.rfind('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    m_fileName = path.substr(slash == std::string::npos ? 0 : slash + 1);
+
+    // Closing a file written in place, or a temporary file renamed over it
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd < 0 || inotify_add_watch(m_inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        Stop();
+        return false;
+    }
+
+    m_stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_stopFd < 0)
+    {
+        Stop();
+        return false;
+    }
+
+    m_handler = handler;
+    m_thread = std::thread(&SettingsWatcher::Run, this);
+    return true;
+}
+
+void SettingsWatcher::Stop()
+{
+    if (m_thread.joinable())
+    {
+        uint64_t one = 1;
+        ssize_t written = write(m_stopFd, &one, sizeof(one));
+        (void)written;
+        m_thread.join();
+    }
+
+    if (m_inotifyFd >= 0)
+        close(m_inotifyFd);
+    if (m_stopFd >= 0)
+        close(m_stopFd);
+
+    m_inotifyFd = -1;
+    m_stopFd = -1;
+}
+
+bool SettingsWatcher::Rearm()
+{
+    // inotify watches stay armed; drain what is queued and report whether it touched the file
+    alignas(inotify_event) char buffer[4096];
+    bool matched = false;
+    for (;;)
+    {
+        ssize_t length = read(m_inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0)
+            break;
+
+        for (ssize_t offset = 0; offset < length;)
+        {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            if (event->len && strcmp(event->name, m_fileName.c_str()) == 0)
+            {
+                m_notifications.fetch_add(1, std::memory_order_relaxed);
+                matched = true;
+            }
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        }
+    }
+    return matched;
+}
+
+void SettingsWatcher::Run()
+{
+    MMA_TRACE_THREAD("settings-watch");
+
+    pollfd fds[2] = { { m_stopFd, POLLIN, 0 }, { m_inotifyFd, POLLIN, 0 } };
+    bool pending = false;
+    for (;;)
+    {
+        int ready = poll(fds, 2, pending ? static_cast<int>(SETTLE_MS) : -1);
+        if (ready < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        if (fds[0].revents)
+            break;
+
+        if (ready == 0)
+        {
+            pending = false;
+            m_changes.fetch_add(1, std::memory_order_relaxed);
+            m_handler();
+        }
+        else if (fds[1].revents & POLLIN)
+        {
+            pending |= Rearm();
+        }
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "SettingsWriter.h"
+#include "Clock.h"
+#include "Logger.h"
+#include "SettingsStore.h"
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <chrono>
+
+SettingsWriter::SettingsWriter(ISettingsStore& store, IClock& clock, uint32_t debounceMs)
+    : m_store(store)
+    , m_clock(clock)
+    , m_debounceMs(debounceMs)
+{
+}
+
+SettingsWriter::~SettingsWriter()
+{
+    Stop();
+}
+
+void SettingsWriter::SetPersisted(const AppSettings& settings)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_persisted = settings;
+    m_pending = settings;
+    m_dirty = 0;
+    m_firstDirtyMs = 0;
+    m_deadlineMs = 0;
+}
+
+uint32_t SettingsWriter::Rebase(const AppSettings& stored, AppSettings& settings)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint32_t external = SettingsModel::Diff(stored, m_persisted) & ~m_dirty;
+    uint32_t changed = SettingsModel::Diff(stored, settings) & external;
+
+    SettingsModel::CopyFields(settings, stored, changed);
+    SettingsModel::CopyFields(m_pending, stored, external);
+    m_persisted = stored;
+
+    // Only fields that were dirty can still be; a write already scheduled keeps its deadline
+    m_dirty = SettingsModel::Diff(m_pending, m_persisted);
+    if (!m_dirty)
+    {
+        m_firstDirtyMs = 0;
+        m_deadlineMs = 0;
+    }
+    return changed;
+}
+
+void SettingsWriter::Submit(const AppSettings& settings)
+{
+    m_submits.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending = settings;
+        m_dirty = SettingsModel::Diff(m_pending, m_persisted);
+        if (!m_dirty)
+        {
+            // Changed back before the write: nothing left to save
+            m_firstDirtyMs = 0;
+            m_deadlineMs = 0;
+            return;
+        }
+
+        uint64_t now = m_clock.NowMs();
+        if (!m_firstDirtyMs)
+            m_firstDirtyMs = now;
+        m_deadlineMs = std::min(now + m_debounceMs, m_firstDirtyMs + MAX_DELAY_MS);
+    }
+    m_wake.notify_one();
+}
+
+bool SettingsWriter::Start()
+{
+    if (IsRunning())
+        return true;
+
+    m_stopRequested = false;
+    m_thread = std::thread(&SettingsWriter::Run, this);
+    return true;
+}
+
+void SettingsWriter::Stop()
+{
+    if (!IsRunning())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopRequested = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+bool SettingsWriter::Flush()
+{
+    return WriteDirty();
+}
+
+bool SettingsWriter::Poll(uint64_t nowMs)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_dirty || nowMs < m_deadlineMs)
+            return false;
+    }
+
+    WriteDirty();
+    return true;
+}
+
+uint32_t SettingsWriter::GetDirtyFields() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_dirty;
+}
+
+bool SettingsWriter::WriteDirty()
+{
+    std::lock_guard<std::mutex> writeLock(m_writeMutex);
+
+    AppSettings snapshot;
+    uint32_t fields;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        fields = m_dirty;
+        snapshot = m_pending;
+    }
+
+    if (!fields)
+        return true;
+
+    MMA_TRACE_SCOPE("settings.save");
+    bool saved = SettingsModel::SaveFields(m_store, snapshot, fields);
+
+    // Submits that arrived during the write are diffed against the new state
+    uint64_t now = m_clock.NowMs();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (saved)
+    {
+        // Only what was written: a rebase during the write may have moved the other fields
+        SettingsModel::CopyFields(m_persisted, snapshot, fields);
+        m_writes.fetch_add(1, std::memory_order_relaxed);
+        m_valuesWritten.fetch_add(SettingsModel::CountFields(fields), std::memory_order_relaxed);
+        MMA_LOG_DEBUG("Settings saved: %u changed values", SettingsModel::CountFields(fields));
+    }
+    else
+    {
+        m_failures.fetch_add(1, std::memory_order_relaxed);
+        MMA_LOG_WARNING("Settings could not be saved to the store; retrying in %u ms", MAX_DELAY_MS);
+    }
+
+    m_dirty = SettingsModel::Diff(m_pending, m_persisted);
+    if (m_dirty)
+    {
+        m_firstDirtyMs = now;
+        m_deadlineMs = now + (saved ? m_debounceMs : MAX_DELAY_MS);
+    }
+    else
+    {
+        m_firstDirtyMs = 0;
+        m_deadlineMs = 0;
+    }
+    return saved;
+}
+
+void SettingsWriter::Run()
+{
+    MMA_TRACE_THREAD("settings");
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stopRequested)
+    {
+        if (!m_dirty)
+        {
+            m_wake.wait(lock, [this] { return m_stopRequested || m_dirty != 0; });
+            continue;
+        }
+
+        uint64_t now = m_clock.NowMs();
+        if (now < m_deadlineMs)
+        {
+            m_wake.wait_for(lock, std::chrono::milliseconds(m_deadlineMs - now));
+            continue;
+        }
+
+        lock.unlock();
+        WriteDirty();
+        lock.lock();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,256 @@
+#include "SharedStatusSegment.h"
+#include <cstdio>
+
+#ifdef _WIN32
+#include "framework.h"
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+SharedStatusSegment::~SharedStatusSegment()
+{
+    Close();
+}
+
+void SharedStatusSegment::GetDefaultName(char* buffer, size_t size)
+{
+#ifdef _WIN32
+    // Local\ objects are already private to the session
+    snprintf(buffer, size, "mma-status");
+#else
+    // /dev/shm is shared by every user; the uid keeps each user's page apart
+    snprintf(buffer, size, "mma-status-%lu", static_cast<unsigned long>(geteuid()));
+#endif
+}
+
+// Whether the process that last wrote a page still exists
+static bool IsProcessRunning(uint64_t pid)
+{
+#ifdef _WIN32
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, static_cast<DWORD>(pid));
+    if (!process)
+        return GetLastError() == ERROR_ACCESS_DENIED;
+
+    DWORD exitCode = 0;
+    bool running = GetExitCodeProcess(process, &exitCode) && exitCode == STILL_ACTIVE;
+    CloseHandle(process);
+    return running;
+#else
+    return kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+#endif
+}
+
+// A page is abandoned once the writer it names has exited; a page without a
+// writer yet is still being set up and counts as live
+static bool IsAbandoned(const StatusPage& page)
+{
+    StatusSnapshot snapshot;
+    return StatusPage::Read(page, snapshot) && snapshot.writerPid != 0 && !IsProcessRunning(snapshot.writerPid);
+}
+
+#ifdef _WIN32
+
+bool SharedStatusSegment::Create(const char* name)
+{
+    if (IsOpen())
+        return true;
+
+    char defaultName[MAX_NAME_LENGTH];
+    if (!name)
+    {
+        GetDefaultName(defaultName, sizeof(defaultName));
+        name = defaultName;
+    }
+
+    char fullName[96];
+    snprintf(fullName, sizeof(fullName), "Local\\%s", name);
+
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                        0, sizeof(StatusPage), fullName);
+    if (!mapping)
+        return false;
+    bool existed = GetLastError() == ERROR_ALREADY_EXISTS;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, sizeof(StatusPage));
+    if (!view)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    // The mapping outlives its writer while a reader holds it; only then is it ours to reset
+    if (existed && !IsAbandoned(*static_cast<StatusPage*>(view)))
+    {
+        UnmapViewOfFile(view);
+        CloseHandle(mapping);
+        return false;
+    }
+
+    m_mapping = mapping;
+    m_page = static_cast<StatusPage*>(view);
+    m_owner = true;
+    StatusPage::Initialize(*m_page);
+    return true;
+}
+
+bool SharedStatusSegment::Open(const char* name)
+{
+    if (IsOpen())
+        return true;
+
+    char defaultName[MAX_NAME_LENGTH];
+    if (!name)
+    {
+        GetDefaultName(defaultName, sizeof(defaultName));
+        name = defaultName;
+    }
+
+    char fullName[96];
+    snprintf(fullName, sizeof(fullName), "Local\\%s", name);
+
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, fullName);
+    if (!mapping)
+        return false;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, sizeof(StatusPage));
+    if (!view)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    m_mapping = mapping;
+    m_page = static_cast<StatusPage*>(view);
+    m_owner = false;
+    return true;
+}
+
+void SharedStatusSegment::Close()
+{
+    if (!IsOpen())
+        return;
+
+    // The mapping disappears with its last handle, so there is nothing to unlink
+    UnmapViewOfFile(m_page);
+    CloseHandle(static_cast<HANDLE>(m_mapping));
+    m_page = nullptr;
+    m_mapping = nullptr;
+    m_owner = false;
+}
+
+#else
+
+// Whether an existing segment may be unlinked and created afresh: it must be
+// this user's, fully sized and left behind by a writer that has exited
+static bool IsSegmentAbandoned(const char* name)
+{
+    int fd = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0)
+        return errno == ENOENT;
+
+    bool abandoned = false;
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_uid == geteuid() && info.st_size >= static_cast<off_t>(sizeof(StatusPage)))
+    {
+        void* view = mmap(nullptr, sizeof(StatusPage), PROT_READ, MAP_SHARED, fd, 0);
+        if (view != MAP_FAILED)
+        {
+            abandoned = IsAbandoned(*static_cast<const StatusPage*>(view));
+            munmap(view, sizeof(StatusPage));
+        }
+    }
+    close(fd);
+    return abandoned;
+}
+
+static void FormatSegmentName(char* buffer, size_t size, const char* name)
+{
+    char defaultName[SharedStatusSegment::MAX_NAME_LENGTH];
+    if (!name)
+    {
+        SharedStatusSegment::GetDefaultName(defaultName, sizeof(defaultName));
+        name = defaultName;
+    }
+    snprintf(buffer, size, "/%s", name);
+}
+
+bool SharedStatusSegment::Create(const char* name)
+{
+    if (IsOpen())
+        return true;
+
+    FormatSegmentName(m_name, sizeof(m_name), name);
+
+    // Readable by other local users' agents, writable by the owner only. O_EXCL
+    // so a second writer never zeroes a live page; a dead writer's page is replaced
+    int fd = shm_open(m_name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0 && errno == EEXIST && IsSegmentAbandoned(m_name))
+    {
+        shm_unlink(m_name);
+        fd = shm_open(m_name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    }
+    if (fd < 0)
+        return false;
+
+    void* view = MAP_FAILED;
+    if (ftruncate(fd, sizeof(StatusPage)) == 0)
+        view = mmap(nullptr, sizeof(StatusPage), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (view == MAP_FAILED)
+    {
+        shm_unlink(m_name);
+        return false;
+    }
+
+    m_page = static_cast<StatusPage*>(view);
+    m_owner = true;
+    StatusPage::Initialize(*m_page);
+    return true;
+}
+
+bool SharedStatusSegment::Open(const char* name)
+{
+    if (IsOpen())
+        return true;
+
+    FormatSegmentName(m_name, sizeof(m_name), name);
+
+    int fd = shm_open(m_name, O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0)
+        return false;
+
+    // A segment still being sized by its writer is not a StatusPage yet
+    void* view = MAP_FAILED;
+    off_t size = lseek(fd, 0, SEEK_END);
+    if (size >= static_cast<off_t>(sizeof(StatusPage)))
+        view = mmap(nullptr, sizeof(StatusPage), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (view == MAP_FAILED)
+        return false;
+
+    m_page = static_cast<StatusPage*>(view);
+    m_owner = false;
+    return true;
+}
+
+void SharedStatusSegment::Close()
+{
+    if (!IsOpen())
+        return;
+
+    munmap(m_page, sizeof(StatusPage));
+    if (m_owner)
+        shm_unlink(m_name);
+
+    m_page = nullptr;
+    m_owner = false;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "StartupProfiler.h"
+#include "Logger.h"
+#include <chrono>
+#include <cstring>
+
+// Static member definitions
+StartupProfiler::NowUsFunction StartupProfiler::s_nowUs = nullptr;
+uint64_t StartupProfiler::s_originUs = 0;
+bool StartupProfiler::s_begun = false;
+const char* StartupProfiler::s_names[StartupProfiler::MAX_PHASES] = {};
+uint64_t StartupProfiler::s_times[StartupProfiler::MAX_PHASES] = {};
+std::atomic<size_t> StartupProfiler::s_count{ 0 };
+
+void StartupProfiler::SetClock(NowUsFunction nowUs)
+{
+    s_nowUs = nowUs;
+}
+
+uint64_t StartupProfiler::NowUs()
+{
+    if (s_nowUs)
+        return s_nowUs();
+
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void StartupProfiler::Begin(uint64_t processAgeUs)
+{
+    s_originUs = NowUs() - processAgeUs;
+    s_begun = true;
+    s_count.store(0, std::memory_order_release);
+}
+
+void StartupProfiler::Mark(const char* phase)
+{
+    // Without Begin, phases count from the first mark
+    if (!s_begun)
+        Begin(0);
+
+    size_t index = s_count.load(std::memory_order_relaxed);
+    if (index >= MAX_PHASES)
+        return;
+
+    uint64_t elapsedUs = NowUs() - s_originUs;
+    s_names[index] = phase;
+    s_times[index] = elapsedUs;
+    s_count.store(index + 1, std::memory_order_release);
+
+    MMA_LOG_INFO("Startup phase %s at %llu us (+%llu us)", phase, elapsedUs, GetPhaseDurationUs(index));
+}
+
+uint64_t StartupProfiler::FindPhaseUs(const char* phase)
+{
+    size_t count = GetPhaseCount();
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (strcmp(s_names[i], phase) == 0)
+            return s_times[i];
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include "StatusPublisher.h"
+#include "MonotonicClock.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+bool StatusPublisher::Open(const char* name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!m_segment.Create(name))
+        return false;
+
+#ifdef _WIN32
+    m_snapshot.writerPid = GetCurrentProcessId();
+#else
+    m_snapshot.writerPid = static_cast<uint64_t>(getpid());
+#endif
+    WriteLocked();
+    return true;
+}
+
+void StatusPublisher::Close()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Leave a final "not monitoring" page for readers that keep it mapped
+    if (m_segment.IsOpen())
+    {
+        m_snapshot.state.monitoring = 0;
+        WriteLocked();
+    }
+    m_segment.Close();
+}
+
+void StatusPublisher::PublishState(const StatusSnapshot::State& state)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_snapshot.state = state;
+    WriteLocked();
+}
+
+void StatusPublisher::PublishInput(const StatusSnapshot::Input& input)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_snapshot.input = input;
+    WriteLocked();
+}
+
+void StatusPublisher::PublishInputAnalytics(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_snapshot.inputAnalyticsOff = enabled ? 0 : 1;
+    WriteLocked();
+}
+
+StatusSnapshot StatusPublisher::GetSnapshot() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_snapshot;
+}
+
+void StatusPublisher::WriteLocked()
+{
+    if (!m_segment.IsOpen())
+        return;
+
+    m_snapshot.publishedMs = MonotonicNowMs();
+    ++m_snapshot.publishCount;
+    StatusPage::Write(*m_segment.GetPage(), m_snapshot);
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#include "SystemIdleSource.h"
+
+bool SystemIdleSource::Open()
+{
+    uint64_t lastInputMs;
+    return QueryLastInputTime(lastInputMs);
+}
+
+void SystemIdleSource::Close()
+{
+}
+
+bool SystemIdleSource::QueryLastInputTime(uint64_t& lastInputMs)
+{
+    LASTINPUTINFO info = { 0 };
+    info.cbSize = sizeof(info);
+
+    if (!GetLastInputInfo(&info))
+        return false;
+
+    // dwTime is a 32-bit tick count; the unsigned difference is wrap-safe
+    ULONGLONG now = GetTickCount64();
+    DWORD idleMs = static_cast<DWORD>(now) - info.dwTime;
+
+    lastInputMs = now - idleMs;
+    return true;
+}
\ No newline at end of file
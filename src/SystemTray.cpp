@@ -2,6 +2,8 @@
 #include "ApplicationManager.h"
 #include "ActivityMonitor.h"
 #include "DialogManager.h"
+#include "SettingsManager.h"
+#include "TraceRecorder.h"
 #include "resource.h"
 
 SystemTray::SystemTray()
@@ -12,6 +14,12 @@ SystemTray::SystemTray()
 SystemTray::~SystemTray()
 {
     RemoveTrayIcon();
+
+    if (m_menu)
+    {
+        DestroyMenu(m_menu);
+        m_menu = nullptr;
+    }
 }
 
 bool SystemTray::AddTrayIcon(HWND hWnd)
@@ -54,6 +62,7 @@ void SystemTray::UpdateTooltip(const WCHAR* tooltip)
 {
     if (m_iconAdded && tooltip)
     {
+        MMA_TRACE_SCOPE("ui.tray_tooltip");
         wcscpy_s(m_notifyIconData.szTip, tooltip);
         Shell_NotifyIconW(NIM_MODIFY, &m_notifyIconData);
     }
@@ -74,11 +83,14 @@ void SystemTray::SetMonitoringState(bool monitoring)
 void SystemTray::ShowContextMenu()
 {
     auto& app = ApplicationManager::GetInstance();
-    HMENU hMenu = LoadMenuW(app.GetAppInstance(), MAKEINTRESOURCEW(IDM_TRAY_MENU));
+    if (!m_menu)
+    {
+        m_menu = LoadMenuW(app.GetAppInstance(), MAKEINTRESOURCEW(IDM_TRAY_MENU));
+    }
     
-    if (hMenu)
+    if (m_menu)
     {
-        HMENU hSubMenu = GetSubMenu(hMenu, 0);
+        HMENU hSubMenu = GetSubMenu(m_menu, 0);
         if (hSubMenu)
         {
             // Update menu text based on current state
@@ -90,26 +102,38 @@ void SystemTray::ShowContextMenu()
             SetForegroundWindow(m_mainDialog);
             TrackPopupMenu(hSubMenu, TPM_RIGHTBUTTON, pt.x, pt.y, 0, m_mainDialog, nullptr);
         }
-        DestroyMenu(hMenu);
+        
+        // The chosen command is already posted; low-footprint instances reload the menu next time
+        if (app.GetSettingsManager()->GetLowFootprint())
+        {
+            DestroyMenu(m_menu);
+            m_menu = nullptr;
+        }
     }
 }
 
 void SystemTray::ShowMainDialog()
 {
-    if (m_mainDialog)
+    // The tray may belong to the hidden window; the dialog itself may not exist yet
+    HWND hDlg = ApplicationManager::GetInstance().EnsureMainDialog();
+    if (hDlg)
     {
-        ShowWindow(m_mainDialog, SW_SHOW);
-        SetForegroundWindow(m_mainDialog);
-        SetActiveWindow(m_mainDialog);
+        ShowWindow(hDlg, SW_SHOW);
+        SetForegroundWindow(hDlg);
+        SetActiveWindow(hDlg);
     }
 }
 
 void SystemTray::HideMainDialog()
 {
-    if (m_mainDialog)
+    auto& app = ApplicationManager::GetInstance();
+    HWND hDlg = app.GetMainDialog();
+    if (hDlg)
     {
-        ShowWindow(m_mainDialog, SW_HIDE);
+        ShowWindow(hDlg, SW_HIDE);
     }
+    
+    app.ReleaseHiddenResources();
 }
 
 bool SystemTray::HandleTrayMessage(WPARAM wParam, LPARAM lParam)
@@ -148,4 +172,10 @@ void SystemTray::UpdateMenuItems(HMENU hMenu, bool monitoring)
         ModifyMenuW(hMenu, IDM_TRAY_START_STOP, MF_BYCOMMAND | MF_STRING, 
                    IDM_TRAY_START_STOP, L"Start Monitoring");
     }
+
+#ifdef MMA_ENABLE_TRACE
+    // Trace builds only: the menu resource stays the same for release builds; the menu is cached
+    if (GetMenuState(hMenu, IDM_TRAY_SAVE_TRACE, MF_BYCOMMAND) == static_cast<UINT>(-1))
+        InsertMenuW(hMenu, IDM_TRAY_EXIT, MF_BYCOMMAND | MF_STRING, IDM_TRAY_SAVE_TRACE, L"Save Trace");
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "TimerFdDeadlineTimer.h"
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+TimerFdDeadlineTimer::TimerFdDeadlineTimer()
+{
+    m_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+}
+
+TimerFdDeadlineTimer::~TimerFdDeadlineTimer()
+{
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+        m_fd = -1;
+    }
+}
+
+bool TimerFdDeadlineTimer::Arm(uint64_t deadlineMs)
+{
+    if (m_fd < 0)
+        return false;
+
+    // A zero it_value disarms, so a deadline at time zero fires at 1 ns instead
+    itimerspec spec = {};
+    spec.it_value.tv_sec = static_cast<time_t>(deadlineMs / 1000);
+    spec.it_value.tv_nsec = static_cast<long>((deadlineMs % 1000) * 1000000);
+    if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0)
+        spec.it_value.tv_nsec = 1;
+
+    ++m_armCount;
+    return timerfd_settime(m_fd, TFD_TIMER_ABSTIME, &spec, nullptr) == 0;
+}
+
+void TimerFdDeadlineTimer::Disarm()
+{
+    if (m_fd < 0)
+        return;
+
+    itimerspec spec = {};
+    timerfd_settime(m_fd, 0, &spec, nullptr);
+}
+
+bool TimerFdDeadlineTimer::ConsumeExpiration()
+{
+    uint64_t expirations = 0;
+    return read(m_fd, &expirations, sizeof(expirations)) == sizeof(expirations) && expirations > 0;
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "TimerHeap.h"
+
+const uint32_t TimerHeap::NOT_SCHEDULED;
+
+void TimerHeap::Reserve(size_t ids)
+{
+    m_entries.reserve(ids);
+    if (m_positions.size() < ids)
+    {
+        m_positions.resize(ids, NOT_SCHEDULED);
+    }
+}
+
+size_t TimerHeap::GetBytesPerId()
+{
+    return sizeof(Entry) + sizeof(uint32_t);
+}
+
+void TimerHeap::Schedule(uint32_t id, uint64_t deadlineMs)
+{
+    if (id >= m_positions.size())
+    {
+        m_positions.resize(static_cast<size_t>(id) + 1, NOT_SCHEDULED);
+    }
+
+    uint32_t pos = m_positions[id];
+    if (pos == NOT_SCHEDULED)
+    {
+        m_entries.push_back(Entry{ deadlineMs, id });
+        m_positions[id] = static_cast<uint32_t>(m_entries.size() - 1);
+        SiftUp(m_entries.size() - 1);
+        return;
+    }
+
+    // Move the existing entry in whichever direction the new deadline needs
+    uint64_t previous = m_entries[pos].deadlineMs;
+    m_entries[pos].deadlineMs = deadlineMs;
+    if (deadlineMs < previous)
+        SiftUp(pos);
+    else
+        SiftDown(pos);
+}
+
+void TimerHeap::Cancel(uint32_t id)
+{
+    if (!IsScheduled(id))
+        return;
+
+    RemoveAt(m_positions[id]);
+}
+
+bool TimerHeap::IsScheduled(uint32_t id) const
+{
+    return id < m_positions.size() && m_positions[id] != NOT_SCHEDULED;
+}
+
+bool TimerHeap::PopExpired(uint64_t nowMs, uint32_t& id)
+{
+    if (m_entries.empty() || m_entries.front().deadlineMs > nowMs)
+        return false;
+
+    id = m_entries.front().id;
+    RemoveAt(0);
+    return true;
+}
+
+void TimerHeap::SiftUp(size_t pos)
+{
+    Entry entry = m_entries[pos];
+    while (pos > 0)
+    {
+        size_t parent = (pos - 1) / 2;
+        if (m_entries[parent].deadlineMs <= entry.deadlineMs)
+            break;
+
+        Place(pos, m_entries[parent]);
+        pos = parent;
+    }
+    Place(pos, entry);
+}
+
+void TimerHeap::SiftDown(size_t pos)
+{
+    Entry entry = m_entries[pos];
+    size_t count = m_entries.size();
+    for (;;)
+    {
+        size_t child = pos * 2 + 1;
+        if (child >= count)
+            break;
+
+        if (child + 1 < count && m_entries[child + 1].deadlineMs < m_entries[child].deadlineMs)
+            ++child;
+
+        if (entry.deadlineMs <= m_entries[child].deadlineMs)
+            break;
+
+        Place(pos, m_entries[child]);
+        pos = child;
+    }
+    Place(pos, entry);
+}
+
+void TimerHeap::Place(size_t pos, const Entry& entry)
+{
+    m_entries[pos] = entry;
+    m_positions[entry.id] = static_cast<uint32_t>(pos);
+}
+
+void TimerHeap::RemoveAt(size_t pos)
+{
+    m_positions[m_entries[pos].id] = NOT_SCHEDULED;
+
+    Entry last = m_entries.back();
+    m_entries.pop_back();
+    if (pos == m_entries.size())
+        return;
+
+    // Refill the hole with the former last entry and restore heap order
+    Place(pos, last);
+    if (pos > 0 && last.deadlineMs < m_entries[(pos - 1) / 2].deadlineMs)
+        SiftUp(pos);
+    else
+        SiftDown(pos);
+}
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "TraceRecorder.h"
+#include "AllocationAudit.h"
+#include <vector>
+
+// Static member definitions
+thread_local TraceRecorder::ThreadRing* TraceRecorder::t_ring = nullptr;
+std::mutex TraceRecorder::s_ringMutex;
+TraceRecorder::ThreadRing* TraceRecorder::s_rings[TraceRecorder::MAX_THREADS] = {};
+size_t TraceRecorder::s_ringCount = 0;
+uint64_t TraceRecorder::s_originTicks = 0;
+std::chrono::steady_clock::time_point TraceRecorder::s_originTime;
+
+/**
+ * Hands the thread's ring back when the thread exits
+ */
+class TraceThreadHandle
+{
+public:
+    ~TraceThreadHandle()
+    {
+        if (m_ring)
+            TraceRecorder::DetachThread(m_ring);
+    }
+
+    TraceRecorder::ThreadRing* m_ring = nullptr;
+};
+
+static thread_local TraceThreadHandle t_handle;
+
+TraceRecorder::ThreadRing* TraceRecorder::AttachThread()
+{
+    // A thread's first event allocates its ring once, wherever that happens
+    MMA_ALLOC_ALLOWED_SCOPE();
+    std::lock_guard<std::mutex> lock(s_ringMutex);
+
+    if (s_ringCount == 0)
+    {
+        s_originTicks = NowTicks();
+        s_originTime = std::chrono::steady_clock::now();
+    }
+
+    ThreadRing* ring = nullptr;
+    for (size_t i = 0; i < s_ringCount; ++i)
+    {
+        if (!s_rings[i]->inUse)
+        {
+            ring = s_rings[i];
+            break;
+        }
+    }
+
+    if (!ring)
+    {
+        if (s_ringCount == MAX_THREADS)
+            return nullptr;
+
+        ring = new ThreadRing();
+        s_rings[s_ringCount++] = ring;
+    }
+
+    ring->inUse = true;
+    ring->threadName.store(nullptr, std::memory_order_relaxed);
+    t_handle.m_ring = ring;
+    t_ring = ring;
+    return ring;
+}
+
+void TraceRecorder::DetachThread(ThreadRing* ring)
+{
+    std::lock_guard<std::mutex> lock(s_ringMutex);
+    ring->inUse = false;
+    t_ring = nullptr;
+}
+
+void TraceRecorder::SetThreadName(const char* name)
+{
+    ThreadRing* ring = t_ring;
+    if (!ring && !(ring = AttachThread()))
+        return;
+
+    ring->threadName.store(name, std::memory_order_relaxed);
+}
+
+size_t TraceRecorder::GetEventCount()
+{
+    std::lock_guard<std::mutex> lock(s_ringMutex);
+
+    size_t count = 0;
+    for (size_t i = 0; i < s_ringCount; ++i)
+    {
+        uint64_t head = s_rings[i]->head.load(std::memory_order_acquire);
+        count += static_cast<size_t>(head < EVENTS_PER_THREAD ? head : EVENTS_PER_THREAD);
+    }
+    return count;
+}
+
+bool TraceRecorder::WriteChromeJson(FILE* file)
+{
+    if (!file)
+        return false;
+
+    struct Event
+    {
+        uint64_t ticks;
+        uint64_t duration;
+        uint64_t arg;
+        const char* name;
+    };
+
+    std::lock_guard<std::mutex> lock(s_ringMutex);
+
+    // Ticks per nanosecond over the whole recording so far
+    uint64_t nowTicks = NowTicks();
+    double elapsedNs = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - s_originTime).count());
+    double nsPerTick = nowTicks > s_originTicks && elapsedNs > 0.0
+        ? elapsedNs / static_cast<double>(nowTicks - s_originTicks) : 1.0;
+
+    fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"mma\"}}");
+
+    std::vector<Event> events(EVENTS_PER_THREAD);
+
+    for (size_t index = 0; index < s_ringCount; ++index)
+    {
+        ThreadRing* ring = s_rings[index];
+        size_t tid = index + 1;
+
+        const char* threadName = ring->threadName.load(std::memory_order_relaxed);
+        fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":\"%s\"}}",
+                tid, threadName ? threadName : "thread");
+
+        // Copy first, then discard whatever the owner overwrote meanwhile (seqlock style)
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t first = head > EVENTS_PER_THREAD ? head - EVENTS_PER_THREAD : 0;
+        for (uint64_t i = first; i < head; ++i)
+        {
+            const Slot& slot = ring->slots[i & (EVENTS_PER_THREAD - 1)];
+            Event& event = events[i - first];
+            event.ticks = slot.ticks.load(std::memory_order_relaxed);
+            event.duration = slot.duration.load(std::memory_order_relaxed);
+            event.arg = slot.arg.load(std::memory_order_relaxed);
+            event.name = slot.name.load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = ring->head.load(std::memory_order_relaxed);
+
+        // Any slot store seen above was fenced behind the head store for its index,
+        // so 'after' covers it; the writer may be filling slot 'after', which held
+        // index after - EVENTS_PER_THREAD
+        uint64_t valid = after >= EVENTS_PER_THREAD ? after - EVENTS_PER_THREAD + 1 : 0;
+        if (valid < first)
+            valid = first;
+
+        for (uint64_t i = valid; i < head; ++i)
+        {
+            const Event& event = events[i - first];
+            if (!event.name || event.ticks < s_originTicks)
+                continue;
+
+            double tsUs = static_cast<double>(event.ticks - s_originTicks) * nsPerTick / 1000.0;
+            if (event.duration == INSTANT)
+            {
+                fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%zu,\"ts\":%.3f,"
+                        "\"args\":{\"value\":%llu}}",
+                        event.name, tid, tsUs, static_cast<unsigned long long>(event.arg));
+            }
+            else
+            {
+                double durUs = static_cast<double>(event.duration) * nsPerTick / 1000.0;
+                fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%zu,\"ts\":%.3f,\"dur\":%.3f,"
+                        "\"args\":{\"value\":%llu}}",
+                        event.name, tid, tsUs, durUs, static_cast<unsigned long long>(event.arg));
+            }
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    return ferror(file) == 0;
+}
\ No newline at end of file
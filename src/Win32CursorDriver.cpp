@@ -0,0 +1,17 @@
+#include "Win32CursorDriver.h"
+
+bool Win32CursorDriver::GetBounds(int& left, int& top, int& width, int& height)
+{
+    // Get screen dimensions
+    left = 0;
+    top = 0;
+    width = GetSystemMetrics(SM_CXSCREEN);
+    height = GetSystemMetrics(SM_CYSCREEN);
+
+    return width > 0 && height > 0;
+}
+
+bool Win32CursorDriver::MoveTo(int x, int y)
+{
+    return SetCursorPos(x, y) != FALSE;
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#include "WindowDeadlineTimer.h"
+#include "ApplicationManager.h"
+#include "MonotonicClock.h"
+
+WindowDeadlineTimer::~WindowDeadlineTimer()
+{
+    Disarm();
+}
+
+bool WindowDeadlineTimer::Arm(uint64_t deadlineMs)
+{
+    auto& app = ApplicationManager::GetInstance();
+    HWND hDlg = app.GetMessageWindow();
+
+    if (!hDlg)
+        return false;
+
+    uint64_t now = MonotonicNowMs();
+    uint64_t delay = deadlineMs > now ? deadlineMs - now : 0;
+    if (delay < USER_TIMER_MINIMUM)
+        delay = USER_TIMER_MINIMUM;
+    if (delay > USER_TIMER_MAXIMUM)
+        delay = USER_TIMER_MAXIMUM;
+
+    // SetTimer with an existing ID replaces the pending interval
+    m_targetWindow = hDlg;
+    m_timerId = SetTimer(hDlg, ACTIVITY_TIMER_ID, static_cast<UINT>(delay), nullptr);
+    return m_timerId != 0;
+}
+
+void WindowDeadlineTimer::Disarm()
+{
+    if (m_targetWindow && m_timerId)
+    {
+        KillTimer(m_targetWindow, m_timerId);
+        m_timerId = 0;
+    }
+}
\ No newline at end of file
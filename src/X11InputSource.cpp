@@ -0,0 +1,267 @@
+#include "X11InputSource.h"
+#include "InputDispatch.h"
+#include "MonotonicClock.h"
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <X11/Xlib.h>
+#include <X11/extensions/XInput2.h>
+#include <X11/extensions/XTest.h>
+
+X11InputSource::X11InputSource(const char* displayName)
+    : m_displayName(displayName)
+{
+}
+
+X11InputSource::~X11InputSource()
+{
+    Close();
+}
+
+bool X11InputSource::Open()
+{
+    m_stopRequested.store(false);
+    m_movePending.store(false);
+
+    m_display = XOpenDisplay(m_displayName);
+    if (!m_display)
+        return false;
+
+    int eventBase, errorBase;
+    if (!XQueryExtension(m_display, "XInputExtension", &m_xiOpcode, &eventBase, &errorBase))
+    {
+        Close();
+        return false;
+    }
+
+    // Announce XI 2.2: from 2.1 on raw events keep arriving while another client
+    // holds a grab (menus, games), and 2.2 adds raw touch events. The server
+    // answers with the version both sides support; raw events need at least 2.0
+    int major = 2, minor = 2;
+    if (XIQueryVersion(m_display, &major, &minor) != Success || major < 2)
+    {
+        Close();
+        return false;
+    }
+    bool hasTouch = major > 2 || minor >= 2;
+
+    int xtestMajor, xtestMinor;
+    m_hasXTest = XTestQueryExtension(m_display, &eventBase, &errorBase, &xtestMajor, &xtestMinor) != False;
+
+    // Raw events are only delivered to the root window and carry the physical source device
+    unsigned char bits[XIMaskLen(XI_LASTEVENT)] = { 0 };
+    XISetMask(bits, XI_RawMotion);
+    XISetMask(bits, XI_RawKeyPress);
+    XISetMask(bits, XI_RawKeyRelease);
+    XISetMask(bits, XI_RawButtonPress);
+    XISetMask(bits, XI_RawButtonRelease);
+    if (hasTouch)
+    {
+        XISetMask(bits, XI_RawTouchBegin);
+        XISetMask(bits, XI_RawTouchUpdate);
+        XISetMask(bits, XI_RawTouchEnd);
+    }
+
+    XIEventMask mask;
+    mask.deviceid = XIAllMasterDevices;
+    mask.mask_len = sizeof(bits);
+    mask.mask = bits;
+    XISelectEvents(m_display, DefaultRootWindow(m_display), &mask, 1);
+    XFlush(m_display);
+
+    // The root window spans every monitor; cached so GetBounds never touches Xlib
+    int screen = DefaultScreen(m_display);
+    m_rootWidth = DisplayWidth(m_display, screen);
+    m_rootHeight = DisplayHeight(m_display, screen);
+
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wakeFd < 0)
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void X11InputSource::Pump(InputDispatch& dispatch)
+{
+    pollfd fds[2];
+    fds[0].fd = ConnectionNumber(m_display);
+    fds[0].events = POLLIN;
+    fds[1].fd = m_wakeFd;
+    fds[1].events = POLLIN;
+
+    for (;;)
+    {
+        // Xlib may already hold buffered events that poll cannot see
+        DrainEvents(dispatch);
+
+        if (poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+
+        if (fds[1].revents & POLLIN)
+        {
+            uint64_t counter;
+            ssize_t bytes = read(m_wakeFd, &counter, sizeof(counter));
+            (void)bytes;
+
+            if (m_stopRequested.load(std::memory_order_acquire))
+                return;
+
+            HandleRequests();
+        }
+
+        if (fds[0].revents & (POLLERR | POLLHUP))
+            return;
+    }
+}
+
+void X11InputSource::Wake()
+{
+    m_stopRequested.store(true, std::memory_order_release);
+
+    if (m_wakeFd >= 0)
+    {
+        uint64_t one = 1;
+        ssize_t written = write(m_wakeFd, &one, sizeof(one));
+        (void)written;
+    }
+}
+
+void X11InputSource::Close()
+{
+    if (m_wakeFd >= 0)
+    {
+        close(m_wakeFd);
+        m_wakeFd = -1;
+    }
+
+    if (m_display)
+    {
+        XCloseDisplay(m_display);
+        m_display = nullptr;
+    }
+}
+
+bool X11InputSource::GetBounds(int& left, int& top, int& width, int& height)
+{
+    left = 0;
+    top = 0;
+    width = m_rootWidth;
+    height = m_rootHeight;
+
+    return width > 0 && height > 0;
+}
+
+bool X11InputSource::MoveTo(int x, int y)
+{
+    if (!m_hasXTest || m_wakeFd < 0)
+        return false;
+
+    // Latest request wins; the input thread applies it on its next wakeup
+    m_moveX.store(x, std::memory_order_relaxed);
+    m_moveY.store(y, std::memory_order_relaxed);
+    m_movePending.store(true, std::memory_order_release);
+
+    uint64_t one = 1;
+    return write(m_wakeFd, &one, sizeof(one)) == sizeof(one);
+}
+
+bool X11InputSource::Decode(int evtype, int sourceId, int detail, uint64_t timestampMs, InputEvent& event)
+{
+    event.timestampMs = timestampMs;
+    event.device = static_cast<uint64_t>(sourceId);
+    event.x = 0;
+    event.y = 0;
+
+    switch (evtype)
+    {
+    case XI_RawMotion:
+        event.type = InputEventType::MouseMove;
+        return true;
+
+    case XI_RawButtonPress:
+    case XI_RawButtonRelease:
+        // Core buttons 4-7 are the vertical and horizontal wheel
+        if (detail >= 4 && detail <= 7)
+        {
+            event.type = InputEventType::MouseWheel;
+            event.y = static_cast<int16_t>((detail == 4 || detail == 6) ? 1 : -1);
+        }
+        else
+        {
+            event.type = InputEventType::MouseButton;
+        }
+        return true;
+
+    case XI_RawTouchBegin:
+    case XI_RawTouchEnd:
+        // A finger landing or lifting is the touchscreen's click
+        event.type = InputEventType::MouseButton;
+        return true;
+
+    case XI_RawTouchUpdate:
+        event.type = InputEventType::MouseMove;
+        return true;
+
+    case XI_RawKeyPress:
+        event.type = InputEventType::KeyDown;
+        event.x = static_cast<int16_t>(detail);
+        return true;
+
+    case XI_RawKeyRelease:
+        event.type = InputEventType::KeyUp;
+        event.x = static_cast<int16_t>(detail);
+        return true;
+    }
+
+    return false;
+}
+
+void X11InputSource::DrainEvents(InputDispatch& dispatch)
+{
+    // XPending reads what the socket holds without a server round-trip
+    if (XPending(m_display) == 0)
+        return;
+
+    uint64_t now = MonotonicNowMs();
+    InputEvent event;
+
+    while (XPending(m_display) > 0)
+    {
+        XEvent xevent;
+        XNextEvent(m_display, &xevent);
+
+        XGenericEventCookie* cookie = &xevent.xcookie;
+        if (cookie->type != GenericEvent || cookie->extension != m_xiOpcode)
+            continue;
+
+        if (XGetEventData(m_display, cookie))
+        {
+            const XIRawEvent* raw = static_cast<const XIRawEvent*>(cookie->data);
+            if (Decode(raw->evtype, raw->sourceid, raw->detail, now, event))
+            {
+                dispatch.Dispatch(event);
+            }
+            XFreeEventData(m_display, cookie);
+        }
+    }
+}
+
+void X11InputSource::HandleRequests()
+{
+    if (!m_movePending.exchange(false, std::memory_order_acquire))
+        return;
+
+    // Screen -1 targets the screen the pointer is on; XFlush writes without waiting for a reply
+    XTestFakeMotionEvent(m_display, -1,
+                         m_moveX.load(std::memory_order_relaxed),
+                         m_moveY.load(std::memory_order_relaxed), CurrentTime);
+    XFlush(m_display);
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include "XScreenSaverIdleSource.h"
+#include "MonotonicClock.h"
+#include <X11/Xlib.h>
+#include <X11/extensions/scrnsaver.h>
+
+XScreenSaverIdleSource::XScreenSaverIdleSource(const char* displayName)
+    : m_displayName(displayName)
+{
+}
+
+XScreenSaverIdleSource::~XScreenSaverIdleSource()
+{
+    Close();
+}
+
+bool XScreenSaverIdleSource::Open()
+{
+    if (m_display)
+        return true;
+
+    m_display = XOpenDisplay(m_displayName);
+    if (!m_display)
+        return false;
+
+    int eventBase, errorBase;
+    if (!XScreenSaverQueryExtension(m_display, &eventBase, &errorBase))
+    {
+        Close();
+        return false;
+    }
+
+    m_info = XScreenSaverAllocInfo();
+    if (!m_info)
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void XScreenSaverIdleSource::Close()
+{
+    if (m_info)
+    {
+        XFree(m_info);
+        m_info = nullptr;
+    }
+
+    if (m_display)
+    {
+        XCloseDisplay(m_display);
+        m_display = nullptr;
+    }
+}
+
+bool XScreenSaverIdleSource::QueryLastInputTime(uint64_t& lastInputMs)
+{
+    if (!m_display || !m_info)
+        return false;
+
+    XScreenSaverInfo* info = static_cast<XScreenSaverInfo*>(m_info);
+    if (!XScreenSaverQueryInfo(m_display, DefaultRootWindow(m_display), info))
+        return false;
+
+    // idle is milliseconds since the server last saw input
+    uint64_t now = MonotonicNowMs();
+    uint64_t idleMs = info->idle;
+    lastInputMs = idleMs < now ? now - idleMs : 0;
+    return true;
+}
\ No newline at end of file
@@ -2,6 +2,9 @@
 //
 
 #include "ApplicationManager.h"
+#include "ControlClient.h"
+#include "StartupProfiler.h"
+#include "resource.h"
 
 // Global application instance pointer
 ApplicationManager* g_pApp = nullptr;
@@ -9,128 +12,81 @@ ApplicationManager* g_pApp = nullptr;
 // Single instance handle for cleanup
 static HANDLE g_hSingleInstanceMutex = nullptr;
 
-// Key mapping data (moved from global variables)
-const KeyMapping g_keyMappings[] = {
-    {VK_F1, L"F1"}, {VK_F2, L"F2"}, {VK_F3, L"F3"}, {VK_F4, L"F4"},
-    {VK_F5, L"F5"}, {VK_F6, L"F6"}, {VK_F7, L"F7"}, {VK_F8, L"F8"},
-    {VK_F9, L"F9"}, {VK_F10, L"F10"}, {VK_F11, L"F11"}, {VK_F12, L"F12"},
-    {'A', L"A"}, {'B', L"B"}, {'C', L"C"}, {'D', L"D"}, {'E', L"E"},
-    {'F', L"F"}, {'G', L"G"}, {'H', L"H"}, {'I', L"I"}, {'J', L"J"},
-    {'K', L"K"}, {'L', L"L"}, {'M', L"M"}, {'N', L"N"}, {'O', L"O"},
-    {'P', L"P"}, {'Q', L"Q"}, {'R', L"R"}, {'S', L"S"}, {'T', L"T"},
-    {'U', L"U"}, {'V', L"V"}, {'W', L"W"}, {'X', L"X"}, {'Y', L"Y"}, {'Z', L"Z"},
-    {'0', L"0"}, {'1', L"1"}, {'2', L"2"}, {'3', L"3"}, {'4', L"4"},
-    {'5', L"5"}, {'6', L"6"}, {'7', L"7"}, {'8', L"8"}, {'9', L"9"},
-    {VK_SPACE, L"Space"}, {VK_ESCAPE, L"Esc"}, {VK_TAB, L"Tab"},
-    {VK_RETURN, L"Enter"}, {VK_BACK, L"Backspace"}, {VK_DELETE, L"Delete"},
-    {VK_INSERT, L"Insert"}, {VK_HOME, L"Home"}, {VK_END, L"End"},
-    {VK_PRIOR, L"Page Up"}, {VK_NEXT, L"Page Down"},
-    {VK_UP, L"Up Arrow"}, {VK_DOWN, L"Down Arrow"}, 
-    {VK_LEFT, L"Left Arrow"}, {VK_RIGHT, L"Right Arrow"}
-};
-
-const int g_keyMappingsCount = sizeof(g_keyMappings) / sizeof(g_keyMappings[0]);
-
 /**
- * Structure to pass data between enumeration callback and caller
+ * Microseconds since the process was created: loader and static initialization
  */
-struct FindWindowData
+static uint64_t GetProcessAgeUs()
 {
-    HWND foundWindow;
-    DWORD targetProcessId;
-};
+    FILETIME creation, exit, kernel, user, now;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+        return 0;
+    GetSystemTimeAsFileTime(&now);
+
+    ULARGE_INTEGER created, current;
+    created.LowPart = creation.dwLowDateTime;
+    created.HighPart = creation.dwHighDateTime;
+    current.LowPart = now.dwLowDateTime;
+    current.HighPart = now.dwHighDateTime;
+
+    // FILETIME counts 100 ns units
+    return current.QuadPart > created.QuadPart ? (current.QuadPart - created.QuadPart) / 10 : 0;
+}
 
 /**
- * Callback function to enumerate windows and find existing instance
+ * Hands this launch's command line to the running instance over the control
+ * channel: "mma stop", "mma set-timeout 300", and a bare launch shows the
+ * existing window. Returns the exit status, as mma_ctl does: 0 when the
+ * command was carried out, 1 when nothing answered, 2 when it was refused
  */
-BOOL CALLBACK FindWindowCallback(HWND hwnd, LPARAM lParam)
+static int ForwardToExistingInstance()
 {
-    FindWindowData* pData = reinterpret_cast<FindWindowData*>(lParam);
-    
-    // Get window class name
-    WCHAR className[256];
-    if (GetClassNameW(hwnd, className, 256) == 0)
-        return TRUE; // Continue enumeration
-    
-    // Check if this is a dialog window (our main window type)
-    if (wcsstr(className, L"#32770") == nullptr)
-        return TRUE; // Continue enumeration
-    
-    // Get window title
-    WCHAR windowTitle[256];
-    if (GetWindowTextW(hwnd, windowTitle, 256) == 0)
-        return TRUE; // Continue enumeration
-    
-    // Check if this is our application window by title
-    if (wcsstr(windowTitle, APP_NAME) != nullptr)
+    ControlCommand command = ControlCommand::Show;
+    uint32_t argument = 0;
+
+    int argc = 0;
+    LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+    if (argv)
     {
-        // Additional check: verify this belongs to a different process
-        DWORD processId;
-        GetWindowThreadProcessId(hwnd, &processId);
-        
-        if (processId != GetCurrentProcessId())
+        char name[32];
+        if (argc > 1 && WideCharToMultiByte(CP_UTF8, 0, argv[1], -1, name, sizeof(name), nullptr, nullptr) > 0 &&
+            ControlProtocol::ParseCommand(name, command))
+        {
+            if (argc > 2)
+            {
+                argument = static_cast<uint32_t>(wcstoul(argv[2], nullptr, 10));
+            }
+        }
+        else
         {
-            pData->foundWindow = hwnd;
-            return FALSE; // Stop enumeration - found it!
+            command = ControlCommand::Show;
         }
+        LocalFree(argv);
     }
-    
-    return TRUE; // Continue enumeration
-}
 
-/**
- * Attempts to bring an existing instance to the foreground
- */
-bool BringExistingInstanceToFront()
-{
-    FindWindowData data = { nullptr, GetCurrentProcessId() };
-    
-    // Try to find existing window by enumerating all windows
-    EnumWindows(FindWindowCallback, reinterpret_cast<LPARAM>(&data));
-    
-    if (data.foundWindow != nullptr)
+    // The first instance may still be starting; Connect waits for its listener
+    ControlClient client;
+    if (!client.Connect())
+        return 1;
+
+    // Only the foreground process may hand the foreground on, and only to a
+    // server in this session: pipe names are machine-wide, so a process in
+    // another session could be serving the name
+    if (command == ControlCommand::Show)
     {
-        // First, try to restore if minimized
-        if (IsIconic(data.foundWindow))
+        DWORD serverId = client.GetServerProcessId();
+        DWORD serverSession = 0;
+        DWORD session = 0;
+        if (serverId != 0 && ProcessIdToSessionId(serverId, &serverSession) &&
+            ProcessIdToSessionId(GetCurrentProcessId(), &session) && serverSession == session)
         {
-            ShowWindow(data.foundWindow, SW_RESTORE);
+            AllowSetForegroundWindow(serverId);
         }
-        
-        // Make sure it's visible
-        ShowWindow(data.foundWindow, SW_SHOW);
-        
-        // Try to bring to foreground
-        // Note: This may not work in all cases due to Windows foreground restrictions
-        if (!SetForegroundWindow(data.foundWindow))
-        {
-            // If SetForegroundWindow fails, try alternative method
-            HWND hCurWnd = GetForegroundWindow();
-            DWORD dwMyID = GetCurrentThreadId();
-            DWORD dwCurID = GetWindowThreadProcessId(hCurWnd, nullptr);
-            
-            if (AttachThreadInput(dwCurID, dwMyID, TRUE))
-            {
-                SetForegroundWindow(data.foundWindow);
-                AttachThreadInput(dwCurID, dwMyID, FALSE);
-            }
-        }
-        
-        // Bring to top and flash to get attention
-        BringWindowToTop(data.foundWindow);
-        
-        // Flash the window to get user attention
-        FLASHWINFO flashInfo = { 0 };
-        flashInfo.cbSize = sizeof(FLASHWINFO);
-        flashInfo.hwnd = data.foundWindow;
-        flashInfo.dwFlags = FLASHW_ALL | FLASHW_TIMERNOFG;
-        flashInfo.uCount = 3;
-        flashInfo.dwTimeout = 0;
-        FlashWindowEx(&flashInfo);
-        
-        return true;
     }
-    
-    return false;
+
+    ControlResponse response;
+    if (!client.Transact(ControlProtocol::MakeRequest(command, argument), response))
+        return 1;
+    return response.result == static_cast<uint8_t>(ControlResult::Ok) ? 0 : 2;
 }
 
 /**
@@ -159,10 +115,6 @@ bool CheckSingleInstance()
         // Another instance is already running
         CloseHandle(g_hSingleInstanceMutex);
         g_hSingleInstanceMutex = nullptr;
-        
-        // Try to bring the existing instance to the front
-        BringExistingInstanceToFront();
-        
         return false;
     }
     
@@ -189,14 +141,17 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
                      _In_ int       nCmdShow)
 {
     UNREFERENCED_PARAMETER(hPrevInstance);
-    UNREFERENCED_PARAMETER(lpCmdLine);
+    UNREFERENCED_PARAMETER(lpCmdLine); // only a second launch reads its command line
+
+    StartupProfiler::Begin(GetProcessAgeUs());
 
     // Check if another instance is already running
     if (!CheckSingleInstance())
     {
-        // Another instance found - exit silently
-        return 0;
+        // Another instance found - pass the command line on and exit
+        return ForwardToExistingInstance();
     }
+    StartupProfiler::Mark("mutex");
 
     int result = 0;
 
@@ -0,0 +1,446 @@
+// mmad.cpp : Multi-seat Linux daemon entry point
+//
+// Usage: mmad --seat TIMEOUT:DEVICE[,DEVICE...] [--seat ...] [--x11-seat TIMEOUT] [--trace FILE]
+//             [--metrics FILE] [--log FILE] [--config FILE]
+// Each --seat gets an independent idle engine over its evdev devices.
+// --x11-seat adds a seat for the X session on $DISPLAY that reads the
+// server's idle clock (MIT-SCREEN-SAVER) when its deadline expires instead
+// of reading any device; it needs a build with libXss.
+// When a seat stays idle for TIMEOUT seconds a "seat N idle" line is
+// written to stdout for the session manager to act on.
+// With --trace, SIGUSR1 and exit write the trace rings to FILE as Chrome
+// trace-event JSON (trace points need a build with MMA_ENABLE_TRACE).
+// With --metrics, per-seat counters are written to FILE in OpenMetrics text
+// format every 15 seconds, for the node_exporter textfile collector.
+// With --log, structured log lines go to FILE, rotated at 1 MB.
+// Settings (LogLevel) come from --config FILE, an INI file or a compiled
+// snapshot, or else from $XDG_CONFIG_HOME/mma/mma.ini when it exists; the
+// file is watched and a changed LogLevel applies without a restart.
+// mma_ctl talks to the daemon over the user's control socket: stop and
+// start pause and resume idle lines, set-timeout applies to every seat.
+
+#include "ControlServer.h"
+#include "CoreConfig.h"
+#include "FileSettingsStore.h"
+#include "IdleSource.h"
+#include "Logger.h"
+#include "MappedSettingsStore.h"
+#include "MonotonicClock.h"
+#include "OpenMetricsWriter.h"
+#include "ProcessMemory.h"
+#include "RotatingFileSink.h"
+#include "SeatDaemon.h"
+#include "SettingsReloader.h"
+#include "SettingsWatcher.h"
+#include "StartupProfiler.h"
+#include "TraceRecorder.h"
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef MMAD_X11_IDLE
+#include "XScreenSaverIdleSource.h"
+#endif
+
+// Daemon reached from the signal handler
+static SeatDaemon* g_daemon = nullptr;
+
+// Set by SIGUSR1; the dump itself runs on the event loop thread
+static volatile sig_atomic_t g_traceRequested = 0;
+
+// Control channel state, read by the loop and written by the control thread
+static std::atomic<bool> g_announcing{ true };
+static std::atomic<uint32_t> g_timeoutSeconds{ 0 };
+
+/**
+ * Stop the event loop on SIGINT/SIGTERM
+ */
+static void HandleSignal(int)
+{
+    if (g_daemon)
+    {
+        g_daemon->Stop();
+    }
+}
+
+/**
+ * Ask for a trace dump; the interrupted epoll_wait returns to the loop
+ */
+static void HandleTraceSignal(int)
+{
+    g_traceRequested = 1;
+}
+
+/**
+ * Write the trace rings to path
+ */
+static void WriteTrace(const char* path)
+{
+    FILE* file = fopen(path, "w");
+    bool saved = file && TraceRecorder::WriteChromeJson(file);
+    if (file && fclose(file) != 0)
+        saved = false;
+
+    if (!saved)
+        fprintf(stderr, "mmad: cannot write trace to %s\n", path);
+}
+
+/**
+ * Write per-seat and loop counters through the reused writer buffer
+ */
+static void WriteMetrics(OpenMetricsWriter& writer, const SeatDaemon& daemon)
+{
+    writer.Begin();
+
+    char seat[16];
+    writer.BeginFamily("mma_seat_events", "counter", "Input events read from the seat's devices");
+    for (uint32_t i = 0; i < daemon.GetSeatCount(); ++i)
+    {
+        snprintf(seat, sizeof(seat), "%u", i);
+        writer.WriteLabeledSample("mma_seat_events", "_total", "seat", seat, daemon.GetSeatEvents(i));
+    }
+
+    writer.BeginFamily("mma_seat_idle_actions", "counter", "Idle notifications written for the seat");
+    for (uint32_t i = 0; i < daemon.GetSeatCount(); ++i)
+    {
+        snprintf(seat, sizeof(seat), "%u", i);
+        writer.WriteLabeledSample("mma_seat_idle_actions", "_total", "seat", seat, daemon.GetSeatActions(i));
+    }
+
+    writer.WriteGauge("mma_devices", "Open evdev devices across all seats", daemon.GetDeviceCount());
+    writer.WriteCounter("mma_daemon_wakeups", "Event loop wakeups", daemon.GetWakeups());
+    writer.WriteCounter("mma_timer_arms", "timerfd re-arms for the earliest seat deadline", daemon.GetTimerArms());
+    writer.End();
+
+    if (!writer.WriteFile())
+        fprintf(stderr, "mmad: cannot write metrics\n");
+}
+
+/**
+ * Parse one TIMEOUT:DEVICE[,DEVICE...] argument into a new seat
+ */
+static bool AddSeatFromSpec(SeatDaemon& daemon, char* spec)
+{
+    char* devices = strchr(spec, ':');
+    if (!devices)
+        return false;
+    *devices++ = '\0';
+
+    char* end = nullptr;
+    unsigned long timeout = strtoul(spec, &end, 10);
+    if (end == spec || *end != '\0' || timeout == 0)
+        return false;
+
+    uint32_t seat = daemon.AddSeat(static_cast<uint32_t>(timeout));
+
+    for (char* path = strtok(devices, ","); path; path = strtok(nullptr, ","))
+    {
+        if (!daemon.AddDevicePath(seat, path))
+        {
+            fprintf(stderr, "mmad: seat %u: cannot open %s\n", seat, path);
+            MMA_LOG_ERROR("Seat %u: cannot open %s", seat, path); // path lives in argv
+        }
+    }
+
+    return true;
+}
+
+#ifdef MMAD_X11_IDLE
+/**
+ * Add a seat that follows the X server's idle clock; the source outlives the loop in sources
+ */
+static bool AddX11Seat(SeatDaemon& daemon, const char* spec, std::vector<std::unique_ptr<IIdleSource>>& sources)
+{
+    char* end = nullptr;
+    unsigned long timeout = strtoul(spec, &end, 10);
+    if (end == spec || *end != '\0' || timeout == 0)
+        return false;
+
+    std::unique_ptr<IIdleSource> source(new XScreenSaverIdleSource());
+    if (!source->Open())
+    {
+        fprintf(stderr, "mmad: cannot read the X server idle time (no $DISPLAY or no MIT-SCREEN-SAVER extension)\n");
+        return false;
+    }
+
+    uint32_t seat = daemon.AddSeat(static_cast<uint32_t>(timeout));
+    daemon.SetIdleSource(seat, source.get());
+    sources.push_back(std::move(source));
+    MMA_LOG_INFO("Seat %u follows the X server idle clock", seat);
+    return true;
+}
+#else
+static bool AddX11Seat(SeatDaemon&, const char*, std::vector<std::unique_ptr<IIdleSource>>&)
+{
+    fprintf(stderr, "mmad: --x11-seat needs a build with libXss\n");
+    return false;
+}
+#endif
+
+/**
+ * Answer one control request on the server thread; seat changes are posted to the loop
+ */
+static void HandleControlRequest(SeatDaemon& daemon, const ControlRequest& request, ControlResponse& response)
+{
+    switch (static_cast<ControlCommand>(request.command))
+    {
+    case ControlCommand::Start:
+        g_announcing = true;
+        break;
+
+    case ControlCommand::Stop:
+        g_announcing = false;
+        break;
+
+    case ControlCommand::SetTimeout:
+        if (request.argument == 0 || request.argument > MAX_TIMEOUT_SECONDS)
+        {
+            response.result = static_cast<uint8_t>(ControlResult::InvalidArgument);
+            break;
+        }
+        g_timeoutSeconds = request.argument;
+        daemon.Post([&daemon, timeout = request.argument]()
+        {
+            for (uint32_t seat = 0; seat < daemon.GetSeatCount(); ++seat)
+            {
+                daemon.SetTimeout(seat, timeout);
+            }
+            MMA_LOG_INFO("Timeout of all seats set to %u s", timeout);
+        });
+        break;
+
+    case ControlCommand::Show:
+        response.result = static_cast<uint8_t>(ControlResult::Unsupported);
+        break;
+
+    default:
+        break;
+    }
+
+    response.monitoring = g_announcing ? 1 : 0;
+    response.timeoutSeconds = g_timeoutSeconds;
+    response.backend = ACTIVITY_BACKEND_EVDEV;
+}
+
+static void PrintUsage()
+{
+    fprintf(stderr, "usage: mmad --seat TIMEOUT:DEVICE[,DEVICE...] [--seat ...] [--x11-seat TIMEOUT] [--trace FILE]\n"
+                    "            [--metrics FILE] [--log FILE] [--config FILE]\n");
+}
+
+/**
+ * Load settings from path; returns the store that read them, kept for reloads
+ */
+static std::unique_ptr<ISettingsStore> LoadSettings(const std::string& path, AppSettings& settings)
+{
+    // A snapshot is recognized by its header; anything else is read as INI
+    std::unique_ptr<ISettingsStore> store(new MappedSettingsStore(path));
+    if (SettingsModel::Load(*store, settings))
+        return store;
+
+    store.reset(new FileSettingsStore(path));
+    if (SettingsModel::Load(*store, settings))
+        return store;
+    return nullptr;
+}
+
+int main(int argc, char* argv[])
+{
+    MMA_TRACE_THREAD("mmad");
+    StartupProfiler::Begin(0);
+
+    std::vector<std::unique_ptr<IIdleSource>> idleSources;
+    SeatDaemon daemon;
+    const char* tracePath = nullptr;
+    OpenMetricsWriter metrics;
+    std::unique_ptr<RotatingFileSink> logSink;
+    std::string configPath;
+    if (!daemon.Open())
+    {
+        fprintf(stderr, "mmad: failed to create the event loop\n");
+        return 1;
+    }
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--seat") == 0 && i + 1 < argc)
+        {
+            if (!AddSeatFromSpec(daemon, argv[++i]))
+            {
+                PrintUsage();
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--x11-seat") == 0 && i + 1 < argc)
+        {
+            if (!AddX11Seat(daemon, argv[++i], idleSources))
+            {
+                PrintUsage();
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+        {
+            tracePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--metrics") == 0 && i + 1 < argc)
+        {
+            metrics.SetPath(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc)
+        {
+            logSink.reset(new RotatingFileSink(argv[++i]));
+        }
+        else if (strcmp(argv[i], "--config") == 0 && i + 1 < argc)
+        {
+            configPath = argv[++i];
+        }
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if (daemon.GetSeatCount() == 0)
+    {
+        PrintUsage();
+        return 1;
+    }
+    StartupProfiler::Mark("seats");
+
+    // An explicit config must load; the XDG default is optional
+    AppSettings settings;
+    std::unique_ptr<ISettingsStore> store;
+    if (!configPath.empty())
+    {
+        store = LoadSettings(configPath, settings);
+        if (!store)
+        {
+            fprintf(stderr, "mmad: cannot read settings from %s\n", configPath.c_str());
+            return 1;
+        }
+    }
+    else
+    {
+        std::string defaultPath = FileSettingsStore::GetDefaultPath();
+        if (!defaultPath.empty() && FileSettingsStore::FileExists(defaultPath))
+        {
+            store = LoadSettings(defaultPath, settings);
+            configPath = defaultPath;
+        }
+    }
+    Logger::SetLevel(static_cast<LogLevel>(settings.logLevel));
+
+    // Reloads run on the watcher thread, the only one touching settings after this point
+    std::unique_ptr<SettingsReloader> reloader;
+    SettingsWatcher watcher;
+    if (store)
+    {
+        reloader.reset(new SettingsReloader(*store));
+        SettingsReloader* activeReloader = reloader.get();
+        watcher.WatchFile(configPath, [activeReloader, &settings]()
+        {
+            if (activeReloader->Reload(settings) & SettingsModel::FIELD_LOG_LEVEL)
+            {
+                Logger::SetLevel(static_cast<LogLevel>(settings.logLevel));
+                MMA_LOG_INFO("Log level changed to %u", settings.logLevel);
+            }
+        });
+    }
+    StartupProfiler::Mark("settings");
+
+    // Lines logged while parsing the seats waited in the ring until now
+    if (logSink)
+        Logger::Start(logSink.get());
+    MMA_LOG_INFO("mmad started with %u seats and %u devices", daemon.GetSeatCount(), daemon.GetDeviceCount());
+
+    daemon.SetIdleAction([](uint32_t seat)
+    {
+        if (!g_announcing)
+            return;
+
+        MMA_LOG_DEBUG("Seat %u idle", seat);
+        printf("seat %u idle\n", seat);
+        fflush(stdout);
+    });
+
+    g_daemon = &daemon;
+
+    // Status reports the first seat's timeout until set-timeout makes them all equal
+    g_timeoutSeconds = daemon.GetTimeout(0);
+    ControlServer control;
+    if (!control.Start([&daemon](const ControlRequest& request, ControlResponse& response)
+                       { HandleControlRequest(daemon, request, response); }))
+    {
+        MMA_LOG_WARNING("Control socket in use, another mmad runs for this user; mma_ctl will not reach this one");
+    }
+
+    struct sigaction action = {};
+    action.sa_handler = HandleSignal;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    StartupProfiler::Mark("ready");
+    ProcessMemory::CheckBudget(static_cast<uint64_t>(MEMORY_BUDGET_KB) * 1024, "at startup");
+
+    if (!tracePath && !metrics.HasPath())
+    {
+        int result = daemon.Run();
+        g_daemon = nullptr;
+        control.Stop();
+        watcher.Stop();
+        MMA_LOG_INFO("mmad stopped");
+        Logger::Stop();
+        return result;
+    }
+
+    if (tracePath)
+    {
+        struct sigaction traceAction = {};
+        traceAction.sa_handler = HandleTraceSignal;
+        sigaction(SIGUSR1, &traceAction, nullptr);
+    }
+
+    // Same loop as Run, checking for dump requests and due exports after every wakeup
+    const uint64_t METRICS_INTERVAL_MS = 15000;
+    uint64_t nextExportMs = MonotonicNowMs();
+    for (;;)
+    {
+        int timeoutMs = -1;
+        if (metrics.HasPath())
+        {
+            uint64_t now = MonotonicNowMs();
+            if (now >= nextExportMs)
+            {
+                WriteMetrics(metrics, daemon);
+                nextExportMs = now + METRICS_INTERVAL_MS;
+            }
+            timeoutMs = static_cast<int>(nextExportMs - now);
+        }
+
+        if (!daemon.RunOnce(timeoutMs))
+            break;
+
+        if (g_traceRequested)
+        {
+            g_traceRequested = 0;
+            WriteTrace(tracePath);
+        }
+    }
+
+    if (tracePath)
+        WriteTrace(tracePath);
+    if (metrics.HasPath())
+        WriteMetrics(metrics, daemon);
+    g_daemon = nullptr;
+    control.Stop();
+    watcher.Stop();
+    MMA_LOG_INFO("mmad stopped");
+    Logger::Stop();
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "Test.h"
+
+#ifdef MMA_ALLOC_AUDIT
+
+#include "AllocationAudit.h"
+#include <cstring>
+
+// Deliberate allocations are stored here so the compiler cannot elide them
+static void* volatile g_keep = nullptr;
+
+/**
+ * The audit must see an allocation inside a scope and ignore one in a nested allowed scope
+ */
+static void TestDetection()
+{
+    AllocationAudit::Reset();
+    AllocationAudit::SetAssertOnViolation(false);
+    AllocationAudit::Arm();
+    {
+        MMA_NO_ALLOC_SCOPE("test");
+        g_keep = new int(1);
+        {
+            MMA_ALLOC_ALLOWED_SCOPE();
+            delete static_cast<int*>(g_keep);
+            g_keep = new int(2);
+        }
+    }
+    AllocationAudit::Disarm();
+    AllocationAudit::SetAssertOnViolation(true);
+
+    delete static_cast<int*>(g_keep);
+    g_keep = nullptr;
+
+    AllocationAudit::Site sites[AllocationAudit::MAX_SITES];
+    size_t count = AllocationAudit::GetSites(sites, AllocationAudit::MAX_SITES);
+
+    Expect(AllocationAudit::GetAllocations() >= 2, "allocations are counted");
+    Expect(AllocationAudit::GetViolations() == 1, "allocation in a no-alloc scope is caught");
+    Expect(count == 1 && sites[0].count == 1 && strcmp(sites[0].scope, "test") == 0,
+           "call site and scope are recorded");
+    AllocationAudit::Reset();
+}
+
+void RegisterAllocationAuditTests(TestRunner& runner)
+{
+    runner.Add("audit.detection", TestDetection);
+}
+
+#else
+
+void RegisterAllocationAuditTests(TestRunner&)
+{
+}
+
+#endif
\ No newline at end of file
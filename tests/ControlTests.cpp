@@ -0,0 +1,289 @@
+#include "Test.h"
+#include "ControlClient.h"
+#include "ControlServer.h"
+#include "CoreConfig.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Stand-in for the application: handler state lives on the server thread
+    class FakeApplication
+    {
+    public:
+        ControlServer::RequestHandler GetHandler()
+        {
+            return [this](const ControlRequest& request, ControlResponse& response)
+            {
+                switch (static_cast<ControlCommand>(request.command))
+                {
+                case ControlCommand::Start:
+                    monitoring = true;
+                    break;
+                case ControlCommand::Stop:
+                    monitoring = false;
+                    break;
+                case ControlCommand::SetTimeout:
+                    if (request.argument == 0 || request.argument > MAX_TIMEOUT_SECONDS)
+                        response.result = static_cast<uint8_t>(ControlResult::InvalidArgument);
+                    else
+                        timeout = request.argument;
+                    break;
+                case ControlCommand::Show:
+                    ++shows;
+                    break;
+                default:
+                    break;
+                }
+                response.monitoring = monitoring ? 1 : 0;
+                response.timeoutSeconds = timeout;
+                response.backend = ACTIVITY_BACKEND_HOOKS;
+            };
+        }
+
+        std::atomic<bool> monitoring{ false };
+        std::atomic<uint32_t> timeout{ DEFAULT_TIMEOUT_SECONDS };
+        std::atomic<uint32_t> shows{ 0 };
+    };
+}
+
+static uint32_t CurrentProcessId()
+{
+#ifdef _WIN32
+    return static_cast<uint32_t>(_getpid());
+#else
+    return static_cast<uint32_t>(getpid());
+#endif
+}
+
+static uint64_t ElapsedNs(std::chrono::steady_clock::time_point start)
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+static void PrintLatency(const char* what, std::vector<uint64_t>& samplesNs)
+{
+    if (samplesNs.empty())
+        return;
+
+    std::sort(samplesNs.begin(), samplesNs.end());
+    printf("  %-22s p50 %7.1f us   p99 %7.1f us   max %7.1f us   (%zu round trips)\n", what,
+           samplesNs[samplesNs.size() / 2] / 1000.0, samplesNs[samplesNs.size() * 99 / 100] / 1000.0,
+           samplesNs.back() / 1000.0, samplesNs.size());
+}
+
+static void TestCommands()
+{
+    std::string endpoint = MakeTestName("mma-test-control");
+    FakeApplication application;
+
+    ControlServer server;
+    Expect(server.Start(application.GetHandler(), endpoint.c_str()), "server listens on a private endpoint");
+    ControlServer second;
+    Expect(!second.Start(application.GetHandler(), endpoint.c_str()), "second server on the same endpoint refused");
+
+    ControlClient client;
+    ControlResponse response;
+    Expect(client.Connect(endpoint.c_str()) && client.GetServerProcessId() == CurrentProcessId(),
+           "client connects, server pid known");
+    Expect(client.Transact(ControlProtocol::MakeRequest(ControlCommand::Start, 0, 1), response) &&
+           response.result == static_cast<uint8_t>(ControlResult::Ok) && response.monitoring == 1, "start");
+    Expect(client.Transact(ControlProtocol::MakeRequest(ControlCommand::SetTimeout, 42, 2), response) &&
+           response.timeoutSeconds == 42 && response.monitoring == 1, "set-timeout on the same connection");
+    Expect(client.Transact(ControlProtocol::MakeRequest(ControlCommand::SetTimeout, 0, 3), response) &&
+           response.result == static_cast<uint8_t>(ControlResult::InvalidArgument) &&
+           response.timeoutSeconds == 42, "set-timeout 0 refused, state unchanged");
+    Expect(client.Transact(ControlProtocol::MakeRequest(ControlCommand::Stop, 0, 4), response) &&
+           response.monitoring == 0, "stop");
+    Expect(client.Transact(ControlProtocol::MakeRequest(ControlCommand::Show, 0, 5), response) &&
+           application.shows == 1, "show");
+    Expect(client.Transact(ControlProtocol::MakeRequest(ControlCommand::Status, 0, 6), response) &&
+           response.sequence == 6 && response.processId == CurrentProcessId(), "status echoes the sequence");
+
+    client.Close();
+    server.Stop();
+}
+
+static void TestMalformedFrames()
+{
+    std::string endpoint = MakeTestName("mma-test-control-frames");
+    FakeApplication application;
+    ControlServer server;
+    ControlClient client;
+    ControlResponse response;
+    if (!Expect(server.Start(application.GetHandler(), endpoint.c_str()) && client.Connect(endpoint.c_str()),
+                "client connected"))
+        return;
+
+    // A foreign magic is answered, a wrong size ends the connection
+    ControlRequest foreign = ControlProtocol::MakeRequest(ControlCommand::Status, 0, 7);
+    foreign.magic = 0;
+    Expect(client.TransactRaw(&foreign, sizeof(foreign), response) == static_cast<int>(sizeof(response)) &&
+           response.result == static_cast<uint8_t>(ControlResult::BadRequest), "foreign magic is a bad request");
+    ControlRequest unknown = ControlProtocol::MakeRequest(static_cast<ControlCommand>(CONTROL_COMMAND_COUNT), 0, 8);
+    Expect(client.Transact(unknown, response) && response.result == static_cast<uint8_t>(ControlResult::BadRequest),
+           "unknown command is a bad request");
+    uint64_t rejected = server.GetRejected();
+    char oversized[sizeof(ControlRequest) * 2] = {};
+    Expect(client.TransactRaw(oversized, sizeof(oversized), response) <= 0 && server.GetRejected() == rejected + 1,
+           "oversized frame drops the connection");
+    Expect(client.Connect(endpoint.c_str()) && client.Transact(ControlProtocol::MakeRequest(ControlCommand::Status), response),
+           "server serves the next client");
+
+    client.Close();
+    server.Stop();
+}
+
+static void TestConnect()
+{
+    ControlClient client;
+    ControlResponse response;
+
+    // Nothing listening: fails within the timeout
+    auto start = std::chrono::steady_clock::now();
+    Expect(!client.Connect(MakeTestName("mma-test-control-nobody").c_str(), 50) && ElapsedNs(start) < 1000000000ull,
+           "no server: connect gives up after its timeout");
+
+    // A second launch racing the first instance's startup: the command waits for the listener
+    std::string endpoint = MakeTestName("mma-test-control-late");
+    FakeApplication application;
+    ControlServer late;
+    std::thread starter([&]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        late.Start(application.GetHandler(), endpoint.c_str());
+    });
+    bool delivered = client.Connect(endpoint.c_str()) &&
+                     client.Transact(ControlProtocol::MakeRequest(ControlCommand::Show), response);
+    starter.join();
+    Expect(delivered && application.shows == 1, "command sent before the server listens is delivered");
+    client.Close();
+    late.Stop();
+}
+
+#ifndef _WIN32
+static void TestForeignServer()
+{
+    // Binding the socket as another user needs root
+    if (geteuid() != 0)
+    {
+        printf("  not running as root, skipped\n");
+        return;
+    }
+
+    // A process of another user squats on the endpoint before the instance starts
+    std::string endpoint = MakeTestName("mma-test-control-foreign");
+    int ready[2];
+    int release[2];
+    if (!Expect(pipe(ready) == 0 && pipe(release) == 0, "pipes created"))
+        return;
+
+    pid_t child = fork();
+    if (child == 0)
+    {
+        close(ready[0]);
+        close(release[1]);
+        sockaddr_un address;
+        socklen_t length = ControlProtocol::GetSocketAddress(endpoint.c_str(), address);
+        int fd = -1;
+        if (setgid(65534) == 0 && setuid(65534) == 0)
+            fd = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+        char status = fd >= 0 && bind(fd, reinterpret_cast<sockaddr*>(&address), length) == 0 && listen(fd, 4) == 0;
+        if (write(ready[1], &status, 1) != 1 || !status)
+            _exit(1);
+
+        // Serve until the test is done with the endpoint
+        char done;
+        while (read(release[0], &done, 1) > 0)
+        {
+        }
+        _exit(0);
+    }
+    close(ready[1]);
+    close(release[0]);
+
+    char status = 0;
+    bool listening = child > 0 && read(ready[0], &status, 1) == 1 && status;
+    ControlClient client;
+    Expect(listening, "server of another uid listening");
+    Expect(listening && !client.Connect(endpoint.c_str(), 200) && !client.IsConnected(),
+           "client refuses a server of another uid");
+
+    close(release[1]);
+    close(ready[0]);
+    int exitStatus = 0;
+    if (child > 0)
+        waitpid(child, &exitStatus, 0);
+}
+#endif
+
+static void TestLatency()
+{
+    static const int ROUND_TRIPS = 2000;
+    static const int CONNECTS = 200;
+
+    std::string endpoint = MakeTestName("mma-test-control-latency");
+    FakeApplication application;
+    ControlServer server;
+    if (!Expect(server.Start(application.GetHandler(), endpoint.c_str()), "server listens"))
+        return;
+
+    // One connection, then a connection per command as mma_ctl does
+    ControlClient client;
+    ControlResponse response;
+    std::vector<uint64_t> persistentNs, connectNs;
+    ControlRequest status = ControlProtocol::MakeRequest(ControlCommand::Status);
+    if (client.Connect(endpoint.c_str()))
+    {
+        for (int i = 0; i < ROUND_TRIPS; ++i)
+        {
+            status.sequence = static_cast<uint32_t>(i);
+            auto begin = std::chrono::steady_clock::now();
+            if (!client.Transact(status, response))
+                break;
+            persistentNs.push_back(ElapsedNs(begin));
+        }
+        client.Close();
+    }
+    for (int i = 0; i < CONNECTS; ++i)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        if (!client.Connect(endpoint.c_str()) || !client.Transact(status, response))
+            break;
+        client.Close();
+        connectNs.push_back(ElapsedNs(begin));
+    }
+    Expect(persistentNs.size() == ROUND_TRIPS && connectNs.size() == CONNECTS, "every timed round trip answered");
+
+    server.Stop();
+    PrintLatency("round trip", persistentNs);
+    PrintLatency("connect + round trip", connectNs);
+    printf("  server: %llu connections, %llu requests, %llu rejected\n",
+           static_cast<unsigned long long>(server.GetConnections()),
+           static_cast<unsigned long long>(server.GetRequests()),
+           static_cast<unsigned long long>(server.GetRejected()));
+}
+
+void RegisterControlTests(TestRunner& runner)
+{
+    runner.Add("control.commands", TestCommands);
+    runner.Add("control.malformed_frames", TestMalformedFrames);
+    runner.Add("control.connect", TestConnect);
+#ifndef _WIN32
+    runner.Add("control.foreign_server", TestForeignServer);
+#endif
+    runner.Add("control.latency", TestLatency);
+}
\ No newline at end of file
@@ -0,0 +1,1041 @@
+#include "Test.h"
+#include "ActivityChannel.h"
+#include "Clock.h"
+#include "DeadlineTimer.h"
+#include "FastRandom.h"
+#include "HeadlessCursorDriver.h"
+#include "HookWatchdog.h"
+#include "HotkeyModel.h"
+#include "IdleEngine.h"
+#include "IdleScheduler.h"
+#include "ManualIdleSource.h"
+#include "ProcessMemory.h"
+#include "SettingsSchema.h"
+#include "SpscRing.h"
+#include "StartupProfiler.h"
+#include "TimerHeap.h"
+#include "TraceRecorder.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Deadline timer that records how often it was programmed
+    class CountingDeadlineTimer : public IDeadlineTimer
+    {
+    public:
+        bool Arm(uint64_t deadlineMs) override
+        {
+            m_deadlineMs = deadlineMs;
+            m_armed = true;
+            ++m_arms;
+            return true;
+        }
+
+        void Disarm() override { m_armed = false; }
+
+        uint64_t GetDeadline() const { return m_deadlineMs; }
+        bool IsArmed() const { return m_armed; }
+        uint64_t GetArmCount() const { return m_arms; }
+
+    private:
+        uint64_t m_deadlineMs = 0;
+        bool m_armed = false;
+        uint64_t m_arms = 0;
+    };
+
+    // Everything an IdleEngine needs, driven by a manual clock
+    struct EngineFixture
+    {
+        ManualClock clock{ 1000000 };
+        CountingDeadlineTimer timer;
+        HeadlessCursorDriver cursor{ 800, 600 };
+        ActivityChannel channel;
+        IdleEngine engine{ clock, timer, cursor, channel };
+
+        EngineFixture()
+        {
+            channel.Reset(clock.NowMs());
+            engine.SetTimeout(60);
+            engine.Start();
+        }
+
+        // What the timer backend does when the armed deadline passes
+        bool RunToDeadline()
+        {
+            clock.Set(timer.GetDeadline());
+            return engine.OnDeadline();
+        }
+    };
+
+    // Reads a HotkeyModel display string back into modifiers and key;
+    // false on an unknown token or a missing key
+    bool ParseHotkey(const std::wstring& text, uint32_t& modifiers, uint32_t& vk)
+    {
+        static const struct { const wchar_t* name; uint32_t flag; } MODIFIERS[] =
+        {
+            { L"Ctrl", HOTKEY_MOD_CONTROL }, { L"Shift", HOTKEY_MOD_SHIFT },
+            { L"Alt", HOTKEY_MOD_ALT }, { L"Win", HOTKEY_MOD_WIN }
+        };
+
+        modifiers = 0;
+        size_t start = 0;
+        for (;;)
+        {
+            size_t plus = text.find(L'+', start);
+            std::wstring token = text.substr(start, plus == std::wstring::npos ? std::wstring::npos : plus - start);
+            if (plus == std::wstring::npos)
+            {
+                for (int i = 0; i < g_keyMappingsCount; ++i)
+                {
+                    if (token == g_keyMappings[i].name)
+                    {
+                        vk = g_keyMappings[i].vk;
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            bool known = false;
+            for (const auto& modifier : MODIFIERS)
+            {
+                if (token == modifier.name && !(modifiers & modifier.flag))
+                {
+                    modifiers |= modifier.flag;
+                    known = true;
+                }
+            }
+            if (!known)
+                return false;
+            start = plus + 1;
+        }
+    }
+
+    // Microsecond clock StartupProfiler reads while a test drives it
+    uint64_t g_fakeNowUs = 0;
+
+    uint64_t FakeNowUs()
+    {
+        return g_fakeNowUs;
+    }
+
+    // Syntax-only JSON check, enough to tell whether a viewer will load the trace
+    void SkipJsonSpace(const std::string& text, size_t& pos)
+    {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\n' || text[pos] == '\r' || text[pos] == '\t'))
+        {
+            ++pos;
+        }
+    }
+
+    bool SkipJsonString(const std::string& text, size_t& pos)
+    {
+        if (pos >= text.size() || text[pos] != '"')
+            return false;
+
+        for (++pos; pos < text.size(); ++pos)
+        {
+            unsigned char c = static_cast<unsigned char>(text[pos]);
+            if (c == '"')
+            {
+                ++pos;
+                return true;
+            }
+            if (c < 0x20)
+                return false;
+            if (c == '\\')
+                ++pos;
+        }
+        return false;
+    }
+
+    bool SkipJsonDigits(const std::string& text, size_t& pos)
+    {
+        size_t start = pos;
+        while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9')
+        {
+            ++pos;
+        }
+        return pos > start;
+    }
+
+    bool SkipJsonValue(const std::string& text, size_t& pos)
+    {
+        SkipJsonSpace(text, pos);
+        if (pos >= text.size())
+            return false;
+
+        char c = text[pos];
+        if (c == '{' || c == '[')
+        {
+            char close = c == '{' ? '}' : ']';
+            ++pos;
+            SkipJsonSpace(text, pos);
+            if (pos < text.size() && text[pos] == close)
+            {
+                ++pos;
+                return true;
+            }
+
+            for (;;)
+            {
+                if (c == '{')
+                {
+                    SkipJsonSpace(text, pos);
+                    if (!SkipJsonString(text, pos))
+                        return false;
+                    SkipJsonSpace(text, pos);
+                    if (pos >= text.size() || text[pos++] != ':')
+                        return false;
+                }
+                if (!SkipJsonValue(text, pos))
+                    return false;
+
+                SkipJsonSpace(text, pos);
+                if (pos >= text.size())
+                    return false;
+                if (text[pos] == close)
+                {
+                    ++pos;
+                    return true;
+                }
+                if (text[pos++] != ',')
+                    return false;
+            }
+        }
+
+        if (c == '"')
+            return SkipJsonString(text, pos);
+
+        for (const char* literal : { "true", "false", "null" })
+        {
+            if (text.compare(pos, strlen(literal), literal) == 0)
+            {
+                pos += strlen(literal);
+                return true;
+            }
+        }
+
+        if (c == '-')
+            ++pos;
+        if (!SkipJsonDigits(text, pos))
+            return false;
+        if (pos < text.size() && text[pos] == '.' && !SkipJsonDigits(text, ++pos))
+            return false;
+        if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E'))
+        {
+            ++pos;
+            if (pos < text.size() && (text[pos] == '+' || text[pos] == '-'))
+                ++pos;
+            if (!SkipJsonDigits(text, pos))
+                return false;
+        }
+        return true;
+    }
+
+    bool IsWellFormedJson(const std::string& text)
+    {
+        size_t pos = 0;
+        if (!SkipJsonValue(text, pos))
+            return false;
+        SkipJsonSpace(text, pos);
+        return pos == text.size();
+    }
+
+    // One exported trace event; the export writes one event per line
+    struct TraceLine
+    {
+        std::string name;
+        std::string phase;
+        std::string threadName;  // thread_name metadata only
+        size_t tid = 0;
+        uint64_t value = 0;
+        bool hasDuration = false;
+    };
+
+    // Raw text of "key": in line at or after from, without quotes; empty when absent
+    std::string TraceField(const std::string& line, const char* key, size_t from = 0)
+    {
+        std::string pattern = std::string("\"") + key + "\":";
+        size_t start = line.find(pattern, from);
+        if (start == std::string::npos)
+            return std::string();
+
+        start += pattern.size();
+        if (start < line.size() && line[start] == '"')
+            return line.substr(start + 1, line.find('"', start + 1) - start - 1);
+        return line.substr(start, line.find_first_of(",}", start) - start);
+    }
+
+    // Exports every ring through a scratch file
+    bool ExportTrace(std::string& text, std::vector<TraceLine>& lines)
+    {
+        std::string path = GetTestDirectory() + "/" + MakeTestName("mma-trace") + ".json";
+        FILE* file = fopen(path.c_str(), "w+b");
+        if (!file)
+            return false;
+
+        bool written = TraceRecorder::WriteChromeJson(file);
+        rewind(file);
+
+        char chunk[4096];
+        size_t read;
+        text.clear();
+        while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        {
+            text.append(chunk, read);
+        }
+        fclose(file);
+        remove(path.c_str());
+
+        lines.clear();
+        size_t start = 0;
+        while (start < text.size())
+        {
+            size_t end = text.find('\n', start);
+            std::string line = text.substr(start, end == std::string::npos ? std::string::npos : end - start);
+            start = end == std::string::npos ? text.size() : end + 1;
+            if (line.find("\"ph\":") == std::string::npos)
+                continue;
+
+            TraceLine event;
+            event.name = TraceField(line, "name");
+            event.phase = TraceField(line, "ph");
+            event.tid = static_cast<size_t>(strtoull(TraceField(line, "tid").c_str(), nullptr, 10));
+            event.value = strtoull(TraceField(line, "value").c_str(), nullptr, 10);
+            event.hasDuration = !TraceField(line, "dur").empty();
+            if (event.phase == "M")
+                event.threadName = TraceField(line, "name", line.find("\"args\":"));
+            lines.push_back(event);
+        }
+        return written;
+    }
+
+    // Track id the export gave a thread name; 0 when no ring carries it
+    size_t FindTraceThread(const std::vector<TraceLine>& lines, const char* threadName)
+    {
+        for (const TraceLine& line : lines)
+        {
+            if (line.name == "thread_name" && line.threadName == threadName)
+                return line.tid;
+        }
+        return 0;
+    }
+}
+
+static void TestActivityChannel()
+{
+    ActivityChannel channel;
+    channel.Reset(1000);
+
+    // Events inside the quantum only bump a counter
+    Expect(!channel.Publish(1000) && !channel.Publish(1000 + ActivityChannel::QUANTUM_MS - 1),
+           "events inside the quantum are coalesced");
+    Expect(channel.GetLastActivity() == 1000 && channel.GetCoalescedCount() == 2 && channel.GetProcessedCount() == 0,
+           "coalesced events leave the timestamp alone");
+    Expect(channel.Publish(1000 + ActivityChannel::QUANTUM_MS) &&
+           channel.GetLastActivity() == 1000 + ActivityChannel::QUANTUM_MS, "first event of the next quantum published");
+    Expect(!channel.Publish(500) && channel.GetLastActivity() == 1000 + ActivityChannel::QUANTUM_MS,
+           "an older timestamp never moves the channel back");
+
+    // Self-generated activity moves the timestamp without counting as input
+    uint64_t events = channel.GetEventCount();
+    channel.Advance(5000);
+    channel.Advance(4000);
+    Expect(channel.GetLastActivity() == 5000 && channel.GetEventCount() == events,
+           "advance moves forward only and counts nothing");
+    channel.Reset(10);
+    Expect(channel.GetLastActivity() == 10, "reset overwrites the timestamp");
+
+    // An 8 kHz mouse for three seconds: at most one published event per quantum
+    ActivityChannel mouse;
+    mouse.Reset(100000);
+    uint64_t published = 0;
+    for (uint64_t tick = 0; tick < 3 * 8000; ++tick)
+    {
+        published += mouse.Publish(100000 + tick / 8) ? 1 : 0;
+    }
+    Expect(published == mouse.GetProcessedCount() && published <= 3000 / ActivityChannel::QUANTUM_MS + 1,
+           "8 kHz input publishes once per quantum");
+    Expect(mouse.GetEventCount() == 3 * 8000, "every event counted");
+    uint64_t perSecond = mouse.GetProcessedPerSecond() + mouse.GetCoalescedPerSecond();
+    Expect(mouse.GetProcessedPerSecond() <= 1000 / ActivityChannel::QUANTUM_MS + 1 &&
+           perSecond >= 7800 && perSecond <= 8200, "per-second rates match the input rate");
+}
+
+static void TestIdleScheduler()
+{
+    CountingDeadlineTimer timer;
+    IdleScheduler scheduler(&timer);
+    scheduler.SetTimeout(60);
+    scheduler.Start(0, 0);
+    Expect(timer.IsArmed() && timer.GetDeadline() == 60000 && timer.GetArmCount() == 1,
+           "start arms one deadline at activity + timeout");
+
+    // Activity never touches the timer; the expired deadline re-arms for the newer one
+    Expect(!scheduler.OnTimer(60000, 30000) && timer.GetDeadline() == 90000 && scheduler.GetActions() == 0,
+           "activity since arming re-arms for the new deadline");
+    Expect(scheduler.OnTimer(90000, 30000) && scheduler.GetActions() == 1 && timer.GetDeadline() == 150000,
+           "full timeout idle acts and restarts the countdown");
+    Expect(scheduler.OnTimer(150000 - IdleScheduler::TIMER_SLACK_MS, 90000) && scheduler.GetActions() == 2,
+           "a timer firing within the slack counts as expired");
+    Expect(scheduler.GetWakeups() == 3 && timer.GetArmCount() == 4, "one wakeup and one arm per expiry");
+
+    // An hour of activity every second costs one wakeup per timeout, not one per event
+    scheduler.Start(0, 0);
+    uint64_t arms = timer.GetArmCount();
+    for (uint64_t now = 1000; now <= 3600000; now += 1000)
+    {
+        if (now >= timer.GetDeadline())
+            scheduler.OnTimer(now, now);
+    }
+    Expect(scheduler.GetWakeups() == 60 && scheduler.GetActions() == 0 && timer.GetArmCount() - arms == 60,
+           "steady activity: one wakeup per timeout");
+    Expect(scheduler.GetWakeupsPerHour(3600000) == 60, "wakeups per hour reported");
+
+    scheduler.Stop();
+    Expect(!timer.IsArmed() && !scheduler.OnTimer(4000000, 0), "stop disarms, a late expiry is ignored");
+}
+
+static void TestIdleEngine()
+{
+    EngineFixture fixture;
+    Expect(fixture.timer.GetDeadline() == fixture.clock.NowMs() + 60000, "engine arms the timeout on start");
+
+    // Idle for the whole timeout: the cursor moves inside the driver bounds
+    Expect(fixture.RunToDeadline() && fixture.cursor.GetMoveCount() == 1, "idle deadline moves the cursor");
+    Expect(fixture.cursor.GetX() >= 0 && fixture.cursor.GetX() < 800 && fixture.cursor.GetY() >= 0 &&
+           fixture.cursor.GetY() < 600, "cursor target inside the bounds");
+    Expect(fixture.channel.GetLastActivity() == fixture.clock.NowMs() &&
+           fixture.timer.GetDeadline() == fixture.clock.NowMs() + 60000, "the idle action restarts the countdown");
+
+    // Input arrives before the deadline: no move, re-armed from the input
+    fixture.clock.Advance(20000);
+    fixture.channel.Publish(fixture.clock.NowMs());
+    uint64_t inputAt = fixture.clock.NowMs();
+    Expect(!fixture.RunToDeadline() && fixture.cursor.GetMoveCount() == 1 &&
+           fixture.timer.GetDeadline() == inputAt + 60000, "input before the deadline defers the idle action");
+
+    // A new timeout restarts the countdown from now
+    fixture.clock.Advance(1000);
+    fixture.engine.SetTimeout(120);
+    Expect(fixture.timer.GetDeadline() == fixture.clock.NowMs() + 120000, "new timeout counts from now");
+
+    fixture.engine.Stop();
+    Expect(!fixture.timer.IsArmed() && !fixture.engine.OnDeadline() && fixture.cursor.GetMoveCount() == 1,
+           "stopped engine ignores a stale expiry");
+}
+
+static void TestHookWatchdog()
+{
+    // The idle clock is driven by hand next to the engine's manual clock
+    EngineFixture fixture;
+    ManualIdleSource idle;
+    HookWatchdog watchdog(idle, fixture.channel);
+    int reinstalls = 0;
+    bool reinstallSucceeds = true;
+    watchdog.SetReinstallAction([&]() { ++reinstalls; return reinstallSucceeds; });
+
+    // The system clock may trail the hooks by up to the tolerance
+    fixture.clock.Advance(30000);
+    fixture.channel.Publish(fixture.clock.NowMs());
+    idle.SetLastInputTime(fixture.clock.NowMs() + HookWatchdog::DEFAULT_TOLERANCE_MS);
+    Expect(watchdog.Check() == HookWatchdog::Verdict::Healthy && watchdog.GetIncidents() == 0 && reinstalls == 0,
+           "idle clock within the tolerance is healthy");
+
+    // Hooks dropped: the system saw input five seconds after the last hook event
+    uint64_t events = fixture.channel.GetEventCount();
+    fixture.clock.Advance(5000);
+    uint64_t missedAt = fixture.clock.NowMs();
+    idle.SetLastInputTime(missedAt);
+    Expect(watchdog.Check() == HookWatchdog::Verdict::HookLost && watchdog.GetIncidents() == 1 && reinstalls == 1 &&
+           watchdog.GetLastIncidentMs() == missedAt, "input past the tolerance is an incident and reinstalls");
+    Expect(fixture.channel.GetLastActivity() == missedAt && fixture.channel.GetEventCount() == events,
+           "missed input adopted as activity, not counted as an event");
+    Expect(!fixture.RunToDeadline() && fixture.cursor.GetMoveCount() == 0 &&
+           fixture.timer.GetDeadline() == missedAt + 60000, "engine defers the idle action for the adopted input");
+
+    // The user stays away: later deadlines see the same idle clock and no new incident
+    bool quiet = true;
+    for (int i = 0; i < 3; ++i)
+    {
+        fixture.clock.Advance(60000);
+        quiet &= watchdog.Check() == HookWatchdog::Verdict::Healthy;
+    }
+    Expect(quiet && watchdog.GetIncidents() == 1 && reinstalls == 1, "no repeat incident until input resumes");
+
+    // Input resumes through the reinstalled hooks
+    fixture.channel.Publish(fixture.clock.NowMs());
+    idle.SetLastInputTime(fixture.clock.NowMs());
+    Expect(watchdog.Check() == HookWatchdog::Verdict::Healthy && watchdog.GetIncidents() == 1,
+           "input delivered by the hooks is healthy");
+
+    // Input resumes without the hooks again; this time the reinstall fails
+    reinstallSucceeds = false;
+    fixture.clock.Advance(10000);
+    idle.SetLastInputTime(fixture.clock.NowMs());
+    Expect(watchdog.Check() == HookWatchdog::Verdict::HookLost && watchdog.GetIncidents() == 2 && reinstalls == 2 &&
+           watchdog.GetReinstallFailures() == 1, "later missed input is a new incident; failure counted");
+
+    idle.SetAvailable(false);
+    Expect(watchdog.Check() == HookWatchdog::Verdict::Unavailable && watchdog.GetIncidents() == 2 &&
+           watchdog.GetChecks() == 8, "unreadable idle clock decides nothing");
+}
+
+static void TestTimerHeap()
+{
+    static const uint32_t IDS = 1000;
+
+    TimerHeap heap;
+    heap.Reserve(IDS);
+    for (uint32_t id = 0; id < IDS; ++id)
+    {
+        heap.Schedule(id, static_cast<uint64_t>((id * 7919) % IDS) * 10 + 1000);
+    }
+    Expect(heap.GetSize() == IDS && heap.GetEarliest() == 1000, "earliest of all deadlines on top");
+
+    // Rescheduling moves an entry in place, cancelling removes it
+    heap.Schedule(0, 500);
+    heap.Cancel(1);
+    Expect(heap.GetEarliest() == 500 && heap.GetSize() == IDS - 1 && !heap.IsScheduled(1) && heap.IsScheduled(0),
+           "reschedule and cancel");
+
+    uint32_t id = TimerHeap::NOT_SCHEDULED;
+    Expect(!heap.PopExpired(499, id), "nothing expired before the earliest deadline");
+
+    std::vector<uint64_t> popped;
+    uint64_t previous = 0;
+    bool ordered = true;
+    while (heap.PopExpired(UINT64_MAX, id))
+    {
+        uint64_t deadline = id == 0 ? 500 : static_cast<uint64_t>((id * 7919) % IDS) * 10 + 1000;
+        ordered &= deadline >= previous && !heap.IsScheduled(id);
+        previous = deadline;
+        popped.push_back(id);
+    }
+    std::sort(popped.begin(), popped.end());
+    Expect(ordered && heap.IsEmpty(), "expired ids pop in deadline order");
+    Expect(popped.size() == IDS - 1 && std::unique(popped.begin(), popped.end()) == popped.end(),
+           "every scheduled id popped once");
+}
+
+static void TestSpscRing()
+{
+    // Single thread: capacity, drops and FIFO order across the wrap
+    SpscRing<uint32_t, 8> ring;
+    uint32_t pushed = 0;
+    while (ring.TryPush(pushed))
+    {
+        ++pushed;
+    }
+    Expect(pushed == 8 && ring.GetSize() == 8 && ring.GetDropped() == 1, "full ring drops and counts");
+
+    uint32_t out[8];
+    uint32_t next = 0;
+    bool ordered = true;
+    for (int round = 0; round < 100; ++round)
+    {
+        size_t count = ring.PopBatch(out, 3);
+        for (size_t i = 0; i < count; ++i)
+        {
+            ordered &= out[i] == next++;
+        }
+        while (ring.TryPush(pushed))
+        {
+            ++pushed;
+        }
+    }
+    Expect(ordered && ring.GetDropped() == 101, "items come out in push order across the wrap");
+
+    // Two threads: everything pushed arrives once and in order, or is counted as dropped
+    static const uint32_t ITEMS = 1000000;
+    SpscRing<uint32_t, 1024> shared;
+    std::atomic<bool> done{ false };
+    std::thread producer([&]()
+    {
+        for (uint32_t value = 0; value < ITEMS; ++value)
+        {
+            if (!shared.TryPush(value) && (value & 255) == 0)
+                std::this_thread::yield();
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    uint32_t batch[256];
+    uint64_t received = 0;
+    uint32_t last = 0;
+    bool increasing = true;
+    for (;;)
+    {
+        bool finished = done.load(std::memory_order_acquire);
+        size_t count = shared.PopBatch(batch, 256);
+        for (size_t i = 0; i < count; ++i)
+        {
+            increasing &= received == 0 || batch[i] > last;
+            last = batch[i];
+            ++received;
+        }
+        if (finished && count == 0)
+            break;
+    }
+    producer.join();
+    Expect(increasing, "consumer sees increasing values");
+    Expect(received + shared.GetDropped() == ITEMS, "received plus dropped equals pushed");
+}
+
+static void TestHotkeyModel()
+{
+    static const uint32_t ALL_MODIFIERS = HOTKEY_MOD_ALT | HOTKEY_MOD_CONTROL | HOTKEY_MOD_SHIFT | HOTKEY_MOD_WIN;
+
+    Expect(wcscmp(HotkeyModel::GetHotkeyDisplayString(HOTKEY_MOD_CONTROL | HOTKEY_MOD_SHIFT, 'M'),
+                  L"Ctrl+Shift+M") == 0, "default hotkey formats as Ctrl+Shift+M");
+    Expect(wcscmp(HotkeyModel::GetModifierString(ALL_MODIFIERS), L"Ctrl+Shift+Alt+Win") == 0,
+           "modifiers in fixed order");
+    Expect(wcscmp(HotkeyModel::GetHotkeyDisplayString(0, 0x70), L"F1") == 0 &&
+           HotkeyModel::GetModifierString(0)[0] == L'\0', "no modifiers formats the key alone");
+    Expect(wcscmp(HotkeyModel::GetKeyName(0xFF), L"Unknown") == 0, "key outside the table is Unknown");
+
+    // Every offered key is a valid stored value and has a unique code and name
+    const SettingField& modifierField = SETTINGS_FIELDS[SettingFieldIndex("HotkeyModifiers")];
+    const SettingField& keyField = SETTINGS_FIELDS[SettingFieldIndex("HotkeyVK")];
+    bool valid = true;
+    bool unique = true;
+    for (int i = 0; i < g_keyMappingsCount; ++i)
+    {
+        valid &= keyField.IsValid(g_keyMappings[i].vk) && wcschr(g_keyMappings[i].name, L'+') == nullptr;
+        for (int j = i + 1; j < g_keyMappingsCount; ++j)
+        {
+            unique &= g_keyMappings[i].vk != g_keyMappings[j].vk &&
+                      wcscmp(g_keyMappings[i].name, g_keyMappings[j].name) != 0;
+        }
+    }
+    Expect(valid, "every offered key passes HotkeyVK validation");
+    Expect(unique, "key codes and names are unique");
+    Expect(!keyField.IsValid(0) && !keyField.IsValid(0xFF) && !modifierField.IsValid(HOTKEY_MOD_WIN << 1),
+           "out-of-range key and modifier rejected");
+
+    // Format then parse gives back the same hotkey for every modifier set and key
+    bool roundTrip = true;
+    for (uint32_t modifiers = 0; modifiers <= ALL_MODIFIERS; ++modifiers)
+    {
+        roundTrip &= modifierField.IsValid(modifiers);
+        for (int i = 0; i < g_keyMappingsCount; ++i)
+        {
+            uint32_t parsedModifiers = 0;
+            uint32_t parsedVk = 0;
+            std::wstring text = HotkeyModel::GetHotkeyDisplayString(modifiers, g_keyMappings[i].vk);
+            roundTrip &= ParseHotkey(text, parsedModifiers, parsedVk) && parsedModifiers == modifiers &&
+                         parsedVk == g_keyMappings[i].vk;
+        }
+    }
+    Expect(roundTrip, "display strings parse back to the same hotkey");
+
+    uint32_t modifiers = 0;
+    uint32_t vk = 0;
+    Expect(!ParseHotkey(L"Ctrl+Ctrl+M", modifiers, vk) && !ParseHotkey(L"Hyper+M", modifiers, vk) &&
+           !ParseHotkey(L"Ctrl+", modifiers, vk) && !ParseHotkey(L"Unknown", modifiers, vk),
+           "malformed display strings rejected");
+}
+
+static void TestStartupProfiler()
+{
+    StartupProfiler::SetClock(FakeNowUs);
+
+    // The process existed for 5 ms before Begin; every phase counts from its creation
+    g_fakeNowUs = 1000000;
+    StartupProfiler::Begin(5000);
+    Expect(StartupProfiler::GetPhaseCount() == 0, "Begin starts an empty table");
+
+    g_fakeNowUs += 1200;
+    StartupProfiler::Mark("settings");
+    g_fakeNowUs += 300;
+    StartupProfiler::Mark("tray");
+    g_fakeNowUs += 40000;
+    StartupProfiler::Mark("hooks");
+    StartupProfiler::Mark("tray");
+    g_fakeNowUs += 7;
+    StartupProfiler::Mark("ready");
+
+    static const char* const ORDER[] = { "settings", "tray", "hooks", "tray", "ready" };
+    static const uint64_t TIMES_US[] = { 6200, 6500, 46500, 46500, 46507 };
+    static const uint64_t DURATIONS_US[] = { 6200, 300, 40000, 0, 7 };
+    bool ordered = StartupProfiler::GetPhaseCount() == 5;
+    bool durations = ordered;
+    for (size_t i = 0; ordered && i < 5; ++i)
+    {
+        ordered &= strcmp(StartupProfiler::GetPhaseName(i), ORDER[i]) == 0 &&
+                   StartupProfiler::GetPhaseUs(i) == TIMES_US[i];
+        durations &= StartupProfiler::GetPhaseDurationUs(i) == DURATIONS_US[i];
+    }
+    Expect(ordered, "phases in mark order, timed from process start");
+    Expect(durations, "phase durations measured from the previous mark");
+    Expect(StartupProfiler::FindPhaseUs("hooks") == 46500 && StartupProfiler::FindPhaseUs("tray") == 6500 &&
+           StartupProfiler::FindPhaseUs("shown") == 0, "lookup finds the first mark, 0 when missing");
+
+    // The table is fixed; marks past it are dropped
+    for (size_t i = 0; i < StartupProfiler::MAX_PHASES; ++i)
+    {
+        g_fakeNowUs += 1;
+        StartupProfiler::Mark("extra");
+    }
+    Expect(StartupProfiler::GetPhaseCount() == StartupProfiler::MAX_PHASES &&
+           StartupProfiler::GetPhaseUs(StartupProfiler::MAX_PHASES - 1) == 46507 + StartupProfiler::MAX_PHASES - 5,
+           "marks past MAX_PHASES dropped");
+
+    g_fakeNowUs += 1000;
+    StartupProfiler::Begin(0);
+    StartupProfiler::Mark("ready");
+    Expect(StartupProfiler::GetPhaseCount() == 1 && StartupProfiler::FindPhaseUs("ready") == 0,
+           "Begin restarts the table");
+
+    StartupProfiler::SetClock(nullptr);
+}
+
+static void TestFastRandom()
+{
+    FastRandom first(12345);
+    FastRandom second(12345);
+    FastRandom other(12346);
+    bool same = true;
+    bool differs = false;
+    for (int i = 0; i < 1000; ++i)
+    {
+        uint32_t value = first.Next();
+        same &= value == second.Next();
+        differs |= value != other.Next();
+    }
+    Expect(same && differs, "a seed fixes the sequence, another seed changes it");
+
+    // Bounds hold for negative, single-value and full-width ranges
+    bool inRange = true;
+    bool single = true;
+    int lowest = INT_MAX;
+    int highest = INT_MIN;
+    for (int i = 0; i < 100000; ++i)
+    {
+        int value = first.NextInRange(-5, 5);
+        inRange &= value >= -5 && value <= 5;
+        lowest = std::min(lowest, value);
+        highest = std::max(highest, value);
+        single &= first.NextInRange(7, 7) == 7;
+        first.NextInRange(INT_MIN, INT_MAX);
+    }
+    Expect(inRange && lowest == -5 && highest == 5, "NextInRange covers [low, high] and nothing else");
+    Expect(single, "single-value range");
+
+    // Chi-square over 10 buckets; 27.88 is the 0.1% critical value for 9 degrees of freedom
+    static const int BUCKETS = 10;
+    static const int DRAWS = 100000;
+    int counts[BUCKETS] = {};
+    FastRandom random(42);
+    for (int i = 0; i < DRAWS; ++i)
+    {
+        ++counts[random.NextInRange(0, BUCKETS - 1)];
+    }
+    double expected = static_cast<double>(DRAWS) / BUCKETS;
+    double chiSquare = 0.0;
+    for (int count : counts)
+    {
+        chiSquare += (count - expected) * (count - expected) / expected;
+    }
+    Expect(chiSquare < 27.88, "buckets evenly filled");
+
+    // Default construction seeds from time and address: two generators disagree
+    FastRandom a;
+    FastRandom b;
+    Expect(a.Next() != b.Next() || a.Next() != b.Next(), "default seeds differ");
+}
+
+static void TestProcessMemory()
+{
+    static const size_t TOUCHED = 32 * 1024 * 1024;
+
+    ProcessMemoryUsage before = {};
+    if (!Expect(ProcessMemory::Query(before), "usage readable"))
+        return;
+    Expect(before.privateBytes > 0 && before.workingSetBytes > 0 && before.privateBytes < (1ULL << 40),
+           "plausible private bytes and working set");
+#ifndef _WIN32
+    // The commit charge on Windows may exceed the resident set; private resident pages cannot
+    Expect(before.privateBytes <= before.workingSetBytes, "private pages are part of the working set");
+#endif
+
+    // Writing fresh pages shows up as private memory
+    std::vector<char> block(TOUCHED);
+    for (size_t i = 0; i < TOUCHED; i += 4096)
+    {
+        block[i] = static_cast<char>(i);
+    }
+    ProcessMemoryUsage after = {};
+    Expect(ProcessMemory::Query(after) && after.privateBytes >= before.privateBytes + TOUCHED / 2,
+           "touched pages counted as private");
+    Expect(block[4096] == static_cast<char>(4096), "block kept alive");
+
+    Expect(ProcessMemory::CheckBudget(UINT64_MAX, "test") && !ProcessMemory::CheckBudget(1, "test"),
+           "budget check against usage");
+}
+
+static void TestTraceWraparound()
+{
+    static const uint64_t EXTRA = 100;
+    const uint64_t total = TraceRecorder::EVENTS_PER_THREAD + EXTRA;
+
+    TraceRecorder::SetThreadName("trace-main");
+    for (uint64_t i = 0; i < total; ++i)
+    {
+        TraceRecorder::Instant("wrap", i);
+    }
+    Expect(TraceRecorder::GetEventCount() >= TraceRecorder::EVENTS_PER_THREAD, "full ring counts EVENTS_PER_THREAD");
+
+    std::string text;
+    std::vector<TraceLine> lines;
+    Expect(ExportTrace(text, lines), "export succeeds");
+
+    // The slot the next event reuses is never exported, so a full ring shows one event less
+    size_t tid = FindTraceThread(lines, "trace-main");
+    std::vector<uint64_t> values;
+    for (const TraceLine& line : lines)
+    {
+        if (line.tid == tid && line.name == "wrap")
+            values.push_back(line.value);
+    }
+
+    bool consecutive = true;
+    for (size_t i = 1; i < values.size(); ++i)
+    {
+        consecutive &= values[i] == values[i - 1] + 1;
+    }
+    Expect(tid != 0 && values.size() == TraceRecorder::EVENTS_PER_THREAD - 1, "ring keeps the newest events");
+    Expect(!values.empty() && values.front() == EXTRA + 1 && values.back() == total - 1 && consecutive,
+           "oldest events overwritten, rest in order");
+}
+
+static void TestTraceExportRace()
+{
+    static const int EXPORTS = 20;
+
+    std::atomic<uint64_t> written{ 0 };
+    std::atomic<bool> stop{ false };
+    std::thread writer([&]()
+    {
+        TraceRecorder::SetThreadName("trace-writer");
+        for (uint64_t i = 0; !stop.load(std::memory_order_relaxed); ++i)
+        {
+            TraceRecorder::Instant((i & 1) ? "odd" : "even", i);
+            written.store(i + 1, std::memory_order_relaxed);
+        }
+    });
+
+    while (written.load(std::memory_order_relaxed) < 2 * TraceRecorder::EVENTS_PER_THREAD)
+    {
+        std::this_thread::yield();
+    }
+
+    // Every exported event is one the writer finished: values consecutive, names match them
+    std::string text;
+    std::vector<TraceLine> lines;
+    bool wellFormed = true;
+    bool consistent = true;
+    bool bounded = true;
+    for (int round = 0; round < EXPORTS; ++round)
+    {
+        wellFormed &= ExportTrace(text, lines) && IsWellFormedJson(text);
+        size_t tid = FindTraceThread(lines, "trace-writer");
+        size_t count = 0;
+        uint64_t previous = 0;
+        for (const TraceLine& line : lines)
+        {
+            if (line.tid != tid || line.phase != "i")
+                continue;
+
+            consistent &= line.name == ((line.value & 1) ? "odd" : "even");
+            consistent &= count == 0 || line.value == previous + 1;
+            previous = line.value;
+            ++count;
+        }
+        bounded &= tid != 0 && count < TraceRecorder::EVENTS_PER_THREAD;
+    }
+
+    stop.store(true, std::memory_order_relaxed);
+    writer.join();
+
+    Expect(wellFormed, "exports during writes are well-formed JSON");
+    Expect(consistent, "overwritten slots dropped, no torn events");
+    Expect(bounded, "export never exceeds the ring");
+
+    // Once the writer is gone nothing is overwritten during the copy
+    ExportTrace(text, lines);
+    size_t tid = FindTraceThread(lines, "trace-writer");
+    size_t count = 0;
+    for (const TraceLine& line : lines)
+    {
+        if (line.tid == tid && line.phase == "i")
+            ++count;
+    }
+    Expect(tid != 0 && count == TraceRecorder::EVENTS_PER_THREAD - 1, "idle ring exported whole");
+}
+
+static void TestTraceThreadLimit()
+{
+    static const char* const NAMES[] =
+    {
+        "trace-0", "trace-1", "trace-2", "trace-3", "trace-4", "trace-5", "trace-6", "trace-7",
+        "trace-8", "trace-9", "trace-10", "trace-11", "trace-12", "trace-13", "trace-14", "trace-15"
+    };
+    static_assert(sizeof(NAMES) / sizeof(NAMES[0]) == TraceRecorder::MAX_THREADS, "one name per ring");
+
+    // This thread holds a ring, so MAX_THREADS more threads are at least one too many
+    TraceRecorder::SetThreadName("trace-main");
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t ready = 0;
+    bool release[TraceRecorder::MAX_THREADS] = {};
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < TraceRecorder::MAX_THREADS; ++i)
+    {
+        threads.emplace_back([&, i]()
+        {
+            TraceRecorder::SetThreadName(NAMES[i]);
+            TraceRecorder::Instant("limit", i);
+
+            std::unique_lock<std::mutex> lock(mutex);
+            ++ready;
+            changed.notify_all();
+            changed.wait(lock, [&]() { return release[i]; });
+        });
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&]() { return ready == TraceRecorder::MAX_THREADS; });
+    }
+
+    std::string text;
+    std::vector<TraceLine> lines;
+    ExportTrace(text, lines);
+
+    size_t rings = 0;
+    size_t limitEvents = 0;
+    size_t attached = 0;
+    size_t reused = TraceRecorder::MAX_THREADS;
+    for (const TraceLine& line : lines)
+    {
+        rings += line.name == "thread_name";
+        limitEvents += line.name == "limit";
+    }
+    for (size_t i = 0; i < TraceRecorder::MAX_THREADS; ++i)
+    {
+        if (FindTraceThread(lines, NAMES[i]) == 0)
+            continue;
+
+        ++attached;
+        if (reused == TraceRecorder::MAX_THREADS)
+            reused = i;
+    }
+    Expect(rings == TraceRecorder::MAX_THREADS, "no more than MAX_THREADS rings");
+    Expect(attached < TraceRecorder::MAX_THREADS && limitEvents == attached, "threads past the cap record nothing");
+
+    // Every ring is taken, so the next thread gets exactly the one an exiting thread frees
+    size_t tid = reused < TraceRecorder::MAX_THREADS ? FindTraceThread(lines, NAMES[reused]) : 0;
+    if (tid != 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            release[reused] = true;
+        }
+        changed.notify_all();
+        threads[reused].join();
+
+        std::thread successor([]()
+        {
+            TraceRecorder::SetThreadName("trace-successor");
+            TraceRecorder::Instant("successor", 1);
+        });
+        successor.join();
+    }
+
+    ExportTrace(text, lines);
+    bool successorEvent = false;
+    for (const TraceLine& line : lines)
+    {
+        successorEvent |= line.tid == tid && line.name == "successor";
+    }
+    Expect(tid != 0 && FindTraceThread(lines, "trace-successor") == tid && successorEvent,
+           "freed ring reused under the new thread name");
+    Expect(reused < TraceRecorder::MAX_THREADS && FindTraceThread(lines, NAMES[reused]) == 0,
+           "old thread name gone");
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (bool& flag : release)
+        {
+            flag = true;
+        }
+    }
+    changed.notify_all();
+    for (std::thread& thread : threads)
+    {
+        if (thread.joinable())
+            thread.join();
+    }
+}
+
+static void TestTraceJson()
+{
+    TraceRecorder::SetThreadName("trace-main");
+    {
+        TraceScope scope("json-scope", 3);
+        TraceRecorder::Instant("json-instant", 4);
+    }
+
+    std::string text;
+    std::vector<TraceLine> lines;
+    Expect(ExportTrace(text, lines) && IsWellFormedJson(text), "export is well-formed JSON");
+    Expect(!IsWellFormedJson(text.substr(0, text.size() / 2)) && !IsWellFormedJson(text + ","),
+           "checker rejects truncated and trailing text");
+
+    bool process = false;
+    bool complete = false;
+    bool instant = false;
+    size_t tid = FindTraceThread(lines, "trace-main");
+    for (const TraceLine& line : lines)
+    {
+        process |= line.name == "process_name" && line.phase == "M";
+        complete |= line.tid == tid && line.name == "json-scope" && line.phase == "X" && line.hasDuration &&
+                    line.value == 3;
+        instant |= line.tid == tid && line.name == "json-instant" && line.phase == "i" && line.value == 4;
+    }
+    Expect(process && tid != 0, "process and thread metadata");
+    Expect(complete && instant, "complete and instant events on the thread's track");
+    Expect(!TraceRecorder::WriteChromeJson(nullptr), "null file rejected");
+}
+
+void RegisterCoreTests(TestRunner& runner)
+{
+    runner.Add("core.activity_channel", TestActivityChannel);
+    runner.Add("core.idle_scheduler", TestIdleScheduler);
+    runner.Add("core.idle_engine", TestIdleEngine);
+    runner.Add("core.hook_watchdog", TestHookWatchdog);
+    runner.Add("core.timer_heap", TestTimerHeap);
+    runner.Add("core.spsc_ring", TestSpscRing);
+    runner.Add("core.hotkey_model", TestHotkeyModel);
+    runner.Add("core.startup_profiler", TestStartupProfiler);
+    runner.Add("core.fast_random", TestFastRandom);
+    runner.Add("core.process_memory", TestProcessMemory);
+    runner.Add("core.trace_wraparound", TestTraceWraparound);
+    runner.Add("core.trace_export_race", TestTraceExportRace);
+    runner.Add("core.trace_thread_limit", TestTraceThreadLimit);
+    runner.Add("core.trace_json", TestTraceJson);
+}
\ No newline at end of file
@@ -0,0 +1,340 @@
+#include "Test.h"
+#include "ActivityChannel.h"
+#include "EventDrainThread.h"
+#include "InputConsumer.h"
+#include "InputDispatch.h"
+#include "InputEventRing.h"
+#include "InputSource.h"
+#include "InputThread.h"
+#include "MonotonicClock.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    /**
+     * Input source standing in for the hook thread
+     * Pump delivers a burst, then keeps delivering one event per millisecond
+     * until Wake, recording which thread ran each step
+     */
+    class FakeInputSource : public IInputSource
+    {
+    public:
+        explicit FakeInputSource(bool openSucceeds = true, uint32_t burst = 0)
+            : m_openSucceeds(openSucceeds)
+            , m_burst(burst)
+        {
+        }
+
+        // IInputSource
+        bool Open() override
+        {
+            m_openThread = std::this_thread::get_id();
+            return m_openSucceeds;
+        }
+
+        void Pump(InputDispatch& dispatch) override
+        {
+            m_pumpThread = std::this_thread::get_id();
+
+            InputEvent event;
+            event.device = 7;
+            for (uint32_t i = 0; i < m_burst; ++i)
+            {
+                event.timestampMs = MonotonicNowMs();
+                event.x = static_cast<int16_t>(i);
+                dispatch.Dispatch(event);
+            }
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (!m_wake)
+            {
+                lock.unlock();
+                event.timestampMs = MonotonicNowMs();
+                dispatch.Dispatch(event);
+                lock.lock();
+                m_wakeSignal.wait_for(lock, std::chrono::milliseconds(1), [this] { return m_wake; });
+            }
+        }
+
+        void Wake() override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_wake = true;
+            m_wakeSignal.notify_one();
+        }
+
+        void Close() override
+        {
+            m_closeThread = std::this_thread::get_id();
+            ++m_closes;
+        }
+
+        // Observation (after the input thread stopped)
+        std::thread::id GetOpenThread() const { return m_openThread; }
+        std::thread::id GetPumpThread() const { return m_pumpThread; }
+        std::thread::id GetCloseThread() const { return m_closeThread; }
+        int GetCloses() const { return m_closes; }
+
+    private:
+        // Member variables
+        bool m_openSucceeds;
+        uint32_t m_burst;
+        std::mutex m_mutex;
+        std::condition_variable m_wakeSignal;
+        bool m_wake = false;
+        std::thread::id m_openThread;
+        std::thread::id m_pumpThread;
+        std::thread::id m_closeThread;
+        int m_closes = 0;
+    };
+
+    // Checks that every device's sequence numbers arrive in increasing order
+    class SequenceConsumer : public IInputConsumer
+    {
+    public:
+        static const size_t DEVICES = 4;
+
+        void OnEvents(const InputEvent* events, size_t count) override
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                uint64_t device = events[i].device;
+                if (device >= DEVICES)
+                {
+                    ++m_misordered;
+                    continue;
+                }
+
+                uint32_t sequence = GetSequence(events[i]);
+                if (m_received[device] && sequence <= m_last[device])
+                    ++m_misordered;
+                m_last[device] = sequence;
+                ++m_received[device];
+            }
+            ++m_batches;
+        }
+
+        static void SetSequence(InputEvent& event, uint32_t sequence)
+        {
+            event.x = static_cast<int16_t>(sequence & 0xFFFF);
+            event.y = static_cast<int16_t>(sequence >> 16);
+        }
+
+        static uint32_t GetSequence(const InputEvent& event)
+        {
+            return static_cast<uint16_t>(event.x) | (static_cast<uint32_t>(static_cast<uint16_t>(event.y)) << 16);
+        }
+
+        uint64_t GetReceived() const
+        {
+            uint64_t total = 0;
+            for (uint64_t received : m_received)
+            {
+                total += received;
+            }
+            return total;
+        }
+        uint64_t GetMisordered() const { return m_misordered; }
+        uint64_t GetBatches() const { return m_batches; }
+
+    private:
+        // Member variables (drain thread only)
+        uint64_t m_received[DEVICES] = {};
+        uint32_t m_last[DEVICES] = {};
+        uint64_t m_misordered = 0;
+        uint64_t m_batches = 0;
+    };
+}
+
+static void TestInputThreadHandoff()
+{
+    ActivityChannel channel;
+    InputDispatch dispatch(channel);
+    std::unique_ptr<InputEventRing> ring(new InputEventRing());
+    dispatch.SetEventRing(ring.get());
+
+    FakeInputSource source(true, 100);
+    InputThread thread;
+    uint64_t startedAt = MonotonicNowMs();
+    Expect(thread.Start(&source, &dispatch) && thread.IsRunning(), "start returns once the source opened");
+
+    // The caller stands in for a UI thread stuck in a modal loop; input keeps flowing
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    uint64_t lastActivity = channel.GetLastActivity();
+    Expect(lastActivity >= startedAt + 50, "activity published while the caller was blocked");
+    Expect(ring->GetSize() >= 100 && dispatch.GetDeviceCount() == 1 && dispatch.GetDeviceHandle(0) == 7,
+           "events reach the ring and are attributed to their device");
+
+    thread.Stop();
+    Expect(!thread.IsRunning() && source.GetCloses() == 1, "stop wakes the pump and closes the source once");
+    Expect(source.GetOpenThread() != std::this_thread::get_id() && source.GetOpenThread() == source.GetPumpThread() &&
+           source.GetPumpThread() == source.GetCloseThread(), "open, pump and close run on the input thread");
+
+    InputEvent events[256];
+    size_t count = ring->PopBatch(events, 256);
+    bool ordered = count >= 100;
+    for (size_t i = 1; i < count; ++i)
+    {
+        ordered &= events[i].timestampMs >= events[i - 1].timestampMs;
+    }
+    Expect(ordered && events[0].x == 0 && events[99].x == 99, "events handed over in order");
+
+    thread.Stop();
+    Expect(source.GetCloses() == 1, "second stop is a no-op");
+}
+
+static void TestInputThreadOpenFailure()
+{
+    ActivityChannel channel;
+    InputDispatch dispatch(channel);
+    FakeInputSource source(false);
+    InputThread thread;
+    Expect(!thread.Start(&source, &dispatch) && !thread.IsRunning(), "failed open reported to the caller");
+    Expect(source.GetCloses() == 0 && source.GetPumpThread() == std::thread::id(), "nothing pumped or closed");
+    Expect(!thread.Start(nullptr, &dispatch) && !thread.Start(&source, nullptr), "missing source or dispatch refused");
+}
+
+static void TestRingDrainStress()
+{
+    // The input thread interleaves four devices as fast as it can while the drain
+    // thread feeds two consumers every millisecond; nothing may be lost unaccounted
+    // or reordered, and the input thread never waits when the ring is full
+    static const uint32_t EVENTS = 2000000;
+
+    ActivityChannel channel;
+    InputDispatch dispatch(channel);
+    std::unique_ptr<InputEventRing> ring(new InputEventRing());
+
+    SequenceConsumer first;
+    SequenceConsumer second;
+    EventDrainThread drain;
+    dispatch.SetEventRing(ring.get(), &drain);
+    drain.AddConsumer(&first);
+    drain.AddConsumer(&second);
+    std::atomic<uint64_t> passes{ 0 };
+    drain.SetPassCallback([&passes]() { passes.fetch_add(1, std::memory_order_relaxed); });
+    if (!Expect(drain.Start(ring.get(), 1), "drain thread started"))
+        return;
+
+    uint32_t sequences[SequenceConsumer::DEVICES] = {};
+    auto start = std::chrono::steady_clock::now();
+    std::thread producer([&]()
+    {
+        InputEvent event;
+        for (uint32_t i = 0; i < EVENTS; ++i)
+        {
+            // Bursts from one device, then the next, as real input arrives
+            uint64_t device = (i / 7) % SequenceConsumer::DEVICES;
+            event.device = device;
+            event.timestampMs = MonotonicNowMs();
+            event.type = (i & 1) ? InputEventType::KeyDown : InputEventType::MouseMove;
+            SequenceConsumer::SetSequence(event, sequences[device]++);
+            dispatch.Dispatch(event);
+
+            // Give a single core's drain thread a chance to run now and then
+            if ((i & 4095) == 0)
+                std::this_thread::yield();
+        }
+    });
+    producer.join();
+    double producerMs = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count()) / 1000.0;
+    drain.Stop();
+
+    printf("  %u events in %.1f ms, %llu drained in %llu batches, %llu dropped, %llu passes\n", EVENTS, producerMs,
+           static_cast<unsigned long long>(first.GetReceived()), static_cast<unsigned long long>(first.GetBatches()),
+           static_cast<unsigned long long>(ring->GetDropped()), static_cast<unsigned long long>(passes.load()));
+    Expect(first.GetReceived() + ring->GetDropped() == EVENTS, "drained plus dropped equals dispatched");
+    Expect(first.GetReceived() > 0 && first.GetMisordered() == 0, "every device's events in order");
+    Expect(second.GetReceived() == first.GetReceived() && second.GetMisordered() == 0, "every consumer sees every batch");
+    Expect(ring->GetSize() == 0, "stop drains what was left in the ring");
+
+    bool attributed = dispatch.GetDeviceCount() == SequenceConsumer::DEVICES;
+    for (size_t i = 0; attributed && i < SequenceConsumer::DEVICES; ++i)
+    {
+        attributed = dispatch.GetDeviceHandle(i) == i && dispatch.GetDeviceEvents(i) == sequences[i];
+    }
+    Expect(attributed, "dispatch counts dropped events against their device too");
+}
+
+// Waits until the drain thread ran passes passes and left the ring empty
+static bool WaitForPasses(const EventDrainThread& drain, const InputEventRing& ring, uint64_t passes, int timeoutMs)
+{
+    uint64_t deadline = MonotonicNowMs() + static_cast<uint64_t>(timeoutMs);
+    while (drain.GetPasses() < passes || ring.GetSize() != 0)
+    {
+        if (MonotonicNowMs() >= deadline)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+static void TestDrainIdleWakeups()
+{
+    // The drain thread sleeps on an empty ring until the input thread pushes,
+    // drains every interval while events flow and falls asleep again after a
+    // pass that found nothing; a burst past the threshold wakes it early
+    ActivityChannel channel;
+    InputDispatch dispatch(channel);
+    std::unique_ptr<InputEventRing> ring(new InputEventRing());
+    SequenceConsumer consumer;
+    EventDrainThread drain;
+    dispatch.SetEventRing(ring.get(), &drain);
+    drain.AddConsumer(&consumer);
+    if (!Expect(drain.Start(ring.get(), 20), "drain thread started"))
+        return;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    Expect(drain.GetPasses() == 0, "no wakeups without input");
+
+    InputEvent event;
+    uint32_t sequence = 0;
+    event.timestampMs = MonotonicNowMs();
+    SequenceConsumer::SetSequence(event, sequence++);
+    dispatch.Dispatch(event);
+    Expect(WaitForPasses(drain, *ring, 1, 100), "first push wakes the sleeping drain thread");
+
+    // One pass for the event, at most one more that finds the ring empty
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    uint64_t passes = drain.GetPasses();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    Expect(passes <= 2 && drain.GetPasses() == passes, "asleep again once the ring stayed empty");
+    drain.Stop();
+
+    // With a long interval only the threshold brings the next pass forward
+    drain.Start(ring.get(), 60000);
+    SequenceConsumer::SetSequence(event, sequence++);
+    dispatch.Dispatch(event);
+    passes = drain.GetPasses();
+    Expect(WaitForPasses(drain, *ring, passes + 1, 100), "push after a restart wakes it");
+    passes = drain.GetPasses();
+    for (size_t i = 0; i + 1 < EventDrainThread::WAKE_THRESHOLD; ++i)
+    {
+        SequenceConsumer::SetSequence(event, sequence++);
+        dispatch.Dispatch(event);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    Expect(drain.GetPasses() == passes && ring->GetSize() == EventDrainThread::WAKE_THRESHOLD - 1,
+           "events below the threshold wait for the interval");
+    SequenceConsumer::SetSequence(event, sequence++);
+    dispatch.Dispatch(event);
+    Expect(WaitForPasses(drain, *ring, passes + 1, 1000), "burst past the threshold wakes it early");
+    drain.Stop();
+
+    Expect(consumer.GetReceived() == sequence && consumer.GetMisordered() == 0 && ring->GetDropped() == 0,
+           "every event drained once, in order");
+}
+
+void RegisterInputTests(TestRunner& runner)
+{
+    runner.Add("input.thread_handoff", TestInputThreadHandoff);
+    runner.Add("input.thread_open_failure", TestInputThreadOpenFailure);
+    runner.Add("input.ring_drain_stress", TestRingDrainStress);
+    runner.Add("input.drain_idle_wakeups", TestDrainIdleWakeups);
+}
\ No newline at end of file
@@ -0,0 +1,302 @@
+#include "Test.h"
+
+#ifdef __linux__
+
+#include "ActivityChannel.h"
+#include "CoreConfig.h"
+#include "EvdevInputSource.h"
+#include "IdleScheduler.h"
+#include "InputDispatch.h"
+#include "InputThread.h"
+#include "ManualIdleSource.h"
+#include "MonotonicClock.h"
+#include "SeatDaemon.h"
+#include "StatusPublisher.h"
+#include "TimerFdDeadlineTimer.h"
+#include <cerrno>
+#include <chrono>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <poll.h>
+#include <string>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+// Waits for the timer descriptor; true when it expired within timeoutMs
+static bool WaitForExpiry(TimerFdDeadlineTimer& timer, int timeoutMs)
+{
+    pollfd fd = {};
+    fd.fd = timer.GetFd();
+    fd.events = POLLIN;
+    return poll(&fd, 1, timeoutMs) == 1 && timer.ConsumeExpiration();
+}
+
+static void TestTimerFd()
+{
+    TimerFdDeadlineTimer timer;
+    if (!Expect(timer.GetFd() >= 0, "timerfd created"))
+        return;
+
+    uint64_t start = MonotonicNowMs();
+    Expect(timer.Arm(start + 20) && WaitForExpiry(timer, 1000), "armed deadline expires");
+    Expect(MonotonicNowMs() >= start + 20, "not before the deadline");
+    Expect(!timer.ConsumeExpiration(), "one expiry per arm");
+
+    // Re-arming replaces the pending deadline; disarming cancels it
+    timer.Arm(MonotonicNowMs() + 10000);
+    timer.Arm(MonotonicNowMs() + 20);
+    Expect(WaitForExpiry(timer, 1000), "re-arm replaces the later deadline");
+    timer.Arm(MonotonicNowMs() + 20);
+    timer.Disarm();
+    Expect(!WaitForExpiry(timer, 60), "disarmed timer stays quiet");
+
+    // A deadline already in the past fires at once
+    Expect(timer.Arm(0) && WaitForExpiry(timer, 100), "past deadline fires immediately");
+    Expect(timer.GetArmCount() == 5, "every arm programmed the kernel timer");
+}
+
+static void TestSchedulerWakeups()
+{
+    // One-second timeout on the real timerfd; activity every 100 ms for 2.5 s,
+    // then idle: a wakeup per timeout while active, then one action
+    TimerFdDeadlineTimer timer;
+    IdleScheduler scheduler(&timer);
+    scheduler.SetTimeout(1);
+
+    uint64_t start = MonotonicNowMs();
+    uint64_t lastActivity = start;
+    scheduler.Start(start, lastActivity);
+
+    uint64_t activeUntil = start + 2500;
+    uint64_t actedAt = 0;
+    while (!actedAt && MonotonicNowMs() < start + 5000)
+    {
+        if (WaitForExpiry(timer, 100) && scheduler.OnTimer(MonotonicNowMs(), lastActivity))
+            actedAt = MonotonicNowMs();
+
+        uint64_t now = MonotonicNowMs();
+        if (now < activeUntil)
+            lastActivity = now;
+    }
+    scheduler.Stop();
+
+    printf("  %llu wakeups, %llu timer arms, idle action %llu ms after the last input\n",
+           static_cast<unsigned long long>(scheduler.GetWakeups()), static_cast<unsigned long long>(timer.GetArmCount()),
+           static_cast<unsigned long long>(actedAt ? actedAt - lastActivity : 0));
+    Expect(scheduler.GetActions() == 1, "idle action after activity stopped");
+    Expect(actedAt >= lastActivity + 1000 - IdleScheduler::TIMER_SLACK_MS && actedAt < lastActivity + 1500,
+           "action one timeout after the last input");
+    Expect(scheduler.GetWakeups() >= 3 && scheduler.GetWakeups() <= 5, "about one wakeup per timeout, not per input");
+}
+
+static void TestSeatIdleSource()
+{
+    // A seat without devices follows an idle clock (mmad --x11-seat): input the
+    // clock saw half a second in defers the one-second idle action by as much
+    SeatDaemon daemon;
+    if (!Expect(daemon.Open(), "daemon opened"))
+        return;
+
+    ManualIdleSource idle;
+    uint32_t seat = daemon.AddSeat(1);
+    uint64_t start = daemon.GetLastActivity(seat);
+    idle.SetLastInputTime(start + 500);
+    Expect(daemon.SetIdleSource(seat, &idle) && !daemon.SetIdleSource(seat + 1, &idle),
+           "idle source attached to an existing seat only");
+
+    uint64_t actedAt = 0;
+    daemon.SetIdleAction([&actedAt](uint32_t)
+    {
+        if (!actedAt)
+            actedAt = MonotonicNowMs();
+    });
+    while (!actedAt && MonotonicNowMs() < start + 3000)
+    {
+        daemon.RunOnce(100);
+    }
+
+    printf("  idle action %llu ms after the seat started\n", static_cast<unsigned long long>(actedAt ? actedAt - start : 0));
+    Expect(actedAt >= start + 1500 - IdleScheduler::TIMER_SLACK_MS && actedAt < start + 2000,
+           "idle action one timeout after the input the clock saw");
+    Expect(daemon.GetSeatActions(seat) == 1 && daemon.GetSeatEvents(seat) == 0, "clock input is not counted as events");
+}
+
+static void TestSeatTimeoutLimits()
+{
+    // A zero timeout would re-arm the seat at now and pop it again in the same
+    // pass forever; the daemon clamps it when a seat is added and refuses it later
+    SeatDaemon daemon;
+    if (!Expect(daemon.Open(), "daemon opened"))
+        return;
+
+    uint32_t seat = daemon.AddSeat(0);
+    uint32_t capped = daemon.AddSeat(MAX_TIMEOUT_SECONDS + 1);
+    Expect(daemon.GetTimeout(seat) == 1 && daemon.GetTimeout(capped) == MAX_TIMEOUT_SECONDS,
+           "seat timeouts clamped to 1..MAX_TIMEOUT_SECONDS");
+    Expect(!daemon.SetTimeout(seat, 0) && !daemon.SetTimeout(seat, MAX_TIMEOUT_SECONDS + 1) &&
+           daemon.GetTimeout(seat) == 1, "out-of-range timeout refused, old one kept");
+    Expect(daemon.SetTimeout(capped, 2) && daemon.GetTimeout(capped) == 2 && !daemon.SetTimeout(capped + 1, 2),
+           "valid timeout applied to existing seats only");
+
+    uint64_t start = MonotonicNowMs();
+    while (MonotonicNowMs() < start + 1500)
+    {
+        daemon.RunOnce(100);
+    }
+    Expect(daemon.GetSeatActions(seat) == 1 && daemon.GetSeatActions(capped) == 0,
+           "one idle action per timeout, no spinning");
+    Expect(daemon.GetWakeups() <= 30, "about one wakeup per RunOnce timeout");
+}
+
+// Opens the writing end of a FIFO node once the source holds the reading end
+static int OpenNodeWriter(const std::string& path, int timeoutMs)
+{
+    uint64_t deadline = MonotonicNowMs() + static_cast<uint64_t>(timeoutMs);
+    for (;;)
+    {
+        // ENXIO until a reader has the FIFO open
+        int fd = open(path.c_str(), O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd >= 0 || errno != ENXIO || MonotonicNowMs() >= deadline)
+            return fd;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+// One relative move and its SYN_REPORT, as the kernel writes them
+static bool WriteMove(int fd, int dx)
+{
+    input_event records[2] = {};
+    records[0].type = EV_REL;
+    records[0].code = REL_X;
+    records[0].value = dx;
+    records[1].type = EV_SYN;
+    records[1].code = SYN_REPORT;
+    return write(fd, records, sizeof(records)) == static_cast<ssize_t>(sizeof(records));
+}
+
+static uint64_t GetNodeId(const std::string& path)
+{
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 ? static_cast<uint64_t>(info.st_ino) : 0;
+}
+
+// Waits until the dispatch saw events events from devices devices
+static bool WaitForDispatch(const InputDispatch& dispatch, size_t devices, uint64_t events, int timeoutMs)
+{
+    uint64_t deadline = MonotonicNowMs() + static_cast<uint64_t>(timeoutMs);
+    while (MonotonicNowMs() < deadline)
+    {
+        size_t count = dispatch.GetDeviceCount();
+        uint64_t total = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            total += dispatch.GetDeviceEvents(i);
+        }
+        if (count == devices && total == events)
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+static void TestEvdevHotplug()
+{
+    // A folder of FIFOs stands in for /dev/input: one node present at start,
+    // one created while running (IN_CREATE) and one created unreadable and
+    // opened up afterwards (IN_ATTRIB; root may open it at IN_CREATE already)
+    std::string directory = GetTestDirectory() + "/" + MakeTestName("mma-test-evdev");
+    std::string present = directory + "/event0";
+    std::string created = directory + "/event1";
+    std::string attributed = directory + "/event2";
+    if (!Expect(mkdir(directory.c_str(), 0700) == 0 && mkfifo(present.c_str(), 0600) == 0, "node folder created"))
+        return;
+
+    ActivityChannel channel;
+    channel.Reset(0);
+    InputDispatch dispatch(channel);
+    EvdevInputSource source(directory.c_str());
+    InputThread thread;
+    int writers[3] = { -1, -1, -1 };
+
+    if (Expect(thread.Start(&source, &dispatch), "source opened on the input thread"))
+    {
+        writers[0] = OpenNodeWriter(present, 1000);
+        Expect(writers[0] >= 0 && WriteMove(writers[0], 3) && WriteMove(writers[0], -3) &&
+               WaitForDispatch(dispatch, 1, 2, 1000), "events from a node found by the scan reach the channel");
+        Expect(dispatch.GetDeviceHandle(0) == GetNodeId(present), "events attributed to the node");
+
+        mkfifo(created.c_str(), 0600);
+        writers[1] = OpenNodeWriter(created, 1000);
+        Expect(writers[1] >= 0 && WriteMove(writers[1], 1) && WaitForDispatch(dispatch, 2, 3, 1000),
+               "node created while running is opened and read");
+
+        mkfifo(attributed.c_str(), 0);
+        chmod(attributed.c_str(), 0600);
+        writers[2] = OpenNodeWriter(attributed, 1000);
+        Expect(writers[2] >= 0 && WriteMove(writers[2], 1) && WriteMove(writers[2], 1) &&
+               WaitForDispatch(dispatch, 3, 5, 1000), "node made readable later is opened once and read");
+        Expect(channel.GetEventCount() == 5 && dispatch.GetDeviceHandle(1) == GetNodeId(created) &&
+               dispatch.GetDeviceHandle(2) == GetNodeId(attributed), "every event published once, per device");
+
+        thread.Stop();
+    }
+
+    for (int fd : writers)
+    {
+        if (fd >= 0)
+            close(fd);
+    }
+    unlink(present.c_str());
+    unlink(created.c_str());
+    unlink(attributed.c_str());
+    rmdir(directory.c_str());
+}
+
+static void TestStatusTakeover()
+{
+    char defaultName[SharedStatusSegment::MAX_NAME_LENGTH];
+    SharedStatusSegment::GetDefaultName(defaultName, sizeof(defaultName));
+    Expect(std::string(defaultName) == "mma-status-" + std::to_string(geteuid()), "default name carries the uid");
+
+    // A writer that dies without closing leaves its page behind
+    std::string name = MakeTestName("mma-test-status-takeover");
+    pid_t child = fork();
+    if (child == 0)
+    {
+        StatusPublisher publisher;
+        _exit(publisher.Open(name.c_str()) ? 0 : 1);
+    }
+
+    int status = 0;
+    bool exited = child > 0 && waitpid(child, &status, 0) == child && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    SharedStatusSegment reader;
+    StatusSnapshot snapshot;
+    if (!Expect(exited && reader.Open(name.c_str()) && StatusPage::Read(*reader.GetPage(), snapshot) &&
+                snapshot.writerPid == static_cast<uint64_t>(child), "dead writer's page left behind"))
+        return;
+
+    SharedStatusSegment writer;
+    Expect(writer.Create(name.c_str()), "page of an exited writer taken over");
+    Expect(StatusPage::Read(*writer.GetPage(), snapshot) && snapshot.writerPid == 0 && snapshot.publishCount == 0,
+           "taken over page starts fresh");
+}
+
+void RegisterLinuxTests(TestRunner& runner)
+{
+    runner.Add("linux.timerfd", TestTimerFd);
+    runner.Add("linux.scheduler_wakeups", TestSchedulerWakeups);
+    runner.Add("linux.seat_idle_source", TestSeatIdleSource);
+    runner.Add("linux.seat_timeout_limits", TestSeatTimeoutLimits);
+    runner.Add("linux.evdev_hotplug", TestEvdevHotplug);
+    runner.Add("linux.status_takeover", TestStatusTakeover);
+}
+
+#else
+
+void RegisterLinuxTests(TestRunner&)
+{
+}
+
+#endif
\ No newline at end of file
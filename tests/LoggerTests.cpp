@@ -0,0 +1,139 @@
+#include "Test.h"
+#include "Logger.h"
+#include <atomic>
+#include <cstring>
+#include <string>
+
+namespace
+{
+    // Sink that keeps what the logger thread wrote
+    class StringLogSink : public ILogSink
+    {
+    public:
+        bool Write(const char* text, size_t length) override
+        {
+            m_text.append(text, length);
+            return true;
+        }
+
+        const std::string& GetText() const { return m_text; }
+        size_t GetLineCount() const
+        {
+            size_t lines = 0;
+            for (char c : m_text)
+            {
+                lines += c == '\n' ? 1 : 0;
+            }
+            return lines;
+        }
+
+    private:
+        std::string m_text;
+    };
+}
+
+// Record as Logger::Write would enqueue it
+template <typename... Args>
+static LogRecord MakeRecord(const LogSite& site, Args... args)
+{
+    const LogArg packed[sizeof...(Args) + 1] = { MakeLogArg(args)..., LogArg{ 0, LogArgType::Unsigned } };
+
+    LogRecord record = {};
+    record.site = &site;
+    record.timeUs = 1700000000123456;
+    record.threadId = 3;
+    record.argCount = static_cast<uint8_t>(sizeof...(Args));
+    for (size_t i = 0; i < sizeof...(Args); ++i)
+    {
+        record.types[i] = packed[i].type;
+        record.args[i] = packed[i].bits;
+    }
+    return record;
+}
+
+// The quoted message of a formatted line
+template <typename... Args>
+static std::string FormatMessage(const char* format, Args... args)
+{
+    LogSite site = { LogLevel::Info, "src/Example.cpp", 42, format };
+    char line[512];
+    size_t length = Logger::Format(MakeRecord(site, args...), line, sizeof(line));
+
+    std::string text(line, length);
+    size_t start = text.find("msg=\"");
+    if (start == std::string::npos || text.size() < start + 7 || text.compare(text.size() - 2, 2, "\"\n") != 0)
+        return "(malformed line)";
+    return text.substr(start + 5, text.size() - start - 7);
+}
+
+static void TestFormat()
+{
+    LogSite site = { LogLevel::Warning, "C:\\src\\mma/src/Example.cpp", 42, "started" };
+    char line[512];
+    size_t length = Logger::Format(MakeRecord(site), line, sizeof(line));
+    Expect(std::string(line, length) ==
+           "ts=2023-11-14T22:13:20.123Z level=warning thread=3 site=Example.cpp:42 msg=\"started\"\n",
+           "logfmt line: UTC time, level, thread, file name and line");
+
+    Expect(FormatMessage("%u events, %d left, %s", 12u, -3, "done") == "12 events, -3 left, done",
+           "arguments substituted in order");
+    Expect(FormatMessage("100%% busy") == "100% busy", "%% prints one percent sign");
+    Expect(FormatMessage("%lu and %llu", static_cast<uint64_t>(1) << 40, static_cast<uint64_t>(UINT64_MAX)) ==
+           "1099511627776 and 18446744073709551615", "length modifiers print 64-bit values");
+    Expect(FormatMessage("%u then %u", 7u) == "7 then (missing)", "missing argument marked");
+    Expect(FormatMessage("[%5u|%-4d|%08.3f|%x|%.2s]", 42u, -3, 3.14159, 255u, "abc") ==
+           "[   42|-3  |0003.142|ff|ab]", "width, flags and precision honoured");
+    Expect(FormatMessage("%d ms", 2.75) == "2 ms" && FormatMessage("%.1f", 5) == "5.0",
+           "integer and double arguments converted to the conversion");
+    Expect(FormatMessage("%s", 17) == "(not a string)" && FormatMessage("%s", static_cast<const char*>(nullptr)) == "(null)",
+           "non-string and null string arguments");
+
+    // The message is quoted: quotes, backslashes and line breaks are escaped, in the format and the arguments
+    Expect(FormatMessage("path \"%s\"", "C:\\temp\nx") == "path \\\"C:\\\\temp\\nx\\\"", "quotes, backslashes and newlines escaped");
+
+    // A short buffer still ends the line with the closing quote
+    LogSite longSite = { LogLevel::Info, "Example.cpp", 1, "a long message that does not fit into the buffer" };
+    char small[96];
+    length = Logger::Format(MakeRecord(longSite), small, sizeof(small));
+    Expect(length <= sizeof(small) && length > 2 && small[length - 2] == '"' && small[length - 1] == '\n',
+           "truncated line still closed");
+    LogSite escapeSite = { LogLevel::Info, "Example.cpp", 1, "\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"\"" };
+    length = Logger::Format(MakeRecord(escapeSite), small, sizeof(small));
+    Expect(length <= sizeof(small) && small[length - 3] != '\\', "truncation never splits an escape");
+}
+
+static void TestDrops()
+{
+    static const LogSite site = { LogLevel::Info, __FILE__, __LINE__, "record %u" };
+    static const uint32_t EXTRA = 100;
+
+    // Start from an empty ring: earlier tests may have logged while no logger ran
+    StringLogSink drainSink;
+    Logger::Start(&drainSink);
+    Logger::Stop();
+
+    // Records enqueued while stopped wait in the ring; what does not fit is dropped and counted
+    uint64_t dropped = Logger::GetDropped();
+    uint64_t written = Logger::GetWritten();
+    for (uint32_t i = 0; i < Logger::RING_CAPACITY + EXTRA; ++i)
+    {
+        Logger::Write(&site, i);
+    }
+    Expect(Logger::GetDropped() - dropped == EXTRA, "full ring drops and counts the excess");
+
+    StringLogSink sink;
+    Logger::Start(&sink);
+    Logger::Flush();
+    Logger::Stop();
+    Expect(Logger::GetWritten() - written == Logger::RING_CAPACITY && sink.GetLineCount() == Logger::RING_CAPACITY,
+           "every queued record written on the next start");
+    Expect(sink.GetText().find("msg=\"record 0\"") != std::string::npos &&
+           sink.GetText().find("msg=\"record 1023\"") != std::string::npos &&
+           sink.GetText().find("msg=\"record 1024\"") == std::string::npos, "the oldest records kept, the newest dropped");
+}
+
+void RegisterLoggerTests(TestRunner& runner)
+{
+    runner.Add("logger.format", TestFormat);
+    runner.Add("logger.drops", TestDrops);
+}
\ No newline at end of file
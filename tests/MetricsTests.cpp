@@ -0,0 +1,126 @@
+#include "Test.h"
+#include "LatencyHistogram.h"
+#include "OpenMetricsParser.h"
+#include "OpenMetricsWriter.h"
+#include <cstdio>
+#include <memory>
+#include <string>
+
+static const uint64_t BOUNDS_NS[] = { 1000, 10000, 100000, 1000000 };
+
+static bool ReadFile(const std::string& path, std::string& text)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+
+    char chunk[4096];
+    size_t read;
+    text.clear();
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        text.append(chunk, read);
+    }
+
+    bool success = ferror(file) == 0;
+    fclose(file);
+    return success;
+}
+
+static void TestExport()
+{
+    std::unique_ptr<LatencyHistogram> histogram(new LatencyHistogram());
+    std::unique_ptr<LatencyHistogram> empty(new LatencyHistogram());
+    for (uint64_t value = 1; value <= 2000000; value = value * 3 + 7)
+    {
+        histogram->Record(value);
+    }
+
+    std::string path = GetTestDirectory() + "/" + MakeTestName("mma-metrics") + ".prom";
+    OpenMetricsWriter writer;
+    writer.SetPath(path.c_str());
+
+    auto exportOnce = [&]()
+    {
+        writer.Begin();
+        writer.BeginFamily("mma_input_events", "counter", "Input events by type");
+        writer.WriteLabeledSample("mma_input_events", "_total", "type", "mouse_move", 12345);
+        writer.WriteLabeledSample("mma_input_events", "_total", "type", "key_down", 678);
+        writer.WriteCounter("mma_idle_actions", "Cursor moves injected after an idle timeout", 9);
+        writer.WriteGauge("mma_monitoring", "1 while monitoring is on", 1);
+        writer.WriteHistogram("mma_hook_latency_seconds", "Hook latency", "seconds", *histogram,
+                              BOUNDS_NS, sizeof(BOUNDS_NS) / sizeof(BOUNDS_NS[0]), 1e-9);
+        writer.WriteHistogram("mma_empty_seconds", "Nothing recorded", "seconds", *empty,
+                              BOUNDS_NS, sizeof(BOUNDS_NS) / sizeof(BOUNDS_NS[0]), 1e-9);
+        writer.End();
+        return writer.WriteFile();
+    };
+
+    Expect(exportOnce(), "first export written");
+
+    const char* data = writer.GetText().data();
+    size_t capacity = writer.GetText().capacity();
+    Expect(exportOnce(), "second export written");
+    Expect(writer.GetText().data() == data && writer.GetText().capacity() == capacity,
+           "second export reused the buffer");
+
+    std::string text;
+    Expect(ReadFile(path, text) && text == writer.GetText(), "file matches the buffer");
+
+    FILE* temp = fopen((path + ".tmp").c_str(), "rb");
+    Expect(temp == nullptr, "no temporary file left behind");
+    if (temp)
+        fclose(temp);
+
+    OpenMetricsParser parser;
+    bool parsed = parser.Parse(text);
+    Expect(parsed, "exposition parses");
+    if (!parsed)
+        printf("  %s\n", parser.GetError().c_str());
+
+    const OpenMetricsParser::Family* events = parser.FindFamily("mma_input_events");
+    Expect(events && events->type == "counter" && events->samples.size() == 2 &&
+           events->samples[0].labels.at("type") == "mouse_move" && events->samples[0].value == 12345,
+           "labeled counter round-trips");
+
+    const OpenMetricsParser::Family* latency = parser.FindFamily("mma_hook_latency_seconds");
+    bool histogramOk = latency && latency->unit == "seconds";
+    if (histogramOk)
+    {
+        double infCount = -1.0, count = -1.0, sum = -1.0;
+        for (const OpenMetricsParser::Sample& sample : latency->samples)
+        {
+            if (sample.name == "mma_hook_latency_seconds_bucket" && sample.labels.at("le") == "+Inf")
+                infCount = sample.value;
+            else if (sample.name == "mma_hook_latency_seconds_count")
+                count = sample.value;
+            else if (sample.name == "mma_hook_latency_seconds_sum")
+                sum = sample.value;
+        }
+
+        double expectedSum = static_cast<double>(histogram->GetSum()) * 1e-9;
+        histogramOk = infCount == static_cast<double>(histogram->GetCount()) && count == infCount &&
+                      sum > expectedSum * 0.999999 && sum < expectedSum * 1.000001;
+    }
+    Expect(histogramOk, "histogram count and sum match the recorder");
+
+    remove(path.c_str());
+}
+
+static void TestParserRejects()
+{
+    // The parser must catch what a collector would reject
+    OpenMetricsParser negative;
+    Expect(!negative.Parse("# TYPE a counter\na_total 1\n"), "rejects a missing # EOF");
+    Expect(!negative.Parse("# TYPE a counter\na 1\n# EOF\n"), "rejects a counter without _total");
+    Expect(!negative.Parse("# TYPE a histogram\na_bucket{le=\"1\"} 2\na_bucket{le=\"+Inf\"} 1\n# EOF\n"),
+           "rejects decreasing bucket counts");
+    Expect(!negative.Parse("# TYPE a_seconds gauge\n# UNIT a_seconds bytes\n# EOF\n"),
+           "rejects a unit the name does not end with");
+}
+
+void RegisterMetricsTests(TestRunner& runner)
+{
+    runner.Add("metrics.export", TestExport);
+    runner.Add("metrics.parser_rejects", TestParserRejects);
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+// RAWINPUT packets byte for byte as GetRawInputData returns them on x64 Windows
+// (24-byte header, 8-byte device handle); the decoder tests skip them on 32-bit builds
+
+// Mouse 0x10041 moved 5 right and 3 up (MOUSE_MOVE_RELATIVE)
+static const unsigned char RELATIVE_MOUSE_MOVE[] =
+{
+    0x00, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00,
+    0x41, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00,
+    0xFD, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00
+};
+
+// Pen tablet 0x10045 at the horizontal centre, bottom edge (MOUSE_MOVE_ABSOLUTE | MOUSE_VIRTUAL_DESKTOP)
+static const unsigned char ABSOLUTE_MOUSE_MOVE[] =
+{
+    0x00, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00,
+    0x45, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00,
+    0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+// Mouse 0x10041 wheel one notch towards the user (RI_MOUSE_WHEEL, -120)
+static const unsigned char MOUSE_WHEEL[] =
+{
+    0x00, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00,
+    0x41, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x88, 0xFF,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+// Keyboard 0x10043: A pressed (scan code 0x1E, VK_A, WM_KEYDOWN)
+static const unsigned char KEY_A_MAKE[] =
+{
+    0x01, 0x00, 0x00, 0x00, 0x28, 0x00, 0x00, 0x00,
+    0x43, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x1E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+// Keyboard 0x10043: A released (RI_KEY_BREAK, WM_KEYUP)
+static const unsigned char KEY_A_BREAK[] =
+{
+    0x01, 0x00, 0x00, 0x00, 0x28, 0x00, 0x00, 0x00,
+    0x43, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x1E, 0x00, 0x01, 0x00, 0x00, 0x00, 0x41, 0x00,
+    0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+// Keyboard 0x10043: right Ctrl pressed (scan code 0x1D with RI_KEY_E0, VK_CONTROL)
+static const unsigned char RIGHT_CTRL_MAKE[] =
+{
+    0x01, 0x00, 0x00, 0x00, 0x28, 0x00, 0x00, 0x00,
+    0x43, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x1D, 0x00, 0x02, 0x00, 0x00, 0x00, 0x11, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+// Keyboard 0x10043: right Ctrl released (RI_KEY_E0 | RI_KEY_BREAK)
+static const unsigned char RIGHT_CTRL_BREAK[] =
+{
+    0x01, 0x00, 0x00, 0x00, 0x28, 0x00, 0x00, 0x00,
+    0x43, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x1D, 0x00, 0x03, 0x00, 0x00, 0x00, 0x11, 0x00,
+    0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+// KEY_A_MAKE whose dwSize claims 32 bytes, less than header plus RAWKEYBOARD
+static const unsigned char TRUNCATED_KEYBOARD[] =
+{
+    0x01, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00,
+    0x43, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x1E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0x00,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+// Gamepad 0x10049 report (RIM_TYPEHID, one 8-byte report)
+static const unsigned char HID_GAMEPAD[] =
+{
+    0x02, 0x00, 0x00, 0x00, 0x28, 0x00, 0x00, 0x00,
+    0x49, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x08, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00,
+    0x01, 0x80, 0x7F, 0x80, 0x80, 0x08, 0x00, 0x00
+};
\ No newline at end of file
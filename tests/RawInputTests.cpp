@@ -0,0 +1,140 @@
+#include "Test.h"
+#include "ActivityChannel.h"
+#include "HookEventDecoder.h"
+#include "InputDispatch.h"
+#include "RawInputDecoder.h"
+#include "RawInputFixtures.h"
+#include <cstdio>
+#include <cstring>
+
+// The fixtures carry the x64 layout: 24-byte header with an 8-byte device handle
+static bool HasFixtureLayout()
+{
+    if (sizeof(RawInputDecoder::Header) == 24)
+        return true;
+
+    printf("  fixtures use the x64 RAWINPUTHEADER layout, skipped\n");
+    return false;
+}
+
+template <size_t N>
+static bool DecodeFixture(const unsigned char (&packet)[N], InputEvent& event)
+{
+    return RawInputDecoder::Decode(packet, N, 1234, event);
+}
+
+static void TestRawMouse()
+{
+    if (!HasFixtureLayout())
+        return;
+
+    InputEvent event;
+    Expect(DecodeFixture(RELATIVE_MOUSE_MOVE, event) && event.type == InputEventType::MouseMove &&
+           event.x == 5 && event.y == -3, "relative move keeps the signed motion");
+    Expect(event.device == 0x10041 && event.timestampMs == 1234, "device handle and timestamp attached");
+
+    Expect(DecodeFixture(ABSOLUTE_MOUSE_MOVE, event) && event.type == InputEventType::MouseMove &&
+           event.x == 16384 && event.y == 32767 && event.device == 0x10045,
+           "absolute position scaled from 0..65535 to 15 bits");
+
+    Expect(DecodeFixture(MOUSE_WHEEL, event) && event.type == InputEventType::MouseWheel && event.y == -120 &&
+           event.x == 0, "wheel delta taken from buttonData");
+}
+
+static void TestRawKeyboard()
+{
+    if (!HasFixtureLayout())
+        return;
+
+    InputEvent event;
+    Expect(DecodeFixture(KEY_A_MAKE, event) && event.type == InputEventType::KeyDown && event.x == 'A' &&
+           event.y == 0x1E && event.device == 0x10043, "make code decoded as key down");
+    Expect(DecodeFixture(KEY_A_BREAK, event) && event.type == InputEventType::KeyUp && event.x == 'A' &&
+           event.y == 0x1E, "break flag decoded as key up");
+
+    // Right Ctrl shares VK_CONTROL and scan code 0x1D with left Ctrl; only the E0 prefix differs
+    Expect(DecodeFixture(RIGHT_CTRL_MAKE, event) && event.type == InputEventType::KeyDown && event.x == 0x11 &&
+           static_cast<uint16_t>(event.y) == 0xE01D, "E0 prefix kept in the scan code");
+    Expect(DecodeFixture(RIGHT_CTRL_BREAK, event) && event.type == InputEventType::KeyUp &&
+           static_cast<uint16_t>(event.y) == 0xE01D, "E0 prefix does not hide the break flag");
+}
+
+static void TestRawRejects()
+{
+    if (!HasFixtureLayout())
+        return;
+
+    InputEvent event;
+    Expect(!DecodeFixture(TRUNCATED_KEYBOARD, event), "dwSize shorter than the payload rejected");
+    Expect(!RawInputDecoder::Decode(KEY_A_MAKE, sizeof(KEY_A_MAKE) - 1, 0, event),
+           "buffer shorter than dwSize rejected");
+    Expect(!RawInputDecoder::Decode(RELATIVE_MOUSE_MOVE, sizeof(RawInputDecoder::Header) - 1, 0, event) &&
+           !RawInputDecoder::Decode(nullptr, 64, 0, event), "no header, no event");
+    Expect(!DecodeFixture(HID_GAMEPAD, event), "RIM_TYPEHID packets not tracked");
+}
+
+static void TestRawDispatch()
+{
+    if (!HasFixtureLayout())
+        return;
+
+    // Replayed packets attribute activity to the device that produced it
+    ActivityChannel channel;
+    channel.Reset(0);
+    InputDispatch dispatch(channel);
+
+    const unsigned char* packets[] = { RELATIVE_MOUSE_MOVE, MOUSE_WHEEL, KEY_A_MAKE, HID_GAMEPAD, KEY_A_BREAK,
+                                       ABSOLUTE_MOUSE_MOVE, RELATIVE_MOUSE_MOVE };
+    const size_t sizes[] = { sizeof(RELATIVE_MOUSE_MOVE), sizeof(MOUSE_WHEEL), sizeof(KEY_A_MAKE), sizeof(HID_GAMEPAD),
+                             sizeof(KEY_A_BREAK), sizeof(ABSOLUTE_MOUSE_MOVE), sizeof(RELATIVE_MOUSE_MOVE) };
+    uint64_t now = 1000;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+    {
+        InputEvent event;
+        now += ActivityChannel::QUANTUM_MS;
+        if (RawInputDecoder::Decode(packets[i], sizes[i], now, event))
+            dispatch.Dispatch(event);
+    }
+
+    Expect(channel.GetEventCount() == 6 && channel.GetLastActivity() == now, "every tracked packet is activity");
+    Expect(dispatch.GetDeviceCount() == 3 && dispatch.GetDeviceHandle(0) == 0x10041 && dispatch.GetDeviceEvents(0) == 3 &&
+           dispatch.GetDeviceHandle(1) == 0x10043 && dispatch.GetDeviceEvents(1) == 2 &&
+           dispatch.GetDeviceHandle(2) == 0x10045 && dispatch.GetDeviceEvents(2) == 1, "events attributed per device");
+}
+
+static void TestHookRecords()
+{
+    // The hook path reports the same events without a device
+    HookEventDecoder::MouseInfo mouse = {};
+    mouse.x = 640;
+    mouse.y = 480;
+    InputEvent event;
+    HookEventDecoder::DecodeMouse(HookEventDecoder::MESSAGE_MOUSEMOVE, mouse, 1234, event);
+    Expect(event.type == InputEventType::MouseMove && event.x == 640 && event.y == 480 && event.device == 0 &&
+           event.timestampMs == 1234, "mouse move carries the screen position");
+
+    mouse.mouseData = 0xFF880000;
+    HookEventDecoder::DecodeMouse(HookEventDecoder::MESSAGE_MOUSEWHEEL, mouse, 1234, event);
+    Expect(event.type == InputEventType::MouseWheel && event.y == -120, "wheel delta from the high word");
+    HookEventDecoder::DecodeMouse(0x0201, mouse, 1234, event);
+    Expect(event.type == InputEventType::MouseButton, "other mouse messages are buttons");
+
+    HookEventDecoder::KeyboardInfo keyboard = {};
+    keyboard.vkCode = 0x11;
+    keyboard.scanCode = 0x1D;
+    keyboard.flags = HookEventDecoder::KEY_EXTENDED;
+    HookEventDecoder::DecodeKeyboard(0x0100, keyboard, 1234, event);
+    Expect(event.type == InputEventType::KeyDown && event.x == 0x11 && static_cast<uint16_t>(event.y) == 0xE01D,
+           "extended key reported like the raw E0 prefix");
+    HookEventDecoder::DecodeKeyboard(HookEventDecoder::MESSAGE_SYSKEYUP, keyboard, 1234, event);
+    Expect(event.type == InputEventType::KeyUp, "system key up is a key up");
+}
+
+void RegisterRawInputTests(TestRunner& runner)
+{
+    runner.Add("rawinput.mouse", TestRawMouse);
+    runner.Add("rawinput.keyboard", TestRawKeyboard);
+    runner.Add("rawinput.rejects", TestRawRejects);
+    runner.Add("rawinput.dispatch", TestRawDispatch);
+    runner.Add("rawinput.hook_records", TestHookRecords);
+}
\ No newline at end of file
@@ -0,0 +1,514 @@
+#include "Test.h"
+#include "Clock.h"
+#include "FileSettingsStore.h"
+#include "MappedSettingsStore.h"
+#include "MemorySettingsStore.h"
+#include "SettingsModel.h"
+#include "SettingsReloader.h"
+#include "SettingsWatcher.h"
+#include "SettingsWriter.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Memory store that counts value writes and can refuse to open
+    class CountingStore : public MemorySettingsStore
+    {
+    public:
+        bool Open(bool forWrite) override { return !m_failing && MemorySettingsStore::Open(forWrite); }
+
+        uint32_t ReadValues(const char* const* names, uint32_t* values, uint32_t count) override
+        {
+            ++m_batchReads;
+            return MemorySettingsStore::ReadValues(names, values, count);
+        }
+
+        bool WriteUInt32(const char* name, uint32_t value) override
+        {
+            ++m_valueWrites;
+            return MemorySettingsStore::WriteUInt32(name, value);
+        }
+
+        void SetFailing(bool failing) { m_failing = failing; }
+        uint64_t GetValueWrites() const { return m_valueWrites; }
+        uint64_t GetBatchReads() const { return m_batchReads; }
+
+    private:
+        bool m_failing = false;
+        uint64_t m_valueWrites = 0;
+        uint64_t m_batchReads = 0;
+    };
+
+    // File store whose saves give up the CPU between values, so a reload lands inside one
+    class SlowWriteFileStore : public FileSettingsStore
+    {
+    public:
+        explicit SlowWriteFileStore(const std::string& path) : FileSettingsStore(path) {}
+
+        bool WriteUInt32(const char* name, uint32_t value) override
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            return FileSettingsStore::WriteUInt32(name, value);
+        }
+    };
+}
+
+static const uint32_t DEBOUNCE_MS = 500;
+
+static void TestWriterDebounce()
+{
+    CountingStore store;
+    ManualClock clock(1000);
+    SettingsWriter writer(store, clock, DEBOUNCE_MS);
+
+    AppSettings settings;
+    writer.SetPersisted(settings);
+
+    // A burst of checkbox clicks inside the debounce window becomes one write
+    for (int click = 0; click < 20; ++click)
+    {
+        settings.minimizeToTray = (click % 2) == 0;
+        settings.startHidden = true;
+        writer.Submit(settings);
+        clock.Advance(10);
+    }
+    Expect(writer.GetDirtyFields() == (SettingsModel::FIELD_MINIMIZE_TO_TRAY | SettingsModel::FIELD_START_HIDDEN),
+           "burst marks only the changed fields dirty");
+    Expect(!writer.Poll(clock.NowMs()) && store.GetValueWrites() == 0, "nothing written inside the window");
+
+    clock.Advance(DEBOUNCE_MS);
+    Expect(writer.Poll(clock.NowMs()) && writer.GetWrites() == 1, "one write once the window closed");
+    Expect(store.GetValueWrites() == 2 && writer.GetValuesWritten() == 2, "only the two changed values written");
+    Expect(writer.GetSubmits() == 20 && writer.GetDirtyFields() == 0, "20 submits, nothing left dirty");
+
+    // Toggling a value and back before the write leaves nothing to save
+    settings.timeoutSeconds = 42;
+    writer.Submit(settings);
+    settings.timeoutSeconds = DEFAULT_TIMEOUT_SECONDS;
+    writer.Submit(settings);
+    clock.Advance(DEBOUNCE_MS);
+    Expect(!writer.Poll(clock.NowMs()) && writer.GetWrites() == 1, "change reverted before the write is dropped");
+
+    // Continuous changes are still saved after the maximum delay
+    uint64_t start = clock.NowMs();
+    uint64_t writtenAt = 0;
+    for (uint32_t step = 1; step <= 100 && !writtenAt; ++step)
+    {
+        settings.timeoutSeconds = 100 + step;
+        writer.Submit(settings);
+        clock.Advance(DEBOUNCE_MS / 5);
+        if (writer.Poll(clock.NowMs()))
+            writtenAt = clock.NowMs();
+    }
+    Expect(writtenAt && writtenAt - start <= SettingsWriter::MAX_DELAY_MS + DEBOUNCE_MS / 5,
+           "steady changes written within the maximum delay");
+}
+
+static void TestWriterRetry()
+{
+    CountingStore store;
+    ManualClock clock(1000);
+    SettingsWriter writer(store, clock, DEBOUNCE_MS);
+
+    AppSettings settings;
+    writer.SetPersisted(settings);
+
+    // A failed write keeps its fields dirty and retries later
+    store.SetFailing(true);
+    settings.hotkeyVK = 'K';
+    writer.Submit(settings);
+    clock.Advance(DEBOUNCE_MS);
+    writer.Poll(clock.NowMs());
+    Expect(writer.GetFailures() == 1 && (writer.GetDirtyFields() & SettingsModel::FIELD_HOTKEY_VK),
+           "failed write counted, fields stay dirty");
+    store.SetFailing(false);
+    clock.Advance(DEBOUNCE_MS);
+    Expect(!writer.Poll(clock.NowMs()), "no retry before the maximum delay");
+    clock.Advance(SettingsWriter::MAX_DELAY_MS);
+    uint32_t storedVK = 0;
+    Expect(writer.Poll(clock.NowMs()) && store.ReadUInt32("HotkeyVK", storedVK) && storedVK == 'K',
+           "retry writes the value");
+
+    // Shutdown flush: a clean writer does not touch the store
+    uint64_t valueWrites = store.GetValueWrites();
+    Expect(writer.Flush() && store.GetValueWrites() == valueWrites, "flush with nothing dirty writes nothing");
+    settings.logLevel = 3;
+    writer.Submit(settings);
+    Expect(writer.Flush() && store.GetValueWrites() == valueWrites + 1, "flush writes a pending change at once");
+
+    // Round trip through the model
+    AppSettings loaded;
+    Expect(SettingsModel::Load(store, loaded) && SettingsModel::Diff(loaded, settings) == 0,
+           "store content loads back as the submitted settings");
+}
+
+static void TestWriterThread()
+{
+    // Background thread against the real clock
+    CountingStore store;
+    SystemClock clock;
+    SettingsWriter writer(store, clock, 20);
+    writer.SetPersisted(AppSettings());
+    writer.Start();
+    AppSettings changed;
+    changed.startMonitoring = true;
+    writer.Submit(changed);
+    for (int wait = 0; wait < 200 && writer.GetWrites() == 0; ++wait)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    writer.Stop();
+    Expect(writer.GetWrites() == 1 && store.GetValueWrites() == 1, "writer thread saves after the debounce");
+}
+
+static void TestSchema()
+{
+    // Every field survives a round trip with a non-default, in-range value
+    AppSettings settings;
+    for (const SettingField& field : SETTINGS_FIELDS)
+    {
+        field.Set(settings, field.defaultValue == field.maxValue ? field.minValue : field.maxValue);
+    }
+    CountingStore store;
+    AppSettings loaded;
+    SettingsLoadInfo info;
+    Expect(SettingsModel::Diff(settings, AppSettings()) == SettingsModel::FIELD_ALL, "every field changed from its default");
+    Expect(SettingsModel::Save(store, settings) && SettingsModel::Load(store, loaded, &info) &&
+           SettingsModel::Diff(loaded, settings) == 0, "all fields round-trip");
+    Expect(store.GetBatchReads() == 1 && store.GetValueWrites() == SETTINGS_FIELD_COUNT + 1,
+           "one batched read, one value per field plus the version");
+    Expect(info.version == SETTINGS_VERSION && !info.NeedsMigration(), "full save is current, nothing to migrate");
+
+    // Out-of-range values fall back to the row's default
+    store.WriteUInt32("Timeout", MAX_TIMEOUT_SECONDS + 1);
+    store.WriteUInt32("ActivityBackend", ACTIVITY_BACKEND_COUNT);
+    store.WriteUInt32("HotkeyModifiers", 0x4000);
+    Expect(SettingsModel::Load(store, loaded) && loaded.timeoutSeconds == DEFAULT_TIMEOUT_SECONDS &&
+           loaded.activityBackend == ACTIVITY_BACKEND_HOOKS &&
+           loaded.hotkeyModifiers == (HOTKEY_MOD_CONTROL | HOTKEY_MOD_SHIFT), "out-of-range values reset to defaults");
+}
+
+static void TestMigration()
+{
+    // An unversioned store from the first release: seven values, no version
+    MemorySettingsStore legacy;
+    legacy.WriteUInt32("Timeout", 120);
+    legacy.WriteUInt32("MinimizeToTray", 0);
+    legacy.WriteUInt32("StartHidden", 1);
+    legacy.WriteUInt32("StartMonitoring", 1);
+    legacy.WriteUInt32("StartWithWindows", 0);
+    legacy.WriteUInt32("HotkeyModifiers", HOTKEY_MOD_ALT);
+    legacy.WriteUInt32("HotkeyVK", 'P');
+    AppSettings loaded;
+    SettingsLoadInfo info;
+    Expect(SettingsModel::Load(legacy, loaded, &info) && loaded.timeoutSeconds == 120 && !loaded.minimizeToTray &&
+           loaded.startHidden && loaded.hotkeyModifiers == HOTKEY_MOD_ALT && loaded.hotkeyVK == 'P' &&
+           loaded.logLevel == DEFAULT_LOG_LEVEL, "unversioned store keeps its values, defaults the rest");
+    Expect(info.version == 0 && info.NeedsMigration() &&
+           info.upgradeFields == (SettingsModel::FIELD_ACTIVITY_BACKEND | SettingsModel::FIELD_LOG_LEVEL |
+                                  SettingsModel::FIELD_LOW_FOOTPRINT), "missing values marked for migration");
+    Expect(SettingsModel::Migrate(legacy, loaded, info) && legacy.GetValueCount() == SETTINGS_FIELD_COUNT + 1,
+           "migration adds the missing values and the version");
+    AppSettings migrated;
+    Expect(SettingsModel::Load(legacy, migrated, &info) && !info.NeedsMigration() &&
+           info.version == SETTINGS_VERSION && SettingsModel::Diff(migrated, loaded) == 0,
+           "migrated store loads the same, nothing left to do");
+
+    // A store written by a newer version is read but never rewritten
+    MemorySettingsStore newer;
+    newer.WriteUInt32(SettingsModel::VALUE_VERSION, SETTINGS_VERSION + 1);
+    newer.WriteUInt32("Timeout", 30);
+    Expect(SettingsModel::Load(newer, loaded, &info) && loaded.timeoutSeconds == 30 && !info.NeedsMigration() &&
+           SettingsModel::Migrate(newer, loaded, info) && newer.GetValueCount() == 2,
+           "newer store loads and is left alone");
+}
+
+static void TestFileStore()
+{
+    std::string iniPath = GetTestDirectory() + "/" + MakeTestName("mma-settings") + ".ini";
+    remove(iniPath.c_str());
+
+    AppSettings settings;
+    settings.timeoutSeconds = 77;
+    settings.hotkeyVK = 'Q';
+    settings.lowFootprint = true;
+
+    // INI file: full save, partial save, and comments from a hand edit
+    FileSettingsStore file(iniPath);
+    AppSettings loaded;
+    Expect(!SettingsModel::Load(file, loaded), "missing file does not load");
+    Expect(SettingsModel::Save(file, settings) && SettingsModel::Load(file, loaded) &&
+           SettingsModel::Diff(loaded, settings) == 0, "file round trip");
+
+    settings.startHidden = true;
+    Expect(SettingsModel::SaveFields(file, settings, SettingsModel::FIELD_START_HIDDEN) &&
+           SettingsModel::Load(file, loaded) && SettingsModel::Diff(loaded, settings) == 0,
+           "partial save keeps the other values");
+
+    FILE* temp = fopen((iniPath + ".tmp").c_str(), "rb");
+    Expect(temp == nullptr, "no temporary file left behind");
+    if (temp)
+        fclose(temp);
+
+    static const char HAND_EDITED[] = "; edited by hand\n[MMA]\n  Timeout = 032 \r\nbogus\n# HotkeyVK=1\n";
+    FileSettingsStore::WriteFileAtomic(iniPath, HAND_EDITED, sizeof(HAND_EDITED) - 1);
+    Expect(SettingsModel::Load(file, loaded) && loaded.timeoutSeconds == 32 && loaded.hotkeyVK == 'M',
+           "hand-edited file parses, comments skipped");
+
+    remove(iniPath.c_str());
+}
+
+static void TestFileStoreValues()
+{
+    std::string iniPath = GetTestDirectory() + "/" + MakeTestName("mma-settings-values") + ".ini";
+
+    // Values are decimal and must be nothing but digits; anything else is ignored
+    static const char VALUES[] =
+        "[MMA]\n"
+        "Leading=060\n"
+        "Spaced =  7\t\n"
+        "Largest=4294967295\n"
+        "Unit=60s\n"
+        "Hex=0x20\n"
+        "Negative=-1\n"
+        "Plus=+5\n"
+        "Overflow=4294967296\n"
+        "Empty=\n"
+        "Inner=1 2\n"
+        "Repeated=5\n"
+        "Repeated=5x\n";
+    FileSettingsStore::WriteFileAtomic(iniPath, VALUES, sizeof(VALUES) - 1);
+
+    FileSettingsStore file(iniPath);
+    uint32_t leading = 0, spaced = 0, largest = 0, repeated = 0, value = 0;
+    if (!Expect(file.Open(false), "value file opens"))
+        return;
+    Expect(file.ReadUInt32("Leading", leading) && leading == 60, "leading zero is decimal, not octal");
+    Expect(file.ReadUInt32("Spaced", spaced) && spaced == 7, "blanks around the value allowed");
+    Expect(file.ReadUInt32("Largest", largest) && largest == UINT32_MAX, "UINT32_MAX accepted");
+    Expect(!file.ReadUInt32("Unit", value) && !file.ReadUInt32("Hex", value) && !file.ReadUInt32("Inner", value),
+           "trailing text rejected");
+    Expect(!file.ReadUInt32("Negative", value) && !file.ReadUInt32("Plus", value) &&
+           !file.ReadUInt32("Overflow", value) && !file.ReadUInt32("Empty", value),
+           "signs, overflow and empty values rejected");
+    Expect(file.ReadUInt32("Repeated", repeated) && repeated == 5, "malformed repeat keeps the earlier value");
+    file.Close();
+
+    remove(iniPath.c_str());
+}
+
+static void TestSnapshotStore()
+{
+    std::string base = GetTestDirectory() + "/" + MakeTestName("mma-settings");
+    std::string iniPath = base + ".ini";
+    std::string snapshotPath = base + ".snapshot";
+
+    AppSettings settings;
+    settings.timeoutSeconds = 77;
+    settings.startHidden = true;
+
+    // Snapshot: compiled from the settings, loads identically, refuses writes
+    MappedSettingsStore snapshot(snapshotPath);
+    AppSettings loaded;
+    Expect(MappedSettingsStore::WriteSnapshot(snapshotPath, settings) &&
+           SettingsModel::Load(snapshot, loaded) && SettingsModel::Diff(loaded, settings) == 0,
+           "snapshot round trip");
+    Expect(snapshot.IsReadOnly() && !SettingsModel::Save(snapshot, settings), "snapshot rejects saves");
+
+    FileSettingsStore file(iniPath);
+    SettingsModel::Save(file, settings);
+    MappedSettingsStore notSnapshot(iniPath);
+    Expect(!notSnapshot.Open(false), "INI file is not taken for a snapshot");
+
+    remove(iniPath.c_str());
+    remove(snapshotPath.c_str());
+}
+
+static void TestReloadMerge()
+{
+    // Merge: external changes land, an unsaved local edit wins over the store
+    CountingStore store;
+    ManualClock clock(1000);
+    SettingsWriter writer(store, clock, DEBOUNCE_MS);
+    AppSettings settings;
+    SettingsModel::Save(store, settings);
+    writer.SetPersisted(settings);
+    SettingsReloader reloader(store, &writer);
+
+    settings.startHidden = true;
+    writer.Submit(settings);
+    Expect(reloader.Reload(settings) == 0 && settings.startHidden, "reload without external change applies nothing");
+
+    store.WriteUInt32("Timeout", 90);
+    store.WriteUInt32("StartHidden", 0);
+    store.WriteUInt32("StartWithWindows", 1);
+    uint32_t changed = reloader.Reload(settings, SettingsModel::FIELD_START_WITH_WINDOWS);
+    Expect(changed == SettingsModel::FIELD_TIMEOUT && settings.timeoutSeconds == 90,
+           "external change applied, only its field reported");
+    Expect(settings.startHidden && !settings.startWithWindows &&
+           writer.GetDirtyFields() == SettingsModel::FIELD_START_HIDDEN,
+           "unsaved edit and ignored field keep their value");
+    clock.Advance(DEBOUNCE_MS);
+    uint32_t storedHidden = 0;
+    uint32_t storedTimeout = 0;
+    Expect(writer.Poll(clock.NowMs()) && store.ReadUInt32("StartHidden", storedHidden) && storedHidden == 1 &&
+           store.ReadUInt32("Timeout", storedTimeout) && storedTimeout == 90,
+           "pending edit written over the store, reload kept");
+
+    // A recompiled snapshot replaces the file; the old mapping must not be served again
+    std::string snapshotPath = GetTestDirectory() + "/" + MakeTestName("mma-reload") + ".snapshot";
+    AppSettings compiled;
+    MappedSettingsStore snapshot(snapshotPath);
+    AppSettings provisioned;
+    MappedSettingsStore::WriteSnapshot(snapshotPath, compiled);
+    SettingsReloader snapshotReloader(snapshot);
+    SettingsModel::Load(snapshot, provisioned);
+    compiled.timeoutSeconds = 600;
+    MappedSettingsStore::WriteSnapshot(snapshotPath, compiled);
+    Expect(snapshotReloader.Reload(provisioned) == SettingsModel::FIELD_TIMEOUT &&
+           provisioned.timeoutSeconds == 600, "recompiled snapshot reloaded");
+    remove(snapshotPath.c_str());
+}
+
+static void TestReloadWatchedFile()
+{
+    // Live: another process rewrites the INI file while it is watched
+    static const int REWRITES = 20;
+    std::string iniPath = GetTestDirectory() + "/" + MakeTestName("mma-reload") + ".ini";
+    FileSettingsStore external(iniPath);
+    FileSettingsStore watched(iniPath);
+    AppSettings written;
+    if (!Expect(SettingsModel::Save(external, written), "reload test file written"))
+        return;
+
+    AppSettings live;
+    SettingsReloader fileReloader(watched);
+    std::mutex mutex;
+    std::condition_variable reloaded;
+    uint64_t reloads = 0;
+    uint32_t hotkeyRegistrations = 0;
+    uint32_t registrationsAvoided = 0;
+    std::chrono::steady_clock::time_point reloadedAt;
+
+    SettingsWatcher watcher;
+    const uint32_t hotkeyFields = SettingsModel::FIELD_HOTKEY_MODIFIERS | SettingsModel::FIELD_HOTKEY_VK;
+    bool watching = watcher.WatchFile(iniPath, [&]()
+    {
+        // What ApplicationManager does: each field's owner only hears about its own change
+        uint32_t fields = fileReloader.Reload(live);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (fields & hotkeyFields)
+            ++hotkeyRegistrations;
+        else if (fields)
+            ++registrationsAvoided;
+        reloadedAt = std::chrono::steady_clock::now();
+        ++reloads;
+        reloaded.notify_all();
+    });
+    Expect(watching, "settings file watched");
+
+    std::vector<uint64_t> latenciesUs;
+    for (int i = 0; watching && i < REWRITES + 1; ++i)
+    {
+        // The last rewrite changes the hotkey instead
+        if (i < REWRITES)
+            written.timeoutSeconds = 100 + i;
+        else
+            written.hotkeyVK = 'J';
+
+        std::unique_lock<std::mutex> lock(mutex);
+        uint64_t expected = reloads + 1;
+        lock.unlock();
+        auto start = std::chrono::steady_clock::now();
+        SettingsModel::SaveFields(external, written, i < REWRITES ? SettingsModel::FIELD_TIMEOUT : SettingsModel::FIELD_HOTKEY_VK);
+        lock.lock();
+        if (!reloaded.wait_for(lock, std::chrono::seconds(2), [&]() { return reloads >= expected; }))
+            break;
+        latenciesUs.push_back(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::microseconds>(reloadedAt - start).count()));
+    }
+    watcher.Stop();
+
+    Expect(latenciesUs.size() == REWRITES + 1 && SettingsModel::Diff(live, written) == 0,
+           "every rewrite reloaded, live settings match the file");
+    Expect(registrationsAvoided == REWRITES && hotkeyRegistrations == 1, "hotkey re-registered only when it changed");
+    Expect(watcher.GetChanges() == fileReloader.GetReloads() && fileReloader.GetUnchangedReloads() == 0,
+           "one reload per rewrite, none spurious");
+
+    if (!latenciesUs.empty())
+    {
+        std::sort(latenciesUs.begin(), latenciesUs.end());
+        printf("  reload latency: p50 %.1f ms, max %.1f ms over %zu rewrites (%u ms settle), "
+               "%u hotkey re-registrations avoided\n",
+               latenciesUs[latenciesUs.size() / 2] / 1000.0, latenciesUs.back() / 1000.0, latenciesUs.size(),
+               SettingsWatcher::SETTLE_MS, registrationsAvoided);
+    }
+
+    remove(iniPath.c_str());
+}
+
+static void TestReloadDuringSaves()
+{
+    // The writer thread saves to the same file store the reloader reads; with no
+    // external writer, no reload may report a change or lose a pending edit
+    static const int ROUNDS = 500;
+    std::string iniPath = GetTestDirectory() + "/" + MakeTestName("mma-reload-saves") + ".ini";
+    SlowWriteFileStore store(iniPath);
+    AppSettings settings;
+    if (!Expect(SettingsModel::Save(store, settings), "settings file written"))
+        return;
+
+    SystemClock clock;
+    SettingsWriter writer(store, clock, 1);
+    writer.SetPersisted(settings);
+    writer.Start();
+    SettingsReloader reloader(store, &writer);
+
+    uint32_t reportedFields = 0;
+    int lostEdits = 0;
+    for (int round = 0; round < ROUNDS; ++round)
+    {
+        settings.timeoutSeconds = 100 + round;
+        settings.startHidden = (round & 1) != 0;
+        writer.Submit(settings);
+        if ((round & 7) == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        reportedFields |= reloader.Reload(settings);
+        if (settings.timeoutSeconds != static_cast<uint32_t>(100 + round))
+            ++lostEdits;
+    }
+    writer.Stop();
+
+    AppSettings stored;
+    printf("  %llu saves during %d reloads\n", static_cast<unsigned long long>(writer.GetWrites()), ROUNDS);
+    Expect(reloader.GetReloads() == ROUNDS, "every reload read the file");
+    Expect(writer.GetWrites() > 0 && writer.GetFailures() == 0, "no save failed while reloads ran");
+    Expect(reportedFields == 0 && lostEdits == 0, "own saves never look like an external change");
+    Expect(writer.Flush() && SettingsModel::Load(store, stored) && SettingsModel::Diff(stored, settings) == 0,
+           "file holds the last edit");
+
+    remove(iniPath.c_str());
+}
+
+void RegisterSettingsTests(TestRunner& runner)
+{
+    runner.Add("settings.writer_debounce", TestWriterDebounce);
+    runner.Add("settings.writer_retry_and_flush", TestWriterRetry);
+    runner.Add("settings.writer_thread", TestWriterThread);
+    runner.Add("settings.schema", TestSchema);
+    runner.Add("settings.migration", TestMigration);
+    runner.Add("settings.file_store", TestFileStore);
+    runner.Add("settings.file_store_values", TestFileStoreValues);
+    runner.Add("settings.snapshot_store", TestSnapshotStore);
+    runner.Add("settings.reload_merge", TestReloadMerge);
+    runner.Add("settings.reload_watched_file", TestReloadWatchedFile);
+    runner.Add("settings.reload_during_saves", TestReloadDuringSaves);
+}
\ No newline at end of file
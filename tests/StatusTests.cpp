@@ -0,0 +1,189 @@
+#include "Test.h"
+#include "SharedStatusSegment.h"
+#include "StatusPage.h"
+#include "StatusPublisher.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+// Long enough for a few million reads against a writer on another core
+static const int STRESS_MS = 1000;
+
+/**
+ * Snapshot whose every field derives from one generation number, so a
+ * reader can tell a torn copy from a consistent one
+ */
+static StatusSnapshot MakeStressSnapshot(uint64_t generation)
+{
+    uint64_t values[StatusPage::FIELD_COUNT];
+    for (size_t i = 0; i < StatusPage::FIELD_COUNT; ++i)
+    {
+        values[i] = generation * (i + 1) + i;
+    }
+
+    StatusSnapshot snapshot;
+    memcpy(&snapshot, values, sizeof(values));
+    return snapshot;
+}
+
+static bool IsStressSnapshotConsistent(const StatusSnapshot& snapshot, uint64_t& generation)
+{
+    uint64_t values[StatusPage::FIELD_COUNT];
+    memcpy(values, &snapshot, sizeof(values));
+
+    generation = values[0];
+    for (size_t i = 1; i < StatusPage::FIELD_COUNT; ++i)
+    {
+        if (values[i] != generation * (i + 1) + i)
+            return false;
+    }
+    return true;
+}
+
+static void TestRoundTrip()
+{
+    std::string name = MakeTestName("mma-test-status");
+    SharedStatusSegment writerSegment;
+    SharedStatusSegment readerSegment;
+    if (!Expect(writerSegment.Create(name.c_str()) && readerSegment.Open(name.c_str()), "segment created and mapped twice"))
+        return;
+
+    StatusSnapshot snapshot;
+    StatusPage::Write(*writerSegment.GetPage(), MakeStressSnapshot(7));
+    uint64_t generation = 0;
+    Expect(StatusPage::Read(*readerSegment.GetPage(), snapshot) && IsStressSnapshotConsistent(snapshot, generation) &&
+           generation == 7, "second mapping reads what the first wrote");
+}
+
+static void TestSeqlockStress()
+{
+    // A writer thread publishes into a private segment as fast as it can while
+    // this thread reads it back through a second mapping
+    std::string name = MakeTestName("mma-test-status-stress");
+    SharedStatusSegment writerSegment;
+    SharedStatusSegment readerSegment;
+    if (!Expect(writerSegment.Create(name.c_str()) && readerSegment.Open(name.c_str()), "stress segment created"))
+        return;
+
+    // A freshly initialized page is all zeros, which is no generation: publish once first
+    StatusPage::Write(*writerSegment.GetPage(), MakeStressSnapshot(0));
+
+    std::atomic<bool> stop{ false };
+    std::atomic<uint64_t> written{ 0 };
+    std::thread writer([&]()
+    {
+        uint64_t generation = 0;
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            StatusPage::Write(*writerSegment.GetPage(), MakeStressSnapshot(++generation));
+
+            // Single core machines only interleave when the writer gives way now and then
+            if ((generation & 1023) == 0)
+                std::this_thread::yield();
+        }
+        written.store(generation, std::memory_order_relaxed);
+    });
+
+    uint64_t reads = 0, retries = 0, torn = 0, backwards = 0, lastGeneration = 0;
+    auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(STRESS_MS);
+
+    while (std::chrono::steady_clock::now() < end)
+    {
+        for (int i = 0; i < 1024; ++i)
+        {
+            StatusSnapshot snapshot;
+            if (!StatusPage::Read(*readerSegment.GetPage(), snapshot, 1))
+            {
+                ++retries;
+                continue;
+            }
+
+            uint64_t generation;
+            if (!IsStressSnapshotConsistent(snapshot, generation))
+                ++torn;
+            else if (generation < lastGeneration)
+                ++backwards;
+            else
+                lastGeneration = generation;
+            ++reads;
+        }
+    }
+
+    stop.store(true, std::memory_order_relaxed);
+    writer.join();
+
+    printf("  %llu writes, %llu reads, %llu retried\n", static_cast<unsigned long long>(written.load()),
+           static_cast<unsigned long long>(reads), static_cast<unsigned long long>(retries));
+    Expect(reads > 0, "reads completed while the writer ran");
+    Expect(torn == 0, "no torn snapshot");
+    Expect(backwards == 0, "generations never go backwards");
+}
+
+static void TestSingleWriter()
+{
+    std::string name = MakeTestName("mma-test-status-writer");
+    StatusPublisher publisher;
+    if (!Expect(publisher.Open(name.c_str()), "first writer creates the page"))
+        return;
+
+    StatusSnapshot::State state = {};
+    state.monitoring = 1;
+    state.timeoutSeconds = 42;
+    publisher.PublishState(state);
+
+    // A second writer must neither succeed nor reset the live page
+    SharedStatusSegment intruder;
+    SharedStatusSegment reader;
+    StatusSnapshot snapshot;
+    Expect(!intruder.Create(name.c_str()), "second writer refused while the first runs");
+    Expect(reader.Open(name.c_str()) && StatusPage::Read(*reader.GetPage(), snapshot) &&
+           snapshot.state.timeoutSeconds == 42 && snapshot.publishCount == publisher.GetSnapshot().publishCount,
+           "live page left untouched");
+    reader.Close();
+
+    publisher.Close();
+    Expect(intruder.Create(name.c_str()), "name free again once the writer closed");
+}
+
+static void TestInputAnalyticsFlag()
+{
+    std::string name = MakeTestName("mma-test-status-analytics");
+    StatusPublisher publisher;
+    SharedStatusSegment reader;
+    if (!Expect(publisher.Open(name.c_str()) && reader.Open(name.c_str()), "page created and mapped"))
+        return;
+
+    StatusSnapshot snapshot;
+    Expect(StatusPage::Read(*reader.GetPage(), snapshot) && snapshot.inputAnalyticsOff == 0, "analytics on by default");
+
+    publisher.PublishInputAnalytics(false);
+    Expect(StatusPage::Read(*reader.GetPage(), snapshot) && snapshot.inputAnalyticsOff == 1 &&
+           reader.GetPage()->version == StatusPage::VERSION, "low-footprint page says analytics are off");
+
+    // A version 1 writer publishes one field less; its readers see analytics on
+    std::string oldName = MakeTestName("mma-test-status-v1");
+    SharedStatusSegment oldWriter;
+    SharedStatusSegment oldReader;
+    if (!Expect(oldWriter.Create(oldName.c_str()) && oldReader.Open(oldName.c_str()), "version 1 page mapped"))
+        return;
+
+    StatusPage& page = *oldWriter.GetPage();
+    page.version = 1;
+    page.fieldCount = static_cast<uint32_t>(StatusPage::FIELD_COUNT - 1);
+    StatusSnapshot written = {};
+    written.inputAnalyticsOff = 1;
+    StatusPage::Write(page, written);
+    Expect(StatusPage::Read(*oldReader.GetPage(), snapshot) && snapshot.inputAnalyticsOff == 0,
+           "version 1 page reads as analytics on");
+}
+
+void RegisterStatusTests(TestRunner& runner)
+{
+    runner.Add("status.round_trip", TestRoundTrip);
+    runner.Add("status.seqlock_stress", TestSeqlockStress);
+    runner.Add("status.single_writer", TestSingleWriter);
+    runner.Add("status.input_analytics_flag", TestInputAnalyticsFlag);
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include "Test.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+// Failed checks in the running test
+static int s_failures = 0;
+
+void TestRunner::Add(const std::string& name, std::function<void()> body)
+{
+    TestCase test;
+    test.name = name;
+    test.body = body;
+    m_tests.push_back(test);
+}
+
+int TestRunner::Run(const std::string& filter)
+{
+    int run = 0;
+    int failed = 0;
+
+    for (const TestCase& test : m_tests)
+    {
+        if (!filter.empty() && test.name.find(filter) == std::string::npos)
+            continue;
+
+        printf("%s\n", test.name.c_str());
+        fflush(stdout);
+
+        s_failures = 0;
+        auto start = std::chrono::steady_clock::now();
+        test.body();
+        long long elapsedMs = static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count());
+
+        ++run;
+        if (s_failures)
+            ++failed;
+        printf("%s %s (%lld ms)\n\n", test.name.c_str(), s_failures ? "FAILED" : "passed", elapsedMs);
+        fflush(stdout);
+    }
+
+    printf("%d tests, %d failed\n", run, failed);
+    return run ? failed : 1;
+}
+
+void TestRunner::List(const std::string& filter) const
+{
+    for (const TestCase& test : m_tests)
+    {
+        if (filter.empty() || test.name.find(filter) != std::string::npos)
+            printf("%s\n", test.name.c_str());
+    }
+}
+
+bool Expect(bool condition, const char* what)
+{
+    printf("  %-58s %s\n", what, condition ? "ok" : "FAILED");
+    if (!condition)
+        ++s_failures;
+    return condition;
+}
+
+std::string GetTestDirectory()
+{
+    const char* directory = getenv("MMA_TEST_DIR");
+    return directory && directory[0] ? directory : ".";
+}
+
+std::string MakeTestName(const char* prefix)
+{
+    return std::string(prefix) + "-" + std::to_string(static_cast<long>(getpid()));
+}
\ No newline at end of file
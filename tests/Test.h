@@ -0,0 +1,52 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * One test case
+ * body reports every check through Expect; the test fails when any check
+ * failed. Names are GROUP.CASE, and CTest runs each group as one entry
+ */
+struct TestCase
+{
+    std::string name;
+    std::function<void()> body;
+};
+
+class TestRunner
+{
+public:
+    void Add(const std::string& name, std::function<void()> body);
+
+    // Runs the tests whose name contains filter, in registration order; returns how many failed
+    int Run(const std::string& filter);
+    void List(const std::string& filter) const;
+
+private:
+    // Member variables
+    std::vector<TestCase> m_tests;
+};
+
+// One check of the running test, printed as it runs; returns condition so a test can stop early
+bool Expect(bool condition, const char* what);
+
+// Files a test creates go here: $MMA_TEST_DIR, else the working directory (CTest: the build tree)
+std::string GetTestDirectory();
+
+// Name unique to this process, for endpoints, shared memory and scratch files
+std::string MakeTestName(const char* prefix);
+
+// Test groups
+void RegisterControlTests(TestRunner& runner);
+void RegisterCoreTests(TestRunner& runner);
+void RegisterInputTests(TestRunner& runner);
+void RegisterLinuxTests(TestRunner& runner);
+void RegisterLoggerTests(TestRunner& runner);
+void RegisterMetricsTests(TestRunner& runner);
+void RegisterRawInputTests(TestRunner& runner);
+void RegisterSettingsTests(TestRunner& runner);
+void RegisterStatusTests(TestRunner& runner);
+void RegisterX11Tests(TestRunner& runner);
+void RegisterAllocationAuditTests(TestRunner& runner);
\ No newline at end of file
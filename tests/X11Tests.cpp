@@ -0,0 +1,161 @@
+#include "Test.h"
+
+#ifdef MMA_TEST_X11
+
+#include "MonotonicClock.h"
+#include <X11/Xlib.h>
+#include <X11/extensions/XTest.h>
+#include <chrono>
+#include <thread>
+
+#ifdef MMA_TEST_X11_IDLE
+#include "XScreenSaverIdleSource.h"
+#endif
+
+#ifdef MMA_TEST_X11_INPUT
+#include "ActivityChannel.h"
+#include "InputDispatch.h"
+#include "InputThread.h"
+#include "X11InputSource.h"
+#include <X11/keysym.h>
+#endif
+
+// Connection for injecting input; nullptr when $DISPLAY or XTest is missing
+static Display* OpenInjector()
+{
+    Display* display = XOpenDisplay(nullptr);
+    int eventBase, errorBase, major, minor;
+    if (display && !XTestQueryExtension(display, &eventBase, &errorBase, &major, &minor))
+    {
+        XCloseDisplay(display);
+        return nullptr;
+    }
+    return display;
+}
+
+#ifdef MMA_TEST_X11_IDLE
+static void TestIdleClock()
+{
+    // The server's idle time grows while nothing happens and restarts when
+    // XTest injects a move, just as it does for a real mouse
+    Display* injector = OpenInjector();
+    XScreenSaverIdleSource source;
+    if (!Expect(injector && source.Open(), "display with XTest and MIT-SCREEN-SAVER opened"))
+    {
+        if (injector)
+            XCloseDisplay(injector);
+        return;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    uint64_t before = 0;
+    Expect(source.QueryLastInputTime(before) && MonotonicNowMs() >= before + 250, "idle time grows without input");
+
+    uint64_t injectedAt = MonotonicNowMs();
+    XTestFakeRelativeMotionEvent(injector, 1, 0, CurrentTime);
+    XTestFakeRelativeMotionEvent(injector, -1, 0, CurrentTime);
+    XSync(injector, False);
+
+    uint64_t after = 0;
+    Expect(source.QueryLastInputTime(after) && after > before && after + 50 >= injectedAt,
+           "injected input resets the idle time");
+
+    source.Close();
+    XCloseDisplay(injector);
+}
+#endif
+
+#ifdef MMA_TEST_X11_INPUT
+// Waits until the channel counted at least events events
+static bool WaitForEvents(const ActivityChannel& channel, uint64_t events, int timeoutMs)
+{
+    uint64_t deadline = MonotonicNowMs() + static_cast<uint64_t>(timeoutMs);
+    while (channel.GetEventCount() < events)
+    {
+        if (MonotonicNowMs() >= deadline)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// Waits until the server reports the pointer at x, y
+static bool WaitForPointer(Display* display, int x, int y, int timeoutMs)
+{
+    uint64_t deadline = MonotonicNowMs() + static_cast<uint64_t>(timeoutMs);
+    for (;;)
+    {
+        Window root, child;
+        int rootX = -1, rootY = -1, windowX, windowY;
+        unsigned int buttons;
+        XQueryPointer(display, DefaultRootWindow(display), &root, &child, &rootX, &rootY, &windowX, &windowY, &buttons);
+        if (rootX == x && rootY == y)
+            return true;
+        if (MonotonicNowMs() >= deadline)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+static void TestInputAndCursor()
+{
+    // The whole backend on the input thread: XTest input from another client
+    // reaches the channel as XI2 raw events, and MoveTo from this thread moves
+    // the server's pointer through the source's own connection
+    Display* injector = OpenInjector();
+    if (!Expect(injector != nullptr, "display with XTest opened"))
+        return;
+
+    ActivityChannel channel;
+    channel.Reset(0);
+    InputDispatch dispatch(channel);
+    X11InputSource source;
+    InputThread thread;
+    if (!Expect(thread.Start(&source, &dispatch), "XI 2.2 raw events selected on the input thread"))
+    {
+        XCloseDisplay(injector);
+        return;
+    }
+
+    XTestFakeRelativeMotionEvent(injector, 5, 0, CurrentTime);
+    KeyCode shift = XKeysymToKeycode(injector, XK_Shift_L);
+    XTestFakeKeyEvent(injector, shift, True, CurrentTime);
+    XTestFakeKeyEvent(injector, shift, False, CurrentTime);
+    XSync(injector, False);
+    Expect(WaitForEvents(channel, 3, 1000), "injected move and key reach the channel");
+    Expect(dispatch.GetDeviceCount() >= 1 && dispatch.GetDeviceHandle(0) != 0, "events attributed to the XTest device");
+
+    ICursorDriver& cursor = source;
+    int left, top, width, height;
+    Expect(cursor.GetBounds(left, top, width, height) && left == 0 && top == 0 && width == 1280 && height == 1024,
+           "bounds span the Xvfb root window");
+
+    uint64_t events = channel.GetEventCount();
+    Expect(cursor.MoveTo(321, 234) && WaitForPointer(injector, 321, 234, 1000), "MoveTo moves the server's pointer");
+    Expect(cursor.MoveTo(width - 1, height - 1) && WaitForPointer(injector, width - 1, height - 1, 1000),
+           "MoveTo reaches the far corner");
+    Expect(WaitForEvents(channel, events + 1, 1000), "the source sees its own moves as raw motion");
+
+    thread.Stop();
+    Expect(!cursor.MoveTo(0, 0), "no moves once the source closed");
+    XCloseDisplay(injector);
+}
+#endif
+
+void RegisterX11Tests(TestRunner& runner)
+{
+#ifdef MMA_TEST_X11_IDLE
+    runner.Add("x11.idle_clock", TestIdleClock);
+#endif
+#ifdef MMA_TEST_X11_INPUT
+    runner.Add("x11.input_and_cursor", TestInputAndCursor);
+#endif
+}
+
+#else
+
+void RegisterX11Tests(TestRunner&)
+{
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,57 @@
+// main.cpp : Test entry point
+//
+// Usage: mma_tests [--filter TEXT] [--list]
+//
+// Runs the tests whose name contains TEXT (all by default) and prints every
+// check. Exit status 1 when a test failed or nothing matched the filter.
+// CTest runs one group per entry (--filter GROUP.); MMA_TEST_DIR names the
+// directory for scratch files.
+
+#include "Test.h"
+#include <cstdio>
+#include <cstring>
+
+static void PrintUsage()
+{
+    fprintf(stderr, "usage: mma_tests [--filter TEXT] [--list]\n");
+}
+
+int main(int argc, char* argv[])
+{
+    const char* filter = "";
+    bool list = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else if (strcmp(argv[i], "--list") == 0)
+            list = true;
+        else
+        {
+            PrintUsage();
+            return 2;
+        }
+    }
+
+    TestRunner runner;
+    RegisterCoreTests(runner);
+    RegisterInputTests(runner);
+    RegisterRawInputTests(runner);
+    RegisterLoggerTests(runner);
+    RegisterSettingsTests(runner);
+    RegisterControlTests(runner);
+    RegisterMetricsTests(runner);
+    RegisterStatusTests(runner);
+    RegisterLinuxTests(runner);
+    RegisterX11Tests(runner);
+    RegisterAllocationAuditTests(runner);
+
+    if (list)
+    {
+        runner.List(filter);
+        return 0;
+    }
+
+    return runner.Run(filter) ? 1 : 0;
+}
\ No newline at end of file
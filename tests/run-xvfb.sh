@@ -0,0 +1,27 @@
+#!/bin/sh
+# run-xvfb.sh : Runs a test command against a private Xvfb
+#
+# Usage: run-xvfb.sh XVFB COMMAND [ARGS...]
+#
+# CTest runs the x11 test group through this script; the command sees
+# DISPLAY pointing at a fresh server and the server stops when it exits.
+
+set -eu
+
+XVFB=${1:?usage: run-xvfb.sh XVFB COMMAND [ARGS...]}
+shift
+
+# -displayfd picks a free display number and reports it once the server is ready
+DISPLAY_FILE=$(mktemp)
+"$XVFB" -displayfd 3 -screen 0 1280x1024x24 -nolisten tcp 3>"$DISPLAY_FILE" &
+XVFB_PID=$!
+trap 'kill $XVFB_PID 2>/dev/null; rm -f "$DISPLAY_FILE"' EXIT
+
+for _ in $(seq 50); do
+    [ -s "$DISPLAY_FILE" ] && break
+    sleep 0.1
+done
+DISPLAY=:$(cat "$DISPLAY_FILE")
+export DISPLAY
+
+"$@"
\ No newline at end of file
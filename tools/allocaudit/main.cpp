@@ -0,0 +1,325 @@
+// main.cpp : Steady-state allocation audit
+//
+// Usage: mma_allocaudit [--events N]
+//
+// Needs a build with MMA_ALLOC_AUDIT (cmake -DMMA_ALLOC_AUDIT=ON). Drives
+// the core headless the way a monitoring session does, with the audit
+// armed: an input thread dispatches N synthetic hook events (default
+// 5,000,000) through InputDispatch, the drain thread feeds the analytics
+// consumers and publishes the status page, and this thread runs the
+// CheckActivity deadline path (watchdog, idle engine, status page) on a
+// manual clock, dropped-hook incidents included. A seat daemon then reads
+// N evdev records from a pipe and expires its deadline twice. Exit status
+// 1 when any of it allocated. That the audit catches an allocation at all
+// is tested in mma_tests (audit group).
+
+#include "ActivityChannel.h"
+#include "AllocationAudit.h"
+#include "Clock.h"
+#include "DeadlineTimer.h"
+#include "EventDrainThread.h"
+#include "HeadlessCursorDriver.h"
+#include "HookWatchdog.h"
+#include "IdleEngine.h"
+#include "IdlePeriodStatistics.h"
+#include "InputDispatch.h"
+#include "InputEventRing.h"
+#include "InputStatistics.h"
+#include "LatencyHistogram.h"
+#include "Logger.h"
+#include "ManualIdleSource.h"
+#include "MonotonicClock.h"
+#include "SeatDaemon.h"
+#include "StatusPublisher.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+
+#ifndef MMA_ALLOC_AUDIT
+#error "mma_allocaudit needs a build with MMA_ALLOC_AUDIT"
+#endif
+
+static const uint64_t DEFAULT_EVENTS = 5000000;
+
+// Deliberate allocations are stored here so the compiler cannot elide them
+static void* volatile g_keep = nullptr;
+
+class NullDeadlineTimer : public IDeadlineTimer
+{
+public:
+    bool Arm(uint64_t) override { return true; }
+    void Disarm() override {}
+};
+
+class NullLogSink : public ILogSink
+{
+public:
+    bool Write(const char*, size_t) override { return true; }
+};
+
+static bool Expect(bool condition, const char* what)
+{
+    printf("%-56s %s\n", what, condition ? "ok" : "FAILED");
+    return condition;
+}
+
+static void PrintSites()
+{
+    AllocationAudit::Site sites[AllocationAudit::MAX_SITES];
+    size_t count = AllocationAudit::GetSites(sites, AllocationAudit::MAX_SITES);
+    for (size_t i = 0; i < count; ++i)
+    {
+        // The audit is disarmed here, so demangling may allocate
+        Dl_info info;
+        const char* symbol = "?";
+        char* demangled = nullptr;
+        if (dladdr(sites[i].caller, &info) && info.dli_sname)
+        {
+            int status = 0;
+            demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            symbol = status == 0 && demangled ? demangled : info.dli_sname;
+        }
+
+        printf("  %llu allocations in %s, called from %s (%p)\n",
+               static_cast<unsigned long long>(sites[i].count),
+               sites[i].scope ? sites[i].scope : "?", symbol, sites[i].caller);
+        free(demangled);
+    }
+}
+
+/**
+ * Hook, drain and CheckActivity paths of a monitoring session
+ */
+static bool RunMonitorPipeline(uint64_t events)
+{
+    ManualClock clock(1000000);
+    NullDeadlineTimer timer;
+    HeadlessCursorDriver cursor;
+    ActivityChannel channel;
+    ManualIdleSource idleSource;
+    IdleEngine engine(clock, timer, cursor, channel);
+    HookWatchdog watchdog(idleSource, channel);
+    std::unique_ptr<InputEventRing> ring(new InputEventRing());
+    std::unique_ptr<LatencyHistogram> hookLatency(new LatencyHistogram());
+    InputDispatch dispatch(channel);
+    InputStatistics statistics;
+    IdlePeriodStatistics idlePeriods;
+    EventDrainThread drain;
+    StatusPublisher publisher;
+
+    // Reinstalling allocates a new input source, as HookInputSource does in the app
+    uint64_t reinstalls = 0;
+    watchdog.SetReinstallAction([&reinstalls]()
+    {
+        std::unique_ptr<int> source(new int(0));
+        g_keep = source.get();
+        ++reinstalls;
+        return true;
+    });
+
+    char name[64];
+    snprintf(name, sizeof(name), "mma-allocaudit-%ld", static_cast<long>(getpid()));
+    publisher.Open(name);
+
+    dispatch.SetEventRing(ring.get(), &drain);
+    drain.AddConsumer(&statistics);
+    drain.AddConsumer(&idlePeriods);
+    drain.SetPassCallback([&]()
+    {
+        StatusSnapshot::Input input = {};
+        input.lastActivityMs = channel.GetLastActivity();
+        input.processedPerSecond = channel.GetProcessedPerSecond();
+        input.coalescedPerSecond = channel.GetCoalescedPerSecond();
+        input.eventsPerSecond = input.processedPerSecond + input.coalescedPerSecond;
+        input.droppedEvents = ring->GetDropped();
+        input.mouseHookP99Ns = hookLatency->GetPercentile(99.0);
+        publisher.PublishInput(input);
+    });
+
+    channel.Reset(clock.NowMs());
+    engine.SetTimeout(1);
+    engine.Start();
+    if (!drain.Start(ring.get(), 10))
+        return Expect(false, "drain thread started");
+
+    std::atomic<uint64_t> inputNowMs{ clock.NowMs() };
+    std::atomic<bool> inputDone{ false };
+
+    AllocationAudit::Arm();
+
+    std::thread input([&]()
+    {
+        for (uint64_t i = 0; i < events; ++i)
+        {
+            MMA_NO_ALLOC_SCOPE("hook");
+            InputEvent event;
+            event.timestampMs = inputNowMs.load(std::memory_order_relaxed);
+            event.device = i & 3;
+            event.x = static_cast<int16_t>(i);
+            event.type = static_cast<InputEventType>(i % InputStatistics::TYPE_COUNT);
+            dispatch.Dispatch(event);
+            hookLatency->Record(200 + (i & 1023) * 10);
+
+            // Real input arrives in bursts; give the drain and deadline threads a turn on small machines
+            if ((i & 255) == 255)
+                std::this_thread::yield();
+        }
+        inputDone.store(true, std::memory_order_release);
+    });
+
+    uint64_t checks = 0;
+    while (!inputDone.load(std::memory_order_acquire))
+    {
+        {
+            MMA_NO_ALLOC_SCOPE("check_activity");
+            clock.Advance(2000);
+            inputNowMs.store(clock.NowMs(), std::memory_order_relaxed);
+
+            // Every fourth tick the idle clock saw input the hooks did not deliver
+            if ((checks & 3) == 3)
+                idleSource.SetLastInputTime(clock.NowMs());
+
+            watchdog.Check();
+            engine.OnDeadline();
+
+            const IdleScheduler& scheduler = engine.GetScheduler();
+            StatusSnapshot::State state = {};
+            state.monitoring = 1;
+            state.timeoutSeconds = engine.GetTimeout();
+            state.nextDeadlineMs = scheduler.GetDeadline();
+            state.idleActions = scheduler.GetActions();
+            state.hookIncidents = watchdog.GetIncidents();
+            state.wakeups = scheduler.GetWakeups();
+            publisher.PublishState(state);
+        }
+        ++checks;
+        std::this_thread::yield();
+    }
+
+    input.join();
+    drain.Stop();
+    AllocationAudit::Disarm();
+    publisher.Close();
+
+    uint64_t drained = 0;
+    for (size_t type = 0; type < InputStatistics::TYPE_COUNT; ++type)
+    {
+        drained += statistics.GetCount(static_cast<InputEventType>(type));
+    }
+
+    printf("hook events         %llu (%llu drained, %llu dropped by the ring)\n",
+           static_cast<unsigned long long>(events), static_cast<unsigned long long>(drained),
+           static_cast<unsigned long long>(ring->GetDropped()));
+    printf("deadline checks     %llu (%llu cursor moves, %llu hook incidents)\n",
+           static_cast<unsigned long long>(checks), static_cast<unsigned long long>(cursor.GetMoveCount()),
+           static_cast<unsigned long long>(watchdog.GetIncidents()));
+
+    bool passed = true;
+    passed &= Expect(drained + ring->GetDropped() == events, "every event drained or counted as dropped");
+    passed &= Expect(checks > 0 && reinstalls == watchdog.GetIncidents(), "deadline path ran, incidents reinstalled");
+    passed &= Expect(AllocationAudit::GetViolations() == 0, "no allocation in hook, drain or check_activity");
+    if (AllocationAudit::GetViolations())
+        PrintSites();
+
+    AllocationAudit::Reset();
+    return passed;
+}
+
+/**
+ * evdev reads and timer expiries of the Linux seat daemon
+ */
+static bool RunSeatDaemon(uint64_t events)
+{
+    SeatDaemon daemon;
+    int fds[2];
+    if (!daemon.Open() || pipe2(fds, O_NONBLOCK | O_CLOEXEC) != 0)
+        return Expect(false, "seat daemon opened");
+
+    uint32_t seat = daemon.AddSeat(1);
+    daemon.AddDevice(seat, fds[0]);
+
+    uint64_t idleActions = 0;
+    daemon.SetIdleAction([&idleActions](uint32_t) { ++idleActions; });
+
+    input_event batch[SeatDaemon::READ_BATCH];
+    memset(batch, 0, sizeof(batch));
+    for (input_event& record : batch)
+    {
+        record.type = EV_REL;
+        record.code = REL_X;
+        record.value = 1;
+    }
+
+    AllocationAudit::Arm();
+
+    uint64_t written = 0;
+    while (written < events)
+    {
+        if (write(fds[1], batch, sizeof(batch)) == static_cast<ssize_t>(sizeof(batch)))
+            written += SeatDaemon::READ_BATCH;
+        daemon.RunOnce(0);
+    }
+    while (daemon.GetSeatEvents(seat) < written && daemon.RunOnce(0))
+    {
+    }
+
+    // A one-second seat expires twice: once to re-arm after the input, once to go idle
+    uint64_t arms = daemon.GetTimerArms();
+    uint64_t giveUpMs = MonotonicNowMs() + 5000;
+    while (daemon.GetTimerArms() < arms + 2 && MonotonicNowMs() < giveUpMs)
+    {
+        daemon.RunOnce(100);
+    }
+
+    AllocationAudit::Disarm();
+    close(fds[1]);
+
+    printf("seat events         %llu (%llu timer arms, %llu idle actions)\n",
+           static_cast<unsigned long long>(daemon.GetSeatEvents(seat)),
+           static_cast<unsigned long long>(daemon.GetTimerArms()),
+           static_cast<unsigned long long>(idleActions));
+
+    bool passed = true;
+    passed &= Expect(daemon.GetSeatEvents(seat) == written, "every evdev record read");
+    passed &= Expect(daemon.GetTimerArms() >= arms + 2, "seat deadline expired and re-armed");
+    passed &= Expect(AllocationAudit::GetViolations() == 0, "no allocation in seat.input or seat.expire");
+    if (AllocationAudit::GetViolations())
+        PrintSites();
+
+    AllocationAudit::Reset();
+    return passed;
+}
+
+int main(int argc, char* argv[])
+{
+    uint64_t events = DEFAULT_EVENTS;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--events") == 0 && i + 1 < argc)
+            events = strtoull(argv[++i], nullptr, 10);
+        else
+        {
+            fprintf(stderr, "usage: mma_allocaudit [--events N]\n");
+            return 2;
+        }
+    }
+
+    // Violations are logged; run the logger thread as the application does
+    NullLogSink sink;
+    Logger::Start(&sink);
+
+    bool passed = RunMonitorPipeline(events);
+    passed &= RunSeatDaemon(events);
+
+    Logger::Stop();
+    printf("%s\n", passed ? "allocation audit passed" : "allocation audit FAILED");
+    return passed ? 0 : 1;
+}
\ No newline at end of file
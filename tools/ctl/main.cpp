@@ -0,0 +1,96 @@
+// main.cpp : Control channel client
+//
+// Usage:
+//   mma_ctl [--endpoint NAME] status|start|stop|show
+//   mma_ctl [--endpoint NAME] set-timeout SECONDS
+//
+// Sends one command to the current user's running instance (MMA on
+// Windows, mmad on Linux) and prints the state it reports afterwards.
+// Exit status 1 when nothing answered, 2 when the command was refused.
+// The protocol tests and latency figures live in mma_tests (control group).
+
+#include "ControlClient.h"
+#include "CoreConfig.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static void PrintUsage()
+{
+    fprintf(stderr,
+            "usage: mma_ctl [--endpoint NAME] status|start|stop|show\n"
+            "       mma_ctl [--endpoint NAME] set-timeout SECONDS\n");
+}
+
+static const char* BackendName(uint32_t backend)
+{
+    switch (backend)
+    {
+    case ACTIVITY_BACKEND_HOOKS:      return "hooks";
+    case ACTIVITY_BACKEND_IDLE_CLOCK: return "idle-clock";
+    case ACTIVITY_BACKEND_RAW_INPUT:  return "raw-input";
+    case ACTIVITY_BACKEND_EVDEV:      return "evdev";
+    default:                          return "unknown";
+    }
+}
+
+static void PrintResponse(const ControlResponse& response)
+{
+    printf("monitoring          %s\n", response.monitoring ? "on" : "off");
+    printf("timeout             %u s\n", response.timeoutSeconds);
+    printf("backend             %s\n", BackendName(response.backend));
+    printf("pid                 %u\n", response.processId);
+}
+
+int main(int argc, char* argv[])
+{
+    const char* endpoint = nullptr;
+    int next = 1;
+    if (argc > 2 && strcmp(argv[1], "--endpoint") == 0)
+    {
+        endpoint = argv[2];
+        next = 3;
+    }
+
+    ControlCommand command;
+    if (next >= argc || !ControlProtocol::ParseCommand(argv[next], command))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    uint32_t argument = 0;
+    if (command == ControlCommand::SetTimeout)
+    {
+        char* end = nullptr;
+        argument = next + 1 < argc ? static_cast<uint32_t>(strtoul(argv[next + 1], &end, 10)) : 0;
+        if (!end || *end != '\0' || next + 2 != argc)
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+    else if (next + 1 != argc)
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    ControlClient client;
+    ControlResponse response;
+    if (!client.Connect(endpoint) || !client.Transact(ControlProtocol::MakeRequest(command, argument), response))
+    {
+        fprintf(stderr, "mma_ctl: no running instance answered\n");
+        return 1;
+    }
+
+    ControlResult result = static_cast<ControlResult>(response.result);
+    if (result != ControlResult::Ok)
+    {
+        fprintf(stderr, "mma_ctl: %s: %s\n", ControlProtocol::GetCommandName(command), ControlProtocol::GetResultName(result));
+        return 2;
+    }
+
+    PrintResponse(response);
+    return 0;
+}
\ No newline at end of file
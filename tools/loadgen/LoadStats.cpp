@@ -0,0 +1,58 @@
+#include "LoadStats.h"
+#include <algorithm>
+#include <cstring>
+
+static double PercentileUs(const std::vector<uint64_t>& sorted, double percentile)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    // Nearest-rank percentile
+    size_t rank = static_cast<size_t>(percentile / 100.0 * static_cast<double>(sorted.size()));
+    if (rank >= sorted.size())
+        rank = sorted.size() - 1;
+
+    return static_cast<double>(sorted[rank]) / 1000.0;
+}
+
+void LoadStats::Summarize(std::vector<uint64_t>& latenciesNs, LoadReport& report)
+{
+    std::sort(latenciesNs.begin(), latenciesNs.end());
+
+    report.received = latenciesNs.size();
+    report.p50Us = PercentileUs(latenciesNs, 50.0);
+    report.p90Us = PercentileUs(latenciesNs, 90.0);
+    report.p99Us = PercentileUs(latenciesNs, 99.0);
+    report.p999Us = PercentileUs(latenciesNs, 99.9);
+    report.maxUs = latenciesNs.empty() ? 0.0 : static_cast<double>(latenciesNs.back()) / 1000.0;
+}
+
+void LoadStats::PrintText(const LoadReport& report, FILE* file)
+{
+    fprintf(file, "%s [%s] target %u ev/s, achieved %.0f ev/s\n",
+            report.label.c_str(), report.backend.c_str(), report.targetRate, report.achievedRate);
+    fprintf(file, "  sent %llu, received %llu, lost %llu\n",
+            static_cast<unsigned long long>(report.sent), static_cast<unsigned long long>(report.received),
+            static_cast<unsigned long long>(report.sent > report.received ? report.sent - report.received : 0));
+    fprintf(file, "  latency us: p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n",
+            report.p50Us, report.p90Us, report.p99Us, report.p999Us, report.maxUs);
+}
+
+bool LoadStats::WriteJson(const LoadReport& report, const char* path)
+{
+    FILE* file = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (!file)
+        return false;
+
+    fprintf(file,
+            "{\"label\": \"%s\", \"backend\": \"%s\", \"target_rate\": %u, \"achieved_rate\": %.1f, "
+            "\"sent\": %llu, \"received\": %llu, \"p50_us\": %.2f, \"p90_us\": %.2f, "
+            "\"p99_us\": %.2f, \"p999_us\": %.2f, \"max_us\": %.2f}\n",
+            report.label.c_str(), report.backend.c_str(), report.targetRate, report.achievedRate,
+            static_cast<unsigned long long>(report.sent), static_cast<unsigned long long>(report.received),
+            report.p50Us, report.p90Us, report.p99Us, report.p999Us, report.maxUs);
+
+    if (file != stdout)
+        fclose(file);
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/**
+ * Result of one load run: delivery counts and latency percentiles
+ */
+struct LoadReport
+{
+    std::string label;
+    std::string backend;
+    uint32_t targetRate = 0;
+    uint64_t sent = 0;
+    uint64_t received = 0;
+    double achievedRate = 0.0;
+    double p50Us = 0.0;
+    double p90Us = 0.0;
+    double p99Us = 0.0;
+    double p999Us = 0.0;
+    double maxUs = 0.0;
+};
+
+/**
+ * Turns raw per-event latencies into a LoadReport and prints it
+ */
+class LoadStats
+{
+public:
+    // Sorts latenciesNs in place
+    static void Summarize(std::vector<uint64_t>& latenciesNs, LoadReport& report);
+
+    static void PrintText(const LoadReport& report, FILE* file);
+    static bool WriteJson(const LoadReport& report, const char* path);
+};
\ No newline at end of file
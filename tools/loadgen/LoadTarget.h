@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+/**
+ * Injects synthetic input through the platform's normal input pipeline
+ * Events alternate direction (pointer +1/-1, key down/up) so the pointer
+ * position and key state return to rest after every pair
+ */
+class IInputInjector
+{
+public:
+    virtual ~IInputInjector() = default;
+
+    virtual bool Open() = 0;
+    virtual bool Inject(uint64_t sequence, bool keyboard) = 0;
+    virtual void Close() = 0;
+};
+
+/**
+ * Observes injected events at the far end of the pipeline
+ * Run blocks on its own thread and reports every delivered event until Stop
+ */
+class IDeliveryProbe
+{
+public:
+    virtual ~IDeliveryProbe() = default;
+
+    virtual bool Open() = 0;
+    virtual void Run(const std::function<void()>& onDelivered) = 0;
+    virtual void Stop() = 0; // any thread
+    virtual void Close() = 0;
+};
\ No newline at end of file
@@ -0,0 +1,224 @@
+#include "UinputLoadTarget.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/uinput.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <thread>
+#include <unistd.h>
+
+UinputInjector::~UinputInjector()
+{
+    Close();
+}
+
+bool UinputInjector::Open()
+{
+    m_fd = open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    if (m_fd < 0)
+        return false;
+
+    // BTN_LEFT makes the device classify as a mouse; no EV_REP, so the key never autorepeats
+    bool ok = ioctl(m_fd, UI_SET_EVBIT, EV_KEY) == 0 &&
+              ioctl(m_fd, UI_SET_KEYBIT, KEY_LEFTSHIFT) == 0 &&
+              ioctl(m_fd, UI_SET_KEYBIT, BTN_LEFT) == 0 &&
+              ioctl(m_fd, UI_SET_EVBIT, EV_REL) == 0 &&
+              ioctl(m_fd, UI_SET_RELBIT, REL_X) == 0 &&
+              ioctl(m_fd, UI_SET_RELBIT, REL_Y) == 0;
+
+    uinput_setup setup;
+    memset(&setup, 0, sizeof(setup));
+    setup.id.bustype = BUS_VIRTUAL;
+    setup.id.vendor = 0x4D4D;
+    setup.id.product = 0x4C47;
+    snprintf(setup.name, sizeof(setup.name), "mma_loadgen");
+
+    if (!ok || ioctl(m_fd, UI_DEV_SETUP, &setup) != 0 || ioctl(m_fd, UI_DEV_CREATE) != 0)
+    {
+        Close();
+        return false;
+    }
+
+    if (!FindNodePath())
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+bool UinputInjector::Inject(uint64_t sequence, bool keyboard)
+{
+    bool forward = (sequence & 1) == 0;
+
+    // One record plus its SYN_REPORT, written with a single syscall
+    input_event records[2];
+    memset(records, 0, sizeof(records));
+    if (keyboard)
+    {
+        records[0].type = EV_KEY;
+        records[0].code = KEY_LEFTSHIFT;
+        records[0].value = forward ? 1 : 0;
+    }
+    else
+    {
+        records[0].type = EV_REL;
+        records[0].code = REL_X;
+        records[0].value = forward ? 1 : -1;
+    }
+    records[1].type = EV_SYN;
+    records[1].code = SYN_REPORT;
+
+    return write(m_fd, records, sizeof(records)) == sizeof(records);
+}
+
+void UinputInjector::Close()
+{
+    if (m_fd >= 0)
+    {
+        ioctl(m_fd, UI_DEV_DESTROY);
+        close(m_fd);
+        m_fd = -1;
+    }
+    m_nodePath[0] = '\0';
+}
+
+bool UinputInjector::FindNodePath()
+{
+    char sysName[32];
+    if (ioctl(m_fd, UI_GET_SYSNAME(sizeof(sysName)), sysName) < 0)
+        return false;
+
+    char sysPath[96];
+    snprintf(sysPath, sizeof(sysPath), "/sys/class/input/%s", sysName);
+
+    // udev creates the node asynchronously after UI_DEV_CREATE
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        DIR* dir = opendir(sysPath);
+        if (dir)
+        {
+            dirent* entry;
+            while ((entry = readdir(dir)) != nullptr)
+            {
+                // Names too long for m_nodePath are not event nodes
+                if (strncmp(entry->d_name, "event", 5) == 0)
+                {
+                    int length = snprintf(m_nodePath, sizeof(m_nodePath), "/dev/input/%s", entry->d_name);
+                    if (length > 0 && static_cast<size_t>(length) < sizeof(m_nodePath))
+                        break;
+                    m_nodePath[0] = '\0';
+                }
+            }
+            closedir(dir);
+        }
+
+        if (m_nodePath[0] && access(m_nodePath, R_OK) == 0)
+            return true;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    return false;
+}
+
+EvdevProbe::EvdevProbe(const char* nodePath)
+    : m_nodePath(nodePath)
+{
+}
+
+EvdevProbe::~EvdevProbe()
+{
+    Close();
+}
+
+bool EvdevProbe::Open()
+{
+    m_stopRequested.store(false);
+
+    m_fd = open(m_nodePath, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_fd < 0 || m_wakeFd < 0)
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void EvdevProbe::Run(const std::function<void()>& onDelivered)
+{
+    pollfd fds[2];
+    fds[0].fd = m_fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = m_wakeFd;
+    fds[1].events = POLLIN;
+
+    input_event records[READ_BATCH];
+
+    for (;;)
+    {
+        if (poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+
+        if ((fds[1].revents & POLLIN) && m_stopRequested.load(std::memory_order_acquire))
+            return;
+
+        if (fds[0].revents & (POLLERR | POLLHUP))
+            return;
+
+        ssize_t bytes;
+        while ((bytes = read(m_fd, records, sizeof(records))) > 0)
+        {
+            size_t count = static_cast<size_t>(bytes) / sizeof(input_event);
+            for (size_t i = 0; i < count; ++i)
+            {
+                // Every injected event is one EV_KEY or EV_REL record followed by SYN_REPORT
+                if (records[i].type == EV_KEY || records[i].type == EV_REL)
+                    onDelivered();
+            }
+
+            if (count < READ_BATCH)
+                break;
+        }
+    }
+}
+
+void EvdevProbe::Stop()
+{
+    m_stopRequested.store(true, std::memory_order_release);
+
+    if (m_wakeFd >= 0)
+    {
+        uint64_t one = 1;
+        ssize_t written = write(m_wakeFd, &one, sizeof(one));
+        (void)written;
+    }
+}
+
+void EvdevProbe::Close()
+{
+    if (m_wakeFd >= 0)
+    {
+        close(m_wakeFd);
+        m_wakeFd = -1;
+    }
+
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+        m_fd = -1;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "LoadTarget.h"
+#include <atomic>
+
+/**
+ * Creates a virtual mouse/keyboard through /dev/uinput and injects into it
+ * Needs write access to /dev/uinput but no display server
+ */
+class UinputInjector : public IInputInjector
+{
+public:
+    UinputInjector() = default;
+    ~UinputInjector() override;
+
+    UinputInjector(const UinputInjector&) = delete;
+    UinputInjector& operator=(const UinputInjector&) = delete;
+
+    // IInputInjector
+    bool Open() override;
+    bool Inject(uint64_t sequence, bool keyboard) override;
+    void Close() override;
+
+    // evdev node the kernel created for the virtual device, valid after Open
+    const char* GetNodePath() const { return m_nodePath; }
+
+private:
+    // Private helpers
+    bool FindNodePath();
+
+    // Member variables
+    int m_fd = -1;
+    char m_nodePath[64] = {};
+};
+
+/**
+ * Reads the virtual device's evdev node back
+ * Only the injector's own node is opened, so other devices never interfere
+ */
+class EvdevProbe : public IDeliveryProbe
+{
+public:
+    explicit EvdevProbe(const char* nodePath);
+    ~EvdevProbe() override;
+
+    EvdevProbe(const EvdevProbe&) = delete;
+    EvdevProbe& operator=(const EvdevProbe&) = delete;
+
+    // IDeliveryProbe
+    bool Open() override;
+    void Run(const std::function<void()>& onDelivered) override;
+    void Stop() override;
+    void Close() override;
+
+    static const size_t READ_BATCH = 64;
+
+private:
+    // Member variables
+    const char* m_nodePath;
+    int m_fd = -1;
+    int m_wakeFd = -1;
+    std::atomic<bool> m_stopRequested{ false };
+};
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "Win32LoadTarget.h"
+
+// Static member definition
+const WCHAR* RawInputProbe::WINDOW_CLASS = L"MMALoadgenProbe";
+
+bool SendInputInjector::Inject(uint64_t sequence, bool keyboard)
+{
+    bool forward = (sequence & 1) == 0;
+
+    INPUT input = {};
+    if (keyboard)
+    {
+        // Shift produces no text, so a run never types into the focused window
+        input.type = INPUT_KEYBOARD;
+        input.ki.wVk = VK_SHIFT;
+        input.ki.dwFlags = forward ? 0 : KEYEVENTF_KEYUP;
+    }
+    else
+    {
+        input.type = INPUT_MOUSE;
+        input.mi.dx = forward ? 1 : -1;
+        input.mi.dwFlags = MOUSEEVENTF_MOVE;
+    }
+
+    return SendInput(1, &input, sizeof(INPUT)) == 1;
+}
+
+RawInputProbe::~RawInputProbe()
+{
+    Close();
+}
+
+bool RawInputProbe::Open()
+{
+    m_threadId = GetCurrentThreadId();
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL);
+
+    HINSTANCE hInstance = GetModuleHandleW(nullptr);
+
+    WNDCLASSEXW wc = { 0 };
+    wc.cbSize = sizeof(wc);
+    wc.lpfnWndProc = DefWindowProcW;
+    wc.hInstance = hInstance;
+    wc.lpszClassName = WINDOW_CLASS;
+    RegisterClassExW(&wc);
+
+    m_window = CreateWindowExW(0, WINDOW_CLASS, L"", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, hInstance, nullptr);
+    if (!m_window)
+    {
+        Close();
+        return false;
+    }
+
+    RAWINPUTDEVICE devices[2] = {};
+    devices[0].usUsagePage = 0x01; // Generic desktop
+    devices[0].usUsage = 0x02;     // Mouse
+    devices[0].dwFlags = RIDEV_INPUTSINK;
+    devices[0].hwndTarget = m_window;
+    devices[1].usUsagePage = 0x01;
+    devices[1].usUsage = 0x06;     // Keyboard
+    devices[1].dwFlags = RIDEV_INPUTSINK;
+    devices[1].hwndTarget = m_window;
+
+    if (!RegisterRawInputDevices(devices, 2, sizeof(RAWINPUTDEVICE)))
+    {
+        Close();
+        return false;
+    }
+
+    m_devicesRegistered = true;
+    return true;
+}
+
+void RawInputProbe::Run(const std::function<void()>& onDelivered)
+{
+    MSG msg;
+    while (GetMessageW(&msg, nullptr, 0, 0) > 0)
+    {
+        if (msg.message == WM_INPUT)
+        {
+            // The header alone identifies the source device
+            RAWINPUTHEADER header;
+            UINT size = sizeof(header);
+            if (GetRawInputData(reinterpret_cast<HRAWINPUT>(msg.lParam), RID_HEADER, &header, &size,
+                                sizeof(RAWINPUTHEADER)) == sizeof(header) &&
+                header.hDevice == nullptr)
+            {
+                onDelivered();
+            }
+        }
+
+        // DefWindowProc releases the raw input buffer
+        DispatchMessageW(&msg);
+    }
+}
+
+void RawInputProbe::Stop()
+{
+    if (m_threadId)
+    {
+        PostThreadMessageW(m_threadId, WM_QUIT, 0, 0);
+    }
+}
+
+void RawInputProbe::Close()
+{
+    if (m_devicesRegistered)
+    {
+        RAWINPUTDEVICE devices[2] = {};
+        devices[0].usUsagePage = 0x01;
+        devices[0].usUsage = 0x02;
+        devices[0].dwFlags = RIDEV_REMOVE;
+        devices[1].usUsagePage = 0x01;
+        devices[1].usUsage = 0x06;
+        devices[1].dwFlags = RIDEV_REMOVE;
+        RegisterRawInputDevices(devices, 2, sizeof(RAWINPUTDEVICE));
+        m_devicesRegistered = false;
+    }
+
+    if (m_window)
+    {
+        DestroyWindow(m_window);
+        m_window = nullptr;
+    }
+
+    m_threadId = 0;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "LoadTarget.h"
+#include <windows.h>
+
+/**
+ * Injects relative mouse moves and Shift presses through SendInput
+ */
+class SendInputInjector : public IInputInjector
+{
+public:
+    // IInputInjector
+    bool Open() override { return true; }
+    bool Inject(uint64_t sequence, bool keyboard) override;
+    void Close() override {}
+};
+
+/**
+ * Reads the injected events back as WM_INPUT on a message-only window
+ * Injected input carries a null device handle, which keeps real devices out
+ * of the latency matching. Open, Run and Close must share one thread
+ */
+class RawInputProbe : public IDeliveryProbe
+{
+public:
+    RawInputProbe() = default;
+    ~RawInputProbe() override;
+
+    RawInputProbe(const RawInputProbe&) = delete;
+    RawInputProbe& operator=(const RawInputProbe&) = delete;
+
+    // IDeliveryProbe
+    bool Open() override;
+    void Run(const std::function<void()>& onDelivered) override;
+    void Stop() override;
+    void Close() override;
+
+private:
+    static const WCHAR* WINDOW_CLASS;
+
+    // Member variables
+    HWND m_window = nullptr;
+    DWORD m_threadId = 0;
+    bool m_devicesRegistered = false;
+};
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include "X11LoadTarget.h"
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <X11/Xlib.h>
+#include <X11/keysym.h>
+#include <X11/extensions/XInput2.h>
+#include <X11/extensions/XTest.h>
+
+XTestInjector::XTestInjector(const char* displayName)
+    : m_displayName(displayName)
+{
+}
+
+XTestInjector::~XTestInjector()
+{
+    Close();
+}
+
+bool XTestInjector::Open()
+{
+    m_display = XOpenDisplay(m_displayName);
+    if (!m_display)
+        return false;
+
+    int eventBase, errorBase, major, minor;
+    if (!XTestQueryExtension(m_display, &eventBase, &errorBase, &major, &minor))
+    {
+        Close();
+        return false;
+    }
+
+    // Shift produces no text, so a run never types into the focused window
+    m_keycode = XKeysymToKeycode(m_display, XK_Shift_L);
+    if (m_keycode == 0)
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+bool XTestInjector::Inject(uint64_t sequence, bool keyboard)
+{
+    bool forward = (sequence & 1) == 0;
+
+    if (keyboard)
+        XTestFakeKeyEvent(m_display, m_keycode, forward ? True : False, CurrentTime);
+    else
+        XTestFakeRelativeMotionEvent(m_display, forward ? 1 : -1, 0, CurrentTime);
+
+    // XFlush writes the request without waiting for a reply
+    return XFlush(m_display) != 0;
+}
+
+void XTestInjector::Close()
+{
+    if (m_display)
+    {
+        XCloseDisplay(m_display);
+        m_display = nullptr;
+    }
+}
+
+XInputProbe::XInputProbe(const char* displayName)
+    : m_displayName(displayName)
+{
+}
+
+XInputProbe::~XInputProbe()
+{
+    Close();
+}
+
+bool XInputProbe::Open()
+{
+    m_stopRequested.store(false);
+
+    m_display = XOpenDisplay(m_displayName);
+    if (!m_display)
+        return false;
+
+    // Same XI 2.2 as X11InputSource, so raw events survive grabs in both
+    int eventBase, errorBase;
+    int major = 2, minor = 2;
+    if (!XQueryExtension(m_display, "XInputExtension", &m_xiOpcode, &eventBase, &errorBase) ||
+        XIQueryVersion(m_display, &major, &minor) != Success ||
+        !FindXTestDevices())
+    {
+        Close();
+        return false;
+    }
+
+    unsigned char bits[XIMaskLen(XI_LASTEVENT)] = { 0 };
+    XISetMask(bits, XI_RawMotion);
+    XISetMask(bits, XI_RawKeyPress);
+    XISetMask(bits, XI_RawKeyRelease);
+
+    XIEventMask mask;
+    mask.deviceid = XIAllMasterDevices;
+    mask.mask_len = sizeof(bits);
+    mask.mask = bits;
+    XISelectEvents(m_display, DefaultRootWindow(m_display), &mask, 1);
+
+    // Round-trip so the selection is active before the first event is injected
+    XSync(m_display, False);
+
+    m_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (m_wakeFd < 0)
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void XInputProbe::Run(const std::function<void()>& onDelivered)
+{
+    pollfd fds[2];
+    fds[0].fd = ConnectionNumber(m_display);
+    fds[0].events = POLLIN;
+    fds[1].fd = m_wakeFd;
+    fds[1].events = POLLIN;
+
+    for (;;)
+    {
+        while (XPending(m_display) > 0)
+        {
+            XEvent xevent;
+            XNextEvent(m_display, &xevent);
+
+            XGenericEventCookie* cookie = &xevent.xcookie;
+            if (cookie->type != GenericEvent || cookie->extension != m_xiOpcode)
+                continue;
+
+            if (XGetEventData(m_display, cookie))
+            {
+                const XIRawEvent* raw = static_cast<const XIRawEvent*>(cookie->data);
+                if (IsXTestSource(raw->sourceid))
+                    onDelivered();
+                XFreeEventData(m_display, cookie);
+            }
+        }
+
+        if (poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+
+        if ((fds[1].revents & POLLIN) && m_stopRequested.load(std::memory_order_acquire))
+            return;
+
+        if (fds[0].revents & (POLLERR | POLLHUP))
+            return;
+    }
+}
+
+void XInputProbe::Stop()
+{
+    m_stopRequested.store(true, std::memory_order_release);
+
+    if (m_wakeFd >= 0)
+    {
+        uint64_t one = 1;
+        ssize_t written = write(m_wakeFd, &one, sizeof(one));
+        (void)written;
+    }
+}
+
+void XInputProbe::Close()
+{
+    if (m_wakeFd >= 0)
+    {
+        close(m_wakeFd);
+        m_wakeFd = -1;
+    }
+
+    if (m_display)
+    {
+        XCloseDisplay(m_display);
+        m_display = nullptr;
+    }
+}
+
+bool XInputProbe::FindXTestDevices()
+{
+    // The server creates one XTEST slave per master ("Virtual core XTEST pointer", "... keyboard")
+    int count = 0;
+    XIDeviceInfo* devices = XIQueryDevice(m_display, XIAllDevices, &count);
+    if (!devices)
+        return false;
+
+    m_sourceCount = 0;
+    for (int i = 0; i < count && m_sourceCount < MAX_SOURCES; ++i)
+    {
+        if (devices[i].name && strstr(devices[i].name, "XTEST"))
+            m_sources[m_sourceCount++] = devices[i].deviceid;
+    }
+
+    XIFreeDeviceInfo(devices);
+    return m_sourceCount > 0;
+}
+
+bool XInputProbe::IsXTestSource(int sourceId) const
+{
+    for (int i = 0; i < m_sourceCount; ++i)
+    {
+        if (m_sources[i] == sourceId)
+            return true;
+    }
+    return false;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "LoadTarget.h"
+#include <atomic>
+
+struct _XDisplay;
+
+/**
+ * Injects pointer motion and Shift presses through XTest
+ * Works against any X server, including a headless Xvfb
+ */
+class XTestInjector : public IInputInjector
+{
+public:
+    // displayName of nullptr uses $DISPLAY
+    explicit XTestInjector(const char* displayName = nullptr);
+    ~XTestInjector() override;
+
+    XTestInjector(const XTestInjector&) = delete;
+    XTestInjector& operator=(const XTestInjector&) = delete;
+
+    // IInputInjector
+    bool Open() override;
+    bool Inject(uint64_t sequence, bool keyboard) override;
+    void Close() override;
+
+private:
+    // Member variables
+    const char* m_displayName;
+    _XDisplay* m_display = nullptr;
+    unsigned int m_keycode = 0;
+};
+
+/**
+ * Reads XI2 raw events back on a second connection
+ * Only the XTest slave devices are counted, so a real user moving the mouse
+ * during a run does not shift the latency matching
+ */
+class XInputProbe : public IDeliveryProbe
+{
+public:
+    explicit XInputProbe(const char* displayName = nullptr);
+    ~XInputProbe() override;
+
+    XInputProbe(const XInputProbe&) = delete;
+    XInputProbe& operator=(const XInputProbe&) = delete;
+
+    // IDeliveryProbe
+    bool Open() override;
+    void Run(const std::function<void()>& onDelivered) override;
+    void Stop() override;
+    void Close() override;
+
+private:
+    static const int MAX_SOURCES = 4;
+
+    // Private helpers
+    bool FindXTestDevices();
+    bool IsXTestSource(int sourceId) const;
+
+    // Member variables
+    const char* m_displayName;
+    _XDisplay* m_display = nullptr;
+    int m_xiOpcode = 0;
+    int m_sources[MAX_SOURCES] = {};
+    int m_sourceCount = 0;
+    int m_wakeFd = -1;
+    std::atomic<bool> m_stopRequested{ false };
+};
\ No newline at end of file
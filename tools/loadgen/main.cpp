@@ -0,0 +1,409 @@
+// main.cpp : Synthetic input load generator
+//
+// Usage:
+//   mma_loadgen [--backend xtest|uinput|sendinput] [--rate EVENTS_PER_SEC]
+//               [--seconds N] [--mix mouse|keyboard|mixed] [--monitor]
+//               [--label TEXT] [--json FILE] [--max-p99-us N] [--max-loss PERCENT]
+//
+// Injects events at a fixed rate through the platform input pipeline, reads
+// them back at the far end and reports delivery latency percentiles. Run it
+// once with MMA stopped and once with MMA monitoring to measure MMA's cost;
+// on Linux --monitor runs MMA's own input pipeline inside this process.
+// Exit status 2 when a --max-* gate is exceeded.
+
+#include "LoadStats.h"
+#include "LoadTarget.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include "Win32LoadTarget.h"
+#else
+#include "UinputLoadTarget.h"
+#ifdef MMA_LOADGEN_X11
+#include "X11LoadTarget.h"
+#endif
+#ifdef MMA_LOADGEN_MONITOR
+#include "ActivityChannel.h"
+#include "EvdevInputSource.h"
+#include "EventDrainThread.h"
+#include "InputDispatch.h"
+#include "InputStatistics.h"
+#include "InputThread.h"
+#ifdef MMA_LOADGEN_X11
+#include "X11InputSource.h"
+#endif
+#endif
+#endif
+
+typedef std::chrono::steady_clock LoadClock;
+
+static const uint32_t MAX_RATE = 50000;
+static const uint32_t MAX_SECONDS = 600;
+
+enum class LoadMix
+{
+    Mouse,
+    Keyboard,
+    Mixed
+};
+
+struct LoadOptions
+{
+    const char* backend = nullptr;
+    uint32_t rate = 5000;
+    uint32_t seconds = 10;
+    LoadMix mix = LoadMix::Mouse;
+    bool monitor = false;
+    const char* label = nullptr;
+    const char* jsonPath = nullptr;
+    double maxP99Us = 0.0;
+    double maxLossPercent = -1.0;
+};
+
+static void PrintUsage()
+{
+    fprintf(stderr,
+            "usage: mma_loadgen [--backend xtest|uinput|sendinput] [--rate EVENTS_PER_SEC]\n"
+            "                   [--seconds N] [--mix mouse|keyboard|mixed] [--monitor]\n"
+            "                   [--label TEXT] [--json FILE] [--max-p99-us N] [--max-loss PERCENT]\n");
+}
+
+static uint64_t NowNs()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        LoadClock::now().time_since_epoch()).count());
+}
+
+/**
+ * Sleep to just before the deadline, then yield until it passes
+ * Deadlines are absolute, so a late event never shifts the ones after it
+ */
+static void WaitUntil(LoadClock::time_point deadline)
+{
+    for (;;)
+    {
+        LoadClock::time_point now = LoadClock::now();
+        if (now >= deadline)
+            return;
+
+        // Sleep granularity is ~1 ms on Windows and tens of us on Linux
+        LoadClock::duration remaining = deadline - now;
+        if (remaining > std::chrono::milliseconds(2))
+            std::this_thread::sleep_for(remaining - std::chrono::milliseconds(1));
+        else
+            std::this_thread::yield();
+    }
+}
+
+/**
+ * Keyboard events come in down/up pairs so the key is never left pressed
+ */
+static bool IsKeyboardEvent(LoadMix mix, uint64_t sequence)
+{
+    switch (mix)
+    {
+    case LoadMix::Keyboard:
+        return true;
+    case LoadMix::Mixed:
+        return ((sequence >> 1) & 1) != 0;
+    default:
+        return false;
+    }
+}
+
+#ifdef MMA_LOADGEN_MONITOR
+/**
+ * MMA's input pipeline without the UI: source, dispatch, channel and the
+ * analytics ring drained in the background
+ */
+class MonitorPipeline
+{
+public:
+    MonitorPipeline()
+        : m_dispatch(m_channel)
+    {
+        m_dispatch.SetEventRing(&m_ring, &m_drainThread);
+        m_drainThread.AddConsumer(&m_statistics);
+    }
+
+    bool Start(const char* backend)
+    {
+#ifdef MMA_LOADGEN_X11
+        if (strcmp(backend, "xtest") == 0)
+            m_source.reset(new X11InputSource());
+#endif
+        if (strcmp(backend, "uinput") == 0)
+            m_source.reset(new EvdevInputSource());
+
+        if (!m_source || !m_inputThread.Start(m_source.get(), &m_dispatch))
+            return false;
+
+        return m_drainThread.Start(&m_ring);
+    }
+
+    void Stop()
+    {
+        m_inputThread.Stop();
+        m_drainThread.Stop();
+    }
+
+    uint64_t GetProcessed() const { return m_channel.GetProcessedCount(); }
+    uint64_t GetCoalesced() const { return m_channel.GetCoalescedCount(); }
+
+private:
+    // Member variables
+    ActivityChannel m_channel;
+    InputDispatch m_dispatch;
+    InputEventRing m_ring;
+    InputStatistics m_statistics;
+    EventDrainThread m_drainThread;
+    InputThread m_inputThread;
+    std::unique_ptr<IInputSource> m_source;
+};
+#endif
+
+static bool ParseOptions(int argc, char* argv[], LoadOptions& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--backend") == 0 && i + 1 < argc)
+            options.backend = argv[++i];
+        else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc)
+            options.rate = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+            options.seconds = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (strcmp(argv[i], "--mix") == 0 && i + 1 < argc)
+        {
+            const char* mix = argv[++i];
+            if (strcmp(mix, "mouse") == 0)
+                options.mix = LoadMix::Mouse;
+            else if (strcmp(mix, "keyboard") == 0)
+                options.mix = LoadMix::Keyboard;
+            else if (strcmp(mix, "mixed") == 0)
+                options.mix = LoadMix::Mixed;
+            else
+                return false;
+        }
+        else if (strcmp(argv[i], "--monitor") == 0)
+            options.monitor = true;
+        else if (strcmp(argv[i], "--label") == 0 && i + 1 < argc)
+            options.label = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            options.jsonPath = argv[++i];
+        else if (strcmp(argv[i], "--max-p99-us") == 0 && i + 1 < argc)
+            options.maxP99Us = strtod(argv[++i], nullptr);
+        else if (strcmp(argv[i], "--max-loss") == 0 && i + 1 < argc)
+            options.maxLossPercent = strtod(argv[++i], nullptr);
+        else
+            return false;
+    }
+
+    if (options.rate == 0 || options.rate > MAX_RATE || options.seconds == 0 || options.seconds > MAX_SECONDS)
+        return false;
+
+    if (!options.backend)
+    {
+#ifdef _WIN32
+        options.backend = "sendinput";
+#elif defined(MMA_LOADGEN_X11)
+        options.backend = getenv("DISPLAY") ? "xtest" : "uinput";
+#else
+        options.backend = "uinput";
+#endif
+    }
+
+    if (!options.label)
+        options.label = options.monitor ? "monitor-on" : "monitor-off";
+
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    LoadOptions options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    std::unique_ptr<IInputInjector> injector;
+    std::unique_ptr<IDeliveryProbe> probe;
+
+#ifdef _WIN32
+    if (strcmp(options.backend, "sendinput") == 0)
+    {
+        injector.reset(new SendInputInjector());
+        probe.reset(new RawInputProbe());
+    }
+#else
+#ifdef MMA_LOADGEN_X11
+    if (strcmp(options.backend, "xtest") == 0)
+    {
+        injector.reset(new XTestInjector());
+        probe.reset(new XInputProbe());
+    }
+#endif
+    if (strcmp(options.backend, "uinput") == 0)
+        injector.reset(new UinputInjector());
+#endif
+
+    if (!injector)
+    {
+        fprintf(stderr, "mma_loadgen: backend %s is not available in this build\n", options.backend);
+        return 1;
+    }
+
+    if (!injector->Open())
+    {
+        fprintf(stderr, "mma_loadgen: cannot open the %s injector\n", options.backend);
+        return 1;
+    }
+
+#ifndef _WIN32
+    // The probe reads the node the kernel created for the injector's device
+    if (!probe)
+        probe.reset(new EvdevProbe(static_cast<UinputInjector*>(injector.get())->GetNodePath()));
+#endif
+
+    // Preallocated so neither thread allocates while events are in flight
+    const uint64_t total = static_cast<uint64_t>(options.rate) * options.seconds;
+    std::unique_ptr<std::atomic<uint64_t>[]> sendTimes(new std::atomic<uint64_t>[total]);
+    std::vector<uint64_t> latencies(total);
+    std::atomic<uint64_t> received{ 0 };
+
+    // Deliveries match sends in FIFO order; the probe only counts injected events
+    auto onDelivered = [&]()
+    {
+        uint64_t index = received.load(std::memory_order_relaxed);
+        if (index >= total)
+            return;
+
+        latencies[index] = NowNs() - sendTimes[index].load(std::memory_order_acquire);
+        received.store(index + 1, std::memory_order_release);
+    };
+
+    // The probe opens, runs and closes on its own thread (window affinity on Windows)
+    std::promise<bool> opened;
+    std::future<bool> openResult = opened.get_future();
+    IDeliveryProbe* probePtr = probe.get();
+    std::thread probeThread([probePtr, &onDelivered](std::promise<bool> opened)
+    {
+        bool ok = probePtr->Open();
+        opened.set_value(ok);
+        if (!ok)
+            return;
+
+        probePtr->Run(onDelivered);
+        probePtr->Close();
+    }, std::move(opened));
+
+    if (!openResult.get())
+    {
+        probeThread.join();
+        fprintf(stderr, "mma_loadgen: cannot open the %s delivery probe\n", options.backend);
+        return 1;
+    }
+
+#ifdef MMA_LOADGEN_MONITOR
+    MonitorPipeline monitor;
+    if (options.monitor && !monitor.Start(options.backend))
+    {
+        probe->Stop();
+        probeThread.join();
+        fprintf(stderr, "mma_loadgen: cannot start the in-process monitor for %s\n", options.backend);
+        return 1;
+    }
+#else
+    if (options.monitor)
+        fprintf(stderr, "mma_loadgen: --monitor is not built in; start MMA separately for the monitored run\n");
+#endif
+
+    // Let the pipeline settle before the clock starts
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    const LoadClock::duration period = std::chrono::nanoseconds(1000000000ULL / options.rate);
+    LoadClock::time_point start = LoadClock::now();
+    uint64_t sent = 0;
+    uint64_t failures = 0;
+
+    for (uint64_t sequence = 0; sequence < total; ++sequence)
+    {
+        WaitUntil(start + period * static_cast<int64_t>(sequence));
+
+        sendTimes[sent].store(NowNs(), std::memory_order_release);
+        if (injector->Inject(sequence, IsKeyboardEvent(options.mix, sequence)))
+            ++sent;
+        else
+            ++failures;
+    }
+
+    double elapsedSeconds = std::chrono::duration<double>(LoadClock::now() - start).count();
+
+    // Give stragglers a second to arrive
+    LoadClock::time_point drainDeadline = LoadClock::now() + std::chrono::seconds(1);
+    while (received.load(std::memory_order_acquire) < sent && LoadClock::now() < drainDeadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    probe->Stop();
+    probeThread.join();
+    injector->Close();
+
+    LoadReport report;
+    report.label = options.label;
+    report.backend = options.backend;
+    report.targetRate = options.rate;
+    report.sent = sent;
+    report.achievedRate = elapsedSeconds > 0.0 ? static_cast<double>(sent) / elapsedSeconds : 0.0;
+
+    latencies.resize(received.load(std::memory_order_acquire));
+    LoadStats::Summarize(latencies, report);
+    LoadStats::PrintText(report, stdout);
+
+    if (failures)
+        printf("  injection failures %llu\n", static_cast<unsigned long long>(failures));
+
+#ifdef MMA_LOADGEN_MONITOR
+    if (options.monitor)
+    {
+        printf("  monitor processed %llu, coalesced %llu\n",
+               static_cast<unsigned long long>(monitor.GetProcessed()),
+               static_cast<unsigned long long>(monitor.GetCoalesced()));
+        monitor.Stop();
+    }
+#endif
+
+    if (options.jsonPath && !LoadStats::WriteJson(report, options.jsonPath))
+    {
+        fprintf(stderr, "mma_loadgen: cannot write %s\n", options.jsonPath);
+        return 1;
+    }
+
+    // Release gates
+    int status = 0;
+    if (options.maxP99Us > 0.0 && report.p99Us > options.maxP99Us)
+    {
+        printf("FAIL: p99 %.1f us over %.1f us\n", report.p99Us, options.maxP99Us);
+        status = 2;
+    }
+
+    uint64_t lost = sent > report.received ? sent - report.received : 0;
+    double lossPercent = sent ? 100.0 * static_cast<double>(lost) / static_cast<double>(sent) : 100.0;
+    if (options.maxLossPercent >= 0.0 && lossPercent > options.maxLossPercent)
+    {
+        printf("FAIL: lost %.2f%% of events, limit %.2f%%\n", lossPercent, options.maxLossPercent);
+        status = 2;
+    }
+
+    return status;
+}
\ No newline at end of file
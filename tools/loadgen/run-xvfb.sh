@@ -0,0 +1,33 @@
+#!/bin/sh
+# run-xvfb.sh : Headless release gate for MMA's input overhead
+#
+# Usage: run-xvfb.sh LOADGEN [RATE] [SECONDS] [MAX_P99_US]
+#
+# Starts a private Xvfb, runs mma_loadgen with MMA's input pipeline off and
+# on, and fails when the monitored run loses events or its p99 latency
+# exceeds MAX_P99_US. Results land in loadgen-off.json and loadgen-on.json.
+
+set -eu
+
+LOADGEN=${1:?usage: run-xvfb.sh LOADGEN [RATE] [SECONDS] [MAX_P99_US]}
+RATE=${2:-10000}
+SECONDS_PER_RUN=${3:-10}
+MAX_P99_US=${4:-2000}
+
+# -displayfd picks a free display number and reports it once the server is ready
+DISPLAY_FILE=$(mktemp)
+Xvfb -displayfd 3 -screen 0 1280x1024x24 -nolisten tcp 3>"$DISPLAY_FILE" &
+XVFB_PID=$!
+trap 'kill $XVFB_PID 2>/dev/null; rm -f "$DISPLAY_FILE"' EXIT
+
+for _ in $(seq 50); do
+    [ -s "$DISPLAY_FILE" ] && break
+    sleep 0.1
+done
+DISPLAY=:$(cat "$DISPLAY_FILE")
+export DISPLAY
+
+"$LOADGEN" --backend xtest --rate "$RATE" --seconds "$SECONDS_PER_RUN" --mix mixed \
+    --json loadgen-off.json --max-loss 0
+"$LOADGEN" --backend xtest --rate "$RATE" --seconds "$SECONDS_PER_RUN" --mix mixed --monitor \
+    --json loadgen-on.json --max-loss 0 --max-p99-us "$MAX_P99_US"
\ No newline at end of file
@@ -0,0 +1,343 @@
+#include "OpenMetricsParser.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+static const char* const FAMILY_TYPES[] = {
+    "counter", "gauge", "histogram", "gaugehistogram", "summary", "info", "stateset", "unknown" };
+
+// Sample name suffixes each family type allows
+static bool IsValidSuffix(const std::string& type, const std::string& suffix)
+{
+    if (type == "counter")
+        return suffix == "_total" || suffix == "_created";
+    if (type == "histogram")
+        return suffix == "_bucket" || suffix == "_count" || suffix == "_sum" || suffix == "_created";
+    if (type == "gaugehistogram")
+        return suffix == "_bucket" || suffix == "_gcount" || suffix == "_gsum";
+    if (type == "summary")
+        return suffix.empty() || suffix == "_count" || suffix == "_sum" || suffix == "_created";
+    if (type == "info")
+        return suffix == "_info";
+    return suffix.empty();
+}
+
+const OpenMetricsParser::Family* OpenMetricsParser::FindFamily(const std::string& name) const
+{
+    for (const Family& family : m_families)
+    {
+        if (family.name == name)
+            return &family;
+    }
+    return nullptr;
+}
+
+bool OpenMetricsParser::Parse(const std::string& text)
+{
+    m_families.clear();
+    m_error.clear();
+    m_line = 0;
+
+    if (text.empty() || text.back() != '\n')
+        return Fail("the exposition must end with a newline");
+
+    bool sawEof = false;
+    size_t start = 0;
+    while (start < text.size())
+    {
+        size_t end = text.find('\n', start);
+        std::string line = text.substr(start, end - start);
+        start = end + 1;
+        ++m_line;
+
+        if (sawEof)
+            return Fail("content after # EOF");
+
+        if (line == "# EOF")
+            sawEof = true;
+        else if (line.empty())
+            return Fail("empty line");
+        else if (line[0] == '#')
+        {
+            if (!ParseMetadata(line))
+                return false;
+        }
+        else if (!ParseSample(line))
+            return false;
+    }
+
+    if (!sawEof)
+        return Fail("missing # EOF");
+
+    for (const Family& family : m_families)
+    {
+        if (!CheckFamily(family))
+            return false;
+    }
+    return true;
+}
+
+bool OpenMetricsParser::ParseMetadata(const std::string& line)
+{
+    // "# KEYWORD name rest"
+    if (line.compare(0, 2, "# ") != 0)
+        return Fail("malformed comment");
+
+    size_t keywordEnd = line.find(' ', 2);
+    size_t nameEnd = keywordEnd == std::string::npos ? std::string::npos : line.find(' ', keywordEnd + 1);
+    if (nameEnd == std::string::npos)
+        return Fail("metadata needs a family name and a value");
+
+    std::string keyword = line.substr(2, keywordEnd - 2);
+    std::string name = line.substr(keywordEnd + 1, nameEnd - keywordEnd - 1);
+    std::string rest = line.substr(nameEnd + 1);
+
+    if (!IsValidName(name))
+        return Fail("invalid family name '" + name + "'");
+
+    if (keyword == "TYPE")
+    {
+        bool known = false;
+        for (const char* type : FAMILY_TYPES)
+        {
+            known |= rest == type;
+        }
+        if (!known)
+            return Fail("unknown type '" + rest + "'");
+        if (FindFamily(name))
+            return Fail("family '" + name + "' declared twice");
+
+        Family family;
+        family.name = name;
+        family.type = rest;
+        m_families.push_back(family);
+        return true;
+    }
+
+    // HELP and UNIT describe the family just declared, before its samples
+    if (m_families.empty() || m_families.back().name != name)
+        return Fail(keyword + " for '" + name + "' outside its family");
+
+    Family& family = m_families.back();
+    if (!family.samples.empty())
+        return Fail(keyword + " after samples of '" + name + "'");
+
+    if (keyword == "HELP")
+    {
+        if (!family.help.empty())
+            return Fail("second HELP for '" + name + "'");
+        family.help = rest;
+        return true;
+    }
+
+    if (keyword == "UNIT")
+    {
+        if (!family.unit.empty())
+            return Fail("second UNIT for '" + name + "'");
+
+        std::string suffix = "_" + rest;
+        if (name.size() <= suffix.size() || name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0)
+            return Fail("family '" + name + "' must end with its unit '" + rest + "'");
+        family.unit = rest;
+        return true;
+    }
+
+    return Fail("unknown metadata '" + keyword + "'");
+}
+
+bool OpenMetricsParser::ParseSample(const std::string& line)
+{
+    Sample sample;
+
+    size_t pos = 0;
+    while (pos < line.size() && line[pos] != '{' && line[pos] != ' ')
+    {
+        ++pos;
+    }
+    sample.name = line.substr(0, pos);
+    if (!IsValidName(sample.name))
+        return Fail("invalid sample name '" + sample.name + "'");
+
+    if (pos < line.size() && line[pos] == '{')
+    {
+        ++pos;
+        while (pos < line.size() && line[pos] != '}')
+        {
+            size_t equals = line.find('=', pos);
+            if (equals == std::string::npos || equals + 1 >= line.size() || line[equals + 1] != '"')
+                return Fail("malformed label");
+
+            std::string label = line.substr(pos, equals - pos);
+            if (!IsValidName(label))
+                return Fail("invalid label name '" + label + "'");
+
+            std::string value;
+            pos = equals + 2;
+            while (pos < line.size() && line[pos] != '"')
+            {
+                if (line[pos] == '\\')
+                {
+                    if (++pos >= line.size())
+                        break;
+                    char escaped = line[pos];
+                    if (escaped != '\\' && escaped != '"' && escaped != 'n')
+                        return Fail("invalid escape in label value");
+                    value += escaped == 'n' ? '\n' : escaped;
+                }
+                else
+                {
+                    value += line[pos];
+                }
+                ++pos;
+            }
+            if (pos >= line.size())
+                return Fail("unterminated label value");
+
+            if (!sample.labels.insert(std::make_pair(label, value)).second)
+                return Fail("label '" + label + "' repeated");
+
+            ++pos;
+            if (pos < line.size() && line[pos] == ',')
+                ++pos;
+        }
+        if (pos >= line.size())
+            return Fail("unterminated label set");
+        ++pos;
+    }
+
+    if (pos >= line.size() || line[pos] != ' ')
+        return Fail("sample needs a value");
+
+    // "value" or "value timestamp"
+    std::string rest = line.substr(pos + 1);
+    size_t space = rest.find(' ');
+    double timestamp;
+    if (!ParseValue(rest.substr(0, space), sample.value))
+        return Fail("invalid value '" + rest.substr(0, space) + "'");
+    if (space != std::string::npos && !ParseValue(rest.substr(space + 1), timestamp))
+        return Fail("invalid timestamp");
+
+    if (m_families.empty() || sample.name.compare(0, m_families.back().name.size(), m_families.back().name) != 0)
+        return Fail("sample '" + sample.name + "' outside its family");
+
+    Family& family = m_families.back();
+    std::string suffix = sample.name.substr(family.name.size());
+    if (!IsValidSuffix(family.type, suffix))
+        return Fail("sample '" + sample.name + "' not allowed in " + family.type + " '" + family.name + "'");
+
+    if (suffix == "_bucket" && sample.labels.find("le") == sample.labels.end())
+        return Fail("bucket without an le label");
+
+    family.samples.push_back(sample);
+    return true;
+}
+
+bool OpenMetricsParser::CheckFamily(const Family& family)
+{
+    struct Series
+    {
+        std::vector<double> bounds;
+        std::vector<double> counts;
+        bool hasCount = false;
+        double count = 0.0;
+    };
+
+    if (family.type == "counter")
+    {
+        for (const Sample& sample : family.samples)
+        {
+            if (!(sample.value >= 0.0))
+                return Fail("counter '" + sample.name + "' is negative or NaN");
+        }
+        return true;
+    }
+
+    if (family.type != "histogram")
+        return true;
+
+    // Group buckets by every label except le
+    std::map<std::string, Series> series;
+    for (const Sample& sample : family.samples)
+    {
+        std::string key;
+        for (const auto& label : sample.labels)
+        {
+            if (label.first != "le")
+                key += label.first + "=" + label.second + ",";
+        }
+
+        Series& current = series[key];
+        if (sample.name == family.name + "_bucket")
+        {
+            double bound;
+            if (!ParseValue(sample.labels.find("le")->second, bound))
+                return Fail("histogram '" + family.name + "' has an invalid le");
+            current.bounds.push_back(bound);
+            current.counts.push_back(sample.value);
+        }
+        else if (sample.name == family.name + "_count")
+        {
+            current.hasCount = true;
+            current.count = sample.value;
+        }
+    }
+
+    for (const auto& entry : series)
+    {
+        const Series& current = entry.second;
+        if (current.bounds.empty() || !std::isinf(current.bounds.back()))
+            return Fail("histogram '" + family.name + "' must end with an le=\"+Inf\" bucket");
+
+        for (size_t i = 1; i < current.bounds.size(); ++i)
+        {
+            if (!(current.bounds[i] > current.bounds[i - 1]))
+                return Fail("histogram '" + family.name + "' buckets are not in increasing le order");
+            if (current.counts[i] < current.counts[i - 1])
+                return Fail("histogram '" + family.name + "' bucket counts decrease");
+        }
+
+        if (current.hasCount && current.count != current.counts.back())
+            return Fail("histogram '" + family.name + "' _count differs from the +Inf bucket");
+    }
+    return true;
+}
+
+bool OpenMetricsParser::Fail(const std::string& reason)
+{
+    m_error = m_line ? "line " + std::to_string(m_line) + ": " + reason : reason;
+    return false;
+}
+
+bool OpenMetricsParser::IsValidName(const std::string& name)
+{
+    if (name.empty() || (name[0] >= '0' && name[0] <= '9'))
+        return false;
+
+    for (char c : name)
+    {
+        bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == ':';
+        if (!valid)
+            return false;
+    }
+    return true;
+}
+
+bool OpenMetricsParser::ParseValue(const std::string& text, double& value)
+{
+    if (text == "+Inf")
+        value = HUGE_VAL;
+    else if (text == "-Inf")
+        value = -HUGE_VAL;
+    else if (text == "NaN")
+        value = NAN;
+    else
+    {
+        if (text.empty())
+            return false;
+
+        char* end = nullptr;
+        value = strtod(text.c_str(), &end);
+        return *end == '\0';
+    }
+    return true;
+}
\ No newline at end of file
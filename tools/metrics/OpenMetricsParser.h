@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * Strict parser for the OpenMetrics text format subset MMA exports
+ * Checks what a textfile collector or Prometheus would reject: metadata
+ * order, family redeclaration, sample names against the family type, label
+ * syntax, histogram bucket order and counts, and the closing "# EOF"
+ */
+class OpenMetricsParser
+{
+public:
+    struct Sample
+    {
+        std::string name;
+        std::map<std::string, std::string> labels;
+        double value = 0.0;
+    };
+
+    struct Family
+    {
+        std::string name;
+        std::string type;
+        std::string unit;
+        std::string help;
+        std::vector<Sample> samples;
+    };
+
+    // Returns false with a "line N: reason" message on the first violation
+    bool Parse(const std::string& text);
+
+    const std::string& GetError() const { return m_error; }
+    const std::vector<Family>& GetFamilies() const { return m_families; }
+    const Family* FindFamily(const std::string& name) const;
+
+private:
+    // Private helpers
+    bool ParseMetadata(const std::string& line);
+    bool ParseSample(const std::string& line);
+    bool CheckFamily(const Family& family);
+    bool Fail(const std::string& reason);
+
+    static bool IsValidName(const std::string& name);
+    static bool ParseValue(const std::string& text, double& value);
+
+    // Member variables
+    std::vector<Family> m_families;
+    std::string m_error;
+    size_t m_line = 0;
+};
\ No newline at end of file
@@ -0,0 +1,69 @@
+// main.cpp : OpenMetrics exposition checker
+//
+// Usage: mma_metrics FILE [FILE...]
+//
+// Parses textfile-collector files with a strict OpenMetrics parser and
+// reports the first violation per file; exit status 1 when any file fails.
+// The writer round-trip tests live in mma_tests (metrics group).
+
+#include "OpenMetricsParser.h"
+#include <cstdio>
+#include <string>
+
+static void PrintUsage()
+{
+    fprintf(stderr, "usage: mma_metrics FILE [FILE...]\n");
+}
+
+static bool ReadFile(const char* path, std::string& text)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return false;
+
+    char chunk[4096];
+    size_t read;
+    text.clear();
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        text.append(chunk, read);
+    }
+
+    bool success = ferror(file) == 0;
+    fclose(file);
+    return success;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    int failures = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string text;
+        if (!ReadFile(argv[i], text))
+        {
+            fprintf(stderr, "mma_metrics: cannot read %s\n", argv[i]);
+            ++failures;
+            continue;
+        }
+
+        OpenMetricsParser parser;
+        if (parser.Parse(text))
+        {
+            printf("%s: ok, %zu families\n", argv[i], parser.GetFamilies().size());
+        }
+        else
+        {
+            printf("%s: %s\n", argv[i], parser.GetError().c_str());
+            ++failures;
+        }
+    }
+
+    return failures ? 1 : 0;
+}
\ No newline at end of file
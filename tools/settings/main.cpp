@@ -0,0 +1,75 @@
+// main.cpp : Settings file compiler and viewer
+//
+// Usage:
+//   mma_settings --compile INI SNAPSHOT
+//   mma_settings --dump FILE
+//
+// --compile turns an INI file into a read-only snapshot for provisioned
+// installs; --dump prints the settings either kind of file loads as.
+// The writer, backend and reload tests live in mma_tests (settings group).
+
+#include "FileSettingsStore.h"
+#include "MappedSettingsStore.h"
+#include "SettingsModel.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+static void PrintUsage()
+{
+    fprintf(stderr,
+            "usage: mma_settings --compile INI SNAPSHOT\n"
+            "       mma_settings --dump FILE\n");
+}
+
+static bool LoadAny(const std::string& path, AppSettings& settings)
+{
+    MappedSettingsStore snapshot(path);
+    if (SettingsModel::Load(snapshot, settings))
+        return true;
+
+    FileSettingsStore file(path);
+    return SettingsModel::Load(file, settings);
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc == 4 && strcmp(argv[1], "--compile") == 0)
+    {
+        AppSettings settings;
+        FileSettingsStore source(argv[2]);
+        if (!SettingsModel::Load(source, settings))
+        {
+            fprintf(stderr, "mma_settings: cannot read %s\n", argv[2]);
+            return 1;
+        }
+        if (!MappedSettingsStore::WriteSnapshot(argv[3], settings))
+        {
+            fprintf(stderr, "mma_settings: cannot write %s\n", argv[3]);
+            return 1;
+        }
+        return 0;
+    }
+
+    if (argc == 3 && strcmp(argv[1], "--dump") == 0)
+    {
+        AppSettings settings;
+        if (!LoadAny(argv[2], settings))
+        {
+            fprintf(stderr, "mma_settings: cannot read %s\n", argv[2]);
+            return 1;
+        }
+
+        // Same names and layout as the INI file, so the output can be saved as one
+        printf("[MMA]\n");
+        for (const SettingField& field : SETTINGS_FIELDS)
+        {
+            printf("%s=%u\n", field.name, field.Get(settings));
+        }
+        printf("%s=%u\n", SettingsModel::VALUE_VERSION, SETTINGS_VERSION);
+        return 0;
+    }
+
+    PrintUsage();
+    return 2;
+}
\ No newline at end of file
@@ -0,0 +1,170 @@
+// main.cpp : Shared-memory status page reader
+//
+// Usage: mma_status [--name NAME] [--json] [--watch MS]
+//
+// Maps the status page MMA publishes and prints one consistent snapshot,
+// or one per interval with --watch. Reading never makes a syscall after the
+// mapping is set up, so agents may poll as often as they like.
+// The seqlock stress test lives in mma_tests (status group).
+
+#include "CoreConfig.h"
+#include "MonotonicClock.h"
+#include "SharedStatusSegment.h"
+#include "StatusPage.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+static void PrintUsage()
+{
+    fprintf(stderr,
+            "usage: mma_status [--name NAME] [--json] [--watch MS]\n");
+}
+
+static const char* BackendName(uint64_t backend)
+{
+    switch (backend)
+    {
+    case ACTIVITY_BACKEND_HOOKS:      return "hooks";
+    case ACTIVITY_BACKEND_IDLE_CLOCK: return "idle-clock";
+    case ACTIVITY_BACKEND_RAW_INPUT:  return "raw-input";
+    default:                          return "unknown";
+    }
+}
+
+// Milliseconds from 'from' to 'to', negative when 'to' already passed
+static long long Delta(uint64_t from, uint64_t to)
+{
+    return static_cast<long long>(to) - static_cast<long long>(from);
+}
+
+static void PrintText(const StatusSnapshot& snapshot)
+{
+    uint64_t now = MonotonicNowMs();
+    const StatusSnapshot::State& state = snapshot.state;
+    const StatusSnapshot::Input& input = snapshot.input;
+
+    printf("monitoring          %s\n", state.monitoring ? "on" : "off");
+    printf("backend             %s\n", BackendName(state.backend));
+    printf("timeout             %llu s\n", static_cast<unsigned long long>(state.timeoutSeconds));
+    if (state.monitoring && state.nextDeadlineMs)
+        printf("next deadline       in %lld ms\n", Delta(now, state.nextDeadlineMs));
+    else
+        printf("next deadline       -\n");
+    printf("idle actions        %llu\n", static_cast<unsigned long long>(state.idleActions));
+    // Low-footprint instances publish no input figures at all
+    if (snapshot.inputAnalyticsOff)
+    {
+        printf("input analytics     off (low-footprint mode)\n");
+    }
+    else
+    {
+        printf("last activity       %lld ms ago\n", Delta(input.lastActivityMs, now));
+        printf("events/s            %llu (%llu processed, %llu coalesced)\n",
+               static_cast<unsigned long long>(input.eventsPerSecond),
+               static_cast<unsigned long long>(input.processedPerSecond),
+               static_cast<unsigned long long>(input.coalescedPerSecond));
+        printf("dropped events      %llu\n", static_cast<unsigned long long>(input.droppedEvents));
+        printf("hook p99            mouse %.1f us, keyboard %.1f us\n",
+               input.mouseHookP99Ns / 1000.0, input.keyboardHookP99Ns / 1000.0);
+    }
+    printf("hook incidents      %llu\n", static_cast<unsigned long long>(state.hookIncidents));
+    printf("wakeups             %llu (%llu/hour)\n", static_cast<unsigned long long>(state.wakeups),
+           static_cast<unsigned long long>(state.wakeupsPerHour));
+    printf("published           %lld ms ago by pid %llu (#%llu)\n",
+           Delta(snapshot.publishedMs, now),
+           static_cast<unsigned long long>(snapshot.writerPid),
+           static_cast<unsigned long long>(snapshot.publishCount));
+}
+
+static void PrintJson(const StatusSnapshot& snapshot)
+{
+    const StatusSnapshot::State& state = snapshot.state;
+    const StatusSnapshot::Input& input = snapshot.input;
+
+    printf("{\"nowMs\":%llu,\"monitoring\":%s,\"backend\":\"%s\",\"timeoutSeconds\":%llu,"
+           "\"nextDeadlineMs\":%llu,\"idleActions\":%llu,\"hookIncidents\":%llu,\"wakeupsPerHour\":%llu,"
+           "\"wakeups\":%llu,"
+           "\"lastActivityMs\":%llu,\"eventsPerSecond\":%llu,\"processedPerSecond\":%llu,"
+           "\"coalescedPerSecond\":%llu,\"droppedEvents\":%llu,\"mouseHookP99Ns\":%llu,"
+           "\"keyboardHookP99Ns\":%llu,\"publishedMs\":%llu,\"publishCount\":%llu,\"writerPid\":%llu,"
+           "\"inputAnalytics\":%s}\n",
+           static_cast<unsigned long long>(MonotonicNowMs()),
+           state.monitoring ? "true" : "false",
+           BackendName(state.backend),
+           static_cast<unsigned long long>(state.timeoutSeconds),
+           static_cast<unsigned long long>(state.nextDeadlineMs),
+           static_cast<unsigned long long>(state.idleActions),
+           static_cast<unsigned long long>(state.hookIncidents),
+           static_cast<unsigned long long>(state.wakeupsPerHour),
+           static_cast<unsigned long long>(state.wakeups),
+           static_cast<unsigned long long>(input.lastActivityMs),
+           static_cast<unsigned long long>(input.eventsPerSecond),
+           static_cast<unsigned long long>(input.processedPerSecond),
+           static_cast<unsigned long long>(input.coalescedPerSecond),
+           static_cast<unsigned long long>(input.droppedEvents),
+           static_cast<unsigned long long>(input.mouseHookP99Ns),
+           static_cast<unsigned long long>(input.keyboardHookP99Ns),
+           static_cast<unsigned long long>(snapshot.publishedMs),
+           static_cast<unsigned long long>(snapshot.publishCount),
+           static_cast<unsigned long long>(snapshot.writerPid),
+           snapshot.inputAnalyticsOff ? "false" : "true");
+}
+
+int main(int argc, char* argv[])
+{
+    // Default: this user's page (mma-status-<uid> on Linux)
+    char defaultName[SharedStatusSegment::MAX_NAME_LENGTH];
+    SharedStatusSegment::GetDefaultName(defaultName, sizeof(defaultName));
+    const char* name = defaultName;
+    bool json = false;
+    unsigned long watchMs = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--name") == 0 && i + 1 < argc)
+            name = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0)
+            json = true;
+        else if (strcmp(argv[i], "--watch") == 0 && i + 1 < argc)
+            watchMs = strtoul(argv[++i], nullptr, 10);
+        else
+        {
+            PrintUsage();
+            return 2;
+        }
+    }
+
+    SharedStatusSegment segment;
+    if (!segment.Open(name))
+    {
+        fprintf(stderr, "mma_status: no status page named %s (is MMA running?)\n", name);
+        return 1;
+    }
+
+    for (;;)
+    {
+        StatusSnapshot snapshot;
+        if (!StatusPage::Read(*segment.GetPage(), snapshot))
+        {
+            fprintf(stderr, "mma_status: %s is not a version %u status page or its writer stalled\n",
+                    name, StatusPage::VERSION);
+            return 1;
+        }
+
+        if (json)
+            PrintJson(snapshot);
+        else
+            PrintText(snapshot);
+        fflush(stdout);
+
+        if (!watchMs)
+            return 0;
+
+        if (!json)
+            printf("\n");
+        std::this_thread::sleep_for(std::chrono::milliseconds(watchMs));
+    }
+}
\ No newline at end of file